@@ -0,0 +1,137 @@
+//#############################################################################
+//  File:      AppBenchAnimationMain.cpp
+//  Purpose:   Headless micro-benchmark for the keyframe animation evaluation.
+//             A synthetic animation with many long node tracks similar to
+//             imported mocap clips is played forward frame by frame. The time
+//             per frame is measured with and without the per playback
+//             keyframe cursors of SLAnimTrack and with the compiled SLAnimClip
+//             with float and quantized rotations.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <SLAnimation.h>
+#include <SLNode.h>
+
+//-----------------------------------------------------------------------------
+//! Benchmark settings from the command line
+struct BenchSettings
+{
+    SLint   numTracks = 64;    // NO. of node tracks (joints)
+    SLint   numKeys   = 20000; // NO. of keyframes per track
+    SLfloat keyRate   = 60.0f; // Keyframes per second
+    SLint   numFrames = 5000;  // NO. of evaluated frames per run
+    SLfloat frameRate = 60.0f; // Playback frames per second
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], BenchSettings& settings)
+{
+    AppBenchArgs args("app-Bench-Animation [options]");
+    args.add("-tracks", settings.numTracks, "NO. of node tracks (default: 64)");
+    args.add("-keys", settings.numKeys, "NO. of keyframes per track (default: 20000)");
+    args.add("-frames", settings.numFrames, "NO. of evaluated frames per run (default: 5000)");
+
+    if (args.parse(argc, argv) &&
+        settings.numTracks > 0 && settings.numKeys > 1 && settings.numFrames > 0)
+        return true;
+
+    args.printUsage();
+    return false;
+}
+//-----------------------------------------------------------------------------
+//! Creates an animation with numTracks tracks with numKeys keyframes each
+SLAnimation* createAnimation(const BenchSettings& settings, SLVNode& nodes)
+{
+    SLfloat      lengthSec = (SLfloat)settings.numKeys / settings.keyRate;
+    SLAnimation* anim      = new SLAnimation("BenchAnimation", lengthSec);
+
+    for (SLint t = 0; t < settings.numTracks; ++t)
+    {
+        SLNode* node = new SLNode("Joint" + to_string(t));
+        node->setInitialState();
+        nodes.push_back(node);
+
+        SLNodeAnimTrack* track = anim->createNodeAnimationTrack();
+        track->animatedNode(node);
+
+        for (SLint k = 0; k < settings.numKeys; ++k)
+        {
+            SLfloat              time = (SLfloat)k / settings.keyRate;
+            SLTransformKeyframe* kf   = track->createNodeKeyframe(time);
+            kf->translation(SLVec3f(sin(time + t), cos(time), 0.0f));
+            kf->rotation(SLQuat4f(time * 10.0f, SLVec3f::AXISY));
+        }
+    }
+    return anim;
+}
+//-----------------------------------------------------------------------------
+//! Plays the animation forward and returns the average time per frame in ms
+SLfloat runPlayback(SLAnimation*         anim,
+                    SLVNode&             nodes,
+                    const BenchSettings& settings,
+                    SLVuint*             cursors)
+{
+    SLTimer timer;
+    timer.start();
+
+    for (SLint f = 0; f < settings.numFrames; ++f)
+    {
+        for (auto node : nodes)
+            node->resetToInitialState();
+
+        anim->apply((SLfloat)f / settings.frameRate, 1.0f, 1.0f, cursors);
+    }
+
+    return timer.elapsedTimeInMilliSec() / (SLfloat)settings.numFrames;
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    BenchSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    SLVNode      nodes;
+    SLAnimation* anim = createAnimation(settings, nodes);
+
+    SL_LOG("Animation benchmark: %d tracks with %d keyframes, %d frames\n",
+           anim->numNodeAnimTracks(),
+           settings.numKeys,
+           settings.numFrames);
+
+    // Binary search on the key times of every track (no cursors)
+    SLfloat msNoCursor = runPlayback(anim, nodes, settings, nullptr);
+    SL_LOG("Binary search, no cursor: %8.4f ms per frame\n", msNoCursor);
+
+    // Incremental keyframe cursors
+    SLVuint cursors;
+    SLfloat msCursor = runPlayback(anim, nodes, settings, &cursors);
+    SL_LOG("With keyframe cursors   : %8.4f ms per frame\n", msCursor);
+
+    // Compiled structure of arrays clip
+    anim->compile(settings.keyRate, false);
+    SLfloat msClip = runPlayback(anim, nodes, settings, nullptr);
+    SL_LOG("Compiled clip           : %8.4f ms per frame (%.1f MB)\n",
+           msClip,
+           (SLfloat)anim->clip()->memoryBytes() / 1048576.0f);
+
+    anim->compile(settings.keyRate, true);
+    SLfloat msClipQ = runPlayback(anim, nodes, settings, nullptr);
+    SL_LOG("Compiled clip quantized : %8.4f ms per frame (%.1f MB)\n",
+           msClipQ,
+           (SLfloat)anim->clip()->memoryBytes() / 1048576.0f);
+
+    delete anim;
+    for (auto node : nodes)
+        delete node;
+
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
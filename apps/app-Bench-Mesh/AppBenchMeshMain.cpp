@@ -0,0 +1,429 @@
+//#############################################################################
+//  File:      AppBenchMeshMain.cpp
+//  Purpose:   Headless micro-benchmark for the mesh post-processing after an
+//             import. A large grid mesh with a wavy surface is created and
+//             SLMesh::calcNormals, calcTangents, calcMinMax and calcCenterRad
+//             are timed with a single range and in parallel. Both results
+//             are compared bit by bit with a copy of the original serial
+//             implementation.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <SLMesh.h>
+
+//-----------------------------------------------------------------------------
+//! Benchmark settings from the command line
+struct BenchSettings
+{
+    SLint gridRes = 2000; // NO. of vertices per grid side
+    SLint numRuns = 5;    // NO. of runs per function (the fastest counts)
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], BenchSettings& settings)
+{
+    AppBenchArgs args("app-Bench-Mesh [options]");
+    args.add("-grid", settings.gridRes, "NO. of vertices per grid side (default: 2000)");
+    args.add("-runs", settings.numRuns, "NO. of runs per function (default: 5)");
+
+    if (args.parse(argc, argv) && settings.gridRes > 1 && settings.numRuns > 0)
+        return true;
+
+    args.printUsage();
+    return false;
+}
+//-----------------------------------------------------------------------------
+//! Creates a grid mesh with gridRes x gridRes vertices and 32 bit indices
+SLMesh* createGridMesh(SLint gridRes)
+{
+    SLMesh* mesh = new SLMesh("BenchGrid");
+    SLuint  numV = (SLuint)(gridRes * gridRes);
+    SLfloat step = 1.0f / (SLfloat)(gridRes - 1);
+
+    mesh->P.resize(numV);
+    mesh->Tc.resize(numV);
+
+    for (SLint y = 0; y < gridRes; ++y)
+    {
+        for (SLint x = 0; x < gridRes; ++x)
+        {
+            SLuint  i = (SLuint)(y * gridRes + x);
+            SLfloat u = (SLfloat)x * step;
+            SLfloat v = (SLfloat)y * step;
+            mesh->P[i].set(u - 0.5f, 0.05f * sin(u * 40.0f) * cos(v * 30.0f), v - 0.5f);
+            mesh->Tc[i].set(u, v);
+        }
+    }
+
+    mesh->I32.reserve((SLuint)((gridRes - 1) * (gridRes - 1) * 6));
+    for (SLint y = 0; y < gridRes - 1; ++y)
+    {
+        for (SLint x = 0; x < gridRes - 1; ++x)
+        {
+            SLuint i = (SLuint)(y * gridRes + x);
+            mesh->I32.push_back(i);
+            mesh->I32.push_back(i + (SLuint)gridRes);
+            mesh->I32.push_back(i + 1);
+            mesh->I32.push_back(i + 1);
+            mesh->I32.push_back(i + (SLuint)gridRes);
+            mesh->I32.push_back(i + (SLuint)gridRes + 1);
+        }
+    }
+    return mesh;
+}
+//-----------------------------------------------------------------------------
+/*! Copy of the original serial SLMesh::calcNormals for 32 bit indices that
+the new implementation is compared with.
+*/
+void refCalcNormals(SLMesh* mesh, SLVVec3f& N)
+{
+    const SLVVec3f& P   = mesh->P;
+    const SLVuint&  I32 = mesh->I32;
+
+    // Create vector and fill with zero vectors
+    N.resize(P.size());
+    std::fill(N.begin(), N.end(), SLVec3f::ZERO);
+
+    for (SLuint i = 0; i < I32.size(); i += 3)
+    {
+        // Calculate the face's normal
+        SLVec3f e1, e2, n;
+
+        // Calculate edges of triangle
+        e1.sub(P[I32[i + 1]], P[I32[i + 2]]); // e1 = B - C
+        e2.sub(P[I32[i + 1]], P[I32[i]]);     // e2 = B - A
+
+        // Build normal with cross product but do NOT normalize it.
+        n.cross(e1, e2); // n = e1 x e2
+
+        // Add this normal to its vertices normals
+        N[I32[i]] += n;
+        N[I32[i + 1]] += n;
+        N[I32[i + 2]] += n;
+    }
+
+    // normalize vertex normals
+    for (SLuint i = 0; i < P.size(); ++i)
+        N[i].normalize();
+}
+//-----------------------------------------------------------------------------
+//! Copy of the original serial SLMesh::calcTangents for 32 bit indices
+void refCalcTangents(SLMesh* mesh, const SLVVec3f& N, SLVVec4f& T)
+{
+    const SLVVec3f& P   = mesh->P;
+    const SLVVec2f& Tc  = mesh->Tc;
+    const SLVuint&  I32 = mesh->I32;
+
+    // allocate tangents
+    T.resize(P.size());
+
+    // allocate temp arrays for tangents
+    SLVVec3f T1;
+    T1.resize(P.size());
+    fill(T1.begin(), T1.end(), SLVec3f::ZERO);
+    SLVVec3f T2;
+    T2.resize(P.size());
+    fill(T2.begin(), T2.end(), SLVec3f::ZERO);
+
+    SLuint numT = (SLuint)I32.size() / 3; //NO. of triangles
+
+    for (SLuint t = 0; t < numT; ++t)
+    {
+        SLuint i = t * 3; // vertex index
+
+        // Get the 3 vertex indices
+        SLuint iVA = I32[i];
+        SLuint iVB = I32[i + 1];
+        SLuint iVC = I32[i + 2];
+
+        float x1 = P[iVB].x - P[iVA].x;
+        float x2 = P[iVC].x - P[iVA].x;
+        float y1 = P[iVB].y - P[iVA].y;
+        float y2 = P[iVC].y - P[iVA].y;
+        float z1 = P[iVB].z - P[iVA].z;
+        float z2 = P[iVC].z - P[iVA].z;
+
+        float s1 = Tc[iVB].x - Tc[iVA].x;
+        float s2 = Tc[iVC].x - Tc[iVA].x;
+        float t1 = Tc[iVB].y - Tc[iVA].y;
+        float t2 = Tc[iVC].y - Tc[iVA].y;
+
+        float   r = 1.0F / (s1 * t2 - s2 * t1);
+        SLVec3f sdir((t2 * x1 - t1 * x2) * r,
+                     (t2 * y1 - t1 * y2) * r,
+                     (t2 * z1 - t1 * z2) * r);
+        SLVec3f tdir((s1 * x2 - s2 * x1) * r,
+                     (s1 * y2 - s2 * y1) * r,
+                     (s1 * z2 - s2 * z1) * r);
+
+        T1[iVA] += sdir;
+        T1[iVB] += sdir;
+        T1[iVC] += sdir;
+
+        T2[iVA] += tdir;
+        T2[iVB] += tdir;
+        T2[iVC] += tdir;
+    }
+
+    for (SLuint i = 0; i < P.size(); ++i)
+    {
+        // Gram-Schmidt orthogonalization
+        T[i] = T1[i] - N[i] * N[i].dot(T1[i]);
+        T[i].normalize();
+
+        // Calculate temp. bitangent and store its handedness in T.w
+        SLVec3f bitangent;
+        bitangent.cross(N[i], T1[i]);
+        T[i].w = (bitangent.dot(T2[i]) < 0.0f) ? -1.0f : 1.0f;
+    }
+}
+//-----------------------------------------------------------------------------
+//! Copy of the original serial SLMesh::calcMinMax for unskinned meshes
+void refCalcMinMax(SLMesh* mesh, SLVec3f& minP, SLVec3f& maxP)
+{
+    const SLVVec3f& P = mesh->P;
+
+    // init min & max points
+    minP.set(FLT_MAX, FLT_MAX, FLT_MAX);
+    maxP.set(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    // calc min and max point of all vertices
+    for (SLuint i = 0; i < P.size(); ++i)
+    {
+        if (P[i].x < minP.x) minP.x = P[i].x;
+        if (P[i].x > maxP.x) maxP.x = P[i].x;
+        if (P[i].y < minP.y) minP.y = P[i].y;
+        if (P[i].y > maxP.y) maxP.y = P[i].y;
+        if (P[i].z < minP.z) minP.z = P[i].z;
+        if (P[i].z > maxP.z) maxP.z = P[i].z;
+    }
+}
+//-----------------------------------------------------------------------------
+//! Copy of the original serial SLMesh::calcCenterRad without the log output
+void refCalcCenterRad(SLMesh* mesh, SLVec3f& center, SLfloat& radius)
+{
+    const SLVVec3f& P = mesh->P;
+
+    SLuint  i;
+    SLfloat dx, dy, dz;
+    SLfloat radius2, xspan, yspan, zspan, maxspan;
+    SLfloat old_to_p, old_to_p_sq, old_to_new;
+    SLVec3f xmin, xmax, ymin, ymax, zmin, zmax, dia1, dia2;
+
+    // FIRST PASS: find 6 minima/maxima points
+    xmin.x = ymin.y = zmin.z = FLT_MAX;
+    xmax.x = ymax.y = zmax.z = -FLT_MAX;
+
+    for (i = 0; i < P.size(); ++i)
+    {
+        if (P[i].x < xmin.x)
+            xmin = P[i];
+        else if (P[i].x > xmax.x)
+            xmax = P[i];
+        if (P[i].y < ymin.y)
+            ymin = P[i];
+        else if (P[i].y > ymax.y)
+            ymax = P[i];
+        if (P[i].z < zmin.z)
+            zmin = P[i];
+        else if (P[i].z > zmax.z)
+            zmax = P[i];
+    }
+
+    // Set xspan = distance between the 2 points xmin & xmax (squared)
+    dx    = xmax.x - xmin.x;
+    dy    = xmax.y - xmin.y;
+    dz    = xmax.z - xmin.z;
+    xspan = dx * dx + dy * dy + dz * dz;
+
+    // Same for y & z spans
+    dx    = ymax.x - ymin.x;
+    dy    = ymax.y - ymin.y;
+    dz    = ymax.z - ymin.z;
+    yspan = dx * dx + dy * dy + dz * dz;
+
+    dx    = zmax.x - zmin.x;
+    dy    = zmax.y - zmin.y;
+    dz    = zmax.z - zmin.z;
+    zspan = dx * dx + dy * dy + dz * dz;
+
+    // Set points dia1 & dia2 to the maximally separated pair
+    dia1    = xmin;
+    dia2    = xmax; // assume xspan biggest
+    maxspan = xspan;
+    if (yspan > maxspan)
+    {
+        maxspan = yspan;
+        dia1    = ymin;
+        dia2    = ymax;
+    }
+    if (zspan > maxspan)
+    {
+        dia1 = zmin;
+        dia2 = zmax;
+    }
+
+    // dia1,dia2 is a diameter of initial sphere
+    // calc initial center
+    center.x = (dia1.x + dia2.x) * 0.5f;
+    center.y = (dia1.y + dia2.y) * 0.5f;
+    center.z = (dia1.z + dia2.z) * 0.5f;
+
+    // calculate initial radius*radius and radius
+    dx      = dia2.x - center.x; // x component of radius vector
+    dy      = dia2.y - center.y; // y component of radius vector
+    dz      = dia2.z - center.z; // z component of radius vector
+    radius2 = dx * dx + dy * dy + dz * dz;
+    radius  = sqrt(radius2);
+
+    // SECOND PASS: increment current sphere
+    for (i = 0; i < P.size(); ++i)
+    {
+        dx          = P[i].x - center.x;
+        dy          = P[i].y - center.y;
+        dz          = P[i].z - center.z;
+        old_to_p_sq = dx * dx + dy * dy + dz * dz;
+
+        if (old_to_p_sq > radius2) // do r**2 test first
+        {
+            // this point is outside of current sphere
+            old_to_p = sqrt(old_to_p_sq);
+
+            // calc radius of new sphere
+            radius     = (radius + old_to_p) * 0.5f;
+            radius2    = radius * radius; // for next r**2 compare
+            old_to_new = old_to_p - radius;
+
+            // calc center of new sphere
+            center.x = (radius * center.x + old_to_new * P[i].x) / old_to_p;
+            center.y = (radius * center.y + old_to_new * P[i].y) / old_to_p;
+            center.z = (radius * center.z + old_to_new * P[i].z) / old_to_p;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+//! Calls the function numRuns times and returns the fastest time in ms
+template<typename Function>
+SLfloat timeRuns(SLint numRuns, Function function)
+{
+    SLfloat minMS = FLT_MAX;
+    for (SLint r = 0; r < numRuns; ++r)
+    {
+        SLTimer timer;
+        timer.start();
+        function();
+        minMS = std::min(minMS, timer.elapsedTimeInMilliSec());
+    }
+    return minMS;
+}
+//-----------------------------------------------------------------------------
+//! Results of all mesh functions for the comparison
+struct MeshResults
+{
+    SLVVec3f N;
+    SLVVec4f T;
+    SLVec3f  minP, maxP, center;
+    SLfloat  radius;
+    SLfloat  ms[4];
+};
+//-----------------------------------------------------------------------------
+//! Runs all mesh functions with the passed min. NO. of parallel vertices
+MeshResults runMesh(SLMesh* mesh, SLint numRuns, SLuint minParallelVertices)
+{
+    SLMesh::minParallelVertices = minParallelVertices;
+
+    MeshResults res;
+    res.ms[0] = timeRuns(numRuns, [&]() { mesh->calcNormals(); });
+    res.ms[1] = timeRuns(numRuns, [&]() { mesh->calcTangents(); });
+    res.ms[2] = timeRuns(numRuns, [&]() { mesh->calcMinMax(); });
+    res.ms[3] = timeRuns(numRuns, [&]() { mesh->calcCenterRad(res.center, res.radius); });
+    res.N     = mesh->N;
+    res.T     = mesh->T;
+    res.minP  = mesh->minP;
+    res.maxP  = mesh->maxP;
+    return res;
+}
+//-----------------------------------------------------------------------------
+//! Runs the copies of the original serial functions
+MeshResults runReference(SLMesh* mesh, SLint numRuns)
+{
+    MeshResults res;
+    res.ms[0] = timeRuns(numRuns, [&]() { refCalcNormals(mesh, res.N); });
+    res.ms[1] = timeRuns(numRuns, [&]() { refCalcTangents(mesh, res.N, res.T); });
+    res.ms[2] = timeRuns(numRuns, [&]() { refCalcMinMax(mesh, res.minP, res.maxP); });
+    res.ms[3] = timeRuns(numRuns, [&]() { refCalcCenterRad(mesh, res.center, res.radius); });
+    return res;
+}
+//-----------------------------------------------------------------------------
+template<typename T>
+SLbool isSame(const T& a, const T& b)
+{
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+//-----------------------------------------------------------------------------
+template<typename T>
+SLbool isSame(const vector<T>& a, const vector<T>& b)
+{
+    return a.size() == b.size() &&
+           memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    BenchSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    SLMesh* mesh = createGridMesh(settings.gridRes);
+
+    SL_LOG("Mesh benchmark: %u vertices, %u triangles, %u threads\n",
+           (SLuint)mesh->P.size(),
+           mesh->numI() / 3,
+           SL::maxThreads());
+
+    // The original serial code, the new code with one range and in parallel
+    MeshResults ref = runReference(mesh, settings.numRuns);
+    MeshResults ser = runMesh(mesh, settings.numRuns, UINT_MAX);
+    MeshResults par = runMesh(mesh, settings.numRuns, 0);
+
+    auto sameAsRef = [&](const MeshResults& res, SLint f) {
+        switch (f)
+        {
+            case 0: return isSame(ref.N, res.N);
+            case 1: return isSame(ref.T, res.T);
+            case 2: return isSame(ref.minP, res.minP) && isSame(ref.maxP, res.maxP);
+            default: return isSame(ref.center, res.center) && isSame(ref.radius, res.radius);
+        }
+    };
+
+    const SLchar* names[4] = {"calcNormals  ",
+                              "calcTangents ",
+                              "calcMinMax   ",
+                              "calcCenterRad"};
+
+    SLbool allSame = true;
+    for (SLint f = 0; f < 4; ++f)
+    {
+        SLbool same = sameAsRef(ser, f) && sameAsRef(par, f);
+        SL_LOG("%s: original %8.2f ms, single range %8.2f ms, parallel %8.2f ms, speedup %5.2f, %s\n",
+               names[f],
+               ref.ms[f],
+               ser.ms[f],
+               par.ms[f],
+               ref.ms[f] / par.ms[f],
+               same ? "identical" : "DIFFERENT");
+        allSame &= same;
+    }
+
+    delete mesh;
+
+    return allSame ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+//-----------------------------------------------------------------------------
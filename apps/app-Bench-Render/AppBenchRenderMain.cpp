@@ -0,0 +1,440 @@
+//#############################################################################
+//  File:      AppBenchRenderMain.cpp
+//  Purpose:   Headless render benchmark over the demo scenes. The scenes of
+//             AppDemoLoad.cpp are loaded into an invisible GLFW window and
+//             rendered for a fixed NO. of frames while the camera orbits
+//             once around its focal point. The update, skinning, culling and
+//             drawing times, the draw calls and the visible triangles are
+//             written per frame to a CSV file and as statistics per scene to
+//             a JSON file. Optionally each scene is also rendered with the
+//             ray tracer and the path tracer at a fixed resolution.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <GLFW/glfw3.h>
+#include <SLApplication.h>
+#include <SLInterface.h>
+#include <SLScene.h>
+#include <SLSceneView.h>
+
+extern void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID);
+
+//-----------------------------------------------------------------------------
+//! Per frame measurements of the OpenGL rendering
+struct BenchFrame
+{
+    SLfloat frameMS;   //!< Time for update & paint until the GPU is finished
+    SLfloat updateMS;  //!< Time for SLScene::onUpdate
+    SLfloat skinMS;    //!< Time for the software skinning within the update
+    SLfloat cullMS;    //!< Time for the frustum culling
+    SLfloat draw3DMS;  //!< Time for the 3D drawing on the CPU
+    SLfloat draw2DMS;  //!< Time for the 2D drawing on the CPU
+    SLuint  drawCalls; //!< NO. of draw calls
+    SLuint  triangles; //!< NO. of triangles of the visible meshes
+};
+typedef vector<BenchFrame> BenchFrames;
+//-----------------------------------------------------------------------------
+//! Results of one scene
+struct BenchScene
+{
+    SLSceneID   sceneID;      //!< Scene ID of AppDemoLoad.cpp
+    BenchFrames frames;       //!< Measured OpenGL frames
+    SLfloat     loadMS   = 0; //!< Time for loading incl. async imports
+    SLfloat     rtSec    = 0; //!< Ray tracing time (0 if not done)
+    SLfloat     rtRaysMS = 0; //!< Rays per ms of the ray tracer
+    SLfloat     ptSec    = 0; //!< Path tracing time (0 if not done)
+};
+//-----------------------------------------------------------------------------
+//! Benchmark settings from the command line
+struct BenchSettings
+{
+    SLVint   sceneIDs    = {SID_Figure, SID_LargeModel, SID_MassiveData, SID_AnimationArmy};
+    SLint    width       = 1280;  // width of the sceneview
+    SLint    height      = 720;   // height of the sceneview
+    SLint    numFrames   = 300;   // NO. of measured frames per scene
+    SLint    numWarmup   = 10;    // NO. of frames before the measurement
+    SLbool   doRT        = false; // Flag if every scene gets ray traced
+    SLint    rtDepth     = 5;     // max. ray depth for RT & PT
+    SLint    ptSamples   = 0;     // NO. of PT samples per pixel (0 = no PT)
+    SLint    rtWidth     = 640;   // image width for RT & PT
+    SLint    rtHeight    = 360;   // image height for RT & PT
+    SLstring outFilename = "BenchRender";
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], BenchSettings& settings)
+{
+    AppBenchArgs args("app-Bench-Render [options]");
+    args.add("-scenes",
+             [&settings](const SLstring& val) {
+                 SLVstring ids;
+                 SLUtils::split(val, ',', ids);
+                 settings.sceneIDs.clear();
+                 for (auto& id : ids)
+                     settings.sceneIDs.push_back(stoi(id));
+                 return true;
+             },
+             "comma separated scene IDs of SLSceneID (default: Figure, LargeModel, MassiveData, AnimationArmy)");
+    args.add("-width", settings.width, "sceneview width (default: 1280)");
+    args.add("-height", settings.height, "sceneview height (default: 720)");
+    args.add("-frames", settings.numFrames, "NO. of measured frames per scene (default: 300)");
+    args.add("-warmup", settings.numWarmup, "NO. of frames before the measurement (default: 10)");
+    args.add("-rt", settings.doRT, "1 to ray trace every scene once (default: 0)");
+    args.add("-pt", settings.ptSamples, "NO. of path tracing samples per pixel (default: 0 = off)");
+    args.add("-depth", settings.rtDepth, "max. ray depth for RT & PT (default: 5)");
+    args.add("-rtwidth", settings.rtWidth, "image width for RT & PT (default: 640)");
+    args.add("-rtheight", settings.rtHeight, "image height for RT & PT (default: 360)");
+    args.add("-out", settings.outFilename, "result file name without extension (default: BenchRender)");
+
+    SLbool valid = args.parse(argc, argv) &&
+                   settings.width > 0 && settings.height > 0 &&
+                   settings.numFrames > 0 && settings.numWarmup >= 0 &&
+                   settings.rtWidth > 0 && settings.rtHeight > 0;
+
+    for (auto id : settings.sceneIDs)
+        if (id <= SID_All || id >= SID_Maximal)
+            valid = false;
+
+    if (!valid) args.printUsage();
+    return valid;
+}
+//-----------------------------------------------------------------------------
+//! The ray & path tracer call it for intermediate images that we don't show
+SLbool onWndUpdate()
+{
+    return false;
+}
+//-----------------------------------------------------------------------------
+//! Returns the NO. of triangles of all meshes that passed the culling
+SLuint countVisibleTriangles(SLSceneView* sv)
+{
+    SLuint numTriangles = 0;
+    for (auto node : *sv->visibleNodes())
+    {
+        for (auto mesh : node->meshes())
+        {
+            if (mesh->primitive() != PT_triangles) continue;
+            SLuint numI = mesh->numI();
+            numTriangles += (numI ? numI : (SLuint)mesh->P.size()) / 3;
+        }
+    }
+    return numTriangles;
+}
+//-----------------------------------------------------------------------------
+//! Writes the frames of all scenes into the CSV file
+void writeCSV(const BenchSettings& settings, const vector<BenchScene>& scenes)
+{
+    SLstring filename = settings.outFilename + ".csv";
+    ofstream csv(filename);
+    if (!csv.is_open())
+    {
+        SL_LOG("Could not write benchmark results to: %s\n", filename.c_str());
+        return;
+    }
+
+    csv << "scene,frame,frameMS,updateMS,skinMS,cullMS,draw3DMS,draw2DMS,drawCalls,triangles\n";
+    for (auto& scene : scenes)
+    {
+        for (size_t i = 0; i < scene.frames.size(); ++i)
+        {
+            const BenchFrame& f = scene.frames[i];
+            csv << scene.sceneID << "," << i << ","
+                << f.frameMS << "," << f.updateMS << "," << f.skinMS << ","
+                << f.cullMS << "," << f.draw3DMS << "," << f.draw2DMS << ","
+                << f.drawCalls << "," << f.triangles << "\n";
+        }
+    }
+
+    SL_LOG("Frame times written to: %s\n", filename.c_str());
+}
+//-----------------------------------------------------------------------------
+//! Writes the statistics of all scenes into the JSON file
+void writeJSON(const BenchSettings& settings, const vector<BenchScene>& scenes)
+{
+    SLstring filename = settings.outFilename + ".json";
+    ofstream json(filename);
+    if (!json.is_open())
+    {
+        SL_LOG("Could not write benchmark results to: %s\n", filename.c_str());
+        return;
+    }
+
+    json << "{\n";
+    json << "  \"glVersion\": \"" << SLGLState::getInstance()->glVersion() << "\",\n";
+    json << "  \"width\": " << settings.width << ",\n";
+    json << "  \"height\": " << settings.height << ",\n";
+    json << "  \"frames\": " << settings.numFrames << ",\n";
+    json << "  \"threads\": " << SL::maxThreads() << ",\n";
+    json << "  \"scenes\": [\n";
+
+    for (size_t s = 0; s < scenes.size(); ++s)
+    {
+        const BenchScene& scene = scenes[s];
+
+        SLVfloat frameMS, updateMS, skinMS, cullMS, draw3DMS, draw2DMS, drawCalls, triangles;
+        for (auto& f : scene.frames)
+        {
+            frameMS.push_back(f.frameMS);
+            updateMS.push_back(f.updateMS);
+            skinMS.push_back(f.skinMS);
+            cullMS.push_back(f.cullMS);
+            draw3DMS.push_back(f.draw3DMS);
+            draw2DMS.push_back(f.draw2DMS);
+            drawCalls.push_back((SLfloat)f.drawCalls);
+            triangles.push_back((SLfloat)f.triangles);
+        }
+
+        json << "    {\n";
+        json << "      \"sceneID\": " << scene.sceneID << ",\n";
+        json << "      \"loadMS\": " << scene.loadMS << ",\n";
+        json << "      \"rtSec\": " << scene.rtSec << ",\n";
+        json << "      \"rtRaysPerMS\": " << scene.rtRaysMS << ",\n";
+        json << "      \"ptSec\": " << scene.ptSec << ",\n";
+        json << "      \"gl\": {\n";
+        AppBench::writeStats(json, "        ", "frameMS", frameMS, false);
+        AppBench::writeStats(json, "        ", "updateMS", updateMS, false);
+        AppBench::writeStats(json, "        ", "skinMS", skinMS, false);
+        AppBench::writeStats(json, "        ", "cullMS", cullMS, false);
+        AppBench::writeStats(json, "        ", "draw3DMS", draw3DMS, false);
+        AppBench::writeStats(json, "        ", "draw2DMS", draw2DMS, false);
+        AppBench::writeStats(json, "        ", "drawCalls", drawCalls, false);
+        AppBench::writeStats(json, "        ", "triangles", triangles, true);
+        json << "      }\n";
+        json << "    }" << (s + 1 < scenes.size() ? ",\n" : "\n");
+    }
+
+    json << "  ]\n";
+    json << "}\n";
+
+    SL_LOG("Scene statistics written to: %s\n", filename.c_str());
+}
+//-----------------------------------------------------------------------------
+/*! Loads the scene and waits until all asynchronous imports and texture
+uploads are finished.
+*/
+SLfloat loadScene(SLSceneView* sv, SLSceneID sceneID)
+{
+    SLScene* s       = SLApplication::scene;
+    SLfloat  startMS = s->timeMilliSec();
+
+    s->onLoad(s, sv, sceneID);
+
+    while (!s->asyncImporters().empty() || s->textureStreamer().numJobs() > 0)
+        slUpdateAndPaint((int)sv->index());
+
+    glFinish();
+    return s->timeMilliSec() - startMS;
+}
+//-----------------------------------------------------------------------------
+/*! Renders the warmup and the measured frames with OpenGL. The camera orbits
+in the measured frames once around its focal point. glFinish after every frame
+includes the GPU time into the frame time.
+*/
+void renderGL(const BenchSettings& settings, SLSceneView* sv, BenchScene& scene)
+{
+    SLScene* s = SLApplication::scene;
+
+    for (SLint f = 0; f < settings.numWarmup; ++f)
+    {
+        slUpdateAndPaint((int)sv->index());
+        glFinish();
+    }
+
+    SLCamera* cam    = sv->camera();
+    SLVec3f   center = cam->focalPointWS();
+    SLVec3f   axis   = SLVec3f::AXISY;
+    SLfloat   angle  = 360.0f / (SLfloat)settings.numFrames;
+
+    for (SLint i = 0; i < settings.numFrames; ++i)
+    {
+        cam->rotateAround(center, axis, angle, TS_world);
+
+        SLfloat startMS = s->timeMilliSec();
+        slUpdateAndPaint((int)sv->index());
+        glFinish();
+
+        BenchFrame f;
+        f.frameMS   = s->timeMilliSec() - startMS;
+        f.updateMS  = s->updateTimesMS().last();
+        f.skinMS    = s->skinTimesMS().last();
+        f.cullMS    = sv->cullTimeMS();
+        f.draw3DMS  = sv->draw3DTimeMS();
+        f.draw2DMS  = sv->draw2DTimeMS();
+        f.drawCalls = SLGLVertexArray::totalDrawCalls;
+        f.triangles = countVisibleTriangles(sv);
+        scene.frames.push_back(f);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Renders the scene once with the ray tracer and once with the path tracer
+at the fixed RT resolution. Both render blocking within the paint call.
+*/
+void renderRTAndPT(const BenchSettings& settings, SLSceneView* sv, BenchScene& scene)
+{
+    SLint svW = sv->scrW();
+    SLint svH = sv->scrH();
+    sv->onResize(settings.rtWidth, settings.rtHeight);
+
+    if (settings.doRT)
+    {
+        sv->raytracer()->state(rtReady);
+        sv->startRaytracing(settings.rtDepth);
+        sv->raytracer()->aaSamples(1);
+        slUpdateAndPaint((int)sv->index());
+
+        SLfloat rtSec = sv->raytracer()->renderSec();
+        SLuint  rays  = (SLuint)(settings.rtWidth * settings.rtHeight) +
+                      SLRay::reflectedRays + SLRay::refractedRays +
+                      SLRay::subsampledRays + SLRay::shadowRays;
+
+        scene.rtSec    = rtSec;
+        scene.rtRaysMS = rtSec > 0.0f ? (SLfloat)rays / rtSec / 1000.0f : 0.0f;
+        sv->renderType(RT_gl);
+    }
+
+    if (settings.ptSamples > 0)
+    {
+        sv->pathtracer()->state(rtReady);
+        sv->startPathtracing(settings.rtDepth, settings.ptSamples);
+        slUpdateAndPaint((int)sv->index());
+
+        scene.ptSec = sv->pathtracer()->renderSec();
+        sv->renderType(RT_gl);
+    }
+
+    sv->onResize(svW, svH);
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    BenchSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    // An invisible window provides the OpenGL context and the framebuffer
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return EXIT_FAILURE;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(settings.width,
+                                          settings.height,
+                                          "app-Bench-Render",
+                                          nullptr,
+                                          nullptr);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to create an OpenGL context\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    glewExperimental = GL_TRUE; // avoids a crash
+    GLenum err       = glewInit();
+    if (GLEW_OK != err)
+    {
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        return EXIT_FAILURE;
+    }
+
+    SLVstring cmdLineArgs;
+    SLstring  projectRoot = SLstring(SL_PROJECT_ROOT);
+    slCreateAppAndScene(cmdLineArgs,
+                        projectRoot + "/data/shaders/",
+                        projectRoot + "/data/models/",
+                        projectRoot + "/data/images/textures/",
+                        projectRoot + "/data/videos/",
+                        projectRoot + "/data/images/fonts/",
+                        projectRoot + "/data/calibrations/",
+                        SLFileSystem::getAppsWritableDir(),
+                        "AppBenchRender",
+                        (void*)appDemoLoadScene);
+
+    // The sceneview has no UI so that only the scene gets measured
+    SLint svIndex = slCreateSceneView(settings.width,
+                                      settings.height,
+                                      142,
+                                      SID_Empty,
+                                      (void*)&onWndUpdate,
+                                      nullptr,
+                                      nullptr,
+                                      nullptr);
+
+    SLSceneView* sv = SLApplication::scene->sv((SLuint)svIndex);
+
+    SL_LOG("Render benchmark: %dx%d, %d frames per scene, %s\n",
+           settings.width,
+           settings.height,
+           settings.numFrames,
+           SLGLState::getInstance()->glVersion().c_str());
+    SL_LOG("Scene  load ms  frame avg/p95  update  skin   cull  draw3D  calls  triangles  RT s   PT s\n");
+
+    vector<BenchScene> scenes;
+    for (auto sceneID : settings.sceneIDs)
+    {
+        BenchScene scene;
+        scene.sceneID = (SLSceneID)sceneID;
+        scene.loadMS  = loadScene(sv, scene.sceneID);
+
+        renderGL(settings, sv, scene);
+
+        if (settings.doRT || settings.ptSamples > 0)
+            renderRTAndPT(settings, sv, scene);
+
+        SLfloat  frameSum = 0, updateSum = 0, skinSum = 0, cullSum = 0, draw3DSum = 0;
+        SLfloat  callSum = 0, triSum = 0;
+        SLVfloat frameMS;
+        for (auto& f : scene.frames)
+        {
+            frameSum += f.frameMS;
+            updateSum += f.updateMS;
+            skinSum += f.skinMS;
+            cullSum += f.cullMS;
+            draw3DSum += f.draw3DMS;
+            callSum += f.drawCalls;
+            triSum += f.triangles;
+            frameMS.push_back(f.frameMS);
+        }
+        SLfloat n = (SLfloat)scene.frames.size();
+
+        SL_LOG("%5d  %7.0f  %5.2f/%5.2f    %5.2f  %5.2f  %5.2f  %6.2f  %5.0f  %9.0f  %5.2f  %5.2f\n",
+               scene.sceneID,
+               scene.loadMS,
+               frameSum / n,
+               AppBench::percentile(frameMS, 95),
+               updateSum / n,
+               skinSum / n,
+               cullSum / n,
+               draw3DSum / n,
+               callSum / n,
+               triSum / n,
+               scene.rtSec,
+               scene.ptSec);
+
+        scenes.push_back(scene);
+    }
+
+    writeCSV(settings, scenes);
+    writeJSON(settings, scenes);
+
+    slTerminate();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,327 @@
+//#############################################################################
+//  File:      AppBenchTrackingMain.cpp
+//  Purpose:   Headless benchmark for the video trackers. A recorded video file
+//             is fed frame by frame through SLCVCapture::adjustForSL and one
+//             of the SLCVTracked implementations. The per stage latencies,
+//             the pose jitter and the pose loss counts are written to a
+//             JSON file so that different detector/descriptor configurations
+//             can be compared and regressions can be caught.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <SLApplication.h>
+#include <SLAssimpImporter.h>
+#include <SLCVCalibration.h>
+#include <SLCVCapture.h>
+#include <SLCVTrackedAruco.h>
+#include <SLCVTrackedChessboard.h>
+#include <SLCVTrackedFaces.h>
+#include <SLCVTrackedFeatures.h>
+#include <SLCVTrackedFeaturesMulti.h>
+#include <SLScene.h>
+#include <SLSceneView.h>
+
+//-----------------------------------------------------------------------------
+//! Per frame measurements of one benchmark run
+struct BenchFrame
+{
+    SLfloat captureMS;  //!< Time for grabbing and adjusting the frame
+    SLfloat trackingMS; //!< Total time of the tracker->track call
+    SLfloat detectMS;   //!< Time for keypoint detection (0 if not done)
+    SLfloat matchMS;    //!< Time for descriptor matching (0 if not done)
+    SLfloat optFlowMS;  //!< Time for optical flow tracking (0 if not done)
+    SLfloat poseMS;     //!< Time for pose estimation (0 if not done)
+    SLbool  foundPose;  //!< Flag if the tracker found a pose
+    SLMat4f ovm;        //!< Object view matrix if the pose was found
+};
+typedef vector<BenchFrame> BenchFrames;
+//-----------------------------------------------------------------------------
+//! Benchmark settings from the command line
+struct BenchSettings
+{
+    SLstring               videoFile   = "";
+    SLstring               trackerName = "features";
+    SLstring               markerFile  = "features_stones.png";
+    SLstring               outFile     = "BenchTracking.json";
+    SLCVDetectDescribeType ddType      = DDT_RAUL_RAUL;
+    SLint                  maxFrames   = 0; // 0 = all frames of the video
+    SLfloat                outWdivH    = 0; // 0 = no cropping
+};
+//-----------------------------------------------------------------------------
+SLbool parseDDType(const SLstring& name, SLCVDetectDescribeType& ddType)
+{
+    if (name == "FAST_BRIEF") ddType = DDT_FAST_BRIEF;
+    else if (name == "RAUL_RAUL") ddType = DDT_RAUL_RAUL;
+    else if (name == "ORB_ORB") ddType = DDT_ORB_ORB;
+    else if (name == "SURF_SURF") ddType = DDT_SURF_SURF;
+    else if (name == "SIFT_SIFT") ddType = DDT_SIFT_SIFT;
+    else return false;
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], BenchSettings& settings)
+{
+    AppBenchArgs args("app-Bench-Tracking -video <file> [options]");
+    args.add("-video", settings.videoFile, "video file to track");
+    args.add("-tracker", settings.trackerName, "features|multi|aruco|chessboard|faces (default: features)");
+    args.add("-marker",
+             settings.markerFile,
+             "marker image for the features tracker or a comma\n"
+             "separated list of marker images for the multi tracker");
+    args.add("-dd",
+             [&settings](const SLstring& val) { return parseDDType(val, settings.ddType); },
+             "FAST_BRIEF|RAUL_RAUL|ORB_ORB|SURF_SURF|SIFT_SIFT");
+    args.add("-frames", settings.maxFrames, "max. NO. of frames to process (default: all)");
+    args.add("-aspect", settings.outWdivH, "output width/height ratio for cropping (default: none)");
+    args.add("-out", settings.outFile, "JSON result file (default: BenchTracking.json)");
+
+    SLVstring trackers = {"features", "multi", "aruco", "chessboard", "faces"};
+    if (args.parse(argc, argv) &&
+        settings.videoFile != "" &&
+        std::find(trackers.begin(), trackers.end(), settings.trackerName) != trackers.end())
+        return true;
+
+    args.printUsage();
+    return false;
+}
+//-----------------------------------------------------------------------------
+/*! Writes all benchmark results into the JSON file. The relocalizations are
+only written for trackers that count them (relocalizations >= 0).
+*/
+void writeResults(const BenchSettings& settings,
+                  const BenchFrames&   frames,
+                  SLint                relocalizations)
+{
+    SLVfloat captureMS, trackingMS, detectMS, matchMS, optFlowMS, poseMS;
+    SLVfloat jitterTransMM, jitterRotDEG;
+    SLint    framesWithPose     = 0;
+    SLint    poseReacquisitions = 0;
+    SLint    trackingLosses     = 0;
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        const BenchFrame& f = frames[i];
+        captureMS.push_back(f.captureMS);
+        trackingMS.push_back(f.trackingMS);
+        if (f.detectMS > 0) detectMS.push_back(f.detectMS);
+        if (f.matchMS > 0) matchMS.push_back(f.matchMS);
+        if (f.optFlowMS > 0) optFlowMS.push_back(f.optFlowMS);
+        if (f.poseMS > 0) poseMS.push_back(f.poseMS);
+
+        if (f.foundPose) framesWithPose++;
+
+        if (i == 0) continue;
+        const BenchFrame& prev = frames[i - 1];
+
+        // Any pose found after a frame without pose
+        if (f.foundPose && !prev.foundPose) poseReacquisitions++;
+        if (!f.foundPose && prev.foundPose) trackingLosses++;
+
+        // Pose jitter between two consecutive frames with a pose
+        if (f.foundPose && prev.foundPose)
+        {
+            jitterTransMM.push_back(f.ovm.translation().distance(prev.ovm.translation()));
+
+            SLMat3f rotDelta = prev.ovm.mat3().transposed() * f.ovm.mat3();
+            SLfloat angleDEG;
+            SLVec3f axis;
+            rotDelta.toAngleAxis(angleDEG, axis);
+            jitterRotDEG.push_back(angleDEG);
+        }
+    }
+
+    ofstream json(settings.outFile);
+    if (!json.is_open())
+    {
+        SL_LOG("Could not write benchmark results to: %s\n", settings.outFile.c_str());
+        return;
+    }
+
+    json << "{\n";
+    json << "  \"video\": \"" << settings.videoFile << "\",\n";
+    json << "  \"tracker\": \"" << settings.trackerName << "\",\n";
+    json << "  \"detectDescribeType\": " << (SLint)settings.ddType << ",\n";
+    json << "  \"frames\": " << frames.size() << ",\n";
+    json << "  \"framesWithPose\": " << framesWithPose << ",\n";
+    json << "  \"poseReacquisitions\": " << poseReacquisitions << ",\n";
+    if (relocalizations >= 0)
+        json << "  \"relocalizations\": " << relocalizations << ",\n";
+    json << "  \"trackingLosses\": " << trackingLosses << ",\n";
+    json << "  \"latencyMS\": {\n";
+    AppBench::writeStats(json, "    ", "capture", captureMS, false);
+    AppBench::writeStats(json, "    ", "tracking", trackingMS, false);
+    AppBench::writeStats(json, "    ", "detect", detectMS, false);
+    AppBench::writeStats(json, "    ", "match", matchMS, false);
+    AppBench::writeStats(json, "    ", "optFlow", optFlowMS, false);
+    AppBench::writeStats(json, "    ", "pose", poseMS, true);
+    json << "  },\n";
+    json << "  \"jitter\": {\n";
+    AppBench::writeStats(json, "    ", "translation", jitterTransMM, false);
+    AppBench::writeStats(json, "    ", "rotationDEG", jitterRotDEG, true);
+    json << "  }\n";
+    json << "}\n";
+
+    SL_LOG("Benchmark results written to: %s\n", settings.outFile.c_str());
+}
+//-----------------------------------------------------------------------------
+/*! Creates the tracker by name bound to the camera node. The multi marker
+tracker binds the first marker to the camera and every further marker to a new
+child node of the root node.
+*/
+SLCVTracked* createTracker(const BenchSettings& settings, SLCamera* cam, SLNode* root)
+{
+    if (settings.trackerName == "aruco")
+        return new SLCVTrackedAruco(cam, 0);
+    if (settings.trackerName == "chessboard")
+        return new SLCVTrackedChessboard(cam);
+    if (settings.trackerName == "faces")
+        return new SLCVTrackedFaces(cam);
+    if (settings.trackerName == "features")
+    {
+        SLCVTrackedFeatures* tracker = new SLCVTrackedFeatures(cam, settings.markerFile);
+        tracker->type(settings.ddType);
+        return tracker;
+    }
+    if (settings.trackerName == "multi")
+    {
+        SLVstring markerFiles;
+        SLUtils::split(settings.markerFile, ',', markerFiles);
+
+        SLCVTrackedFeaturesMulti* tracker = new SLCVTrackedFeaturesMulti();
+        tracker->type(settings.ddType);
+        for (SLuint i = 0; i < markerFiles.size(); ++i)
+        {
+            SLNode* node = cam;
+            if (i > 0)
+            {
+                node = new SLNode("Marker " + to_string(i));
+                root->addChild(node);
+            }
+            tracker->addMarker(node, markerFiles[i]);
+        }
+        return tracker;
+    }
+    return nullptr;
+}
+//-----------------------------------------------------------------------------
+/*!
+The headless benchmark runs without window and without OpenGL context. The
+scene and sceneview instances are only created for the time keeping, the
+calibration and the camera node that are used by the trackers. No texture or
+shader is ever built on the GPU.
+*/
+int main(int argc, char* argv[])
+{
+    BenchSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    // Default paths for all loaded resources (see slCreateAppAndScene)
+    SLstring projectRoot          = SLstring(SL_PROJECT_ROOT);
+    SLGLProgram::defaultPath      = projectRoot + "/data/shaders/";
+    SLGLTexture::defaultPath      = projectRoot + "/data/images/textures/";
+    SLGLTexture::defaultPathFonts = projectRoot + "/data/images/fonts/";
+    SLAssimpImporter::defaultPath = projectRoot + "/data/models/";
+    SLCVCapture::videoDefaultPath = projectRoot + "/data/videos/";
+    SLCVCalibration::calibIniPath = projectRoot + "/data/calibrations/";
+    SLApplication::configPath     = SLFileSystem::getAppsWritableDir();
+
+    SLApplication::createAppAndScene("AppBenchTracking", nullptr);
+    SLScene* s = SLApplication::scene;
+
+    // Open the video file before the sceneview to get its size
+    SLCVCapture::videoFilename = settings.videoFile;
+    SLCVCapture::videoLoops    = false;
+    SLVec2i videoSize          = SLCVCapture::openFile();
+    if (videoSize == SLVec2i::ZERO)
+    {
+        SLApplication::deleteAppAndScene();
+        return EXIT_FAILURE;
+    }
+
+    // The sceneview aspect ratio defines the cropping in adjustForSL
+    SLint svW = videoSize.x;
+    SLint svH = settings.outWdivH > 0 ? (SLint)(videoSize.x / settings.outWdivH) : videoSize.y;
+
+    SLSceneView* sv = new SLSceneView();
+    sv->init("BenchSceneView", svW, svH, nullptr, nullptr, nullptr);
+
+    SLCamera* cam  = new SLCamera("Tracked Camera");
+    SLNode*   root = new SLNode("Root");
+    root->addChild(cam);
+    s->root3D(root);
+    sv->camera(cam);
+
+    SLCVTracked* tracker = createTracker(settings, cam, root);
+    if (!tracker)
+    {
+        SL_LOG("Unknown tracker: %s\n", settings.trackerName.c_str());
+        SLApplication::deleteAppAndScene();
+        return EXIT_FAILURE;
+    }
+    s->trackers().push_back(tracker);
+
+    SLCVCalibration* ac = SLApplication::activeCalib;
+    BenchFrames      frames;
+
+    SL_LOG("Benchmarking tracker %s on %s\n",
+           settings.trackerName.c_str(),
+           settings.videoFile.c_str());
+
+    while (settings.maxFrames == 0 || (SLint)frames.size() < settings.maxFrames)
+    {
+        BenchFrame f;
+
+        // Reset the stage timings because not all stages run every frame
+        s->detectTimesMS().set(0);
+        s->matchTimesMS().set(0);
+        s->optFlowTimesMS().set(0);
+        s->poseTimesMS().set(0);
+
+        SLfloat startMS = s->timeMilliSec();
+        SLCVCapture::grabAndAdjustForSL();
+        f.captureMS = s->timeMilliSec() - startMS;
+
+        // The failed read at the end of the video releases the last frame
+        if (SLCVCapture::lastFrame.empty())
+            break;
+
+        if (ac->state() == CS_uncalibrated)
+            ac->createFromGuessedFOV(SLCVCapture::lastFrame.cols,
+                                     SLCVCapture::lastFrame.rows);
+
+        SLCVTrackedAruco::trackAllOnce = true;
+
+        startMS     = s->timeMilliSec();
+        f.foundPose = tracker->track(SLCVCapture::lastFrameGray,
+                                     SLCVCapture::lastFrame,
+                                     ac,
+                                     false,
+                                     sv);
+        f.trackingMS = s->timeMilliSec() - startMS;
+        f.detectMS   = s->detectTimesMS().last();
+        f.matchMS    = s->matchTimesMS().last();
+        f.optFlowMS  = s->optFlowTimesMS().last();
+        f.poseMS     = s->poseTimesMS().last();
+        f.ovm        = tracker->objectViewMat();
+
+        frames.push_back(f);
+    }
+
+    // Only the features tracker counts its relocalizations
+    SLCVTrackedFeatures* features = dynamic_cast<SLCVTrackedFeatures*>(tracker);
+    writeResults(settings, frames, features ? features->numRelocalizations() : -1);
+
+    SLCVCapture::release();
+    SLApplication::deleteAppAndScene();
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,225 @@
+//#############################################################################
+//  File:      AppBenchVideoMain.cpp
+//  Purpose:   Benchmark for the upload of the live video texture. Synthetic
+//             camera frames are passed at a fixed frame rate through
+//             SLGLTexture::copyVideoImage and fullUpdate in an invisible GLFW
+//             window. The synchronous upload is compared with the upload
+//             through 2 and 3 pixel buffer objects (SLGLTexture::numUpdatePBOs).
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <GLFW/glfw3.h>
+#include <SLGLState.h>
+#include <SLGLTexture.h>
+
+//-----------------------------------------------------------------------------
+//! Benchmark settings from the command line
+struct BenchSettings
+{
+    SLint width     = 1920; // width of the camera frames
+    SLint height    = 1080; // height of the camera frames
+    SLint numFrames = 150;  // NO. of frames per run
+};
+//-----------------------------------------------------------------------------
+//! Averaged and max. times of a run in ms
+struct BenchResult
+{
+    SLfloat copyAvg = 0, copyMax = 0;       // copyVideoImage on the CPU
+    SLfloat uploadAvg = 0, uploadMax = 0;   // fullUpdate on the render thread
+    SLfloat latencyAvg = 0, latencyMax = 0; // fullUpdate until the GPU has the image
+    SLint   numOverruns = 0;                // NO. of frames that missed the frame time
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], BenchSettings& settings)
+{
+    AppBenchArgs args("app-Bench-Video [options]");
+    args.add("-width", settings.width, "Frame width (default: 1920)");
+    args.add("-height", settings.height, "Frame height (default: 1080)");
+    args.add("-frames", settings.numFrames, "NO. of frames per run (default: 150)");
+
+    if (args.parse(argc, argv) &&
+        settings.width > 0 && settings.height > 0 && settings.numFrames > 0)
+        return true;
+
+    args.printUsage();
+    return false;
+}
+//-----------------------------------------------------------------------------
+//! Creates a few RGB frames with different content like a moving camera
+vector<SLCVMat> createFrames(SLint width, SLint height)
+{
+    vector<SLCVMat> frames(4);
+    for (SLint f = 0; f < (SLint)frames.size(); ++f)
+    {
+        frames[(SLuint)f].create(height, width, CV_8UC3);
+        for (SLint y = 0; y < height; ++y)
+        {
+            SLuchar* row = frames[(SLuint)f].ptr(y);
+            for (SLint x = 0; x < width; ++x)
+            {
+                row[x * 3 + 0] = (SLuchar)(x + f * 16);
+                row[x * 3 + 1] = (SLuchar)(y + f * 16);
+                row[x * 3 + 2] = (SLuchar)((x ^ y) + f * 16);
+            }
+        }
+    }
+    return frames;
+}
+//-----------------------------------------------------------------------------
+/*! Runs numFrames frames at the passed frame rate. The upload latency is the
+time from the start of fullUpdate until a fence behind the upload is signaled.
+The fence gets polled while the render thread waits for the next frame.
+*/
+BenchResult runFrames(BenchSettings&   settings,
+                      vector<SLCVMat>& frames,
+                      SLuint           numPBOs,
+                      SLint            fps)
+{
+    SLGLTexture::numUpdatePBOs = numPBOs;
+    SLGLState*  stateGL        = SLGLState::getInstance();
+    SLGLTexture texture;
+    BenchResult res;
+    SLfloat     frameMS = 1000.0f / (SLfloat)fps;
+
+    SLTimer timer;
+    timer.start();
+
+    for (SLint f = 0; f < settings.numFrames; ++f)
+    {
+        SLfloat  frameStartMS = timer.elapsedTimeInMilliSec();
+        SLCVMat& frame        = frames[(SLuint)f % frames.size()];
+
+        // The capture path: copy & flip the frame into the video image
+        texture.copyVideoImage(frame.cols,
+                               frame.rows,
+                               PF_rgb,
+                               frame.data,
+                               frame.isContinuous(),
+                               true);
+        SLfloat uploadStartMS = timer.elapsedTimeInMilliSec();
+
+        // The render thread: upload the image as SLGLTexture::bindActive does
+        stateGL->bindTexture(GL_TEXTURE_2D, texture.texName());
+        texture.fullUpdate();
+        SLfloat uploadEndMS = timer.elapsedTimeInMilliSec();
+
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        // Wait for the next frame and poll the fence meanwhile
+        SLfloat latencyMS = -1.0f;
+        while (timer.elapsedTimeInMilliSec() < frameStartMS + frameMS)
+        {
+            if (latencyMS < 0.0f &&
+                glClientWaitSync(fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+                latencyMS = timer.elapsedTimeInMilliSec() - uploadStartMS;
+            this_thread::sleep_for(chrono::microseconds(100));
+        }
+        if (latencyMS < 0.0f)
+        {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            latencyMS = timer.elapsedTimeInMilliSec() - uploadStartMS;
+            res.numOverruns++;
+        }
+        glDeleteSync(fence);
+
+        // The first frame builds the texture and is not counted
+        if (f == 0) continue;
+
+        SLfloat copyMS   = uploadStartMS - frameStartMS;
+        SLfloat uploadMS = uploadEndMS - uploadStartMS;
+        res.copyAvg += copyMS;
+        res.copyMax = std::max(res.copyMax, copyMS);
+        res.uploadAvg += uploadMS;
+        res.uploadMax = std::max(res.uploadMax, uploadMS);
+        res.latencyAvg += latencyMS;
+        res.latencyMax = std::max(res.latencyMax, latencyMS);
+    }
+
+    SLfloat numCounted = (SLfloat)std::max(settings.numFrames - 1, 1);
+    res.copyAvg /= numCounted;
+    res.uploadAvg /= numCounted;
+    res.latencyAvg /= numCounted;
+    return res;
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    BenchSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    // An invisible window provides the OpenGL context
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return EXIT_FAILURE;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "app-Bench-Video", nullptr, nullptr);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to create an OpenGL context\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE; // avoids a crash
+    GLenum err       = glewInit();
+    if (GLEW_OK != err)
+    {
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        return EXIT_FAILURE;
+    }
+
+    vector<SLCVMat> frames = createFrames(settings.width, settings.height);
+
+    SL_LOG("Video upload benchmark: %dx%d RGB (%.1f MB), %d frames per run, %s\n",
+           settings.width,
+           settings.height,
+           (SLfloat)(settings.width * settings.height * 3) / 1E6f,
+           settings.numFrames,
+           SLGLState::getInstance()->glVersion().c_str());
+    SL_LOG("Mode     FPS  copy avg/max   upload avg/max  latency avg/max  overruns\n");
+
+    const SLint  fpsList[2]  = {30, 60};
+    const SLuint pbosList[3] = {0, 2, 3};
+
+    for (auto fps : fpsList)
+    {
+        for (auto numPBOs : pbosList)
+        {
+            BenchResult res  = runFrames(settings, frames, numPBOs, fps);
+            SLstring    mode = numPBOs ? to_string(numPBOs) + " PBOs" : "sync";
+            SL_LOG("%-7s  %3d  %5.2f/%5.2f    %5.2f/%5.2f     %5.2f/%5.2f     %4d\n",
+                   mode.c_str(),
+                   fps,
+                   res.copyAvg,
+                   res.copyMax,
+                   res.uploadAvg,
+                   res.uploadMax,
+                   res.latencyAvg,
+                   res.latencyMax,
+                   res.numOverruns);
+        }
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+//#############################################################################
+//  File:      AppBenchVolumeMain.cpp
+//  Purpose:   Benchmark for the 3D gradient calculation of volume textures.
+//             A synthetic volume is passed to SLGLTexture::calc3DGradients
+//             and the time is compared with the former implementation that
+//             walked every voxel with cv::Mat::at and smoothed with a full
+//             3D box filter.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <GLFW/glfw3.h>
+#include <SLGLTexture.h>
+
+//-----------------------------------------------------------------------------
+//! Benchmark settings from the command line
+struct BenchSettings
+{
+    SLint  size = 256;  // NO. of voxels per volume side
+    SLbool ref  = true; // flag if the former implementation is timed
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], BenchSettings& settings)
+{
+    AppBenchArgs args("app-Bench-Volume [options]");
+    args.add("-size", settings.size, "NO. of voxels per volume side (default: 256)");
+    args.add("-ref", settings.ref, "1: time the former implementation too (default: 1)");
+
+    if (args.parse(argc, argv) && settings.size > 4)
+        return true;
+
+    args.printUsage();
+    return false;
+}
+//-----------------------------------------------------------------------------
+//! Creates size RGBA slices with a noisy sphere in the alpha channel like a scan
+void createVolume(SLCVVImage& images, SLint size)
+{
+    SLfloat center = (SLfloat)size * 0.5f;
+    srand(0);
+
+    for (SLint z = 0; z < size; ++z)
+    {
+        SLCVImage* img = new SLCVImage(size, size, PF_rgba, "slice");
+        for (SLint y = 0; y < size; ++y)
+        {
+            SLuchar* row = img->data() + y * (SLint)img->bytesPerLine();
+            for (SLint x = 0; x < size; ++x)
+            {
+                SLVec3f d((SLfloat)x - center, (SLfloat)y - center, (SLfloat)z - center);
+                SLfloat dist  = d.length() / center;
+                SLfloat shell = 0.5f + 0.5f * cos(dist * 20.0f);
+                SLint   a     = dist < 1.0f ? (SLint)(shell * 200.0f) + rand() % 56 : 0;
+                row[x * 4 + 0] = (SLuchar)a;
+                row[x * 4 + 1] = (SLuchar)a;
+                row[x * 4 + 2] = (SLuchar)a;
+                row[x * 4 + 3] = (SLuchar)a;
+            }
+        }
+        images.push_back(img);
+    }
+}
+//-----------------------------------------------------------------------------
+//! Former implementation of SLGLTexture::calc3DGradients for the comparison
+void calc3DGradientsRef(SLCVVImage& images, SLint r)
+{
+    SLint   volX       = (SLint)images[0]->width();
+    SLint   volY       = (SLint)images[0]->height();
+    SLint   volZ       = (SLint)images.size();
+    SLfloat oneOver255 = 1.0f / 255.0f;
+
+    for (int z = r; z < volZ - r; ++z)
+    {
+        for (int y = r; y < volY - r; ++y)
+        {
+            for (int x = r; x < volX - r; ++x)
+            {
+                SLVec3f min, max;
+                min.x = (SLfloat)images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x - r)[3] * oneOver255;
+                max.x = (SLfloat)images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x + r)[3] * oneOver255;
+                min.y = (SLfloat)images[(SLuint)z]->cvMat().at<cv::Vec4b>(y - r, x)[3] * oneOver255;
+                max.y = (SLfloat)images[(SLuint)z]->cvMat().at<cv::Vec4b>(y + r, x)[3] * oneOver255;
+                min.z = (SLfloat)images[(SLuint)z - (SLuint)r]->cvMat().at<cv::Vec4b>(y, x)[3] * oneOver255;
+                max.z = (SLfloat)images[(SLuint)z + (SLuint)r]->cvMat().at<cv::Vec4b>(y, x)[3] * oneOver255;
+
+                SLVec3f normal = max - min;
+                SLfloat length = normal.length();
+                if (length > 0.0001f)
+                    normal /= length;
+                else
+                    normal.set(0, 0, 0);
+
+                normal += 1.0f;
+                images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[0] = (SLuchar)(normal.x * 0.5f * 255.0f);
+                images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[1] = (SLuchar)(normal.y * 0.5f * 255.0f);
+                images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[2] = (SLuchar)(normal.z * 0.5f * 255.0f);
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+//! Former implementation of SLGLTexture::smooth3DGradients for the comparison
+void smooth3DGradientsRef(SLCVVImage& images, SLint r)
+{
+    SLint   volX       = (SLint)images[0]->width();
+    SLint   volY       = (SLint)images[0]->height();
+    SLint   volZ       = (SLint)images.size();
+    SLfloat oneOver255 = 1.0f / 255.0f;
+
+    for (int z = r; z < volZ - r; ++z)
+    {
+        for (int y = r; y < volY - r; ++y)
+        {
+            for (int x = r; x < volX - r; ++x)
+            {
+                SLVec3f filtered(0, 0, 0);
+                SLint   num = 0;
+                for (int fz = z - r; fz <= z + r; ++fz)
+                {
+                    for (int fy = y - r; fy <= y + r; ++fy)
+                    {
+                        for (int fx = x - r; fx <= x + r; ++fx)
+                        {
+                            filtered += SLVec3f((SLfloat)images[(SLuint)fz]->cvMat().at<cv::Vec4b>(fy, fx)[0] * oneOver255 * 2.0f - 1.0f,
+                                                (SLfloat)images[(SLuint)fz]->cvMat().at<cv::Vec4b>(fy, fx)[1] * oneOver255 * 2.0f - 1.0f,
+                                                (SLfloat)images[(SLuint)fz]->cvMat().at<cv::Vec4b>(fy, fx)[2] * oneOver255 * 2.0f - 1.0f);
+                            num++;
+                        }
+                    }
+                }
+                filtered /= (SLfloat)num;
+
+                filtered += 1.0f;
+                images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[0] = (SLuchar)(filtered.x * 0.5f * 255.0f);
+                images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[1] = (SLuchar)(filtered.y * 0.5f * 255.0f);
+                images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[2] = (SLuchar)(filtered.z * 0.5f * 255.0f);
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+//! Times the gradients of a synthetic volume and compares them
+void runBenchmark(BenchSettings& settings)
+{
+    SLint size = settings.size;
+    SL_LOG("Volume gradient benchmark: %d^3 voxels (%.1f MB), %u threads\n",
+           size,
+           (SLfloat)size * (SLfloat)size * (SLfloat)size * 4.0f / 1E6f,
+           SL::maxThreads());
+
+    SLGLTexture texture;
+    createVolume(texture.images(), size);
+
+    SLTimer timer;
+    timer.start();
+    texture.calc3DGradients(1);
+    SLfloat newMS = timer.elapsedTimeInMilliSec();
+    SL_LOG("calc3DGradients  : %9.1f ms\n", newMS);
+
+    if (settings.ref)
+    {
+        SLGLTexture reference;
+        createVolume(reference.images(), size);
+
+        timer.start();
+        calc3DGradientsRef(reference.images(), 1);
+        smooth3DGradientsRef(reference.images(), 1);
+        SLfloat refMS = timer.elapsedTimeInMilliSec();
+
+        // The former smoothing read voxels that it had already smoothed
+        // before, so the results differ slightly.
+        SLint  maxDiff  = 0;
+        SLuint numDiffs = 0;
+        for (SLint z = 0; z < size; ++z)
+        {
+            SLuchar* a = texture.images()[(SLuint)z]->data();
+            SLuchar* b = reference.images()[(SLuint)z]->data();
+            for (SLint i = 0; i < size * size * 4; ++i)
+            {
+                SLint diff = abs((SLint)a[i] - (SLint)b[i]);
+                maxDiff    = std::max(maxDiff, diff);
+                if (diff > 1) numDiffs++;
+            }
+        }
+
+        SL_LOG("former version   : %9.1f ms, speedup %.1f\n", refMS, refMS / newMS);
+        SL_LOG("max. difference  : %d, %u channels differ by more than 1\n",
+               maxDiff,
+               numDiffs);
+    }
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    BenchSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    // SLGLTexture deletes its OpenGL objects and needs a context for it
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return EXIT_FAILURE;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "app-Bench-Volume", nullptr, nullptr);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to create an OpenGL context\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE; // avoids a crash
+    GLenum err       = glewInit();
+    if (GLEW_OK != err)
+    {
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        return EXIT_FAILURE;
+    }
+
+    runBenchmark(settings);
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
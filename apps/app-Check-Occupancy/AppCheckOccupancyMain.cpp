@@ -0,0 +1,336 @@
+//#############################################################################
+//  File:      AppCheckOccupancyMain.cpp
+//  Purpose:   Checks the brick occupancy grid of SLVolumeOccupancy with
+//             synthetic volumes: A single voxel on a brick border must mark
+//             all bricks whose linear texture filter reads it. After random
+//             changes of the transfer function the incrementally updated
+//             grid must match a full rebuild and a brute force reference
+//             and numOccupied must match the occupied bricks of the grid.
+//             The app returns EXIT_FAILURE if any check fails.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <GLFW/glfw3.h>
+#include <SLApplication.h>
+#include <SLCVCalibration.h>
+#include <SLTransferFunction.h>
+#include <SLVolumeOccupancy.h>
+
+//-----------------------------------------------------------------------------
+//! Check settings from the command line
+struct CheckSettings
+{
+    SLint size       = 61;  // NO. of voxels per volume side
+    SLint brickSize  = 8;   // NO. of voxels per brick side
+    SLint iterations = 100; // NO. of random transfer function changes
+};
+//-----------------------------------------------------------------------------
+//! 3D texture with synthetic slices that get created in the app
+class SyntheticVolume : public SLGLTexture
+{
+    public:
+    SyntheticVolume(SLint size)
+    {
+        _target = GL_TEXTURE_3D;
+        for (SLint z = 0; z < size; ++z)
+        {
+            SLCVImage* img = new SLCVImage(size, size, PF_rgba, "slice");
+            memset(img->data(), 0, img->bytesPerImage());
+            _images.push_back(img);
+        }
+    }
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], CheckSettings& settings)
+{
+    AppBenchArgs args("app-Check-Occupancy [options]");
+    args.add("-size", settings.size, "NO. of voxels per volume side (default: 61)");
+    args.add("-brick", settings.brickSize, "NO. of voxels per brick side (default: 8)");
+    args.add("-iter", settings.iterations, "NO. of random transfer function changes (default: 100)");
+
+    if (args.parse(argc, argv) &&
+        settings.brickSize > 1 &&
+        settings.size > 2 * settings.brickSize &&
+        settings.iterations >= 0)
+        return true;
+
+    args.printUsage();
+    return false;
+}
+//-----------------------------------------------------------------------------
+//! Fills the alpha channel with a noisy sphere like a scan
+void fillSphere(SLCVVImage& images)
+{
+    SLint   size   = (SLint)images.size();
+    SLfloat center = (SLfloat)size * 0.5f;
+    srand(0);
+
+    for (SLint z = 0; z < size; ++z)
+    {
+        for (SLint y = 0; y < size; ++y)
+        {
+            SLuchar* row = images[(SLuint)z]->data() + y * (SLint)images[(SLuint)z]->bytesPerLine();
+            for (SLint x = 0; x < size; ++x)
+            {
+                SLVec3f d((SLfloat)x - center, (SLfloat)y - center, (SLfloat)z - center);
+                SLfloat dist  = d.length() / center;
+                SLfloat shell = 0.5f + 0.5f * cos(dist * 20.0f);
+                SLint   a     = dist < 1.0f ? (SLint)(shell * 200.0f) + rand() % 56 : 0;
+                row[x * 4 + 3] = (SLuchar)a;
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+//! Sets a transfer function with an alpha peak of the passed width at center
+void setAlphaPeak(SLTransferFunction* tf, SLfloat center, SLfloat width)
+{
+    tf->alphas().clear();
+    tf->alphas().push_back(SLTransferAlpha(0.0f, 0.0f));
+    tf->alphas().push_back(SLTransferAlpha(0.0f, center - width));
+    tf->alphas().push_back(SLTransferAlpha(1.0f, center));
+    tf->alphas().push_back(SLTransferAlpha(0.0f, center + width));
+    tf->alphas().push_back(SLTransferAlpha(0.0f, 1.0f));
+    tf->generateTexture();
+}
+//-----------------------------------------------------------------------------
+//! Returns the occupancy grid as one byte per brick
+SLVuchar gridOf(SLVolumeOccupancy* occ)
+{
+    SLVuchar grid;
+    for (auto img : occ->images())
+        for (SLuint y = 0; y < img->height(); ++y)
+            grid.insert(grid.end(),
+                        img->data() + y * img->bytesPerLine(),
+                        img->data() + y * img->bytesPerLine() + img->width());
+    return grid;
+}
+//-----------------------------------------------------------------------------
+/*! Brute force occupancy of all bricks: A brick is occupied if the transfer
+function has a nonzero alpha between the min. and max. voxel value of the
+brick and its neighbour voxels. The linear filter of the transfer function
+reads the entries below and above a value.
+*/
+SLVuchar calcReference(SLCVVImage& volume, SLVfloat alphas, SLint B)
+{
+    SLint   size   = (SLint)volume.size();
+    SLint   bricks = (size + B - 1) / B;
+    SLint   length = (SLint)alphas.size();
+    SLfloat scale  = (SLfloat)length / 255.0f;
+
+    SLVuchar grid((SLuint)(bricks * bricks * bricks), 0);
+
+    for (SLint bz = 0; bz < bricks; ++bz)
+        for (SLint by = 0; by < bricks; ++by)
+            for (SLint bx = 0; bx < bricks; ++bx)
+            {
+                SLint minV = 255, maxV = 0;
+                for (SLint z = bz * B - 1; z <= (bz + 1) * B; ++z)
+                    for (SLint y = by * B - 1; y <= (by + 1) * B; ++y)
+                        for (SLint x = bx * B - 1; x <= (bx + 1) * B; ++x)
+                        {
+                            if (x < 0 || y < 0 || z < 0 ||
+                                x >= size || y >= size || z >= size)
+                                continue;
+                            SLCVImage* img = volume[(SLuint)z];
+                            SLint      v   = img->data()[y * (SLint)img->bytesPerLine() + x * 4 + 3];
+                            minV           = std::min(minV, v);
+                            maxV           = std::max(maxV, v);
+                        }
+
+                SLint lo = SL_clamp((SLint)floor((SLfloat)minV * scale - 0.5f), 0, length - 1);
+                SLint hi = SL_clamp((SLint)ceil((SLfloat)maxV * scale - 0.5f), 0, length - 1);
+                for (SLint i = lo; i <= hi; ++i)
+                    if (alphas[(SLuint)i] > 0.0f)
+                        grid[(SLuint)((bz * bricks + by) * bricks + bx)] = 255;
+            }
+
+    return grid;
+}
+//-----------------------------------------------------------------------------
+//! Returns true if numOccupied matches the grid that only contains 0 or 255
+SLbool checkNumOccupied(SLVolumeOccupancy* occ, const SLstring& label)
+{
+    SLVuchar grid     = gridOf(occ);
+    SLuint   occupied = 0;
+    SLbool   isBinary = true;
+    for (auto b : grid)
+    {
+        if (b == 255) occupied++;
+        else if (b != 0) isBinary = false;
+    }
+
+    if (occupied == occ->numOccupied() && isBinary) return true;
+
+    SL_LOG("%s: numOccupied is %u but the grid has %u occupied bricks%s\n",
+           label.c_str(),
+           occ->numOccupied(),
+           occupied,
+           isBinary ? "" : " and values other than 0 or 255");
+    return false;
+}
+//-----------------------------------------------------------------------------
+/*! A single voxel at the corner of 8 bricks must mark all of them because
+each of them reads the voxel at its border. The volume of the other bricks
+is 0 and transparent.
+*/
+SLbool checkBorderVoxel(CheckSettings& settings)
+{
+    SLint B = settings.brickSize;
+
+    SyntheticVolume volume(settings.size);
+    SLCVImage*      img = volume.images()[(SLuint)B];
+    img->data()[B * (SLint)img->bytesPerLine() + B * 4 + 3] = 255;
+
+    SLTransferFunction* tf = new SLTransferFunction({SLTransferAlpha(0.0f, 0.0f),
+                                                     SLTransferAlpha(0.0f, 0.5f),
+                                                     SLTransferAlpha(1.0f, 1.0f)},
+                                                    CLUT_BW);
+    SLVolumeOccupancy*  occ = new SLVolumeOccupancy(&volume, tf, 3, B);
+
+    SLint    bricks = (settings.size + B - 1) / B;
+    SLVuchar grid   = gridOf(occ);
+    SLbool   ok     = checkNumOccupied(occ, "Border voxel");
+
+    for (SLint bz = 0; bz < bricks; ++bz)
+        for (SLint by = 0; by < bricks; ++by)
+            for (SLint bx = 0; bx < bricks; ++bx)
+            {
+                SLbool  touched  = bx < 2 && by < 2 && bz < 2;
+                SLuchar expected = touched ? 255 : 0;
+                if (grid[(SLuint)((bz * bricks + by) * bricks + bx)] != expected)
+                {
+                    SL_LOG("Border voxel: brick (%d,%d,%d) is %s\n",
+                           bx,
+                           by,
+                           bz,
+                           touched ? "empty" : "occupied");
+                    ok = false;
+                }
+            }
+
+    SL_LOG("Border voxel     : %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+//-----------------------------------------------------------------------------
+/*! Changes the alpha peak of the transfer function randomly and compares the
+incrementally updated grid with a full rebuild and the brute force reference.
+*/
+SLbool checkUpdates(CheckSettings& settings)
+{
+    SLint B = settings.brickSize;
+
+    SyntheticVolume volume(settings.size);
+    fillSphere(volume.images());
+
+    SLTransferFunction* tf = new SLTransferFunction({SLTransferAlpha(0.0f, 0.0f),
+                                                     SLTransferAlpha(1.0f, 1.0f)},
+                                                    CLUT_BW);
+    SLVolumeOccupancy*  occ = new SLVolumeOccupancy(&volume, tf, 3, B);
+
+    SLbool ok        = checkNumOccupied(occ, "Initial grid");
+    SLuint numBricks = occ->numBricks();
+    SLuint minOcc    = occ->numOccupied();
+    SLuint maxOcc    = occ->numOccupied();
+    srand(1);
+
+    for (SLint i = 0; i < settings.iterations && ok; ++i)
+    {
+        // Random peaks from a few LUT entries up to a third of the LUT
+        SLfloat width  = 0.02f + 0.3f * (SLfloat)rand() / (SLfloat)RAND_MAX;
+        SLfloat center = width + 0.01f + (0.98f - 2.0f * width) * (SLfloat)rand() / (SLfloat)RAND_MAX;
+        setAlphaPeak(tf, center, width); // calls occ->update
+
+        SLstring label = "Update " + to_string(i);
+        ok             = checkNumOccupied(occ, label);
+
+        // Full rebuild. The transfer function then updates the first grid again.
+        SLVolumeOccupancy* full = new SLVolumeOccupancy(&volume, tf, 3, B);
+        tf->occupancy(occ);
+
+        SLVuchar grid = gridOf(occ);
+        if (grid != gridOf(full) || occ->numOccupied() != full->numOccupied())
+        {
+            SL_LOG("%s: The updated grid (%u occupied) differs from the rebuild (%u occupied)\n",
+                   label.c_str(),
+                   occ->numOccupied(),
+                   full->numOccupied());
+            ok = false;
+        }
+        if (grid != calcReference(volume.images(), tf->allAlphas(), B))
+        {
+            SL_LOG("%s: The updated grid differs from the brute force reference\n",
+                   label.c_str());
+            ok = false;
+        }
+
+        minOcc = std::min(minOcc, occ->numOccupied());
+        maxOcc = std::max(maxOcc, occ->numOccupied());
+    }
+
+    SL_LOG("Updates          : %s (%d changes, %u to %u of %u bricks occupied)\n",
+           ok ? "ok" : "FAILED",
+           settings.iterations,
+           minOcc,
+           maxOcc,
+           numBricks);
+    return ok;
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    CheckSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    // The textures delete their OpenGL objects and need a context for it
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return EXIT_FAILURE;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "app-Check-Occupancy", nullptr, nullptr);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to create an OpenGL context\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE; // avoids a crash
+    GLenum err       = glewInit();
+    if (GLEW_OK != err)
+    {
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        return EXIT_FAILURE;
+    }
+
+    // The scene owns the transfer functions and the grids
+    SLstring projectRoot          = SLstring(SL_PROJECT_ROOT);
+    SLCVCalibration::calibIniPath = projectRoot + "/data/calibrations/";
+    SLApplication::configPath     = SLFileSystem::getAppsWritableDir();
+    SLApplication::createAppAndScene("AppCheckOccupancy", nullptr);
+
+    SL_LOG("Volume occupancy check: %d^3 voxels, bricks of %d^3 voxels\n",
+           settings.size,
+           settings.brickSize);
+
+    SLbool ok = checkBorderVoxel(settings);
+    ok        = checkUpdates(settings) && ok;
+
+    SLApplication::deleteAppAndScene();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+//-----------------------------------------------------------------------------
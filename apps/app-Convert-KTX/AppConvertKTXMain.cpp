@@ -0,0 +1,265 @@
+//#############################################################################
+//  File:      AppConvertKTXMain.cpp
+//  Purpose:   Offline tool that converts an image file into a KTX file with
+//             a precompressed mip chain that SLGLTexture uploads without any
+//             decoding. The compression is done by the OpenGL driver in an
+//             invisible GLFW window and the KTX file is written with the
+//             vendored KTX library.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+#include <GLFW/glfw3.h>
+#include <SLCVImage.h>
+#include <ktx.h>
+
+//-----------------------------------------------------------------------------
+//! Compressed texture format with its name on the command line
+struct KTXFormat
+{
+    const SLchar* name;           // name on the command line
+    SLenum        internalFormat; // compressed OpenGL internal format
+    SLenum        baseFormat;     // GL_RGB or GL_RGBA
+};
+//-----------------------------------------------------------------------------
+static const KTXFormat formats[] = {
+  {"etc2", GL_COMPRESSED_RGB8_ETC2, GL_RGB},
+  {"etc2a", GL_COMPRESSED_RGBA8_ETC2_EAC, GL_RGBA},
+  {"astc", GL_COMPRESSED_RGBA_ASTC_4x4_KHR, GL_RGBA},
+  {"bc1", GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_RGB},
+  {"bc3", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_RGBA},
+  {"bc7", GL_COMPRESSED_RGBA_BPTC_UNORM, GL_RGBA}};
+//-----------------------------------------------------------------------------
+//! Conversion settings from the command line
+struct ConvertSettings
+{
+    SLstring         inFile;              // source image file
+    SLstring         outFile;             // KTX file (default: inFile.ktx)
+    const KTXFormat* format  = formats;   // compressed format
+    SLbool           mipmaps = true;      // flag if a mip chain gets baked
+};
+//-----------------------------------------------------------------------------
+//! Parses the command line into the settings and prints the usage on errors
+SLbool parseArgs(int argc, char* argv[], ConvertSettings& settings)
+{
+    AppBenchArgs args("app-Convert-KTX -in image [options]");
+    args.add("-in", settings.inFile, "Source image file (jpg, png, ...)");
+    args.add("-out", settings.outFile, "KTX file (default: source file with .ktx)");
+    args.add("-format",
+             [&settings](const SLstring& val) {
+                 settings.format = nullptr;
+                 for (auto& f : formats)
+                     if (val == f.name) settings.format = &f;
+                 return settings.format != nullptr;
+             },
+             "etc2, etc2a, astc, bc1, bc3 or bc7 (default: etc2)");
+    args.add("-mips", settings.mipmaps, "1: bake the full mip chain, 0: level 0 only (default: 1)");
+
+    if (!args.parse(argc, argv) || settings.inFile.empty())
+    {
+        args.printUsage();
+        return false;
+    }
+
+    if (settings.outFile.empty())
+        settings.outFile = SLUtils::getPath(settings.inFile) +
+                           SLUtils::getFileNameWOExt(settings.inFile) + ".ktx";
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Returns the image data as RGB or RGBA with the passed NO. of channels
+SLCVMat toRGB(SLCVImage& image, SLint channels)
+{
+    SLint code = -1;
+    switch (image.format())
+    {
+        case PF_red:
+        case PF_luminance: code = channels == 4 ? cv::COLOR_GRAY2RGBA : cv::COLOR_GRAY2RGB; break;
+        case PF_rgb: code = channels == 4 ? cv::COLOR_RGB2RGBA : -1; break;
+        case PF_rgba: code = channels == 4 ? -1 : cv::COLOR_RGBA2RGB; break;
+        case PF_bgr: code = channels == 4 ? cv::COLOR_BGR2RGBA : cv::COLOR_BGR2RGB; break;
+        case PF_bgra: code = channels == 4 ? cv::COLOR_BGRA2RGBA : cv::COLOR_BGRA2RGB; break;
+        default: SL_EXIT_MSG(("Pixel format not supported: " + image.formatString()).c_str());
+    }
+
+    if (code < 0) return image.cvMat();
+
+    SLCVMat rgb;
+    cv::cvtColor(image.cvMat(), rgb, code);
+    return rgb;
+}
+//-----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+    ConvertSettings settings;
+    if (!parseArgs(argc, argv, settings))
+        return EXIT_FAILURE;
+
+    // An invisible window provides the OpenGL context for the compression
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return EXIT_FAILURE;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow* window = glfwCreateWindow(64, 64, "app-Convert-KTX", nullptr, nullptr);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to create an OpenGL context\n");
+        glfwTerminate();
+        return EXIT_FAILURE;
+    }
+    glfwMakeContextCurrent(window);
+
+    glewExperimental = GL_TRUE; // avoids a crash
+    GLenum err       = glewInit();
+    if (GLEW_OK != err)
+    {
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        return EXIT_FAILURE;
+    }
+
+    SLTimer timer;
+    timer.start();
+
+    // The image gets flipped vertically the same way as in SLGLTexture::load
+    SLCVImage image(settings.inFile, true);
+    SLint     channels = settings.format->baseFormat == GL_RGBA ? 4 : 3;
+    SLCVMat   rgb      = toRGB(image, channels);
+    SLint     width    = rgb.cols;
+    SLint     height   = rgb.rows;
+    SLuint    numLevels =
+      settings.mipmaps ? (SLuint)floor(log2((SLfloat)std::max(width, height))) + 1 : 1;
+
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D, texID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    // Each level gets reduced from level 0 and compressed by the driver
+    vector<SLVuchar> levels(numLevels);
+    for (SLuint l = 0; l < numLevels; ++l)
+    {
+        SLint   w = std::max(width >> l, 1);
+        SLint   h = std::max(height >> l, 1);
+        SLCVMat levelMat;
+
+        if (l == 0)
+            levelMat = rgb.isContinuous() ? rgb : rgb.clone();
+        else
+            cv::resize(rgb, levelMat, cv::Size(w, h), 0, 0, cv::INTER_AREA);
+
+        glTexImage2D(GL_TEXTURE_2D,
+                     (SLint)l,
+                     (SLint)settings.format->internalFormat,
+                     w,
+                     h,
+                     0,
+                     channels == 4 ? GL_RGBA : GL_RGB,
+                     GL_UNSIGNED_BYTE,
+                     levelMat.data);
+
+        GLint isCompressed = 0, internalFormat = 0, size = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, (SLint)l, GL_TEXTURE_COMPRESSED, &isCompressed);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, (SLint)l, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, (SLint)l, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+
+        if (glGetError() != GL_NO_ERROR ||
+            !isCompressed ||
+            (SLenum)internalFormat != settings.format->internalFormat)
+        {
+            fprintf(stderr,
+                    "The OpenGL driver can't compress to %s\n",
+                    settings.format->name);
+            return EXIT_FAILURE;
+        }
+
+        levels[l].resize((SLuint)size);
+        glGetCompressedTexImage(GL_TEXTURE_2D, (SLint)l, &levels[l][0]);
+    }
+
+    glDeleteTextures(1, &texID);
+
+    // The rows are bottom up like all images in SLGLTexture
+    const SLchar*  orientation = "S=r,T=u";
+    KTX_hash_table kvTable     = ktxHashTable_Create();
+    ktxHashTable_AddKVPair(kvTable,
+                           KTX_ORIENTATION_KEY,
+                           (unsigned int)strlen(orientation) + 1,
+                           orientation);
+    unsigned int   kvdLen = 0;
+    unsigned char* kvd    = nullptr;
+    ktxHashTable_Serialize(kvTable, &kvdLen, &kvd);
+
+    KTX_texture_info info;
+    info.glType                = 0;
+    info.glTypeSize            = 1;
+    info.glFormat              = 0;
+    info.glInternalFormat      = settings.format->internalFormat;
+    info.glBaseInternalFormat  = settings.format->baseFormat;
+    info.pixelWidth            = (khronos_uint32_t)width;
+    info.pixelHeight           = (khronos_uint32_t)height;
+    info.pixelDepth            = 0;
+    info.numberOfArrayElements = 0;
+    info.numberOfFaces         = 1;
+    info.numberOfMipmapLevels  = numLevels;
+
+    vector<KTX_image_info> images(numLevels);
+    SLuint                 compressedBytes = 0;
+    for (SLuint l = 0; l < numLevels; ++l)
+    {
+        images[l].size = (GLsizei)levels[l].size();
+        images[l].data = &levels[l][0];
+        compressedBytes += (SLuint)levels[l].size();
+    }
+
+    KTX_error_code result = ktxWriteKTXN(settings.outFile.c_str(),
+                                         &info,
+                                         (GLsizei)kvdLen,
+                                         kvd,
+                                         numLevels,
+                                         &images[0]);
+    free(kvd);
+    ktxHashTable_Destroy(kvTable);
+
+    if (result != KTX_SUCCESS)
+    {
+        fprintf(stderr,
+                "Writing %s failed: %s\n",
+                settings.outFile.c_str(),
+                ktxErrorString(result));
+        return EXIT_FAILURE;
+    }
+
+    // Uncompressed RGBA bytes on the GPU as SLGLTexture::build counts them
+    SLuint rawBytes = (SLuint)(width * height * channels);
+    if (numLevels > 1) rawBytes = (SLuint)((SLfloat)rawBytes * 1.333333333f);
+
+    SL_LOG("%s: %dx%d, %u levels, %s, %u bytes on GPU instead of %u (%.1f%%) in %.0f ms\n",
+           settings.outFile.c_str(),
+           width,
+           height,
+           numLevels,
+           settings.format->name,
+           compressedBytes,
+           rawBytes,
+           100.0f * (SLfloat)compressedBytes / (SLfloat)rawBytes,
+           timer.elapsedTimeInMilliSec());
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return EXIT_SUCCESS;
+}
+//-----------------------------------------------------------------------------
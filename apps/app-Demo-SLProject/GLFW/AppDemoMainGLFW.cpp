@@ -49,6 +49,7 @@ SLint       lastMouseWheelPos;          //!< Last mouse wheel position
 SLfloat     lastMouseDownTime = 0.0f;   //!< Last mouse press time
 SLKey       modifiers         = K_none; //!< last modifier keys
 SLbool      fullscreen        = false;  //!< flag if window is in fullscreen mode
+SLint       swapInterval      = 1;      //!< NO. of monitor refreshes between 2 buffer swaps
 
 //-----------------------------------------------------------------------------
 /*! 
@@ -73,6 +74,13 @@ SLbool onPaint()
     bool viewNeedsRepaint = slUpdateAndPaint(svIndex);
     //////////////////////////////////////////////////
 
+    // Apply the swap interval of the target frame rate
+    if (slGetSwapInterval() != swapInterval)
+    {
+        swapInterval = slGetSwapInterval();
+        glfwSwapInterval(swapInterval);
+    }
+
     // Fast copy the back buffer to the front buffer. This is OS dependent.
     glfwSwapBuffers(window);
 
@@ -505,7 +513,7 @@ int main(int argc, char* argv[])
     glfwSetWindowPos(window, 10, 30);
 
     // Set number of monitor refreshes between 2 buffer swaps
-    glfwSwapInterval(1);
+    glfwSwapInterval(swapInterval);
 
     // Get GL errors that occurred before our framework is involved
     GET_GL_ERROR;
@@ -533,6 +541,11 @@ int main(int argc, char* argv[])
                         (void*)appDemoLoadScene);
     /////////////////////////////////////////////////////////
 
+    // Pass the monitor refresh rate for the frame pacing
+    const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    if (videoMode)
+        slSetRefreshRate((float)videoMode->refreshRate);
+
     // This load the GUI configs that are locally stored
     AppDemoGui::loadConfig(dpi);
 
@@ -564,10 +577,14 @@ int main(int argc, char* argv[])
         /////////////////////////////
 
         // if no updated occurred wait for the next event (power saving)
+        // otherwise wait for the next frame of the target frame rate
         if (!doRepaint)
             glfwWaitEvents();
         else
+        {
+            slWaitForNextFrame();
             glfwPollEvents();
+        }
     }
 
     AppDemoGui::saveConfig();
@@ -52,6 +52,7 @@ class AppDemoGui
     static SLbool       showStatsTiming;     //!< Flag if timing info should be shown
     static SLbool       showStatsScene;      //!< Flag if scene info should be shown
     static SLbool       showStatsVideo;      //!< Flag if video info should be shown
+    static SLbool       showProfiler;        //!< Flag if the profiler should be shown
     static SLbool       showInfosSensors;    //!< Flag if device sensors info should be shown
     static SLbool       showInfosFrameworks; //!< Flag if frameworks info should be shown
     static SLbool       showInfosScene;      //!< Flag if scene info should be shown
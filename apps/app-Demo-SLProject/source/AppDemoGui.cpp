@@ -18,12 +18,14 @@
 #include <AppDemoGui.h>
 #include <SLAnimPlayback.h>
 #include <SLApplication.h>
+#include <SLAssimpImporter.h>
 #include <SLCVCapture.h>
 #include <SLCVImage.h>
 #include <SLCVTrackedFeatures.h>
 #include <SLGLProgram.h>
 #include <SLGLShader.h>
 #include <SLGLTexture.h>
+#include <SLGLTextureStreamer.h>
 #include <SLImporter.h>
 #include <SLInterface.h>
 #include <SLLightDirect.h>
@@ -31,10 +33,14 @@
 #include <SLLightSpot.h>
 #include <SLMaterial.h>
 #include <SLMesh.h>
+#include <SLMeshOptimizer.h>
 #include <SLNode.h>
+#include <SLProfiler.h>
 #include <SLScene.h>
+#include <SLSceneCache.h>
 #include <SLSceneView.h>
 #include <SLTransferFunction.h>
+#include <SLVolumeOccupancy.h>
 
 #include <imgui.h>
 
@@ -98,6 +104,7 @@ SLbool       AppDemoGui::showCredits         = false;
 SLbool       AppDemoGui::showStatsTiming     = false;
 SLbool       AppDemoGui::showStatsScene      = false;
 SLbool       AppDemoGui::showStatsVideo      = false;
+SLbool       AppDemoGui::showProfiler        = false;
 SLbool       AppDemoGui::showInfosFrameworks = false;
 SLbool       AppDemoGui::showInfosScene      = false;
 SLbool       AppDemoGui::showInfosSensors    = false;
@@ -264,6 +271,7 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
             // Get averages from average variables (see SLAverage)
             SLfloat captureTime  = s->captureTimesMS().average();
             SLfloat updateTime   = s->updateTimesMS().average();
+            SLfloat skinTime     = s->skinTimesMS().average();
             SLfloat trackingTime = s->trackingTimesMS().average();
             SLfloat detectTime   = s->detectTimesMS().average();
             SLfloat detect1Time  = s->detect1TimesMS().average();
@@ -278,6 +286,7 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
             // Calculate percentage from frame time
             SLfloat captureTimePC  = SL_clamp(captureTime / ft * 100.0f, 0.0f, 100.0f);
             SLfloat updateTimePC   = SL_clamp(updateTime / ft * 100.0f, 0.0f, 100.0f);
+            SLfloat skinTimePC     = SL_clamp(skinTime / ft * 100.0f, 0.0f, 100.0f);
             SLfloat trackingTimePC = SL_clamp(trackingTime / ft * 100.0f, 0.0f, 100.0f);
             SLfloat detectTimePC   = SL_clamp(detectTime / ft * 100.0f, 0.0f, 100.0f);
             SLfloat matchTimePC    = SL_clamp(matchTime / ft * 100.0f, 0.0f, 100.0f);
@@ -294,6 +303,7 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
             sprintf(m + strlen(m), "Frame time    : %4.1f ms (100%%)\n", ft);
             sprintf(m + strlen(m), "  Capture     : %4.1f ms (%3d%%)\n", captureTime, (SLint)captureTimePC);
             sprintf(m + strlen(m), "  Update      : %4.1f ms (%3d%%)\n", updateTime, (SLint)updateTimePC);
+            sprintf(m + strlen(m), "    Skinning  : %4.1f ms (%3d%%)\n", skinTime, (SLint)skinTimePC);
             sprintf(m + strlen(m), "    Tracking  : %4.1f ms (%3d%%)\n", trackingTime, (SLint)trackingTimePC);
             sprintf(m + strlen(m), "      Detect  : %4.1f ms (%3d%%)\n", detectTime, (SLint)detectTimePC);
             sprintf(m + strlen(m), "        Det1  : %4.1f ms\n", detect1Time);
@@ -339,6 +349,81 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
         ImGui::PopFont();
     }
 
+    if (showProfiler)
+    {
+        ImGui::SetNextWindowSize(ImVec2(600, 300), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Profiler", &showProfiler);
+
+        SLbool isOn = SLProfiler::isOn;
+        if (ImGui::Checkbox("Profiling on", &isOn))
+            SLProfiler::isOn = isOn;
+        ImGui::SameLine();
+        if (ImGui::Button("Save Chrome Trace"))
+        {
+            SLstring filename = SLApplication::configPath + "trace.json";
+            if (SLProfiler::exportChromeTrace(filename))
+                SL_LOG("Trace saved     : %s\n", filename.c_str());
+        }
+
+        // Flame graph of the last finished frame with one row per scope depth
+        SLint64 frameStartNS, frameEndNS;
+        SLProfiler::lastFrame(frameStartNS, frameEndNS);
+        SLfloat frameMS = (SLfloat)(frameEndNS - frameStartNS) / 1.0e6f;
+        ImGui::Text("Last frame: %4.2f ms", frameMS);
+
+        if (frameEndNS > frameStartNS)
+        {
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+            SLfloat     rowH     = ImGui::GetTextLineHeightWithSpacing();
+            SLfloat     labelW   = 100.0f;
+            SLfloat     graphW   = SL_max(ImGui::GetContentRegionAvailWidth() - labelW, 10.0f);
+            SLfloat     pxPerNS  = graphW / (SLfloat)(frameEndNS - frameStartNS);
+
+            SLVProfileEvent events;
+            for (SLuint t = 0; t < SLProfiler::numThreads(); ++t)
+            {
+                if (t == SLProfiler::FRAME_THREAD) continue;
+
+                SLProfiler::threadEvents(t, frameStartNS, frameEndNS, events);
+                if (events.empty()) continue;
+
+                SLuint maxDepth = 0;
+                for (auto& e : events) maxDepth = SL_max(maxDepth, e.depth);
+
+                ImVec2 pos = ImGui::GetCursorScreenPos();
+                drawList->AddText(pos, ImGui::GetColorU32(ImGuiCol_Text), SLProfiler::threadName(t).c_str());
+
+                ImGui::PushClipRect(ImVec2(pos.x + labelW, pos.y),
+                                    ImVec2(pos.x + labelW + graphW, pos.y + (maxDepth + 1) * rowH),
+                                    true);
+                for (auto& e : events)
+                {
+                    SLfloat x0 = pos.x + labelW + (SLfloat)(e.startNS - frameStartNS) * pxPerNS;
+                    SLfloat x1 = pos.x + labelW + (SLfloat)(e.endNS - frameStartNS) * pxPerNS;
+                    SLfloat y0 = pos.y + e.depth * rowH;
+                    ImVec2  a(x0, y0);
+                    ImVec2  b(SL_max(x1, x0 + 1.0f), y0 + rowH - 1.0f);
+
+                    // Same color for the same scope name
+                    SLuint hash = 0;
+                    for (const SLchar* c = e.name; *c; ++c) hash = hash * 31 + (SLuint)*c;
+                    ImColor col = ImColor::HSV((hash % 64) / 64.0f, 0.5f, 0.7f);
+
+                    drawList->AddRectFilled(a, b, col);
+                    if (b.x - a.x > 20.0f)
+                        drawList->AddText(ImVec2(a.x + 2, a.y), IM_COL32_WHITE, e.name);
+                    if (ImGui::IsMouseHoveringRect(a, b))
+                        ImGui::SetTooltip("%s: %4.3f ms", e.name, (SLfloat)(e.endNS - e.startNS) / 1.0e6f);
+                }
+                ImGui::PopClipRect();
+
+                ImGui::Dummy(ImVec2(labelW + graphW, (maxDepth + 1) * rowH));
+            }
+        }
+
+        ImGui::End();
+    }
+
     if (showStatsScene)
     {
         SLchar m[2550]; // message character array
@@ -360,11 +445,13 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
         SLint        numBlendedPC    = (SLint)((SLfloat)numBlendedNodes / (SLfloat)stats3D.numNodes * 100.0f);
         SLint        numVisiblePC    = (SLint)((SLfloat)numVisibleNodes / (SLfloat)stats3D.numNodes * 100.0f);
 
-        // Calculate total size of texture bytes on CPU
+        // Calculate total size of texture bytes on CPU without waiting for
+        // the decoding of streamed textures
         SLfloat cpuMBTexture = 0;
         for (auto t : s->textures())
-            for (auto i : t->images())
-                cpuMBTexture += i->bytesPerImage();
+            if (!t->isStreaming())
+                for (auto i : t->images())
+                    cpuMBTexture += i->bytesPerImage();
         cpuMBTexture = cpuMBTexture / 1E6f;
 
         SLfloat cpuMBMeshes    = (SLfloat)stats3D.numBytes / 1E6f;
@@ -387,9 +474,11 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
         sprintf(m + strlen(m), "- Opaque Nodes  : %5d (%3d%%)\n", numOpaqueNodes, numOpaquePC);
         sprintf(m + strlen(m), "- Blended Nodes : %5d (%3d%%)\n", numBlendedNodes, numBlendedPC);
         sprintf(m + strlen(m), "- Visible Nodes : %5d (%3d%%)\n", numVisibleNodes, numVisiblePC);
-        sprintf(m + strlen(m), "- WM Updates    : %5d\n", SLNode::numWMUpdates);
+        sprintf(m + strlen(m), "- WM Updates    : %5d\n", (SLuint)SLNode::numWMUpdates);
+        sprintf(m + strlen(m), "Skel. Updates   : %5u full, %u reduced, %u skipped\n", s->animManager().numFullUpdates(), s->animManager().numReducedUpdates(), s->animManager().numSkippedUpdates());
         sprintf(m + strlen(m), "No. of Meshes   : %5u\n", stats3D.numMeshes);
         sprintf(m + strlen(m), "No. of Triangles: %5u\n", stats3D.numTriangles);
+        sprintf(m + strlen(m), "Streamed Tex.   : %5u\n", s->textureStreamer().numJobs());
         sprintf(m + strlen(m), "CPU MB in Total : %6.2f (100%%)\n", cpuMBTotal);
         sprintf(m + strlen(m), "-   MB in Tex.  : %6.2f (%3d%%)\n", cpuMBTexture, cpuMBTexturePC);
         sprintf(m + strlen(m), "-   MB in Meshes: %6.2f (%3d%%)\n", cpuMBMeshes, cpuMBMeshesPC);
@@ -472,6 +561,19 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
         ImGui::PopFont();
     }
 
+    if (s->asyncImporters().size())
+    {
+        // Show the progress of the assets that get loaded in the background
+        ImGui::SetNextWindowPosCenter(ImGuiSetCond_Always);
+        ImGui::Begin("Loading", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_AlwaysAutoResize);
+        for (auto importer : s->asyncImporters())
+        {
+            ImGui::Text("%s", importer->progressMsg().c_str());
+            ImGui::ProgressBar((SLfloat)importer->progressPC() / 100.0f, ImVec2(300, 0));
+        }
+        ImGui::End();
+    }
+
     if (showInfosScene)
     {
         // Calculate window position for dynamic status bar at the bottom of the main window
@@ -964,6 +1066,21 @@ void AppDemoGui::buildMenuBar(SLScene* s, SLSceneView* sv)
             if (ImGui::MenuItem("Do Wait on Idle", "I", sv->doWaitOnIdle()))
                 sv->doWaitOnIdle(!sv->doWaitOnIdle());
 
+            if (ImGui::BeginMenu("Target Frame Rate"))
+            {
+                SLFrameScheduler& fs  = s->frameScheduler();
+                SLfloat           fps = fs.targetFPS();
+
+                if (ImGui::MenuItem("Display Refresh Rate", nullptr, fps == 0.0f))
+                    fs.targetFPS(0.0f);
+                if (ImGui::MenuItem("60 FPS", nullptr, fps == 60.0f))
+                    fs.targetFPS(60.0f);
+                if (ImGui::MenuItem("30 FPS", nullptr, fps == 30.0f))
+                    fs.targetFPS(30.0f);
+
+                ImGui::EndMenu();
+            }
+
             if (ImGui::MenuItem("Do Multi Sampling", "M", sv->doMultiSampling()))
                 sv->doMultiSampling(!sv->doMultiSampling());
 
@@ -1151,6 +1268,21 @@ void AppDemoGui::buildMenuBar(SLScene* s, SLSceneView* sv)
                 if (ImGui::MenuItem("Skeleton", "K", sv->drawBits()->get(SL_DB_SKELETON)))
                     sv->drawBits()->toggle(SL_DB_SKELETON);
 
+                if (ImGui::MenuItem("Packed Vertices", nullptr, SLMesh::packVertices))
+                    SLMesh::packVertices = !SLMesh::packVertices;
+
+                if (ImGui::MenuItem("Stream Textures", nullptr, SLGLTextureStreamer::isOn))
+                    SLGLTextureStreamer::isOn = !SLGLTextureStreamer::isOn;
+
+                if (ImGui::MenuItem("Scene Cache", nullptr, SLSceneCache::isOn))
+                    SLSceneCache::isOn = !SLSceneCache::isOn;
+
+                if (ImGui::MenuItem("Optimize Meshes", nullptr, SLMeshOptimizer::isOn))
+                    SLMeshOptimizer::isOn = !SLMeshOptimizer::isOn;
+
+                if (ImGui::MenuItem("Video PBO Upload", nullptr, SLGLTexture::numUpdatePBOs > 0))
+                    SLGLTexture::numUpdatePBOs = SLGLTexture::numUpdatePBOs ? 0 : 3;
+
                 if (ImGui::MenuItem("All off"))
                     sv->drawBits()->allOff();
 
@@ -1489,6 +1621,7 @@ void AppDemoGui::buildMenuBar(SLScene* s, SLSceneView* sv)
             ImGui::MenuItem("Stats on Timing", nullptr, &showStatsTiming);
             ImGui::MenuItem("Stats on Scene", nullptr, &showStatsScene);
             ImGui::MenuItem("Stats on Video", nullptr, &showStatsVideo);
+            ImGui::MenuItem("Profiler", nullptr, &showProfiler);
             ImGui::Separator();
             ImGui::MenuItem("Show Scenegraph", nullptr, &showSceneGraph);
             ImGui::MenuItem("Show Properties", nullptr, &showProperties);
@@ -1859,6 +1992,12 @@ void AppDemoGui::buildProperties(SLScene* s)
                                 {
                                     if (t->target() == GL_TEXTURE_CUBE_MAP)
                                         ImGui::Text("Cube maps can not be displayed.");
+                                    else if (typeid(*t) == typeid(SLVolumeOccupancy))
+                                    {
+                                        SLVolumeOccupancy* occ = (SLVolumeOccupancy*)m->textures()[i];
+                                        ImGui::Text("Brick size: %d", occ->brickSize());
+                                        ImGui::Text("Occupied  : %u of %u bricks", occ->numOccupied(), occ->numBricks());
+                                    }
                                     else if (t->target() == GL_TEXTURE_3D)
                                         ImGui::Text("3D textures can not be displayed.");
                                 }
@@ -2060,6 +2199,7 @@ void AppDemoGui::loadConfig(SLint dotsPerInch)
         AppDemoGui::showStatsTiming     = false;
         AppDemoGui::showStatsScene      = false;
         AppDemoGui::showStatsVideo      = false;
+        AppDemoGui::showProfiler        = false;
         AppDemoGui::showInfosFrameworks = false;
         AppDemoGui::showInfosSensors    = false;
         AppDemoGui::showSceneGraph      = false;
@@ -2097,6 +2237,7 @@ void AppDemoGui::loadConfig(SLint dotsPerInch)
             fs["showStatsTiming"] >> b;     AppDemoGui::showStatsTiming = b;
             fs["showStatsMemory"] >> b;     AppDemoGui::showStatsScene = b;
             fs["showStatsVideo"] >> b;      AppDemoGui::showStatsVideo = b;
+            fs["showProfiler"] >> b;        AppDemoGui::showProfiler = b;
             fs["showInfosFrameworks"] >> b; AppDemoGui::showInfosFrameworks = b;
             fs["showInfosSensors"] >> b;    AppDemoGui::showInfosSensors = b;
             fs["showSceneGraph"] >> b;      AppDemoGui::showSceneGraph = b;
@@ -2162,6 +2303,7 @@ void AppDemoGui::saveConfig()
     fs << "showStatsTiming" << AppDemoGui::showStatsTiming;
     fs << "showStatsMemory" << AppDemoGui::showStatsScene;
     fs << "showStatsVideo" << AppDemoGui::showStatsVideo;
+    fs << "showProfiler" << AppDemoGui::showProfiler;
     fs << "showInfosFrameworks" << AppDemoGui::showInfosFrameworks;
     fs << "showInfosScene" << AppDemoGui::showInfosScene;
     fs << "showInfosSensors" << AppDemoGui::showInfosSensors;
@@ -41,6 +41,7 @@
 #include <SLSphere.h>
 #include <SLText.h>
 #include <SLTransferFunction.h>
+#include <SLVolumeOccupancy.h>
 
 //-----------------------------------------------------------------------------
 // Foreward declarations for helper functions used only in this file
@@ -418,7 +419,7 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
     else if (SLApplication::sceneID == SID_LargeModel) //................................................
     {
         s->name("Large Model Test");
-        s->info("Large Model with 7.2 mio. triangles.");
+        s->info("Large Model with 7.2 mio. triangles that gets loaded asynchronously in the background.");
 
         SLCamera* cam1 = new SLCamera("Camera 1");
         cam1->translation(0, 0, 600000);
@@ -434,23 +435,19 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
         light1->specular(SLCol4f(1, 1, 1));
         light1->attenuation(1, 0, 0);
 
-        SLAssimpImporter importer;
-        SLNode*          largeModel = importer.load("PLY/switzerland.ply", true, nullptr
-                                           //,SLProcess_JoinIdenticalVertices
-                                           //|SLProcess_RemoveRedundantMaterials
-                                           //|SLProcess_SortByPType
-                                           //|SLProcess_FindDegenerates
-                                           //|SLProcess_FindInvalidData
-                                           //|SLProcess_SplitLargeMeshes
-        );
-
         SLNode* scene = new SLNode("Scene");
         scene->addChild(light1);
-        if (largeModel)
-        {
-            largeModel->scaleToCenter(100000.0f);
-            scene->addChild(largeModel);
-        }
+
+        // The model gets loaded in the background and added when finished
+        SLAssimpImporter* importer = new SLAssimpImporter();
+        importer->loadAsync("PLY/switzerland.ply", [scene](SLNode* largeModel) {
+            if (largeModel)
+            {
+                largeModel->scaleToCenter(100000.0f);
+                scene->addChild(largeModel);
+            }
+        });
+
         scene->addChild(cam1);
 
         sv->camera(cam1);
@@ -1470,6 +1467,9 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
                                      SLTransferAlpha(1.00f, 1.00f)};
         SLTransferFunction* tf       = new SLTransferFunction(tfAlphas, CLUT_BCGYR);
 
+        // Create the brick occupancy grid for the empty space skipping
+        SLVolumeOccupancy* occupancy = new SLVolumeOccupancy(texMRI, tf, 0);
+
         // Load shader and uniforms for volume size
         SLGLProgram*   sp   = new SLGLGenericProgram("VolumeRenderingRayCast.vert",
                                                  "VolumeRenderingRayCast.frag");
@@ -1479,9 +1479,10 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
         sp->addUniform1f(volX);
         sp->addUniform1f(volY);
         sp->addUniform1f(volZ);
+        sp->addUniform1f(new SLGLUniform1f(UT_const, "u_brickSize", (SLfloat)occupancy->brickSize()));
 
         // Create volume rendering material
-        SLMaterial* matVR = new SLMaterial("matVR", texMRI, tf, nullptr, nullptr, sp);
+        SLMaterial* matVR = new SLMaterial("matVR", texMRI, tf, occupancy, nullptr, sp);
 
         // Create camera
         SLCamera* cam1 = new SLCamera("Camera 1");
@@ -1537,6 +1538,9 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
                                      SLTransferAlpha(1.00f, 1.00f)};
         SLTransferFunction* tf       = new SLTransferFunction(tfAlphas, CLUT_BCGYR);
 
+        // Create the brick occupancy grid for the empty space skipping
+        SLVolumeOccupancy* occupancy = new SLVolumeOccupancy(texMRI, tf, 3);
+
         // Load shader and uniforms for volume size
         SLGLProgram*   sp   = new SLGLGenericProgram("VolumeRenderingRayCast.vert",
                                                  "VolumeRenderingRayCastLighted.frag");
@@ -1546,9 +1550,10 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
         sp->addUniform1f(volX);
         sp->addUniform1f(volY);
         sp->addUniform1f(volZ);
+        sp->addUniform1f(new SLGLUniform1f(UT_const, "u_brickSize", (SLfloat)occupancy->brickSize()));
 
         // Create volume rendering material
-        SLMaterial* matVR = new SLMaterial("matVR", texMRI, tf, nullptr, nullptr, sp);
+        SLMaterial* matVR = new SLMaterial("matVR", texMRI, tf, occupancy, nullptr, sp);
 
         // Create camera
         SLCamera* cam1 = new SLCamera("Camera 1");
@@ -1846,7 +1851,7 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
     else if (SLApplication::sceneID == SID_AnimationArmy) //.............................................
     {
         s->name("Astroboy Army Test");
-        s->info("Mass animation scene of identitcal Astroboy models");
+        s->info("Mass animation scene of identitcal Astroboy models. Each copy is skinned on the GPU with its own skeleton instance.");
 
         // Create materials
         SLMaterial* m1 = new SLMaterial("m1", SLCol4f::GRAY);
@@ -1893,7 +1898,7 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
 #ifdef SL_GLES2
         SLint size = 4;
 #else
-        SLint        size   = 8;
+        SLint        size   = 16;
 #endif
         for (SLint iZ = -size; iZ <= size; ++iZ)
         {
@@ -1908,6 +1913,18 @@ void appDemoLoadScene(SLScene* s, SLSceneView* sv, SLSceneID sceneID)
                     n->translate(xt, 0, zt, TS_object);
                     for (auto m : importer.meshes())
                         n->addMesh(m);
+
+                    // Animate every copy independently with its own skeleton
+                    // instance that starts at a random animation time
+                    SLSkeletonInstance* inst = s->animManager().createSkeletonInstance(importer.skeleton());
+                    for (auto it : importer.skeleton()->animations())
+                    {
+                        SLAnimPlayback* pb = inst->animPlayback(it.first);
+                        pb->localTime(SL_random(0.0f, it.second->lengthSec()));
+                        pb->playForward();
+                    }
+                    n->skeletonInstance(inst);
+
                     scene->addChild(n);
                 }
             }
@@ -0,0 +1,147 @@
+//#############################################################################
+//  File:      AppBench.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <AppBench.h>
+
+//-----------------------------------------------------------------------------
+//! Adds an integer option
+void AppBenchArgs::add(const SLstring& key, SLint& value, const SLstring& help)
+{
+    add(key, [&value](const SLstring& val) {
+        size_t end;
+        value = stoi(val, &end);
+        return end == val.length();
+    },
+        help);
+}
+//-----------------------------------------------------------------------------
+//! Adds a float option
+void AppBenchArgs::add(const SLstring& key, SLfloat& value, const SLstring& help)
+{
+    add(key, [&value](const SLstring& val) {
+        size_t end;
+        value = stof(val, &end);
+        return end == val.length();
+    },
+        help);
+}
+//-----------------------------------------------------------------------------
+//! Adds a flag option with the values 0 and 1
+void AppBenchArgs::add(const SLstring& key, SLbool& value, const SLstring& help)
+{
+    add(key, [&value](const SLstring& val) {
+        if (val != "0" && val != "1") return false;
+        value = val == "1";
+        return true;
+    },
+        help);
+}
+//-----------------------------------------------------------------------------
+//! Adds a string option
+void AppBenchArgs::add(const SLstring& key, SLstring& value, const SLstring& help)
+{
+    add(key, [&value](const SLstring& val) {
+        value = val;
+        return true;
+    },
+        help);
+}
+//-----------------------------------------------------------------------------
+//! Adds an option with its own parser
+void AppBenchArgs::add(const SLstring& key, AppBenchParser parser, const SLstring& help)
+{
+    _options.push_back({key, parser, help});
+}
+//-----------------------------------------------------------------------------
+/*! Parses all "-key value" pairs of the command line. Returns false for an
+unknown key, a key without value or a value that the option can't parse.
+*/
+SLbool AppBenchArgs::parse(int argc, char* argv[])
+{
+    if ((argc - 1) % 2 != 0)
+        return false;
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        SLstring key = argv[i];
+        SLstring val = argv[i + 1];
+
+        auto option = std::find_if(_options.begin(),
+                                   _options.end(),
+                                   [&key](const Option& o) { return o.key == key; });
+        if (option == _options.end())
+            return false;
+
+        try
+        {
+            if (!option->parser(val))
+                return false;
+        }
+        catch (const std::exception&)
+        {
+            return false; // stoi & stof throw on invalid numbers
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Prints the usage line and all options with their help text
+void AppBenchArgs::printUsage()
+{
+    size_t keyWidth = 0;
+    for (auto& option : _options)
+        keyWidth = std::max(keyWidth, option.key.length());
+
+    cout << "Usage: " << _usage << endl;
+    for (auto& option : _options)
+    {
+        // Lines of a multiline help text are aligned below the first one
+        SLstring help = option.help;
+        SLUtils::replaceString(help, "\n", "\n" + SLstring(keyWidth + 4, ' '));
+        cout << "  " << option.key << SLstring(keyWidth - option.key.length() + 2, ' ')
+             << help << endl;
+    }
+}
+//-----------------------------------------------------------------------------
+//! Returns the value at the percentile pc (0-100) with the nearest rank method
+SLfloat AppBench::percentile(SLVfloat values, SLfloat pc)
+{
+    if (values.empty()) return 0.0f;
+    sort(values.begin(), values.end());
+    size_t rank = (size_t)ceil(pc / 100.0f * (SLfloat)values.size());
+    return values[SL_max(rank, (size_t)1) - 1];
+}
+//-----------------------------------------------------------------------------
+//! Returns the arithmetic mean of the values or 0 if there are none
+SLfloat AppBench::mean(const SLVfloat& values)
+{
+    SLfloat sum = 0.0f;
+    for (auto v : values) sum += v;
+    return values.empty() ? 0.0f : sum / (SLfloat)values.size();
+}
+//-----------------------------------------------------------------------------
+//! Writes a JSON object with mean, p50, p95, p99 & max of the values
+void AppBench::writeStats(ofstream&       json,
+                          const SLstring& indent,
+                          const SLstring& name,
+                          const SLVfloat& values,
+                          SLbool          isLast)
+{
+    json << indent << "\"" << name << "\": {"
+         << "\"mean\": " << mean(values) << ", "
+         << "\"p50\": " << percentile(values, 50) << ", "
+         << "\"p95\": " << percentile(values, 95) << ", "
+         << "\"p99\": " << percentile(values, 99) << ", "
+         << "\"max\": " << percentile(values, 100) << "}"
+         << (isLast ? "\n" : ",\n");
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+//#############################################################################
+//  File:      AppBench.h
+//  Purpose:   Helpers shared by the headless benchmark, check and tool apps:
+//             The command line option parsing with the usage output and the
+//             statistics that the benchmarks write into their JSON files.
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef APPBENCH_H
+#define APPBENCH_H
+
+#include <SL.h>
+
+//-----------------------------------------------------------------------------
+//! Parser of an option value that returns false for an invalid value
+typedef std::function<SLbool(const SLstring&)> AppBenchParser;
+//-----------------------------------------------------------------------------
+//! Command line options of the form "-key value" with their usage text
+/*!
+Every option is added with its key, the settings member it writes and a help
+text. AppBenchArgs::parse fails on unknown keys, missing values and numbers
+that can't be converted. Options with special values get their own parser.
+*/
+class AppBenchArgs
+{
+    public:
+    AppBenchArgs(const SLstring& usage) : _usage(usage) {}
+
+    void add(const SLstring& key, SLint& value, const SLstring& help);
+    void add(const SLstring& key, SLfloat& value, const SLstring& help);
+    void add(const SLstring& key, SLbool& value, const SLstring& help);
+    void add(const SLstring& key, SLstring& value, const SLstring& help);
+    void add(const SLstring& key, AppBenchParser parser, const SLstring& help);
+
+    SLbool parse(int argc, char* argv[]);
+    void   printUsage();
+
+    private:
+    //! A command line option
+    struct Option
+    {
+        SLstring       key;    //!< Option key with leading dash
+        AppBenchParser parser; //!< Parser that writes the value
+        SLstring       help;   //!< Help text of the usage
+    };
+
+    SLstring       _usage;   //!< First usage line after the app name
+    vector<Option> _options; //!< Options in the order of the usage
+};
+//-----------------------------------------------------------------------------
+//! Statistics that the benchmarks write into their JSON result files
+class AppBench
+{
+    public:
+    static SLfloat percentile(SLVfloat values, SLfloat pc);
+    static SLfloat mean(const SLVfloat& values);
+    static void    writeStats(ofstream&       json,
+                              const SLstring& indent,
+                              const SLstring& name,
+                              const SLVfloat& values,
+                              SLbool          isLast);
+};
+//-----------------------------------------------------------------------------
+#endif // APPBENCH_H
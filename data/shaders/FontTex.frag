@@ -13,14 +13,14 @@ precision mediump float;
 #endif
 
 //-----------------------------------------------------------------------------
-uniform sampler2D u_texture0;    // Color map
-uniform vec4      u_textColor;   // Text color
+uniform sampler2D u_texture0;    // Glyph atlas
 varying vec2      v_texCoord;    // Interpol. texture coordinate
+varying vec4      v_color;       // Text color
 
 void main()
 {
-    // Interpolated ambient & diffuse components  
-    gl_FragColor = u_textColor;
+    // Text color of the vertex
+    gl_FragColor = v_color;
    
     // componentwise multiply w. texture color
     vec4 texCol = texture2D(u_texture0, v_texCoord);
@@ -10,15 +10,20 @@
 
 attribute   vec4     a_position;    // Vertex position attribute
 attribute   vec3     a_texCoord;    // Vertex texture coord. attribute
+attribute   vec4     a_color;       // Vertex text color attribute
 
 uniform     mat4     u_mvpMatrix; // = projection * modelView
 
 varying     vec2     v_texCoord;    // texture coordinate at vertex
+varying     vec4     v_color;       // text color at vertex
 
 void main()
 {     
     // Set the texture coord. varying for interpolated tex. coords.
     v_texCoord = a_texCoord.xy;
+
+    // Pass the text color of the batched text
+    v_color = a_color;
    
     // Set the transformes vertex position   
     gl_Position = u_mvpMatrix * a_position;
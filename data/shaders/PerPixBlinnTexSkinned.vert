@@ -18,7 +18,7 @@ attribute   vec4  a_jointWeights;// Vertex joint weights attributes
 uniform     mat4  u_mvMatrix;    // modelview matrix 
 uniform     mat3  u_nMatrix;     // normal matrix=transpose(inverse(mv))
 uniform     mat4  u_mvpMatrix;   // = projection * modelView
-uniform     mat4  u_jointMatrices[100]; // joint matrices for skinning
+uniform     mat4  u_jointMatrices[SL_MAX_JOINTS]; // joint matrices (size set in SLGLShader)
 
 varying     vec3  v_P_VS;        // Point of illumination in view space (VS)
 varying     vec3  v_N_VS;        // Normal at P_VS in view space
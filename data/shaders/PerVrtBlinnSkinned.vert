@@ -9,8 +9,6 @@
 //             Please visit: http://opensource.org/licenses/GPL-3.0
 //#############################################################################
 
-#version 150
-
 //-----------------------------------------------------------------------------
 attribute vec4 a_position;          // Vertex position attribute
 attribute vec3 a_normal;            // Vertex normal attribute
@@ -20,7 +18,7 @@ attribute vec4 a_jointWeights;      // Vertex joint weights attributes
 uniform mat4   u_mvMatrix;          // modelview matrix 
 uniform mat3   u_nMatrix;           // normal matrix=transpose(inverse(mv))
 uniform mat4   u_mvpMatrix;         // = projection * modelView
-uniform mat4   u_jointMatrices[100];// joint matrices for vertex skinning
+uniform mat4   u_jointMatrices[SL_MAX_JOINTS];// joint matrices (size set in SLGLShader)
 
 uniform int    u_numLightsUsed;     // NO. of lights used light arrays
 uniform bool   u_lightIsOn[8];      // flag if light is on
@@ -25,6 +25,8 @@ uniform     float      u_volumeZ;       // 3D texture depth
 
 uniform     sampler3D  u_texture0;      // The 3D volume texture
 uniform     sampler2D  u_texture1;      // The 1D LUT for the transform function
+uniform     sampler3D  u_texture2;      // The occupancy grid of the bricks (see SLVolumeOccupancy)
+uniform     float      u_brickSize;     // NO. of voxels per brick side
 
 vec3 findRayDestination(vec3 raySource, vec3 rayDirection)
 {
@@ -87,8 +89,28 @@ void main()
     vec3 position = source;
     gl_FragColor = vec4(0.0);
 
-    for (int i = 0; i < num_steps; ++i) //Step along the view ray
+    //Number of bricks of the occupancy grid and the step direction without zeros.
+    //Small components keep their sign, zero counts as positive like in exitPos.
+    vec3 bricks = ceil(size/u_brickSize);
+    vec3 dirNZ  = (step(0.0, direction)*2.0 - 1.0) * max(abs(direction), vec3(1e-8));
+
+    int i = 0;
+    while (i < num_steps) //Step along the view ray
     {
+        //Jump to the first sample behind an empty brick
+        vec3 brick = floor(position*size/u_brickSize);
+        if (texture3D(u_texture2, (brick + 0.5)/bricks).r < 0.5)
+        {
+            vec3  brickMin = brick*u_brickSize/size;
+            vec3  brickMax = (brick + 1.0)*u_brickSize/size;
+            vec3  exitPos  = mix(brickMin, brickMax, step(0.0, direction));
+            vec3  t        = (exitPos - position)/dirNZ;
+            float numSkip  = max(1.0, ceil(min(min(t.x, t.y), t.z)));
+            i += int(numSkip);
+            position += numSkip*direction;
+            continue;
+        }
+
         //The voxel can be read directly from there assuming we're using GL_NEAREST as interpolation method
         vec4 voxel = texture3D(u_texture0, position);
 
@@ -106,6 +128,7 @@ void main()
 
         //Set the position to the next step
         position += direction;
+        ++i;
     }
     gl_FragColor.a = 1.0;
 }
@@ -190,8 +190,8 @@ class SLCVCalibration
     SLCVVVPoint2f  _imagePoints;            //!< 2D vector of corner points in chessboard
     SLCVSize       _imageSize;              //!< Input image size in pixels
     SLbool         _showUndistorted;        //!< Flag if image should be undistorted
-    SLCVMat        _undistortMapX;          //!< Undistortion float map in x-direction
-    SLCVMat        _undistortMapY;          //!< Undistortion float map in y-direction
+    SLCVMat        _undistortMapXY;         //!< Undistortion fixed-point map for x & y (CV_16SC2)
+    SLCVMat        _undistortMapInterp;     //!< Undistortion interpolation table (CV_16UC1)
     SLCVMat        _cameraMatUndistorted;   //!< Camera matrix for undistorted image
     SLstring       _calibrationTime;        //!< Time stamp string of calibration
 
@@ -70,15 +70,16 @@ class SLCVCapture
                                  int      vPixStride,
                                  int      vLineStride);
 
-    static SLCVMat       lastFrame;          //!< last frame grabbed in RGB
-    static SLCVMat       lastFrameGray;      //!< last frame in grayscale
-    static SLPixelFormat format;             //!< SL pixel format
-    static SLCVSize      captureSize;        //!< size of captured frame
-    static SLfloat       startCaptureTimeMS; //!< start time of capturing in ms
-    static SLbool        hasSecondaryCamera; //!< flag if device has secondary camera
-    static SLstring      videoDefaultPath;   //!< default path for video files
-    static SLstring      videoFilename;      //!< video filename to load
-    static SLbool        videoLoops;         //!< flag if video should loop
+    static SLCVMat       lastFrame;            //!< last frame grabbed in RGB
+    static SLCVMat       lastFrameGray;        //!< last frame in grayscale
+    static SLCVMat       lastFrameUndistorted; //!< last frame undistorted for the video texture
+    static SLPixelFormat format;               //!< SL pixel format
+    static SLCVSize      captureSize;          //!< size of captured frame
+    static SLfloat       startCaptureTimeMS;   //!< start time of capturing in ms
+    static SLbool        hasSecondaryCamera;   //!< flag if device has secondary camera
+    static SLstring      videoDefaultPath;     //!< default path for video files
+    static SLstring      videoFilename;        //!< video filename to load
+    static SLbool        videoLoops;           //!< flag if video should loop
 
     /*! A requestedSizeIndex of 0 returns on Android the default size of 640x480.
     If this size is not available the median element of the available sizes array is returned.
@@ -91,6 +92,8 @@ class SLCVCapture
 
     private:
     static cv::VideoCapture _captureDevice; //!< OpenCV capture device
+    static SLCVMat          _captureFrame;  //!< Reused buffer for the captured or converted frame
+    static SLCVMat          _adjustedFrame; //!< Reused buffer for the cropped & mirrored frame
 };
 //-----------------------------------------------------------------------------
 #endif // SLCVCAPTURE_H
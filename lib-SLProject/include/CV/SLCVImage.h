@@ -50,9 +50,10 @@ class SLCVImage : public SLObject
                                   SLint         height,
                                   SLPixelFormat format,
                                   SLbool        isContinuous = true);
-    void                 load(const SLstring filename,
+    SLbool               load(const SLstring filename,
                               SLbool         flipVertical           = true,
-                              SLbool         loadGrayscaleIntoAlpha = false);
+                              SLbool         loadGrayscaleIntoAlpha = false,
+                              SLbool         exitOnFailure          = true);
     SLbool               load(SLint         inWidth,
                               SLint         inHeight,
                               SLPixelFormat srcFormat,
@@ -85,6 +86,10 @@ class SLCVImage : public SLObject
                               SLubyte b,
                               SLubyte a);
     static SLPixelFormat cv2glPixelFormat(SLint cvType);
+    static SLbool        readInfo(const SLstring filename,
+                                  SLuint&        width,
+                                  SLuint&        height,
+                                  SLbool&        hasAlpha);
 
     // Getters
     SLCVMat       cvMat() { return _cvMat; }
@@ -37,11 +37,23 @@ aumented reality case. If the camera is a normal scene node, the tracker
 calculates the object matrix relative to the scene camera.
 See also the derived classes SLCVTrackedAruco and SLCVTrackedChessboard for
 example implementations.
+\n
+Derived trackers can limit their detection to a region of interest (ROI) that
+is predicted from the image area of the last detection. The ROI is the last
+bounding rectangle moved by its last displacement and enlarged by roiMargin on
+each side. A full frame search is done on the first frame, after a loss and
+every roiFullFrameInterval frames so that new or fast moving objects are found
+again. A tracker uses it with predictROI before the detection, passes the
+detected image points to updateROI and calls resetROI if nothing was found.
 */
 class SLCVTracked
 {
     public:
-    SLCVTracked(SLNode* node = nullptr) : _node(node), _isVisible(false) { ; }
+    SLCVTracked(SLNode* node = nullptr) : _node(node),
+                                          _isVisible(false),
+                                          _useROI(true),
+                                          _roiIsValid(false),
+                                          _framesSinceFullFrame(0) { ; }
     virtual ~SLCVTracked() { ; }
 
     virtual SLbool track(SLCVMat          imageGray,
@@ -58,12 +70,34 @@ class SLCVTracked
     SLMat4f calcObjectMatrix(const SLMat4f& cameraObjectMat,
                              const SLMat4f& objectViewMat);
 
+    // Getters
     SLNode* node() { return _node; }
+    SLMat4f objectViewMat() { return _objectViewMat; }
+    SLbool  useROI() { return _useROI; }
+
+    // Setters
+    void useROI(SLbool use)
+    {
+        _useROI = use;
+        resetROI();
+    }
+
+    static SLfloat roiMargin;            //!< ROI margin on each side relative to the last size
+    static SLint   roiFullFrameInterval; //!< NO. of frames after which a full frame search is forced
 
     protected:
-    SLNode* _node;          //!< Tracked node
-    SLbool  _isVisible;     //!< Flag if marker is visible
-    SLMat4f _objectViewMat; //!< view transformation matrix
+    SLCVRect predictROI(const SLCVSize& imageSize);
+    void     updateROI(const SLCVVPoint2f& points);
+    void     resetROI() { _roiIsValid = false; }
+
+    SLNode*  _node;                 //!< Tracked node
+    SLbool   _isVisible;            //!< Flag if marker is visible
+    SLMat4f  _objectViewMat;        //!< view transformation matrix
+    SLbool   _useROI;               //!< Flag if the detection is limited to a predicted ROI
+    SLbool   _roiIsValid;           //!< Flag if _lastRect holds a detection of the last frame
+    SLCVRect _lastRect;             //!< Bounding rectangle of the last detection
+    SLCVRect _prevRect;             //!< Bounding rectangle of the detection before the last
+    SLint    _framesSinceFullFrame; //!< NO. of frames since the last full frame search
 };
 //-----------------------------------------------------------------------------
 #endif
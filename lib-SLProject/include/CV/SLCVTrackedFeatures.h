@@ -58,6 +58,19 @@ const int reposeFrequency  = 10;
 const int initialPatchSize = 2;
 const int maxPatchSize     = 60;
 
+// Keyframe relocalization cache
+const int   kfCacheSize        = 8;    // Max. NO. of cached keyframes
+const int   kfMaxCandidates    = 2;    // Max. NO. of keyframes tried per relocation
+const int   kfMinInliersToAdd  = 100;  // Min. NO. of inliers for a new keyframe
+const int   kfMinFrameDistance = 15;   // Min. NO. of frames between two new keyframes
+const int   kfMinMatches       = 20;   // Min. NO. of matches against a keyframe
+const int   kfMinInliers       = 30;   // Min. NO. of inliers for a keyframe pose
+const int   kfIterations       = 100;  // RANSAC iterations with extrinsic guess
+const int   kfThumbnailWidth   = 64;   // Width of the thumbnail in pixels
+const int   kfThumbnailHeight  = 48;   // Height of the thumbnail in pixels
+const float kfMinSimilarity    = 0.5f; // Min. thumbnail similarity of a candidate
+const float kfMaxSimilarity    = 0.9f; // Max. similarity to cached keyframes for a new one
+
 //-----------------------------------------------------------------------------
 //! SLCVTrackedFeatures is the main part of the AR Christoffelturm scene
 /*! The implementation tries to find a valid pose based on feature points in
@@ -66,6 +79,11 @@ frame with against a reference. There are two important parts of this procedure:
 The relocalisation, which will be called if we have to find the pose with no hint
 where the camera could be. The other one is called feature tracking: If a pose
 was found, the implementation tries to track them and update the pose respectively.
+Successful relocalisations with enough inliers are stored in a small keyframe
+cache with the inlier descriptors, the pose and a downsampled thumbnail. If the
+tracking got lost, the relocalisation first matches against the keyframes with
+the most similar thumbnails and uses their pose as extrinsic guess. Only if
+this fails the full marker is searched.
 */
 class SLCVTrackedFeatures : public SLCVTracked
 {
@@ -81,6 +99,7 @@ class SLCVTrackedFeatures : public SLCVTracked
     // Getters
     SLbool                 forceRelocation() { return _forceRelocation; }
     SLCVDetectDescribeType type() { return _featureManager.type(); }
+    SLint                  numRelocalizations() { return _numRelocalizations; }
 
     // Setters
     void forceRelocation(SLbool fR) { _forceRelocation = fR; }
@@ -90,6 +109,9 @@ class SLCVTrackedFeatures : public SLCVTracked
     void        loadMarker(string markerFilename);
     void        initFeaturesOnMarker();
     void        relocate();
+    SLbool      relocateWithKeyFrames(const SLCVMat& thumbnail);
+    void        addKeyFrame(const SLCVMat& thumbnail);
+    SLCVMat     createThumbnail(const SLCVMat& imageGray);
     void        tracking();
     void        drawDebugInformation(SLbool drawDetection);
     void        updateSceneCamera(SLSceneView* sv);
@@ -100,10 +122,11 @@ class SLCVTrackedFeatures : public SLCVTracked
     void        optimizeMatches();
     bool        trackWithOptFlow(SLCVMat rvec, SLCVMat tvec);
 
-    Ptr<DescriptorMatcher> _matcher;    //!< Descriptor matching algorithm
-    SLCVCalibration*       _calib;      //!< Current calibration in use
-    SLint                  _frameCount; //!< NO. of frames since process start
-    bool                   _isTracking; //!< True if tracking
+    Ptr<DescriptorMatcher> _matcher;              //!< Descriptor matching algorithm
+    SLCVCalibration*       _calib;                //!< Current calibration in use
+    SLint                  _frameCount;           //!< NO. of frames since process start
+    SLint                  _framesSincePoseFound; //!< NO. of frames since the pose was found again
+    bool                   _isTracking;           //!< True if tracking
 
     //! Data of a 2D marker image
     struct SLFeatureMarker2D
@@ -133,11 +156,25 @@ class SLCVTrackedFeatures : public SLCVTracked
         SLbool        useExtrinsicGuess; //!< flag if extrinsic gues should be used
     };
 
-    SLFeatureMarker2D  _marker;          //!< 2D marker data
-    SLFrameData        _currentFrame;    //!< The current video frame data
-    SLFrameData        _prevFrame;       //!< The previous video frame data
-    SLbool             _forceRelocation; //!< Force relocation every frame (no opt. flow tracking)
-    SLCVFeatureManager _featureManager;  //!< Feature detector-descriptor wrapper instance
+    //! Cached video frame of a successful relocalisation
+    struct SLFeatureKeyFrame
+    {
+        SLCVMat thumbnail;   //!< Downsampled and normalized grayscale frame
+        SLCVMat descriptors; //!< Descriptors of the inlier keypoints
+        SLVint  markerIdx;   //!< Marker keypoint index of each descriptor row
+        SLCVMat rvec;        //!< Rotation of the camera pose
+        SLCVMat tvec;        //!< Translation of the camera pose
+        SLint   frameNo;     //!< Frame number when the keyframe was added
+    };
+
+    SLFeatureMarker2D         _marker;             //!< 2D marker data
+    SLFrameData               _currentFrame;       //!< The current video frame data
+    SLFrameData               _prevFrame;          //!< The previous video frame data
+    SLbool                    _forceRelocation;    //!< Force relocation every frame (no opt. flow tracking)
+    SLCVFeatureManager        _featureManager;     //!< Feature detector-descriptor wrapper instance
+    vector<SLFeatureKeyFrame> _keyFrames;          //!< Cache of recent keyframes for relocalisation
+    SLint                     _lastKeyFrameNo;     //!< Frame number of the last added keyframe
+    SLint                     _numRelocalizations; //!< NO. of poses found by relocate after a lost pose
 };
 //-----------------------------------------------------------------------------
 #endif // SLCVTrackedFeatures_H
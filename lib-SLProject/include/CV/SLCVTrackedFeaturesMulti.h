@@ -0,0 +1,100 @@
+//#############################################################################
+//  File:      SLCVTrackedFeaturesMulti.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch, Michael Goettlicher
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLCVTRACKEDFEATURESMULTI_H
+#define SLCVTRACKEDFEATURESMULTI_H
+
+/*
+The OpenCV library version 3.4 or above with extra module must be present.
+If the application captures the live video stream with OpenCV you have
+to define in addition the constant SL_USES_CVCAPTURE.
+All classes that use OpenCV begin with SLCV.
+See also the class docs for SLCVCapture, SLCVCalibration and SLCVTracked
+for a good top down information.
+*/
+#include <SLCV.h>
+#include <SLCVFeatureManager.h>
+#include <SLCVTracked.h>
+#include <SLNode.h>
+
+//-----------------------------------------------------------------------------
+//! SLCVTrackedFeaturesMulti tracks multiple planar image markers at once
+/*! In contrast to SLCVTrackedFeatures that tracks exactly one marker image,
+this tracker manages N registered markers each bound to its own scene node.
+Per video frame the following steps are done only once for all markers:
+1. Detect and describe the keypoints of the camera frame.
+2. Match the frame descriptors against one shared FLANN index that holds the
+   descriptors of all markers. For binary descriptors (ORB, BRIEF) a LSH index
+   with multi-probing is used, for float descriptors (SURF, SIFT) a set of
+   randomized KD-trees. The image index of each match tells to which marker
+   it belongs, so the matching cost grows sublinear with the marker count.
+3. Run the RANSAC PnP pose estimation for each marker with enough matches in
+   parallel on SL::maxThreads() threads.
+4. Update the nodes on the main thread like SLCVTrackedAruco does.
+*/
+class SLCVTrackedFeaturesMulti : public SLCVTracked
+{
+    public:
+    SLCVTrackedFeaturesMulti();
+    ~SLCVTrackedFeaturesMulti() { ; }
+
+    SLbool track(SLCVMat          imageGray,
+                 SLCVMat          image,
+                 SLCVCalibration* calib,
+                 SLbool           drawDetection,
+                 SLSceneView*     sv);
+
+    void addMarker(SLNode*  node,
+                   SLstring markerFilename,
+                   SLfloat  markerWidthMM = 297.0f);
+
+    // Getters
+    SLint                  numMarkers() { return (SLint)_markers.size(); }
+    SLint                  numMarkersFound() { return _numMarkersFound; }
+    SLCVDetectDescribeType type() { return _featureManager.type(); }
+
+    // Setters
+    void type(SLCVDetectDescribeType ddType);
+
+    private:
+    void buildMarkerIndex();
+    void matchAllMarkers();
+    void calcAllPoses();
+    void calcPose(size_t markerIndex);
+    void updateNodes(SLSceneView* sv);
+
+    //! Data of one registered 2D marker image and its per frame tracking state
+    struct SLFeatureMarker
+    {
+        SLNode*       node;              //!< Node that is transformed by this marker
+        SLCVMat       imageGray;         //!< Grayscale image of the marker
+        SLfloat       widthMM;           //!< Real width of the marker in mm
+        SLCVVKeyPoint keypoints2D;       //!< 2D keypoints in pixels
+        SLCVVPoint3f  keypoints3D;       //!< 3D feature points in mm
+        SLCVMat       descriptors;       //!< Descriptors of the 2D keypoints
+        SLCVVDMatch   matches;           //!< Matches of the current frame to this marker
+        SLCVMat       rvec;              //!< Rotation of the marker pose
+        SLCVMat       tvec;              //!< Translation of the marker pose
+        SLbool        foundPose;         //!< True if pose was found in current frame
+        SLbool        useExtrinsicGuess; //!< True if the last pose is used as guess
+        SLint         numInliers;        //!< NO. of RANSAC inliers of the last pose
+    };
+
+    vector<SLFeatureMarker>        _markers;          //!< All registered markers
+    cv::Ptr<cv::DescriptorMatcher> _matcher;          //!< Shared FLANN matcher over all markers
+    SLCVFeatureManager             _featureManager;   //!< Feature detector-descriptor wrapper instance
+    SLCVCalibration*               _calib;            //!< Current calibration in use
+    SLCVVKeyPoint                  _frameKeypoints;   //!< 2D keypoints detected in video frame
+    SLCVMat                        _frameDescriptors; //!< Descriptors of the video frame keypoints
+    SLbool                         _indexIsDirty;     //!< Flag if the marker index must be rebuilt
+    SLint                          _numMarkersFound;  //!< NO. of markers found in the last frame
+};
+//-----------------------------------------------------------------------------
+#endif // SLCVTRACKEDFEATURESMULTI_H
@@ -19,6 +19,8 @@
 enum SLGLBufferType
 {
     BT_float  = GL_FLOAT,          //!< float vertex attributes
+    BT_half   = 0x140B,            //!< half float vertex attributes (GL_HALF_FLOAT)
+    BT_short  = GL_SHORT,          //!< signed short vertex attributes
     BT_ubyte  = GL_UNSIGNED_BYTE,  //!< vertex index type (0-2^8)
     BT_ushort = GL_UNSIGNED_SHORT, //!< vertex index type (0-2^16)
     BT_uint   = GL_UNSIGNED_INT    //!< vertex index type (0-2^32)
@@ -80,6 +80,8 @@ class SLGLImGui
     static SLfloat fontFixedDots; //!< Default font size of fixed size font
 
     private:
+    void setVertexAttribPointers(SLuint vtxOffset);
+
     SLfloat _timeSec;           //!< Time in seconds
     SLVec2f _mousePosPX;        //!< Mouse cursor position
     SLfloat _mouseWheel;        //!< Mouse wheel position
@@ -96,6 +98,9 @@ class SLGLImGui
     SLuint  _vboHandle;         //!< OpenGL handle for vertex buffer object
     SLuint  _vaoHandle;         //!< OpenGL vertex array object handle
     SLuint  _elementsHandle;    //!< OpenGL handle for vertex indexes
+    SLuint  _vboSize;           //!< Size of the vertex buffer in bytes
+    SLuint  _elementsSize;      //!< Size of the index buffer in bytes
+    SLVec2f _projDisplaySize;   //!< Display size of the projection uniform
     SLfloat _fontPropDots;      //!< Active font size of proportional font
     SLfloat _fontFixedDots;     //!< Active font size of fixed size font
 };
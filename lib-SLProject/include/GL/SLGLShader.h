@@ -40,6 +40,10 @@ version: <br>
     - "texture2D" replaced by "texture"
     - "texture3D" replaced by "texture"
     - "textureCube" replaced by "texture"
+- All versions:
+  - In vertex shaders:
+    - a_position, a_normal and a_tangent get decoded from packed vertices
+      (see SLGLShader::addPackedVertexDecoding)
 \n\n
 In the OpenGL debug mode (define _GLDEBUG in SL.h) the adapted shader files 
 get written out as *.debug files beside the original shader files.
@@ -58,6 +62,7 @@ class SLGLShader : public SLObject
     void     loadFromMemory(SLstring program);
     SLbool   createAndCompile();
     SLstring removeComments(SLstring src);
+    void     addPackedVertexDecoding();
     SLstring typeName();
 
     // Getters
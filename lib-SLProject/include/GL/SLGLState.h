@@ -111,6 +111,7 @@ class SLGLState
     void depthMask(SLbool state);
     void cullFace(SLbool state);
     void blend(SLbool state);
+    void scissorTest(SLbool state);
     void multiSample(SLbool state);
     void polygonLine(SLbool state);
     void polygonOffset(SLbool state, SLfloat factor = 1.0f, SLfloat units = 1.0f);
@@ -175,6 +176,7 @@ class SLGLState
 
     // read/write states
     SLbool  _blend;                //!< blending default false;
+    SLbool  _scissorTest;          //!< GL_SCISSOR_TEST state
     SLbool  _depthTest;            //!< GL_DEPTH_TEST state
     SLbool  _depthMask;            //!< glDepthMask state
     SLbool  _cullFace;             //!< Face culling state
@@ -17,6 +17,7 @@
 #include <atomic>
 
 class SLGLState;
+class SLGLTextureStreamer;
 
 //-----------------------------------------------------------------------------
 // Special constants for anisotropic filtering
@@ -48,6 +49,22 @@ enum SLTextureType
     TT_font       //*_F.{ext}
 };
 //-----------------------------------------------------------------------------
+//! Texture data of a KTX file with all mip levels (see SLGLTexture::loadKTX)
+struct SLKTXData
+{
+    SLVuchar fileData;             //!< Content of the KTX file
+    SLenum   glType;               //!< Pixel data type (0 if compressed)
+    SLenum   glFormat;             //!< Pixel format (0 if compressed)
+    SLenum   glInternalFormat;     //!< Internal format e.g. GL_COMPRESSED_RGB8_ETC2
+    SLenum   glBaseInternalFormat; //!< Base internal format (GL_RGB or GL_RGBA)
+    SLuint   width;                //!< Width of mip level 0
+    SLuint   height;               //!< Height of mip level 0
+    SLuint   numLevels;            //!< NO. of mip levels in the file
+    SLuint   numFaces;             //!< 6 for cube maps, 1 otherwise
+    SLVuint  imageOffsets;         //!< Offset of each level & face in fileData
+    SLVuint  imageSizes;           //!< Size of each level & face in bytes
+};
+//-----------------------------------------------------------------------------
 //! Texture object for OpenGL texturing
 /*!      
 The SLGLTexture class implements an OpenGL texture object that can be used by the 
@@ -57,9 +74,23 @@ you will need 6 images (_images[0-5]). For 3D textures you can have as much
 images of the same size than your GPU and/or CPU memory can hold.
 The images are not released after the OpenGL texture creation. They may be needed
 for ray tracing.
+\n
+A 2D texture or a cube map can also be loaded from a KTX file (*.ktx) with
+precompressed data (e.g. ETC2, ASTC or BC) and a baked mip chain. The file
+gets uploaded as it is with glCompressedTexImage2D without any image decoding
+or mipmap generation. Such a texture has no SLCVImage and is therefore white
+for the ray tracer. The KTX files can be created with the app-Convert-KTX tool.
+\n
+If SLGLTextureStreamer::isOn is true the 2D texture constructor with an image
+filename doesn't decode PNG & JPEG images. The image gets decoded on a worker
+thread and uploaded level by level by the SLGLTextureStreamer of the scene.
+Until the image is decoded width, height & hasAlpha come from the file header
+and images() waits for the decoding.
 */
 class SLGLTexture : public SLObject
 {
+    friend class SLGLTextureStreamer;
+
     public:
     //! Default ctor for all stack instances (not created with new)
     SLGLTexture();
@@ -79,6 +110,14 @@ class SLGLTexture : public SLObject
                 SLint         wrapS      = GL_REPEAT,
                 SLint         wrapT      = GL_REPEAT);
 
+    //! ctor for 2D textures with an already loaded image that gets owned
+    SLGLTexture(SLCVImage*    image,
+                SLint         min_filter = GL_LINEAR_MIPMAP_LINEAR,
+                SLint         mag_filter = GL_LINEAR,
+                SLTextureType type       = TT_unknown,
+                SLint         wrapS      = GL_REPEAT,
+                SLint         wrapT      = GL_REPEAT);
+
     //! ctor for 3D texture with internal image allocation
     SLGLTexture(SLVstring imageFilenames,
                 SLint     min_filter             = GL_LINEAR,
@@ -114,9 +153,15 @@ class SLGLTexture : public SLObject
     void bumpScale(SLfloat bs) { _bumpScale = bs; }
     void minFiler(SLint minF) { _min_filter = minF; } // must be called befor build
     void magFiler(SLint magF) { _mag_filter = magF; } // must be called befor build
+    void wrapS(SLint wrapS) { _wrap_s = wrapS; }     // must be called befor build
+    void wrapT(SLint wrapT) { _wrap_t = wrapT; }     // must be called befor build
 
     // Getters
-    SLCVVImage&   images() { return _images; }
+    SLCVVImage&   images()
+    {
+        if (_imagePending) waitForImage();
+        return _images;
+    }
     SLenum        target() { return _target; }
     SLuint        texName() { return _texName; }
     SLTextureType texType() { return _texType; }
@@ -126,9 +171,13 @@ class SLGLTexture : public SLObject
     SLbool        hasAlpha() { return (_images.size() &&
                                 ((_images[0]->format() == PF_rgba ||
                                   _images[0]->format() == PF_bgra) ||
-                                 _texType == TT_font)); }
-    SLuint        width() { return _images[0]->width(); }
-    SLuint        height() { return _images[0]->height(); }
+                                 _texType == TT_font)) ||
+                               (_imagePending && _streamAlpha) ||
+                               (isKTX() && _ktx.glBaseInternalFormat == GL_RGBA); }
+    SLuint        width() { return _images.size() ? _images[0]->width() : _imagePending ? _streamWidth : _ktx.width; }
+    SLuint        height() { return _images.size() ? _images[0]->height() : _imagePending ? _streamHeight : _ktx.height; }
+    SLbool        isKTX() { return _ktx.fileData.size() > 0; }
+    SLbool        isStreaming() { return _isStreaming; }
     SLint         depth() { return (SLint)_images.size(); }
     SLMat4f       tm() { return _tm; }
     SLbool        autoCalcTM3D() { return _autoCalcTM3D; }
@@ -137,8 +186,8 @@ class SLGLTexture : public SLObject
 
     // Misc
     SLTextureType detectType(SLstring filename);
-    SLuint        closestPowerOf2(SLuint num);
-    SLuint        nextPowerOf2(SLuint num);
+    static SLuint closestPowerOf2(SLuint num);
+    static SLuint nextPowerOf2(SLuint num);
     void          build2DMipmaps(SLint target, SLuint index);
     void          setVideoImage(SLstring videoImageFile);
     SLbool        copyVideoImage(SLint         camWidth,
@@ -158,16 +207,26 @@ class SLGLTexture : public SLObject
     static SLstring defaultPathFonts;   //!< Default path for fonts images
     static SLfloat  maxAnisotropy;      //!< max. anisotropy available
     static SLuint   numBytesInTextures; //!< NO. of texture bytes on GPU
+    static SLuint   numUpdatePBOs;      //!< NO. of PBOs for fullUpdate (0: synchronous)
 
     protected:
     // loading the image files
-    void load(SLstring filename,
-              SLbool   flipVertical           = true,
-              SLbool   loadGrayscaleIntoAlpha = false);
-    void load(const SLVCol4f& colors);
+    void   load(SLstring filename,
+                SLbool   flipVertical           = true,
+                SLbool   loadGrayscaleIntoAlpha = false);
+    void   load(const SLVCol4f& colors);
+    void   loadKTX(SLstring filename);
+    void   buildKTX();
+    void   setTexParameters();
+    void   waitForImage();
+    SLbool updateWithPBO();
+    void   deletePBOs();
+
+    static SLstring findFile(SLstring filename);
 
     SLGLState*      _stateGL;      //!< Pointer to global SLGLState instance
     SLCVVImage      _images;       //!< vector of SLCVImage pointers
+    SLKTXData       _ktx;          //!< Texture data if loaded from a KTX file
     SLuint          _texName;      //!< OpenGL texture "name" (= ID)
     SLTextureType   _texType;      //!< [unknown, ColorMap, NormalMap, HeightMap, GlossMap]
     SLint           _min_filter;   //!< Minification filter
@@ -182,6 +241,16 @@ class SLGLTexture : public SLObject
     SLbool          _resizeToPow2; //!< Flag if image should be resized to n^2
     SLGLVertexArray _vaoSprite;    //!< Vertex array object for sprite rendering
     atomic<bool>    _needsUpdate;  //!< Flag if image needs an update
+    atomic<bool>    _isStreaming;  //!< Flag if SLGLTextureStreamer loads the texture
+    atomic<bool>    _imagePending; //!< Flag if the streamed image isn't decoded yet
+    SLint           _streamLevel;  //!< Finest mip level uploaded by the streamer (-1: none)
+    SLuint          _streamWidth;  //!< Image width from the file header while streaming
+    SLuint          _streamHeight; //!< Image height from the file header while streaming
+    SLbool          _streamAlpha;  //!< Alpha flag from the file header while streaming
+    SLVuint         _pbos;         //!< Pixel buffer objects for the upload in fullUpdate
+    vector<GLsync>  _pboFences;    //!< Fence of the last upload from each PBO
+    SLuint          _pboSize;      //!< Size of each PBO in bytes
+    SLuint          _pboIndex;     //!< Index of the PBO of the last upload
 };
 //-----------------------------------------------------------------------------
 //! STL vector of SLGLTexture pointers
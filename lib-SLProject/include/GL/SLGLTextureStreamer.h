@@ -0,0 +1,128 @@
+//#############################################################################
+//  File:      SLGLTextureStreamer.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLGLTEXTURESTREAMER_H
+#define SLGLTEXTURESTREAMER_H
+
+#include <SL.h>
+#include <SLCVImage.h>
+#include <SLGLTexture.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+//-----------------------------------------------------------------------------
+//! State of a texture in the streaming pipeline
+enum SLStreamJobState
+{
+    SJS_queued,   //!< Waiting for a worker thread
+    SJS_decoding, //!< Image & mip levels get decoded on a worker thread
+    SJS_decoded,  //!< Waiting for the upload on the render thread
+    SJS_uploading //!< Mip levels get uploaded from coarse to fine
+};
+//-----------------------------------------------------------------------------
+//! Streaming job of one 2D texture
+struct SLStreamJob
+{
+    SLGLTexture*     texture;      //!< Texture that gets streamed
+    SLstring         filename;     //!< Image file with the full path
+    SLbool           mipmaps;      //!< Flag if the mip levels are streamed
+    SLbool           resizeToPow2; //!< Flag if the image gets resized to n^2
+    SLStreamJobState state;        //!< State of the job
+    SLbool           canceled;     //!< Flag if the texture got deleted while decoding
+    SLbool           failed;       //!< Flag if the image couldn't be decoded
+    SLCVImage*       image;        //!< Decoded image that the texture takes over
+    SLCVVMat         levels;       //!< Mip levels (level 0 shares the image data)
+    SLint            level;        //!< Mip level that gets uploaded
+    SLint            row;          //!< Next row of the mip level to upload
+};
+typedef vector<SLStreamJob*> SLVStreamJob;
+//-----------------------------------------------------------------------------
+//! Decodes 2D textures on worker threads and uploads them within a frame budget
+/*!
+The 2D texture constructor with an image filename doesn't decode a PNG or JPEG
+image if SLGLTextureStreamer::isOn is true. It only reads the size and the
+alpha flag from the file header (see SLCVImage::readInfo), adds the texture
+with add to the streamer of the scene and returns immediately. Images in other
+formats get decoded in the constructor as usual. The images get decoded and
+their mip levels reduced with cv::INTER_AREA on a pool of worker threads.
+An image that can't be decoded ends the app with SL_EXIT_MSG on the thread
+that takes the image over, which is the render thread in update.
+\n
+Streaming is off by default. Without streaming SLAssimpImporter decodes the
+textures of a model in parallel before it creates them.
+\n
+SLGLTextureStreamer::update is called once per frame on the render thread in
+SLScene::onUpdate. It uploads the decoded mip levels from the coarsest to the
+finest level with glTexSubImage2D and lowers GL_TEXTURE_BASE_LEVEL after each
+completed level, so that a texture gets sharper over a few frames. A level
+that doesn't fit into the rest of the frame budget gets uploaded in bands of
+rows. The pending level with the fewest bytes of all textures goes first, so
+that all textures get a coarse level before any gets its fine levels.
+\n
+The pixel data gets copied into a pixel buffer object (PBO) that is split
+into numSegments segments of uploadBudgetBytes. Each frame writes into the
+next segment with unsynchronized mapping and protects it with a fence, so
+that the copy neither waits for the GPU nor overwrites data that the driver
+still reads. If the fence of the next segment isn't signaled, the uploads
+wait for the next frame. Until the coarsest level of a texture is uploaded
+SLGLTexture::bindActive binds a 1x1 placeholder texture that is gray or a flat
+normal for normal maps.
+\n
+On OpenGL ES 2 there are no PBOs and no base level. The images are then only
+decoded on the worker threads and the texture gets built as usual.
+SLGLTexture::images waits for the decoding of a streamed texture, so that all
+code that uses the images on the CPU works unchanged.
+*/
+class SLGLTextureStreamer
+{
+    public:
+    SLGLTextureStreamer();
+    ~SLGLTextureStreamer();
+
+    void   add(SLGLTexture* texture, const SLstring& filename, SLbool mipmaps);
+    void   remove(SLGLTexture* texture);
+    void   waitForImage(SLGLTexture* texture);
+    SLbool update();
+    void   bindPlaceholder(SLint texID, SLTextureType type);
+    void   clear();
+
+    // Getters
+    SLuint numJobs();
+
+    // Statics
+    static SLbool isOn;              //!< Flag if 2D textures get streamed
+    static SLuint uploadBudgetBytes; //!< max. NO. of bytes uploaded per frame
+    static SLuint numSegments;       //!< NO. of PBO segments of uploadBudgetBytes
+
+    private:
+    void startWorkers();
+    void stopWorkers();
+    void decodeJobs();
+    void decode(SLStreamJob* job);
+    void takeImage(SLStreamJob* job);
+    void startUpload(SLStreamJob* job);
+    void finishLevel(SLStreamJob* job, SLint level);
+    void deleteJob(SLStreamJob* job);
+
+    SLVStreamJob       _jobs;         //!< All jobs in the order of adding
+    vector<thread>     _workers;      //!< Worker threads for the decoding
+    mutex              _mutex;        //!< Mutex for _jobs & the job states
+    condition_variable _queued;       //!< Signals a queued job to the workers
+    condition_variable _decoded;      //!< Signals a decoded job to waitForImage
+    SLbool             _stop;         //!< Flag that stops the workers
+    SLuint             _placeholders[2]; //!< Gray & flat normal placeholder textures
+    SLuint             _pbo;          //!< Pixel buffer object name
+    vector<GLsync>     _fences;       //!< Fence of each PBO segment
+    SLuint             _segment;      //!< PBO segment of the next frame
+    SLuint             _segmentBytes; //!< Size of a PBO segment
+};
+//-----------------------------------------------------------------------------
+#endif // SLGLTEXTURESTREAMER_H
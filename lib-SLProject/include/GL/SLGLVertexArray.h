@@ -22,8 +22,9 @@ Vertex Array Object (VAO), a vertex buffer objects (VBO) for the attributes
 and an index buffer for element drawing. Attributes can be stored in a float
 VBO of type SLGLVertexBuffer.\n 
 VAOs where introduces OpenGL 3.0 and reduce the overhead per draw call. 
-All vertex attributes (e.g. position, normals, texture coords, etc.) must be
-float at the input. All float attributes will be in one VBO (_VBOf). 
+All vertex attributes (e.g. position, normals, texture coords, etc.) are
+float at the input by default. Packed attributes can be passed with their own
+data type (see SLMesh::generateVAO). All attributes will be in one VBO (_VBOf). 
 Vertices can be drawn either directly as in the array (SLGLVertexArray::drawArrayAs) 
 or by element (SLGLVertexArray::drawElementsAs) with a separate indices buffer.\n
 The setup of a VAO has multiple steps:\n
@@ -56,7 +57,9 @@ class SLGLVertexArray
     void setAttrib(SLGLAttributeType type,
                    SLint             elementSize,
                    SLint             location,
-                   void*             dataPointer);
+                   void*             dataPointer,
+                   SLGLBufferType    dataType   = BT_float,
+                   SLbool            normalized = false);
 
     //! Adds a vertex attribute with vector of SLfloat
     void setAttrib(SLGLAttributeType type,
@@ -98,26 +101,31 @@ class SLGLVertexArray
                                                    BT_uint,
                                                    &indices->operator[](0)); }
 
-    //! Updates a specific vertex attribute in the VBO
+    //! Updates a specific vertex attribute in the VBO (numVertices 0: all)
     void updateAttrib(SLGLAttributeType type,
                       SLint             elementSize,
-                      void*             dataPointer);
+                      void*             dataPointer,
+                      SLuint            numVertices = 0);
 
     //! Updates a specific vertex attribute in the VBO
     void updateAttrib(SLGLAttributeType type,
-                      SLVfloat*         data) { updateAttrib(type, 1, (void*)&data->operator[](0)); }
+                      SLVfloat*         data,
+                      SLuint            numVertices = 0) { updateAttrib(type, 1, (void*)&data->operator[](0), numVertices); }
 
     //! Updates a specific vertex attribute in the VBO
     void updateAttrib(SLGLAttributeType type,
-                      SLVVec2f*         data) { updateAttrib(type, 2, (void*)&data->operator[](0)); }
+                      SLVVec2f*         data,
+                      SLuint            numVertices = 0) { updateAttrib(type, 2, (void*)&data->operator[](0), numVertices); }
 
     //! Updates a specific vertex attribute in the VBO
     void updateAttrib(SLGLAttributeType type,
-                      SLVVec3f*         data) { updateAttrib(type, 3, (void*)&data->operator[](0)); }
+                      SLVVec3f*         data,
+                      SLuint            numVertices = 0) { updateAttrib(type, 3, (void*)&data->operator[](0), numVertices); }
 
     //! Updates a specific vertex attribute in the VBO
     void updateAttrib(SLGLAttributeType type,
-                      SLVVec4f*         data) { updateAttrib(type, 4, (void*)&data->operator[](0)); }
+                      SLVVec4f*         data,
+                      SLuint            numVertices = 0) { updateAttrib(type, 4, (void*)&data->operator[](0), numVertices); }
 
     //! Generates the VA & VB objects for a NO. of vertices
     void generate(SLuint          numVertices,
@@ -23,6 +23,8 @@ struct SLGLAttribute
 {
     SLGLAttributeType type;            //!< type of vertex attribute
     SLint             elementSize;     //!< size of attribute element (SLVec3f has 3)
+    SLGLBufferType    dataType;        //!< data type of the element components
+    SLbool            normalized;      //!< flag if integer components get normalized
     SLuint            offsetBytes;     //!< offset of the attribute data in the buffer
     SLuint            bufferSizeBytes; //!< size of the attribute part in the buffer
     void*             dataPointer;     //!< pointer to the attributes source data
@@ -38,6 +40,9 @@ typedef vector<SLGLAttribute> SLVVertexAttrib;
 Attributes can be either be in sequential order (first all positions, then all 
 normals, etc.) or interleaved (all attributes together for one vertex). See 
 SLGLVertexBuffer::generate for more information.\n
+Every attribute has its own component data type. Besides floats, attributes
+can be packed into half floats, shorts or unsigned bytes, which are converted
+to floats by OpenGL (see SLMesh::generateVAO).\n
 Vertex index buffer are not handled in this class. They are generated in
 SLGLVertexArray.
 */
@@ -56,10 +61,11 @@ class SLGLVertexBuffer
     //! Returns the vector index if a vertex attribute exists otherwise -1
     SLint attribIndex(SLGLAttributeType type);
 
-    //! Updates a specific vertex attribute in the VBO
+    //! Updates a specific vertex attribute in the VBO (numVertices 0: all)
     void updateAttrib(SLGLAttributeType type,
                       SLint             elementSize,
-                      void*             dataPointer);
+                      void*             dataPointer,
+                      SLuint            numVertices = 0);
 
     //! Updates a specific vertex attribute in the VBO
     void updateAttrib(SLGLAttributeType type,
@@ -93,9 +99,6 @@ class SLGLVertexBuffer
     SLVVertexAttrib& attribs() { return _attribs; }
     SLbool           outputInterleaved() { return _outputInterleaved; }
 
-    // Setters
-    void dataType(SLGLBufferType dt) { _dataType = dt; }
-
     // Some statistics
     static SLuint totalBufferCount; //! static total no. of buffers in use
     static SLuint totalBufferSize;  //! static total size of all buffers in bytes
@@ -106,7 +109,6 @@ class SLGLVertexBuffer
     protected:
     SLuint          _id;                //! OpenGL id of vertex buffer object
     SLuint          _numVertices;       //! NO. of vertices in array
-    SLGLBufferType  _dataType;          //! Data Type (BT_float or BT_half)
     SLVVertexAttrib _attribs;           //! Vector of vertex attributes
     SLbool          _outputInterleaved; //! Flag if VBO should be generated interleaved
     SLuint          _strideBytes;       //! Distance for interleaved attributes in bytes
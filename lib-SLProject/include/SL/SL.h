@@ -237,6 +237,17 @@ SL_sizeOfVector(const T& vector)
 #define SL_EXIT_MSG(M) SL::exitMsg((M), __LINE__, __FILE__)
 #define SL_WARN_MSG(M) SL::warnMsg((M), __LINE__, __FILE__)
 //-----------------------------------------------------------------------------
+//! Function of a parallel loop or stage that is called once per index
+typedef std::function<void(SLuint)> SLParallelFunction;
+//-----------------------------------------------------------------------------
+//! A stage of SL::parallelStages that processes the indices 0 to num-1
+struct SLParallelStage
+{
+    SLuint             num;      //!< NO. of indices to process
+    SLParallelFunction function; //!< Function called for every index
+};
+typedef std::vector<SLParallelStage> SLVParallelStage;
+//-----------------------------------------------------------------------------
 //! Class SL with some global static functions and members.
 class SL
 {
@@ -249,6 +260,20 @@ class SL
                           const SLint   line,
                           const SLchar* file);
     static SLuint maxThreads();
+
+    template<typename Function>
+    static void parallelFor(SLuint num, Function function);
+    static void parallelStages(const SLVParallelStage& stages);
 };
 //-----------------------------------------------------------------------------
+/*! Calls the function for all indices from 0 to num-1 on the worker threads
+of the SL thread pool. See SL::parallelStages for details.
+*/
+template<typename Function>
+void SL::parallelFor(SLuint num, Function function)
+{
+    if (num == 0) return;
+    SL::parallelStages({{num, SLParallelFunction(function)}});
+}
+//-----------------------------------------------------------------------------
 #endif
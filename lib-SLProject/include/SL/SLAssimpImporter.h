@@ -11,8 +11,11 @@
 #ifndef SLASSIMPIMPORTER_H
 #define SLASSIMPIMPORTER_H
 
+#include <mutex>
+
 #include <SLGLTexture.h>
 #include <SLImporter.h>
+#include <SLScene.h>
 
 // forward declarations of assimp types
 struct aiScene;
@@ -24,20 +27,49 @@ struct aiMesh;
 //-----------------------------------------------------------------------------
 typedef std::map<int, SLMesh*> SLMeshMap;
 //-----------------------------------------------------------------------------
+//! State of an asynchronous load started with SLAssimpImporter::loadAsync
+enum SLAsyncLoadState
+{
+    ALS_none,      //!< no asynchronous load started
+    ALS_loading,   //!< the loader thread reads and converts the file
+    ALS_converted, //!< the loader thread has finished
+    ALS_uploading, //!< the OpenGL objects get created on the render thread
+    ALS_finished   //!< the loaded node was passed to the callback
+};
+//-----------------------------------------------------------------------------
+//! Callback that gets the root node of an asynchronously loaded asset
+typedef std::function<void(SLNode* loaded)> SLLoadCallback;
+//-----------------------------------------------------------------------------
 //! Small class interface into the AssImp library for importing 3D assets.
 /*! See AssImp library (http://assimp.sourceforge.net/) documentation for 
 supported file formats and the import processing options.
+The texture images of all materials are decoded in parallel.
+<br>
+Large assets can be loaded asynchronously with loadAsync without blocking the
+render thread. The instance then is the handle of the load and gets owned by
+the scene (SLScene::asyncImporters):
+- A loader thread reads the file with AssImp and converts it into meshes,
+  materials, textures, a skeleton and animations. These resources are created
+  into an SLSceneStaging and not into the resource vectors of SLScene.
+- SLScene::onUpdate calls finishAsync once per frame on the render thread.
+  After the loader thread has finished it builds the OpenGL textures and vertex
+  array objects one by one until uploadBudgetMS is used up in the frame.
+- When all OpenGL objects exist the resources are moved into the scene and the
+  loaded root node is passed to the callback on the render thread. The scene
+  then deletes the importer.
+
+The progress in percent and a message for the UI are available with progressPC
+and progressMsg. Deleting the importer aborts a running load.
 */
 class SLAssimpImporter : public SLImporter
 {
     public:
-    SLAssimpImporter() {}
-    SLAssimpImporter(SLLogVerbosity consoleVerb)
-      : SLImporter(consoleVerb) {}
+    SLAssimpImporter();
+    SLAssimpImporter(SLLogVerbosity consoleVerb);
     SLAssimpImporter(SLstring&      logFile,
                      SLLogVerbosity logConsoleVerb = LV_normal,
-                     SLLogVerbosity logFileVerb    = LV_diagnostic)
-      : SLImporter(logFile, logConsoleVerb, logFileVerb) {}
+                     SLLogVerbosity logFileVerb    = LV_diagnostic);
+    ~SLAssimpImporter();
 
     SLNode* load(SLstring    pathFilename,
                  SLbool      loadMeshesOnly = true,
@@ -71,6 +103,26 @@ class SLAssimpImporter : public SLImporter
                  //|SLProcess_Dejoint
     );
 
+    void loadAsync(SLstring       pathFilename,
+                   SLLoadCallback onLoaded,
+                   SLbool         loadMeshesOnly = true,
+                   SLMaterial*    overrideMat    = nullptr,
+                   SLuint         flags          = SLProcess_Triangulate |
+                                          SLProcess_JoinIdenticalVertices |
+                                          SLProcess_RemoveRedundantMaterials |
+                                          SLProcess_FindDegenerates |
+                                          SLProcess_FindInvalidData |
+                                          SLProcess_SplitLargeMeshes);
+    SLbool finishAsync(SLfloat budgetMS);
+
+    // Getters
+    SLAsyncLoadState asyncState() const { return (SLAsyncLoadState)(SLint)_asyncState; }
+    SLint            progressPC() const { return _progressPC; }
+    SLstring         progressMsg();
+
+    static SLfloat uploadBudgetMS;           //!< Max. time per frame for the OpenGL uploads of async loads
+    static SLbool  compileSkeletonAnimations; //!< Flag if skeleton animations get compiled into an SLAnimClip
+
     protected:
     // intermediate containers
     typedef std::map<SLstring, aiNode*> SLNodeMap;
@@ -87,6 +139,21 @@ class SLAssimpImporter : public SLImporter
     SLuint   _jointIndex;    //!< index counter used when iterating over joints
     MeshList _skinnedMeshes; //!< list containing all of the skinned meshes, used to assign the skinned materials
 
+    // parallel texture decoding
+    std::map<SLstring, SLstring>   _texFiles;  //!< map from the texture path in the file to the found texture file
+    std::map<SLstring, SLCVImage*> _texImages; //!< map from the found texture file to its decoded image
+
+    // asynchronous loading
+    thread         _loadThread;    //!< loader thread started by loadAsync
+    SLSceneStaging _staging;       //!< resources created by the loader thread
+    SLLoadCallback _onLoaded;      //!< callback for the loaded root node
+    atomic<SLint>  _asyncState;    //!< SLAsyncLoadState of the asynchronous load
+    atomic<bool>   _cancel;        //!< flag for aborting a running load
+    atomic<SLint>  _progressPC;    //!< loading progress in percent
+    SLstring       _progressMsg;   //!< loading progress message
+    mutex          _progressMutex; //!< mutex for the progress message
+    SLuint         _numUploaded;   //!< NO. of textures & meshes uploaded to the GPU
+
     // loading helper
     aiNode*       getNodeByName(const SLstring& name); // return an aiNode ptr if name exists, or null if it doesn't
     const SLMat4f getOffsetMat(const SLstring& name);  // return an aiJoint ptr if name exists, or null if it doesn't
@@ -111,11 +178,14 @@ class SLAssimpImporter : public SLImporter
                               SLMeshMap& meshes,
                               SLbool     loadMeshesOnly = true);
     SLAnimation* loadAnimation(aiAnimation* anim);
+    void         loadTextureImages(const aiScene* scene, SLstring modelPath);
     SLstring     checkFilePath(SLstring modelPath, SLstring texFile);
     SLbool       aiNodeHasMesh(aiNode* node);
+    SLbool       uploadNext();
 
     // misc helper
     void clear();
+    void progress(SLint percent, const SLstring& msg);
 };
 //-----------------------------------------------------------------------------
 #endif // SLASSIMP_H
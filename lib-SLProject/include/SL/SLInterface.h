@@ -58,6 +58,9 @@ void   slResize(int sceneViewIndex,
                 int width,
                 int height);
 bool   slUpdateAndPaint(int sceneViewIndex);
+void   slWaitForNextFrame();
+int    slGetSwapInterval();
+void   slSetRefreshRate(float hz);
 void   slMouseDown(int           sceneViewIndex,
                    SLMouseButton button,
                    int           x,
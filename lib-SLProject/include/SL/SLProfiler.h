@@ -0,0 +1,158 @@
+//#############################################################################
+//  File:      SL/SLProfiler.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLPROFILER_H
+#define SLPROFILER_H
+
+#include <SL.h>
+#include <atomic>
+#include <mutex>
+
+//-----------------------------------------------------------------------------
+//! One timed scope of a thread
+struct SLProfileEvent
+{
+    const SLchar* name;    //!< Static name of the scope
+    SLint64       startNS; //!< Start time in ns since the profiler start
+    SLint64       endNS;   //!< End time in ns since the profiler start
+    SLuint        depth;   //!< Nesting depth of the scope (0 = outermost)
+};
+typedef vector<SLProfileEvent> SLVProfileEvent;
+//-----------------------------------------------------------------------------
+//! Ring buffer with the events of one thread
+/*! Only the owning thread writes into the ring buffer. It publishes an event
+by incrementing head after writing it, so that other threads can read all
+events below head without a lock. A buffer of a finished thread gets reused
+by the next new thread.
+*/
+struct SLProfileThread
+{
+    SLuint           id;     //!< Thread id in the trace
+    SLstring         name;   //!< Thread name in the trace
+    SLVProfileEvent  events; //!< Ring buffer with the events
+    atomic<SLuint64> head;   //!< NO. of events written so far
+    SLuint           depth;  //!< Current nesting depth
+    atomic<SLbool>   isUsed; //!< Flag if a running thread owns the buffer
+};
+//-----------------------------------------------------------------------------
+//! Profiler for nested CPU scopes on all threads and GPU passes
+/*!
+CPU scopes are timed with the RAII class SLProfileScope that the macro
+SL_PROFILE_SCOPE creates. It stores the start and end time in nanoseconds into
+the ring buffer of the current thread. GPU passes are timed with the macro
+SL_PROFILE_GPU that wraps the pass into an OpenGL GL_TIME_ELAPSED query.
+GPU queries can't be nested and are read back without stalling a few frames
+later in beginFrame. GPU events are placed at the CPU time of their submission
+on a separate GPU track. OpenGL ES has no timer queries without an extension,
+so GPU scopes are ignored there. beginFrame adds the duration of every frame
+to a separate frame track, so that frame spikes are easy to find.
+\n
+If SLProfiler::isOn is false a scope costs only the test of this flag. If
+SL_NO_PROFILING is defined the macros are empty.
+\n
+The events can be exported with exportChromeTrace in the JSON trace format
+that chrome://tracing and https://ui.perfetto.dev can open.
+*/
+class SLProfiler
+{
+    public:
+    static SLint64          timeNS();
+    static SLProfileThread* thread();
+    static void             threadName(SLstring name);
+    static void             endScope(SLProfileThread* thread,
+                                     const SLchar*    name,
+                                     SLint64          startNS);
+    static void             beginFrame();
+    static SLint            beginGPU(const SLchar* name);
+    static void             endGPU(SLint query);
+    static void             deleteGPUQueries();
+
+    static void     lastFrame(SLint64& startNS, SLint64& endNS);
+    static SLuint   numThreads();
+    static SLstring threadName(SLuint index);
+    static void     threadEvents(SLuint           index,
+                                 SLint64          startNS,
+                                 SLint64          endNS,
+                                 SLVProfileEvent& events);
+    static SLbool   exportChromeTrace(SLstring filename);
+
+    static atomic<SLbool> isOn;             //!< Flag if the profiler records
+    static SLuint         eventsPerThread;  //!< Ring buffer size per thread
+    static const SLuint   GPU_THREAD   = 0; //!< Thread index of the GPU events
+    static const SLuint   FRAME_THREAD = 1; //!< Thread index of the frame events
+
+    private:
+    static SLProfileThread* addThread(SLstring name);
+    static void             addEvent(SLProfileThread* thread,
+                                     const SLchar*    name,
+                                     SLint64          startNS,
+                                     SLint64          endNS);
+
+    static mutex                    _mutex;        //!< Mutex for the thread list
+    static vector<SLProfileThread*> _threads;      //!< Ring buffers of all threads
+    static SLint64                  _frameStartNS; //!< Start time of the current frame
+};
+//-----------------------------------------------------------------------------
+//! RAII object that times a CPU scope
+class SLProfileScope
+{
+    public:
+    SLProfileScope(const SLchar* name)
+    {
+        _thread = SLProfiler::isOn.load(memory_order_relaxed) ? SLProfiler::thread() : nullptr;
+        if (_thread)
+        {
+            _name    = name;
+            _startNS = SLProfiler::timeNS();
+            _thread->depth++;
+        }
+    }
+    ~SLProfileScope()
+    {
+        if (_thread) SLProfiler::endScope(_thread, _name, _startNS);
+    }
+
+    private:
+    SLProfileThread* _thread;  //!< Ring buffer of the thread or null if off
+    const SLchar*    _name;    //!< Static name of the scope
+    SLint64          _startNS; //!< Start time in ns
+};
+//-----------------------------------------------------------------------------
+//! RAII object that times a GPU pass with a timer query
+class SLProfileScopeGPU
+{
+    public:
+    SLProfileScopeGPU(const SLchar* name)
+    {
+        _query = SLProfiler::isOn.load(memory_order_relaxed) ? SLProfiler::beginGPU(name) : -1;
+    }
+    ~SLProfileScopeGPU()
+    {
+        if (_query >= 0) SLProfiler::endGPU(_query);
+    }
+
+    private:
+    SLint _query; //!< Index of the running query or -1
+};
+//-----------------------------------------------------------------------------
+#define SL_PROFILE_CONCAT2(a, b) a##b
+#define SL_PROFILE_CONCAT(a, b) SL_PROFILE_CONCAT2(a, b)
+
+#ifndef SL_NO_PROFILING
+#    define SL_PROFILE_SCOPE(name) SLProfileScope SL_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#    define SL_PROFILE_FUNCTION() SL_PROFILE_SCOPE(__FUNCTION__)
+#    define SL_PROFILE_GPU(name) SLProfileScopeGPU SL_PROFILE_CONCAT(profileScopeGPU, __LINE__)(name)
+#else
+#    define SL_PROFILE_SCOPE(name)
+#    define SL_PROFILE_FUNCTION()
+#    define SL_PROFILE_GPU(name)
+#endif
+//-----------------------------------------------------------------------------
+#endif // SLPROFILER_H
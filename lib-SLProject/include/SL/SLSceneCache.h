@@ -0,0 +1,68 @@
+//#############################################################################
+//  File:      SL/SLSceneCache.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLSCENECACHE_H
+#define SLSCENECACHE_H
+
+#include <SL.h>
+#include <SLAnimation.h>
+#include <SLMesh.h>
+
+class SLNode;
+class SLMaterial;
+class SLSkeleton;
+
+//-----------------------------------------------------------------------------
+//! Binary cache file of the scene data that an importer created from a file
+/*!
+Importing a large model with AssImp, calculating its normals and building the
+skeleton and animations takes seconds. SLAssimpImporter::load therefore writes
+the converted data into a binary cache file after the first import and reads
+it back on later loads of the same file.
+
+The cache file is written in the native little-endian byte order. It starts
+with a header (magic number, format version, byte order mark and file size)
+followed by the materials, the skeleton with its animations, the meshes,
+the node hierarchy and the node animations. All vertex and index arrays start
+at 16 byte aligned offsets. The cache gets read over a memory mapping of the
+file and the arrays are copied with one memcpy each straight from the mapped
+pages into the mesh vectors without any parsing or recalculation.
+
+The name of the cache file contains a key that is hashed from the source file
+path, its size and modification time, the import flags, the mesh optimizer
+flag and the format version. A changed source file or a new format version
+therefore never reads an outdated cache. The cache files are stored in
+SLApplication::configPath and a new cache file replaces the outdated ones of
+the same source file name. The cache is off by default (see isOn).
+*/
+class SLSceneCache
+{
+    public:
+    static SLstring cacheFile(const SLstring& sourceFile,
+                              SLbool          loadMeshesOnly,
+                              SLbool          hasOverrideMat,
+                              SLuint          flags);
+
+    static SLbool write(const SLstring&     cacheFile,
+                        SLNode*             root,
+                        SLSkeleton*         skeleton,
+                        const SLVAnimation& nodeAnimations);
+
+    static SLNode* read(const SLstring& cacheFile,
+                        SLMaterial*     overrideMat,
+                        SLVMesh&        meshes,
+                        SLSkeleton*&    skeleton,
+                        SLVAnimation&   nodeAnimations);
+
+    static SLbool       isOn;    //!< Flag if the importers use the cache
+    static const SLuint version; //!< Version of the cache file format
+};
+//-----------------------------------------------------------------------------
+#endif // SLSCENECACHE_H
@@ -35,6 +35,11 @@ color=zero at the last pixel of each character.
 The source bitmaps for the fonts are in the folder _data/fonts. The where used
 for design only. Their data is directly included a binary array in the source 
 file SLTexFont.cpp.
+\n
+After all fonts are generated their bitmaps are copied into one glyph atlas
+texture (SLTexFont::atlas) and the texture coordinates of the characters are
+mapped into the atlas. Text of all font sizes can therefore be drawn with a
+single texture in one draw call (see SLTextBatcher).
 */
 class SLTexFont : public SLGLTexture
 {
@@ -48,10 +53,11 @@ class SLTexFont : public SLGLTexture
                            SLfloat  lineHeightFactor = 1.5f);
     SLVstring wrapTextToLines(SLstring text,
                               SLfloat  maxW);
-    void      buildTextBuffers(SLGLVertexArray& vao,
-                               SLstring         text,
-                               SLfloat          maxWidth   = 0.0f,
-                               SLfloat          lineHeight = 1.5f);
+    void      buildTextQuads(SLVVec3f& P,
+                             SLVVec2f& T,
+                             SLstring  text,
+                             SLfloat   maxWidth   = 0.0f,
+                             SLfloat   lineHeight = 1.5f);
 
     //! Single Character info struct w. min. and max. texcoords.
     typedef struct
@@ -71,6 +77,8 @@ class SLTexFont : public SLGLTexture
     static void       deleteFonts();
     static SLTexFont* getFont(SLfloat heightMM, SLint dpi);
 
+    static SLGLTexture* atlas; //!< Glyph atlas texture with all fonts
+
     static SLTexFont* font07;
     static SLTexFont* font08;
     static SLTexFont* font09;
@@ -82,6 +90,9 @@ class SLTexFont : public SLGLTexture
     static SLTexFont* font20;
     static SLTexFont* font22;
     static SLTexFont* font24;
+
+    private:
+    static void buildAtlas();
 };
 //-----------------------------------------------------------------------------
 #endif
@@ -0,0 +1,93 @@
+//#############################################################################
+//  File:      SLAnimClip.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLANIMCLIP_H
+#define SLANIMCLIP_H
+
+#include <SLNode.h>
+
+class SLAnimation;
+
+//-----------------------------------------------------------------------------
+//! Local transform of all tracks of an SLAnimClip in a structure of arrays
+/*!
+Each channel holds one value per track. The pose is filled by
+SLAnimClip::evaluate and written to the nodes with SLAnimClip::applyPose.
+*/
+struct SLAnimPose
+{
+    void resize(SLuint numTracks);
+
+    SLVfloat tx, ty, tz;     //!< translation channels
+    SLVfloat qx, qy, qz, qw; //!< rotation quaternion channels
+    SLVfloat sx, sy, sz;     //!< scale channels
+};
+//-----------------------------------------------------------------------------
+//! SLAnimClip is the compiled, cache friendly form of an SLAnimation
+/*!
+An SLAnimation evaluates every track separately through virtual calls and
+temporary SLTransformKeyframe instances. SLAnimation::compile converts it into
+an SLAnimClip: All tracks are resampled at a fixed sample rate and stored in
+a structure of arrays (SoA) layout. For each sample the values of all tracks
+lie next to each other in 10 channels (translation xyz, rotation xyzw and
+scale xyz). Bezier translation curves are baked into the samples.
+
+SLAnimClip::evaluate calculates the local pose of all tracks at once with a
+linear interpolation for translation and scale and a normalized lerp (nlerp)
+for the rotations between two neighboring samples. The loops run over the
+tracks without branches and are vectorized by the compiler. Optionally the
+rotations are quantized to 16 bit integers which halves their memory.
+
+SLAnimClip::applyPose writes the pose to the animated nodes or joints in one
+pass with the same result as SLNodeAnimTrack::applyToNode. A second variant
+writes the pose to plain local joint matrices for SLSkeletonInstance.
+*/
+class SLAnimClip
+{
+    public:
+    SLAnimClip(SLAnimation* animation,
+               SLfloat      sampleRate        = 60.0f,
+               SLbool       quantizeRotations = false);
+
+    void evaluate(SLfloat time, SLAnimPose& pose) const;
+    void applyPose(const SLAnimPose& pose,
+                   const SLVNode&    targets,
+                   SLfloat           weight = 1.0f,
+                   SLfloat           scale  = 1.0f) const;
+    void applyPose(const SLAnimPose& pose,
+                   SLVMat4f&         localMats,
+                   SLfloat           weight = 1.0f,
+                   SLfloat           scale  = 1.0f) const;
+
+    // Getters
+    SLuint         numTracks() const { return _numTracks; }
+    SLuint         numSamples() const { return _numSamples; }
+    SLfloat        sampleRate() const { return _sampleRate; }
+    SLbool         quantizeRotations() const { return _quantizeRotations; }
+    const SLVuint& trackIDs() const { return _trackIDs; }
+    const SLVNode& animatedNodes() const { return _animatedNodes; }
+    size_t         memoryBytes() const;
+
+    private:
+    SLfloat  _lengthSec;         //!< length of the animation in seconds
+    SLfloat  _sampleRate;        //!< samples per second
+    SLuint   _numTracks;         //!< NO. of tracks (values per sample & channel)
+    SLuint   _numSamples;        //!< NO. of samples per track
+    SLbool   _quantizeRotations; //!< flag if the rotations are stored as 16 bit
+    SLVuint  _trackIDs;          //!< track handle (joint id) per track index
+    SLVNode  _animatedNodes;     //!< animated node per track index (node animations)
+    SLVfloat _tx, _ty, _tz;      //!< translation samples [sample * numTracks + track]
+    SLVfloat _qx, _qy, _qz, _qw; //!< rotation samples if not quantized
+    SLVshort _qxQ, _qyQ, _qzQ;   //!< quantized rotation samples
+    SLVshort _qwQ;               //!< quantized rotation w samples
+    SLVfloat _sx, _sy, _sz;      //!< scale samples
+};
+//-----------------------------------------------------------------------------
+#endif
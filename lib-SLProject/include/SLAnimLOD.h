@@ -0,0 +1,81 @@
+//#############################################################################
+//  File:      SLAnimLOD.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLANIMLOD_H
+#define SLANIMLOD_H
+
+#include <SL.h>
+#include <SLMat4.h>
+
+//-----------------------------------------------------------------------------
+//! Kind of animation update of a skeleton in one frame
+enum SLAnimLODUpdate
+{
+    AU_none,    //!< no playback changed in this frame
+    AU_full,    //!< pose evaluated and skinned in this frame
+    AU_reduced, //!< pose evaluated at a reduced rate and interpolated
+    AU_skipped  //!< not visible: only the time advanced
+};
+//-----------------------------------------------------------------------------
+//! SLAnimLOD holds the animation level of detail policy of a skeleton
+/*!
+Every SLSkeleton and SLSkeletonInstance has an SLAnimLOD that decides per
+frame how much of its animation gets updated:
+- If none of the nodes that draw the skeleton survived the view frustum
+  culling (SLNode::cull3DRec) in the last frame, the pose evaluation and the
+  skinning are skipped. The playback time still advances.
+- If the projected size on screen is smaller than fullSizePX the pose is only
+  evaluated every reducedRate frames. The joint matrices in between are
+  linearly interpolated between the last two evaluated poses. The shown pose
+  therefore lags behind by up to reducedRate frames which is invisible on
+  small characters.
+- Otherwise the pose is evaluated every frame.
+
+The culling of the last frame reports the visibility and screen size with
+visible. The owner calls nextUpdate once per frame, evaluates its joint
+matrices if needsEvaluation is true and passes them to finishUpdate that
+replaces them by the interpolated ones if needed.
+*/
+class SLAnimLOD
+{
+    public:
+    SLAnimLOD();
+
+    void            visible(SLfloat screenSizePX);
+    SLAnimLODUpdate nextUpdate();
+    void            finishUpdate(SLVMat4f& jointMatrices);
+
+    // Getters
+    SLbool          isOn() const { return _isOn; }
+    SLAnimLODUpdate update() const { return _update; }
+    SLbool          needsEvaluation() const { return _needsEvaluation; }
+    SLfloat         fullSizePX() const { return _fullSizePX; }
+    SLint           reducedRate() const { return _reducedRate; }
+
+    // Setters
+    void isOn(SLbool on) { _isOn = on; }
+    void fullSizePX(SLfloat sizePX) { _fullSizePX = sizePX; }
+    void reducedRate(SLint rate) { _reducedRate = rate; }
+
+    private:
+    SLbool          _isOn;            //!< flag if the LOD policy is applied
+    SLfloat         _fullSizePX;      //!< min. screen size in pixels for full updates
+    SLint           _reducedRate;     //!< frames between pose evaluations if small
+    SLbool          _isVisible;       //!< visible in the last culling
+    SLfloat         _screenSizePX;    //!< max. screen size in the last culling
+    SLAnimLODUpdate _update;          //!< update kind of the current frame
+    SLbool          _needsEvaluation; //!< flag if the pose must be evaluated
+    SLint           _framesSinceKey;  //!< frames since the last evaluated key pose
+    SLbool          _hasKeys;         //!< flag if the key poses are valid
+    SLVMat4f        _keyFrom;         //!< older evaluated joint matrices
+    SLVMat4f        _keyTo;           //!< newer evaluated joint matrices
+};
+//-----------------------------------------------------------------------------
+#endif
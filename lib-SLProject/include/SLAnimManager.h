@@ -14,7 +14,9 @@
 #include <SLAnimManager.h>
 #include <SLAnimPlayback.h>
 #include <SLAnimation.h>
+#include <SLMesh.h>
 #include <SLSkeleton.h>
+#include <SLSkeletonInstance.h>
 
 //-----------------------------------------------------------------------------
 //! SLAnimManager is the central class for all animation handling.
@@ -25,12 +27,19 @@ If keeps a list of all skeletons and node animations and also holds a list of
 all animation playback controllers.
 The update of all animations is done before the rendering of all SLSceneView in
 SLScene::updateIfAllViewsGotPainted by calling the SLAnimManager::update.
+The skeletons are independent of each other and of the scene graph and are
+therefore updated in parallel. The software skinning of the meshes bound to a
+skeleton is done afterwards in parallel by SLAnimManager::skinMeshes.
+For crowds the manager also holds SLSkeletonInstances that share a skeleton
+but are animated independently and skinned on the GPU.
 */
 class SLAnimManager
 {
     public:
+    SLAnimManager();
     ~SLAnimManager();
 
+    void            merge(SLAnimManager& other);
     void            addSkeleton(SLSkeleton* skel);
     void            addNodeAnimation(SLAnimation* anim);
     SLbool          hasNodeAnimations() { return (_nodeAnimations.size() > 0); }
@@ -38,24 +47,39 @@ class SLAnimManager
     SLAnimPlayback* allAnimPlayback(SLuint ix) { return _allAnimPlaybacks[ix]; }
     SLAnimPlayback* lastAnimPlayback() { return _allAnimPlaybacks.back(); }
 
-    SLAnimation* createNodeAnimation(SLfloat duration);
-    SLAnimation* createNodeAnimation(const SLstring& name, SLfloat duration);
+    SLAnimation*        createNodeAnimation(SLfloat duration);
+    SLAnimation*        createNodeAnimation(const SLstring& name, SLfloat duration);
+    SLSkeletonInstance* createSkeletonInstance(SLSkeleton* skel);
+    void                deleteSkeleton(SLSkeleton* skel);
+    void                deleteNodeAnimation(SLAnimation* anim);
 
-    SLMAnimation&    animations() { return _nodeAnimations; }
-    SLVSkeleton&     skeletons() { return _skeletons; }
-    SLVstring&       allAnimNames() { return _allAnimNames; }
-    SLVAnimPlayback& allAnimPlaybacks() { return _allAnimPlaybacks; }
+    SLMAnimation&        animations() { return _nodeAnimations; }
+    SLVSkeleton&         skeletons() { return _skeletons; }
+    SLVSkeletonInstance& skeletonInstances() { return _skeletonInstances; }
+    SLVstring&           allAnimNames() { return _allAnimNames; }
+    SLVAnimPlayback&     allAnimPlaybacks() { return _allAnimPlaybacks; }
+    SLuint               numFullUpdates() const { return _numFullUpdates; }
+    SLuint               numReducedUpdates() const { return _numReducedUpdates; }
+    SLuint               numSkippedUpdates() const { return _numSkippedUpdates; }
 
     SLbool update(SLfloat elapsedTimeSec);
+    SLbool skinMeshes(const SLVMesh& meshes);
     void   drawVisuals(SLSceneView* sv);
     void   clear();
 
     private:
-    SLVSkeleton     _skeletons;         //!< all skeleton instances
-    SLMAnimation    _nodeAnimations;    //!< node animations
-    SLMAnimPlayback _nodeAnimPlaybacks; //!< node animation playbacks
-    SLVstring       _allAnimNames;      //!< vector with all animation names
-    SLVAnimPlayback _allAnimPlaybacks;  //!< vector with all animation playbacks
+    void countUpdate(SLAnimLODUpdate update);
+    void removeAnimPlayback(SLAnimPlayback* playback);
+
+    SLVSkeleton         _skeletons;         //!< all skeletons
+    SLVSkeletonInstance _skeletonInstances; //!< all independently animated skeleton instances
+    SLMAnimation        _nodeAnimations;    //!< node animations
+    SLMAnimPlayback     _nodeAnimPlaybacks; //!< node animation playbacks
+    SLVstring           _allAnimNames;      //!< vector with all animation names
+    SLVAnimPlayback     _allAnimPlaybacks;  //!< vector with all animation playbacks
+    SLuint              _numFullUpdates;    //!< NO. of skeletons fully updated in the last frame
+    SLuint              _numReducedUpdates; //!< NO. of skeletons updated at reduced rate in the last frame
+    SLuint              _numSkippedUpdates; //!< NO. of culled skeletons not updated in the last frame
 };
 //-----------------------------------------------------------------------------
 #endif
@@ -63,6 +63,7 @@ class SLAnimPlayback
     SLbool        isPlayingBackward() const { return _enabled && _playbackDir == -1; }
     SLbool        isPaused() const { return _enabled && _playbackDir == 0; }
     SLbool        isStopped() const { return !_enabled; }
+    SLVuint&      keyframeCursors() { return _keyframeCursors; }
 
     // setters
     void localTime(SLfloat time);
@@ -89,6 +90,7 @@ class SLAnimPlayback
     SLfloat       _linearLocalTime;  //!< linear local time used for _easing propert
     SLAnimLooping _loopingBehaviour; //!< We support different looping behaviours
     SLbool        _gotChanged;       //!< Did this playback change in the last frame
+    SLVuint       _keyframeCursors;  //!< Last used keyframe index per track of the animation
 };
 //-----------------------------------------------------------------------------
 typedef std::vector<SLAnimPlayback*>        SLVAnimPlayback;
@@ -28,6 +28,12 @@ An animation track is a specialized track that affects a single SLNode or an
 SLJoint of an SLSkeleton by interpolating its transform. It holds therefore a
 list of SLKeyframe. For a smooth motion it can interpolate the transform at a
 given time between two neighboring SLKeyframe.
+The key times are additionally stored in a contiguous float array for a cache
+friendly lookup. A caller can pass a keyframe cursor that remembers the index
+of the last used keyframe. During normal playback the cursor advances
+incrementally with the time. Only on seeks, backward jumps and wraps a binary
+search over the key times is needed. Because an animation can be played by
+multiple SLAnimPlayback at the same time, the cursors belong to the playback.
 */
 class SLAnimTrack
 {
@@ -38,22 +44,27 @@ class SLAnimTrack
     SLKeyframe*  createKeyframe(SLfloat time); // create and add a new keyframe
     SLfloat      getKeyframesAtTime(SLfloat      time,
                                     SLKeyframe** k1,
-                                    SLKeyframe** k2) const;
+                                    SLKeyframe** k2,
+                                    SLuint*      cursor = nullptr) const;
     virtual void calcInterpolatedKeyframe(SLfloat     time,
-                                          SLKeyframe* keyframe) const = 0; // we need a way to get an output value for a time we put in
+                                          SLKeyframe* keyframe,
+                                          SLuint*     cursor = nullptr) const = 0; // we need a way to get an output value for a time we put in
     virtual void apply(SLfloat time,
                        SLfloat weight = 1.0f,
-                       SLfloat scale  = 1.0f)                          = 0;
-    virtual void drawVisuals(SLSceneView* sv)                         = 0;
+                       SLfloat scale  = 1.0f,
+                       SLuint* cursor = nullptr)                             = 0;
+    virtual void drawVisuals(SLSceneView* sv)                               = 0;
     SLint        numKeyframes() const { return (SLint)_keyframes.size(); }
     SLKeyframe*  keyframe(SLint index);
 
     protected:
     /// Keyframe creator function for derived implementations
     virtual SLKeyframe* createKeyframeImpl(SLfloat time) = 0;
+    SLuint              findKeyframeIndex(SLfloat time, SLuint* cursor) const;
 
     SLAnimation* _animation; //!< parent animation that created this track
     SLVKeyframe  _keyframes; //!< keyframe list for this track
+    SLVfloat     _keyTimes;  //!< contiguous copy of the keyframe times for the lookup
 };
 
 //-----------------------------------------------------------------------------
@@ -74,9 +85,9 @@ class SLNodeAnimTrack : public SLAnimTrack
     void    animatedNode(SLNode* target) { _animatedNode = target; }
     SLNode* animatedNode() { return _animatedNode; }
 
-    virtual void calcInterpolatedKeyframe(SLfloat time, SLKeyframe* keyframe) const;
-    virtual void apply(SLfloat time, SLfloat weight = 1.0f, SLfloat scale = 1.0f);
-    virtual void applyToNode(SLNode* node, SLfloat time, SLfloat weight = 1.0f, SLfloat scale = 1.0f);
+    virtual void calcInterpolatedKeyframe(SLfloat time, SLKeyframe* keyframe, SLuint* cursor = nullptr) const;
+    virtual void apply(SLfloat time, SLfloat weight = 1.0f, SLfloat scale = 1.0f, SLuint* cursor = nullptr);
+    virtual void applyToNode(SLNode* node, SLfloat time, SLfloat weight = 1.0f, SLfloat scale = 1.0f, SLuint* cursor = nullptr);
     virtual void drawVisuals(SLSceneView* sv);
 
     void interpolationCurve(SLCurve* curve);
@@ -11,6 +11,7 @@
 #ifndef SLANIMATION_H
 #define SLANIMATION_H
 
+#include <SLAnimClip.h>
 #include <SLAnimTrack.h>
 #include <SLEnums.h>
 #include <SLJoint.h>
@@ -29,6 +30,10 @@ SLNodeAnimTrack. The SLAnimation class keeps a map with index -> SLNodeAnimTrack
 pairs, the index for the SLNodeAnimTrack must match the index of a bone in the
 target SLSkeleton. This method allows us to animate multiple identical, or similar
 SLSkeletons with the same SLAnimation.
+
+After all keyframes are created, an animation can be compiled into an
+SLAnimClip with compile. The apply functions then evaluate the compiled clip
+for all tracks at once instead of every track separately.
 */
 class SLAnimation
 {
@@ -39,19 +44,23 @@ class SLAnimation
     SLfloat nextKeyframeTime(SLfloat time);
     SLfloat prevKeyframeTime(SLfloat time);
     SLbool  affectsNode(SLNode* node);
-    void    apply(SLfloat time,
-                  SLfloat weight = 1.0f,
-                  SLfloat scale  = 1.0f);
+    void    apply(SLfloat  time,
+                  SLfloat  weight  = 1.0f,
+                  SLfloat  scale   = 1.0f,
+                  SLVuint* cursors = nullptr);
     void    applyToNode(SLNode* node,
                         SLfloat time,
                         SLfloat weight = 1.0f,
                         SLfloat scale  = 1.0f);
     void    apply(SLSkeleton* skel,
                   SLfloat     time,
-                  SLfloat     weight = 1.0f,
-                  SLfloat     scale  = 1.0f);
+                  SLfloat     weight  = 1.0f,
+                  SLfloat     scale   = 1.0f,
+                  SLVuint*    cursors = nullptr);
     void    resetNodes();
     void    drawNodeVisuals(SLSceneView* sv);
+    void    compile(SLfloat sampleRate        = 60.0f,
+                    SLbool  quantizeRotations = false);
 
     // static creator
     static SLAnimation* create(const SLstring& name,
@@ -75,8 +84,11 @@ class SLAnimation
                                              SLfloat radiusB,
                                              SLAxis  axisB);
     // Getters
-    const SLstring& name() { return _name; }
-    SLfloat         lengthSec() const { return _lengthSec; }
+    const SLstring&         name() { return _name; }
+    SLfloat                 lengthSec() const { return _lengthSec; }
+    SLint                   numNodeAnimTracks() const { return (SLint)_nodeAnimTracks.size(); }
+    const SLMNodeAnimTrack& nodeAnimTracks() const { return _nodeAnimTracks; }
+    SLAnimClip*             clip() { return _clip; }
 
     // Setters
     void name(const SLstring& name) { _name = name; }
@@ -86,6 +98,7 @@ class SLAnimation
     SLstring         _name;           //!< name of the animation
     SLfloat          _lengthSec;      //!< duration of the animation in seconds
     SLMNodeAnimTrack _nodeAnimTracks; //!< map of all the node tracks in this animation
+    SLAnimClip*      _clip;           //!< compiled clip or nullptr if not compiled
 };
 //-----------------------------------------------------------------------------
 typedef vector<SLAnimation*>        SLVAnimation;
@@ -59,7 +59,7 @@ class SLAverage
     T average() { return _average; }
 
     //! Get the last entry
-    T last() { return _currentValueNo > 0 ? _currentValueNo - 1 : _values.size() - 1; }
+    T last() { return _values[_currentValueNo > 0 ? _currentValueNo - 1 : _values.size() - 1]; }
 
     private:
     SLfloat   _oneOverNumValues; //!< multiplier instead of devider
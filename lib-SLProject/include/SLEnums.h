@@ -322,7 +322,9 @@ enum SLShaderProg
     SP_bumpNormalParallax,
     SP_fontTex,
     SP_stereoOculus,
-    SP_stereoOculusDistortion
+    SP_stereoOculusDistortion,
+    SP_perVrtBlinnSkinned,
+    SP_perVrtBlinnTexSkinned
 };
 //-----------------------------------------------------------------------------
 //! Type definition for GLSL uniform1f variables that change per frame.
@@ -0,0 +1,81 @@
+//#############################################################################
+//  File:      SLFrameScheduler.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLFRAMESCHEDULER_H
+#define SLFRAMESCHEDULER_H
+
+#include <SL.h>
+#include <SLTimer.h>
+#include <atomic>
+
+//-----------------------------------------------------------------------------
+//! Sources that request a new frame (flags of SLFrameScheduler::markDirty)
+enum SLDirtySource
+{
+    DS_input      = 1 << 0, //!< Input events got processed
+    DS_animation  = 1 << 1, //!< Node, skeleton or camera animation is running
+    DS_video      = 1 << 2, //!< A new video frame got copied to the video texture
+    DS_tracking   = 1 << 3, //!< A tracker found its target
+    DS_loading    = 1 << 4, //!< Async. imports or streamed textures are pending
+    DS_continuous = 1 << 5  //!< The scene view doesn't wait on idle
+};
+//-----------------------------------------------------------------------------
+//! Paces the frames of the main loop and tracks what requests a new frame
+/*!
+SLScene::onUpdate calls beginFrame at the start of every frame. It returns
+the elapsed time since the last frame for the animations. If the main loop
+waited for events before the frame, nothing was animated in the meantime and
+the elapsed time is limited to one frame period, so that animations continue
+smoothly instead of jumping over the idle time.
+\n
+During the frame the scene and the scene view mark the dirty sources with
+markDirty. A scene view that waits on idle renders only on a change: endFrame
+returns false if no source was marked, so that the main loop waits for the
+next event with no CPU or GPU load. markDirty is thread safe.
+\n
+If a target frame rate is set, waitForNextFrame sleeps for the rest of the
+frame period after the buffer swap. With a known display refresh rate the
+frame period is a multiple of the refresh period and swapInterval returns the
+NO. of vertical syncs per frame, so the buffer swap does the pacing.
+*/
+class SLFrameScheduler
+{
+    public:
+    SLFrameScheduler();
+
+    SLfloat beginFrame();
+    void    markDirty(SLDirtySource source) { _dirty |= (SLuint)source; }
+    SLbool  endFrame();
+    void    waitForNextFrame();
+
+    // Setters
+    void targetFPS(SLfloat fps) { _targetFPS = fps; }
+    void refreshRateHz(SLfloat hz) { _refreshRateHz = hz; }
+
+    // Getters
+    SLfloat targetFPS() const { return _targetFPS; }
+    SLfloat refreshRateHz() const { return _refreshRateHz; }
+    SLuint  lastDirtySources() const { return _lastDirty; }
+    SLfloat frameTimeMS() const;
+    SLint   swapInterval() const;
+
+    static SLfloat waitSlackMS; //!< Time the wait ends before the frame period
+
+    private:
+    SLTimer        _timer;         //!< Timer for the frame times
+    atomic<SLuint> _dirty;         //!< Dirty sources of the current frame
+    SLuint         _lastDirty;     //!< Dirty sources of the last frame
+    SLfloat        _targetFPS;     //!< Target frame rate (0: as fast as vsync allows)
+    SLfloat        _refreshRateHz; //!< Refresh rate of the display (0: unknown)
+    SLfloat        _frameStartMS;  //!< Start time of the current frame
+    SLbool         _wasIdle;       //!< Flag if the main loop waited before the frame
+};
+//-----------------------------------------------------------------------------
+#endif // SLFRAMESCHEDULER_H
@@ -43,6 +43,7 @@ class SLJoint : public SLNode
 
     // Setters
     void offsetMat(const SLMat4f& mat) { _offsetMat = mat; }
+    void radius(SLfloat radius) { _radius = radius; }
 
     // Getters
     SLuint         id() const { return _id; }
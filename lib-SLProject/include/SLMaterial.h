@@ -74,9 +74,13 @@ class SLMaterial : public SLObject
 
     ~SLMaterial();
 
+    //! Attaches the default shader program if none is attached
+    void assignDefaultProgram();
+
     //! Sets the material states and passes all variables to the shader program
-    void activate(SLGLState* state,
-                  SLDrawBits drawBits);
+    void activate(SLGLState*   state,
+                  SLDrawBits   drawBits,
+                  SLGLProgram* overrideProgram = nullptr);
 
     //! Returns true if there is any transparency in diffuse alpha or textures
     SLbool hasAlpha() { return (_diffuse.a < 1.0f ||
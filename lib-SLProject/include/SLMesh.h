@@ -24,6 +24,7 @@ class SLMaterial;
 class SLRay;
 class SLSkeleton;
 class SLGLState;
+class SLGLProgram;
 
 //-----------------------------------------------------------------------------
 //!An SLMesh object is a triangulated mesh that is drawn with one draw call.
@@ -46,7 +47,9 @@ The normals of a vertex are automatically calculated in the method calcNormals()
 by averaging the face normals of the adjacent triangles. A vertex has always
 only <b>one</b> normal and is used for the lighting calculation in the shader
 programs. With such averaged normals you can created a interpolated shading on
-smooth surfaces such as a sphere.
+smooth surfaces such as a sphere. For meshes with at least
+minParallelVertices vertices calcNormals, calcTangents, calcMinMax and
+calcCenterRad run in parallel with exactly the same results as serially.
 \n
 For objects with sharp edges such as a box you need 4 vertices per box face.
 All normals of a face point to the same direction. This means, that you have
@@ -111,8 +114,17 @@ A mesh uses normally only one material referenced by the SLMesh::mat pointer.
 If a mesh is associated with a skeleton all its vertices and normals are
 transformed every frame by the joint weights. Every vertex of a mesh has
 weights for 1-n joints by which it can be influenced. This transform is
-called skinning and is done in CPU in the method transformSkin. The final
+called skinning and is done in CPU in the method transformSkin or for many
+meshes in parallel in SLAnimManager::skinMeshes. The final
 transformed vertices and normals are stored in _finalP and _finalN.
+If the node that draws the mesh has an SLSkeletonInstance the mesh is skinned
+on the GPU with the joint matrices of the instance, so many independently
+animated instances can share the same mesh.
+\n
+If SLMesh::packVertices is true static triangle meshes get their vertices
+packed into one interleaved buffer of 24 instead of 64 bytes per vertex (see
+SLMesh::generateVAO). The vertex shaders decode them (see
+SLGLShader::addPackedVertexDecoding).
 */
 
 class SLMesh : public SLObject
@@ -123,6 +135,7 @@ class SLMesh : public SLObject
 
     virtual void init(SLNode* node);
     virtual void draw(SLSceneView* sv, SLNode* node);
+    void         generateVAO(SLGLProgram* sp);
     void         addStats(SLNodeStats& stats);
     virtual void buildAABB(SLAABBox& aabb, SLMat4f wmNode);
     void         updateAccelStruct();
@@ -140,12 +153,15 @@ class SLMesh : public SLObject
     SLbool       hitTriangleOS(SLRay* ray, SLNode* node, SLuint iT);
 
     void transformSkin();
+    void skinVertices();
+    void updateSkin();
 
     // Getters
     SLMaterial*       mat() const { return _mat; }
     SLMaterial*       matOut() const { return _matOut; }
     SLGLPrimitiveType primitive() const { return _primitive; }
     const SLSkeleton* skeleton() const { return _skeleton; }
+    SLSkeleton*       skeleton() { return _skeleton; }
     SLuint            numI() { return (SLuint)(I16.size() ? I16.size() : I32.size()); }
 
     // Setters
@@ -176,6 +192,9 @@ class SLMesh : public SLObject
     SLVec3f minP; //!< min. vertex in OS
     SLVec3f maxP; //!< max. vertex in OS
 
+    static SLuint minParallelVertices; //!< min. NO. of vertices for the parallel calc functions
+    static SLbool packVertices;        //!< Flag if static triangle meshes get packed vertices
+
     protected:
     SLGLState*        _stateGL;   //!< Pointer to the global SLGLState instance
     SLGLPrimitiveType _primitive; //!< Primitive type (default triangles)
@@ -188,16 +207,25 @@ class SLMesh : public SLObject
     SLGLVertexArrayExt _vaoT; //!< OpenGL VAO for optional tangent drawing
     SLGLVertexArrayExt _vaoS; //!< OpenGL VAO for optional selection drawing
 
+    SLbool  _vaoPackFlag; //!< packVertices at the generation of _vao
+    SLbool  _vaoIsPacked; //!< Flag if _vao holds packed vertices
+    SLVec3f _packScale;   //!< Scale from the packed shorts to the positions
+    SLVec3f _packOffset;  //!< Offset of the packed positions (AABB center)
+
     SLbool         _isVolume;             //!< Flag for RT if mesh is a closed volume
     SLAccelStruct* _accelStruct;          //!< KD-tree or uniform grid
     SLbool         _accelStructOutOfDate; //!< flag id accel.struct needs update
 
-    SLSkeleton* _skeleton;      //!< the skeleton this mesh is bound to
-    SLVMat4f    _jointMatrices; //!< joint matrix vector for this mesh
-    SLVVec3f*   _finalP;        //!< Pointer to final vertex position vector
-    SLVVec3f*   _finalN;        //!< pointer to final vertex normal vector
+    SLSkeleton*     _skeleton;        //!< the skeleton this mesh is bound to
+    SLVVec3f*       _finalP;          //!< Pointer to final vertex position vector
+    SLVVec3f*       _finalN;          //!< pointer to final vertex normal vector
+    SLGLVertexArray _vaoSkin;         //!< VAO with unskinned vertices for GPU skinning
+    SLVVec4f        _jointIdsGPU;     //!< max. four joint ids per vertex for GPU skinning
+    SLVVec4f        _jointWeightsGPU; //!< max. four joint weights per vertex for GPU skinning
 
     void notifyParentNodesAABBUpdate() const;
+    void generateSkinVAO(SLGLProgram* sp);
+    void generatePackedVAO(SLGLProgram* sp);
 };
 //-----------------------------------------------------------------------------
 typedef std::vector<SLMesh*> SLVMesh;
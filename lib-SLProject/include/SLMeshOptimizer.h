@@ -0,0 +1,69 @@
+//#############################################################################
+//  File:      SLMeshOptimizer.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLMESHOPTIMIZER_H
+#define SLMESHOPTIMIZER_H
+
+#include <SL.h>
+#include <SLVec3.h>
+
+class SLMesh;
+
+//-----------------------------------------------------------------------------
+//! Reorders the triangles and vertices of a mesh for faster GPU rendering
+/*!
+The index order of imported and generated meshes is whatever the source
+produced. SLMeshOptimizer::optimize reorders a triangle mesh in three steps:
+\n 1) optimizeVertexCache sorts the triangles with Tom Forsyth's linear-speed
+vertex cache optimization so that the post-transform vertex cache of the GPU
+gets reused as much as possible.
+\n 2) optimizeOverdraw splits the sorted triangles into clusters at the points
+where the vertex cache gets flushed and sorts the clusters so that the ones
+that face outwards of the mesh get drawn first (Sander et al.: Fast Triangle
+Reordering for Vertex Locality and Reduced Overdraw). The cluster order costs
+at most overdrawThreshold times the ACMR of step 1.
+\n 3) optimizeVertexFetch renumbers the vertices in the order of their first
+use, so that the vertex fetch reads the vertex buffers sequentially. All
+vertex attributes are remapped and unused vertices are removed.
+\n
+At the end the indices are stored in I16 whenever the NO. of vertices allows.
+The quality is measured with the average cache miss ratio (ACMR): the NO. of
+vertex shader invocations per triangle with a FIFO cache of cacheSizeFIFO
+entries. The ideal ACMR for a regular grid is around 0.5, the worst is 3.
+\n
+The importers and the generated shapes (SLRevolver, SLRectangle) call
+optimize when SLMeshOptimizer::isOn is true. It is off by default because the
+reordering costs load time and must be switched on before the meshes are
+built. The mesh must not be initialized yet because the vertex order changes.
+*/
+class SLMeshOptimizer
+{
+    public:
+    static void optimize(SLMesh*  mesh,
+                         SLfloat* acmrBefore = nullptr,
+                         SLfloat* acmrAfter  = nullptr);
+
+    static void   optimizeVertexCache(SLVuint& indices, SLuint numVertices);
+    static void   optimizeOverdraw(SLVuint&        indices,
+                                   const SLVVec3f& positions,
+                                   SLfloat         threshold);
+    static SLuint optimizeVertexFetch(SLVuint& indices,
+                                      SLuint   numVertices,
+                                      SLVuint& remap);
+    static SLfloat calcACMR(const SLVuint& indices,
+                            SLuint         numVertices,
+                            SLuint         cacheSize);
+
+    static SLbool  isOn;              //!< Flag if the importers & shapes optimize
+    static SLuint  cacheSizeFIFO;     //!< FIFO cache size for ACMR & overdraw
+    static SLfloat overdrawThreshold; //!< max. ACMR factor for the overdraw step
+};
+//-----------------------------------------------------------------------------
+#endif // SLMESHOPTIMIZER_H
@@ -23,6 +23,7 @@ class SLAABBox;
 class SLNode;
 class SLAnimation;
 class SLCVTracked;
+class SLSkeletonInstance;
 
 //-----------------------------------------------------------------------------
 //! SLVNode typdef for a vector of SLNodes
@@ -271,28 +272,31 @@ class SLNode
     void         needWMUpdate();
     void         needAABBUpdate();
     void         tracker(SLCVTracked* t);
+    void         skeletonInstance(SLSkeletonInstance* si) { _skeletonInstance = si; }
 
     // Getters (see also member)
-    SLNode*           parent() { return _parent; }
-    SLint             depth() const { return _depth; }
-    const SLMat4f&    om() { return _om; }
-    const SLMat4f&    initialOM() { return _initialOM; }
-    const SLMat4f&    updateAndGetWM() const;
-    const SLMat4f&    updateAndGetWMI() const;
-    const SLMat3f&    updateAndGetWMN() const;
-    SLDrawBits*       drawBits() { return &_drawBits; }
-    SLbool            drawBit(SLuint bit) { return _drawBits.get(bit); }
-    SLAABBox*         aabb() { return &_aabb; }
-    SLAnimation*      animation() { return _animation; }
-    SLVMesh&          meshes() { return _meshes; }
-    SLVNode&          children() { return _children; }
-    const SLSkeleton* skeleton();
-    SLCVTracked*      tracker() { return _tracker; }
-
-    static SLuint numWMUpdates; //!< NO. of calls to updateWM per frame
+    SLNode*             parent() { return _parent; }
+    SLint               depth() const { return _depth; }
+    const SLMat4f&      om() { return _om; }
+    const SLMat4f&      initialOM() { return _initialOM; }
+    const SLMat4f&      updateAndGetWM() const;
+    const SLMat4f&      updateAndGetWMI() const;
+    const SLMat3f&      updateAndGetWMN() const;
+    SLDrawBits*         drawBits() { return &_drawBits; }
+    SLbool              drawBit(SLuint bit) { return _drawBits.get(bit); }
+    SLAABBox*           aabb() { return &_aabb; }
+    SLAnimation*        animation() { return _animation; }
+    SLVMesh&            meshes() { return _meshes; }
+    SLVNode&            children() { return _children; }
+    const SLSkeleton*   skeleton();
+    SLCVTracked*        tracker() { return _tracker; }
+    SLSkeletonInstance* skeletonInstance() { return _skeletonInstance; }
+
+    static atomic<SLuint> numWMUpdates; //!< NO. of calls to updateWM per frame
 
     private:
     void updateWM() const;
+    void reportAnimLOD(SLSceneView* sv);
     template<typename T>
     void findChildrenHelper(const SLstring& name,
                             vector<T*>&     list,
@@ -306,22 +310,23 @@ class SLNode
                             SLbool           findRecursive);
 
     protected:
-    SLGLState*      _stateGL;        //!< pointer to the global SLGLState instance
-    SLNode*         _parent;         //!< pointer to the parent node
-    SLVNode         _children;       //!< vector of children nodes
-    SLVMesh         _meshes;         //!< vector of meshes of the node
-    SLint           _depth;          //!< depth of the node in a scene tree
-    SLMat4f         _om;             //!< object matrix for local transforms
-    SLMat4f         _initialOM;      //!< the initial om state
-    mutable SLMat4f _wm;             //!< world matrix for world transform
-    mutable SLMat4f _wmI;            //!< inverse world matrix
-    mutable SLMat3f _wmN;            //!< normal world matrix
-    mutable SLbool  _isWMUpToDate;   //!< is the WM of this node still valid
-    mutable SLbool  _isAABBUpToDate; //!< is the saved aabb still valid
-    SLDrawBits      _drawBits;       //!< node level drawing flags
-    SLAABBox        _aabb;           //!< axis aligned bounding box
-    SLAnimation*    _animation;      //!< animation of the node
-    SLCVTracked*    _tracker;        //!< OpenCV Augmented Reality Tracker
+    SLGLState*          _stateGL;          //!< pointer to the global SLGLState instance
+    SLNode*             _parent;           //!< pointer to the parent node
+    SLVNode             _children;         //!< vector of children nodes
+    SLVMesh             _meshes;           //!< vector of meshes of the node
+    SLint               _depth;            //!< depth of the node in a scene tree
+    SLMat4f             _om;               //!< object matrix for local transforms
+    SLMat4f             _initialOM;        //!< the initial om state
+    mutable SLMat4f     _wm;               //!< world matrix for world transform
+    mutable SLMat4f     _wmI;              //!< inverse world matrix
+    mutable SLMat3f     _wmN;              //!< normal world matrix
+    mutable SLbool      _isWMUpToDate;     //!< is the WM of this node still valid
+    mutable SLbool      _isAABBUpToDate;   //!< is the saved aabb still valid
+    SLDrawBits          _drawBits;         //!< node level drawing flags
+    SLAABBox            _aabb;             //!< axis aligned bounding box
+    SLAnimation*        _animation;        //!< animation of the node
+    SLCVTracked*        _tracker;          //!< OpenCV Augmented Reality Tracker
+    SLSkeletonInstance* _skeletonInstance; //!< skeleton instance for GPU skinning (not owned)
 };
 
 ////////////////////////
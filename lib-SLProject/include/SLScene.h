@@ -15,7 +15,9 @@
 #include <SLAnimManager.h>
 #include <SLAverage.h>
 #include <SLEventHandler.h>
+#include <SLFrameScheduler.h>
 #include <SLGLOculus.h>
+#include <SLGLTextureStreamer.h>
 #include <SLLight.h>
 #include <SLMaterial.h>
 #include <SLMesh.h>
@@ -28,10 +30,30 @@
 class SLSceneView;
 class SLCVTracked;
 class SLCamera;
+class SLAssimpImporter;
 
 //-----------------------------------------------------------------------------
-typedef std::vector<SLSceneView*> SLVSceneView; //!< Vector of SceneView pointers
-typedef std::vector<SLCVTracked*> SLVCVTracker; //!< Vector of CV tracker pointers
+typedef std::vector<SLSceneView*>      SLVSceneView;      //!< Vector of SceneView pointers
+typedef std::vector<SLCVTracked*>      SLVCVTracker;      //!< Vector of CV tracker pointers
+typedef std::vector<SLAssimpImporter*> SLVAssimpImporter; //!< Vector of importer pointers
+//-----------------------------------------------------------------------------
+//! Global resources created on a loader thread
+/*!
+The constructors of SLMesh, SLMaterial, SLGLTexture and SLSkeleton add their
+instance to the global resource vectors of SLScene. While an asset is loaded
+asynchronously (see SLAssimpImporter::loadAsync) the render thread keeps
+iterating these vectors. For a thread that set a staging with
+SLScene::staging the resource getters of SLScene therefore return the vectors
+of the staging. They are moved into the scene on the render thread with
+SLScene::addStaging.
+*/
+struct SLSceneStaging
+{
+    SLVMesh       meshes;      //!< Meshes created on the loader thread
+    SLVMaterial   materials;   //!< Materials created on the loader thread
+    SLVGLTexture  textures;    //!< Textures created on the loader thread
+    SLAnimManager animManager; //!< Skeletons & animations created on the loader thread
+};
 //-----------------------------------------------------------------------------
 //! C-Callback function typedef for scene load function
 typedef void(SL_STDCALL* cbOnSceneLoad)(SLScene* s, SLSceneView* sv, SLint sceneID);
@@ -69,7 +91,7 @@ class SLScene : public SLObject
     void info(SLstring i) { _info = i; }
 
     // Getters
-    SLAnimManager&   animManager() { return _animManager; }
+    SLAnimManager&   animManager() { return _staging ? _staging->animManager : _animManager; }
     SLSceneView*     sv(SLuint index) { return _sceneViews[index]; }
     SLVSceneView&    sceneViews() { return _sceneViews; }
     SLNode*          root3D() { return _root3D; }
@@ -80,6 +102,7 @@ class SLScene : public SLObject
     SLfloat          timeMilliSec() { return (SLfloat)_timer.elapsedTimeInMilliSec(); }
     SLfloat          elapsedTimeMS() { return _elapsedTimeMS; }
     SLfloat          elapsedTimeSec() { return _elapsedTimeMS * 0.001f; }
+    SLFrameScheduler& frameScheduler() { return _frameScheduler; }
     SLVEventHandler& eventHandlers() { return _eventHandlers; }
 
     SLCol4f       globalAmbiLight() const { return _globalAmbiLight; }
@@ -87,6 +110,7 @@ class SLScene : public SLObject
     SLfloat       fps() { return _fps; }
     SLAvgFloat&   frameTimesMS() { return _frameTimesMS; }
     SLAvgFloat&   updateTimesMS() { return _updateTimesMS; }
+    SLAvgFloat&   skinTimesMS() { return _skinTimesMS; }
     SLAvgFloat&   trackingTimesMS() { return _trackingTimesMS; }
     SLAvgFloat&   detectTimesMS() { return _detectTimesMS; }
     SLAvgFloat&   detect1TimesMS() { return _detect1TimesMS; }
@@ -98,9 +122,9 @@ class SLScene : public SLObject
     SLAvgFloat&   draw2DTimesMS() { return _draw2DTimesMS; }
     SLAvgFloat&   draw3DTimesMS() { return _draw3DTimesMS; }
     SLAvgFloat&   captureTimesMS() { return _captureTimesMS; }
-    SLVMaterial&  materials() { return _materials; }
-    SLVMesh&      meshes() { return _meshes; }
-    SLVGLTexture& textures() { return _textures; }
+    SLVMaterial&  materials() { return _staging ? _staging->materials : _materials; }
+    SLVMesh&      meshes() { return _staging ? _staging->meshes : _meshes; }
+    SLVGLTexture& textures() { return _staging ? _staging->textures : _textures; }
     SLVGLProgram& programs() { return _programs; }
     SLGLProgram*  programs(SLShaderProg i) { return _programs[i]; }
     SLNode*       selectedNode() { return _selectedNode; }
@@ -118,6 +142,12 @@ class SLScene : public SLObject
     SLVCVTracker& trackers() { return _trackers; }
     SLbool        showDetection() { return _showDetection; }
 
+    // Asynchronous loading
+    SLVAssimpImporter&   asyncImporters() { return _asyncImporters; }
+    SLGLTextureStreamer& textureStreamer() { return _textureStreamer; }
+    static void          staging(SLSceneStaging* staging) { _staging = staging; }
+    void                 addStaging(SLSceneStaging& staging);
+
     cbOnSceneLoad onLoad; //!< C-Callback for scene load
 
     // Misc.
@@ -148,7 +178,8 @@ class SLScene : public SLObject
     SLMesh*  _selectedMesh; //!< Pointer to the selected mesh
     SLRectf  _selectedRect; //!< Mouse selection rectangle
 
-    SLTimer _timer;           //!< high precision timer
+    SLTimer          _timer;          //!< high precision timer
+    SLFrameScheduler _frameScheduler; //!< Paces the frames & tracks the dirty sources
     SLCol4f _globalAmbiLight; //!< global ambient light intensity
     SLbool  _rootInitialized; //!< Flag if scene is initialized
     SLint   _numProgsPreload; //!< No. of preloaded shaderProgs
@@ -157,6 +188,7 @@ class SLScene : public SLObject
     SLfloat    _lastUpdateTimeMS; //!< Last time after update in ms
     SLfloat    _fps;              //!< Averaged no. of frames per second
     SLAvgFloat _updateTimesMS;    //!< Averaged time for update in ms
+    SLAvgFloat _skinTimesMS;      //!< Averaged time for software skinning in ms
     SLAvgFloat _trackingTimesMS;  //!< Averaged time for video tracking in ms
     SLAvgFloat _detectTimesMS;    //!< Averaged time for video feature detection & description in ms
     SLAvgFloat _detect1TimesMS;   //!< Averaged time for video feature detection subpart 1 in ms
@@ -180,6 +212,11 @@ class SLScene : public SLObject
     SLGLTexture  _videoTextureErr; //!< Texture for live video error
     SLVCVTracker _trackers;        //!< Vector of all AR trackers
     SLbool       _showDetection;   //!< Flag if detection should be visualized
+
+    // Asynchronous loading
+    SLVAssimpImporter                   _asyncImporters; //!< Vector of all running asynchronous imports
+    static thread_local SLSceneStaging* _staging;        //!< Staging of the current loader thread
+    SLGLTextureStreamer                 _textureStreamer; //!< Decodes & uploads the 2D textures
 };
 //-----------------------------------------------------------------------------
 #endif
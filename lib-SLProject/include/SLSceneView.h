@@ -22,6 +22,7 @@
 #include <SLRaytracer.h>
 #include <SLScene.h>
 #include <SLSkybox.h>
+#include <SLTextBatcher.h>
 
 //-----------------------------------------------------------------------------
 class SLCamera;
@@ -158,6 +159,7 @@ class SLSceneView : public SLObject
     SLint         scrHdiv2() const { return _scrHdiv2; }
     SLfloat       scrWdivH() const { return _scrWdivH; }
     SLGLImGui&    gui() { return _gui; }
+    SLTextBatcher& textBatcher() { return _textBatcher; }
     SLbool        gotPainted() const { return _gotPainted; }
     SLbool        hasMultiSampling() const { return _stateGL->hasMultiSampling(); }
     SLbool        doFrustumCulling() const { return _doFrustumCulling; }
@@ -206,14 +208,15 @@ class SLSceneView : public SLObject
     SLfloat _draw3DTimeMS; //!< time for 3D drawing in ms
     SLfloat _draw2DTimeMS; //!< time for 2D drawing in ms
 
-    SLbool             _mouseDownL; //!< Flag if left mouse button is pressed
-    SLbool             _mouseDownR; //!< Flag if right mouse button is pressed
-    SLbool             _mouseDownM; //!< Flag if middle mouse button is pressed
-    SLKey              _mouseMod;   //!< mouse modifier key on key down
-    SLint              _touchDowns; //!< finger touch down count
-    SLVec2i            _touch[3];   //!< up to 3 finger touch coordinates
-    SLGLVertexArrayExt _vaoTouch;   //!< Buffer for touch pos. rendering
-    SLGLVertexArrayExt _vaoCursor;  //!< Virtual cursor for stereo rendering
+    SLbool             _mouseDownL;  //!< Flag if left mouse button is pressed
+    SLbool             _mouseDownR;  //!< Flag if right mouse button is pressed
+    SLbool             _mouseDownM;  //!< Flag if middle mouse button is pressed
+    SLKey              _mouseMod;    //!< mouse modifier key on key down
+    SLint              _touchDowns;  //!< finger touch down count
+    SLVec2i            _touch[3];    //!< up to 3 finger touch coordinates
+    SLGLVertexArrayExt _vaoTouch;    //!< Buffer for touch pos. rendering
+    SLGLVertexArrayExt _vaoCursor;   //!< Virtual cursor for stereo rendering
+    SLTextBatcher      _textBatcher; //!< Draws all texts of a pass in one call
 
     SLint   _scrW;     //!< Screen width in pixels
     SLint   _scrH;     //!< Screen height in pixels
@@ -11,6 +11,7 @@
 #ifndef SLSKELETON_H
 #define SLSKELETON_H
 
+#include <SLAnimLOD.h>
 #include <SLAnimPlayback.h>
 #include <SLAnimation.h>
 #include <SLJoint.h>
@@ -33,19 +34,12 @@ by which it can be influenced.
 SLAnimations for this skeleton are also kept in this class. The SLAnimations
 have tracks corresponding to the individual SLJoints in the skeleton.
 
-@note   The current implementation doesn't support multiple instances of the same
-        skeleton animation. It is however not that far away from supporting it.
-        Currently the SLSkeleton class keeps both a SLAnimation map
-        and an SLAnimPlayback map. We can split this into two classes
-        by creating an SLSkeletonInstance class we that keeps the
-        SLAnimPlayback map that references its parent SLSkeleton
-        we would be able to create multiple SLSkeletonInstance instances
-        that use the same SLAnimations but with different states.
-
-        This leaves the problem of SLMesh that is not able to be instantiated
-        without copying the data into a completely separate SLMesh. But the
-        solution for SLMesh would take the same approach by creating a
-        mesh instance class that is able to use SLSkeletonInstance.
+@note   An SLSkeleton itself can only be in one animation state. Multiple
+        independently animated instances of the same skeleton are created
+        with SLAnimManager::createSkeletonInstance. An SLSkeletonInstance
+        shares the joint hierarchy, the animations and the meshes but keeps
+        its own SLAnimPlayback map and joint matrices. The meshes are then
+        skinned on the GPU per instance (see SLMesh::draw).
 
 @note   The current version of the SLAssimpImporter only supports the loading of a single animation.
         This limitation is mainly because there are very few 3D programs
@@ -66,6 +60,7 @@ class SLSkeleton
     void loadAnimation(const SLstring& file);
     void addAnimation(SLAnimation* anim);
     void getJointMatrices(SLVMat4f& jointWM);
+    void updateJointMatrices();
     void reset();
 
     // Getters
@@ -77,6 +72,9 @@ class SLSkeleton
     SLint           numJoints() const { return (SLint)_joints.size(); }
     const SLVJoint& joints() const { return _joints; }
     SLJoint*        rootJoint() { return _rootJoint; }
+    const SLVMat4f& jointMatrices() const { return _jointMatrices; }
+    SLAnimLOD&      lod() { return _lod; }
+    SLAnimLODUpdate lastUpdate() const { return _lastUpdate; }
     SLbool          changed() const { return _changed; }
     const SLVec3f&  minOS();
     const SLVec3f&  maxOS();
@@ -98,10 +96,13 @@ class SLSkeleton
     SLVJoint        _joints;          //!< joint vector for fast access and index to joint mapping
     SLMAnimation    _animations;      //!< map of animations for this skeleton
     SLMAnimPlayback _animPlaybacks;   //!< map of animation playbacks for this skeleton
+    SLVMat4f        _jointMatrices;   //!< final joint matrices shared by all skinned meshes
     SLbool          _changed;         //!< did this skeleton change this frame (attribute for skeleton instance)
     SLVec3f         _minOS;           //!< min point in os for this skeleton (attribute for skeleton instance)
     SLVec3f         _maxOS;           //!< max point in os for this skeleton (attribute for skeleton instance)
     SLbool          _minMaxOutOfDate; //!< dirty flag aabb rebuild
+    SLAnimLODUpdate _lastUpdate;      //!< kind of the last animation update
+    SLAnimLOD       _lod;             //!< animation level of detail policy
 };
 //-----------------------------------------------------------------------------
 typedef std::vector<SLSkeleton*> SLVSkeleton;
@@ -0,0 +1,83 @@
+//#############################################################################
+//  File:      SLSkeletonInstance.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLSKELETONINSTANCE_H
+#define SLSKELETONINSTANCE_H
+
+#include <SLAnimClip.h>
+#include <SLAnimLOD.h>
+#include <SLAnimPlayback.h>
+
+class SLSkeleton;
+
+//-----------------------------------------------------------------------------
+//! SLSkeletonInstance is an independently animated copy of an SLSkeleton
+/*!
+An SLSkeleton owns its joints as SLJoint nodes and can therefore only be in
+one animation state at a time. An SLSkeletonInstance references a parent
+skeleton and shares its joint hierarchy, animations and meshes but has its own
+animation playbacks and its own joint matrix palette. This allows crowds of
+characters that all play the same animations with different phases, speeds
+and weights (see SLAnimManager::createSkeletonInstance).
+
+The instance doesn't touch any SLJoint: The animations are evaluated with
+their compiled SLAnimClip into plain local joint matrices that are
+concatenated along the joint hierarchy. The final joint matrices (palette) are
+uploaded to the skinning vertex shader in SLMesh::draw for every node that
+refers to the instance (see SLNode::skeletonInstance). Instances with more
+joints than SLSkeletonInstance::maxJointsGPU are drawn with the CPU skinned
+meshes of their skeleton. The instances are
+independent of each other and are updated in parallel by SLAnimManager::update.
+
+The instance playbacks are not added to SLAnimManager::allAnimPlaybacks to
+keep the UI lists short with many instances.
+*/
+class SLSkeletonInstance
+{
+    public:
+    SLSkeletonInstance(SLSkeleton* skeleton);
+    ~SLSkeletonInstance();
+
+    SLbool updateAnimations(SLfloat elapsedTimeSec);
+
+    // Getters
+    SLSkeleton*     skeleton() { return _skeleton; }
+    SLAnimPlayback* animPlayback(const SLstring& name);
+    const SLVMat4f& jointMatrices() const { return _jointMatrices; }
+    SLbool          changed() const { return _changed; }
+    SLAnimLOD&      lod() { return _lod; }
+    SLAnimLODUpdate lastUpdate() const { return _lastUpdate; }
+
+    // Setters
+    void changed(SLbool changed) { _changed = changed; }
+
+    static SLuint maxJointsGPU();
+
+    private:
+    void updateJointMatrices();
+
+    SLSkeleton*     _skeleton;      //!< parent skeleton with the joint hierarchy
+    SLMAnimPlayback _animPlaybacks; //!< own playbacks of the skeleton animations
+    SLVint          _parentIDs;     //!< parent joint ID per joint ID (-1 for root)
+    SLVuint         _jointOrder;    //!< joint IDs with parents before children
+    SLVMat4f        _initialMats;   //!< initial local joint matrices
+    SLVMat4f        _offsetMats;    //!< joint offset (inverse bind) matrices
+    SLVMat4f        _localMats;     //!< local joint matrices of the current pose
+    SLVMat4f        _worldMats;     //!< joint matrices in skeleton space
+    SLVMat4f        _jointMatrices; //!< final joint matrices for skinning
+    SLAnimPose      _pose;          //!< pose buffer for the clip evaluation
+    SLbool          _changed;       //!< did this instance change this frame
+    SLAnimLODUpdate _lastUpdate;    //!< kind of the last animation update
+    SLAnimLOD       _lod;           //!< animation level of detail policy
+};
+//-----------------------------------------------------------------------------
+typedef std::vector<SLSkeletonInstance*> SLVSkeletonInstance;
+//-----------------------------------------------------------------------------
+#endif
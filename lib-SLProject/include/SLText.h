@@ -11,7 +11,6 @@
 #ifndef SLTEXT_H
 #define SLTEXT_H
 
-#include <SLGLVertexArray.h>
 #include <SLNode.h>
 #include <SLTexFont.h>
 
@@ -25,6 +24,10 @@ class SLAABBox;
 The text is passed as standard string that can contain line breaks (\\n).
 Line breaks are only inserted if a maxWidth is defined. If the lineHeightFactor
 is 1.0 the minimal line spacing is used.
+\n
+The character quads are only rebuilt if the text changes. They are not drawn
+by the text itself but added to the SLTextBatcher of the scene view that draws
+all texts in one draw call.
 */
 class SLText : public SLNode
 {
@@ -45,6 +48,10 @@ class SLText : public SLNode
 
     void preShade(SLRay* ray) { ; }
 
+    // Setters
+    void text(SLstring text);
+    void color(SLCol4f color) { _color = color; }
+
     // Getters
     SLstring text() { return _text; }
     SLCol4f  color() { return _color; }
@@ -55,12 +62,14 @@ class SLText : public SLNode
     SLint    length() { return (SLint)_text.length(); }
 
     protected:
-    SLstring        _text;  //!< Text of the button
-    SLTexFont*      _font;  //!< Font pointer of the preloaded font
-    SLCol4f         _color; //!< RGBA-Color of the text
-    SLfloat         _maxW;  //!< Max. width in pix. for wrapped text
-    SLfloat         _lineH; //!< Line height factor for wrapped text
-    SLGLVertexArray _vao;   //!< Vertex array for rendering
+    SLstring   _text;    //!< Text of the button
+    SLTexFont* _font;    //!< Font pointer of the preloaded font
+    SLCol4f    _color;   //!< RGBA-Color of the text
+    SLfloat    _maxW;    //!< Max. width in pix. for wrapped text
+    SLfloat    _lineH;   //!< Line height factor for wrapped text
+    SLVVec3f   _P;       //!< Vertex positions of the character quads
+    SLVVec2f   _T;       //!< Texture coords. of the character quads
+    SLbool     _isDirty; //!< Flag if the quads need to be rebuilt
 };
 //-----------------------------------------------------------------------------
 #endif //SLSPHERE_H
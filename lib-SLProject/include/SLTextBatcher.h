@@ -0,0 +1,62 @@
+//#############################################################################
+//  File:      SLTextBatcher.h
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLTEXTBATCHER_H
+#define SLTEXTBATCHER_H
+
+#include <SL.h>
+#include <SLGLVertexArray.h>
+#include <SLMat4.h>
+
+//-----------------------------------------------------------------------------
+//! Collects the character quads of all texts and draws them in one draw call
+/*!
+Every SLText adds its character quads with SLTextBatcher::add during the
+draw pass of the scene view. The quads get transformed with the current
+modelview matrix into the view space and get the text color as vertex
+attribute. SLTextBatcher::flush draws all collected quads with the glyph atlas
+of SLTexFont in a single draw call with the current projection matrix.
+\n
+The vertex buffer is persistent and only regenerated if the NO. of quads
+exceeds its capacity. Otherwise the vertex attributes are only updated.
+The scene view flushes after the blended 3D nodes and after the 2D nodes.
+The indices are 16 bit because OpenGL ES 2.0 supports 32 bit indices only
+with an extension. A batch therefore holds at most maxVertices vertices and
+gets flushed in between if more are added.
+*/
+class SLTextBatcher
+{
+    public:
+    SLTextBatcher();
+
+    void add(const SLVVec3f& P,
+             const SLVVec2f& T,
+             const SLCol4f&  color,
+             const SLMat4f&  mv);
+    void flush();
+
+    // Getters
+    SLuint numQuads() { return _numVertices / 4; }
+
+    static const SLuint maxVertices = 65536; //!< Max. NO. of vertices per batch
+
+    private:
+    void reserve(SLuint numVertices);
+
+    SLVVec3f        _P;           //!< Vertex positions in view space
+    SLVVec2f        _T;           //!< Vertex texture coords in the glyph atlas
+    SLVCol4f        _C;           //!< Vertex text colors
+    SLVushort       _I;           //!< Triangle indices of all quads
+    SLuint          _numVertices; //!< NO. of vertices added since the last flush
+    SLuint          _capacity;    //!< NO. of vertices in the vertex buffer
+    SLGLVertexArray _vao;         //!< Vertex array of all quads
+};
+//-----------------------------------------------------------------------------
+#endif //SLTEXTBATCHER_H
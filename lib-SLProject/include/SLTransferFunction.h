@@ -18,6 +18,7 @@
 
 class SLScene;
 class SLSceneView;
+class SLVolumeOccupancy;
 
 //-----------------------------------------------------------------------------
 //! Predefined color lookup tables
@@ -80,18 +81,21 @@ class SLTransferFunction : public SLGLTexture
 
     // Setters
     void colors(SLColorLUT lut);
+    void occupancy(SLVolumeOccupancy* occ) { _occupancy = occ; }
 
     // Getters
-    SLuint            length() { return _length; }
-    SLVTransferColor& colors() { return _colors; }
-    SLVTransferAlpha& alphas() { return _alphas; }
-    SLVfloat          allAlphas();
+    SLuint             length() { return _length; }
+    SLVTransferColor&  colors() { return _colors; }
+    SLVTransferAlpha&  alphas() { return _alphas; }
+    SLVfloat           allAlphas();
+    SLVolumeOccupancy* occupancy() { return _occupancy; }
 
     private:
-    SLuint           _length;   //! Length of transfer function (default 256)
-    SLColorLUT       _colorLUT; //! Color LUT identifier
-    SLVTransferColor _colors;   //! vector of colors in TF
-    SLVTransferAlpha _alphas;   //! vector of alphas in TF
+    SLuint             _length;    //! Length of transfer function (default 256)
+    SLColorLUT         _colorLUT;  //! Color LUT identifier
+    SLVTransferColor   _colors;    //! vector of colors in TF
+    SLVTransferAlpha   _alphas;    //! vector of alphas in TF
+    SLVolumeOccupancy* _occupancy; //! Brick occupancy grid that depends on the alphas
 };
 //-----------------------------------------------------------------------------
 #endif
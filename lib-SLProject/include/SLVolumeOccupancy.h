@@ -0,0 +1,66 @@
+//#############################################################################
+//  File:      SLVolumeOccupancy.h
+//  Purpose:   Declares the brick occupancy grid for volume ray casting
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#ifndef SLVOLUMEOCCUPANCY_H
+#define SLVOLUMEOCCUPANCY_H
+
+#include <SL.h>
+#include <SLGLTexture.h>
+
+class SLTransferFunction;
+
+//-----------------------------------------------------------------------------
+//! A 3D texture that marks the bricks of a volume that are not transparent
+/*! The volume texture is divided into bricks of brickSize^3 voxels. For each
+brick the min. and max. value of the voxel channel that the transfer function
+maps is calculated once in the constructor. The bricks include the neighbour
+voxels that the linear texture filter reads at the brick borders.
+\n
+A brick is occupied if any alpha value of the transfer function between the
+min. and max. value of the brick is above zero. This is tested with a prefix
+count of the nonzero alphas in constant time per brick. If the alphas of the
+transfer function change (SLTransferFunction::generateTexture calls update)
+only the bricks whose value range overlaps the changed part of the transfer
+function are tested again.
+\n
+The occupancy grid is a 3D texture with one byte per brick (0 or 255) that
+the ray cast shaders (VolumeRenderingRayCast*.frag) sample with GL_NEAREST.
+A ray in an empty brick jumps to the first sample behind the brick.
+*/
+class SLVolumeOccupancy : public SLGLTexture
+{
+    public:
+    SLVolumeOccupancy(SLGLTexture*        volume,
+                      SLTransferFunction* tf,
+                      SLint               channel,
+                      SLint               brickSize = 8);
+
+    SLuint update();
+
+    // Getters
+    SLint  brickSize() { return _brickSize; }
+    SLuint numBricks() { return (SLuint)_brickMin.size(); }
+    SLuint numOccupied() { return _numOccupied; }
+
+    private:
+    void calcMinMax(SLGLTexture* volume, SLint channel);
+
+    SLTransferFunction* _tf;          //!< Transfer function that maps the voxels
+    SLint               _brickSize;   //!< NO. of voxels per brick side
+    SLint               _bricksX;     //!< NO. of bricks in x
+    SLint               _bricksY;     //!< NO. of bricks in y
+    SLint               _bricksZ;     //!< NO. of bricks in z
+    SLVuchar            _brickMin;    //!< min. voxel value of each brick
+    SLVuchar            _brickMax;    //!< max. voxel value of each brick
+    SLVuchar            _lutVisible;  //!< Flags of the nonzero alphas of the last update
+    SLuint              _numOccupied; //!< NO. of occupied bricks
+};
+//-----------------------------------------------------------------------------
+#endif
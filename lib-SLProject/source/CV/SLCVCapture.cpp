@@ -30,6 +30,9 @@ for a good top down information.
 // Global static variables
 SLCVMat          SLCVCapture::lastFrame;
 SLCVMat          SLCVCapture::lastFrameGray;
+SLCVMat          SLCVCapture::lastFrameUndistorted;
+SLCVMat          SLCVCapture::_captureFrame;
+SLCVMat          SLCVCapture::_adjustedFrame;
 SLPixelFormat    SLCVCapture::format;
 cv::VideoCapture SLCVCapture::_captureDevice;
 SLCVSize         SLCVCapture::captureSize;
@@ -136,19 +139,20 @@ void SLCVCapture::grabAndAdjustForSL()
     {
         if (_captureDevice.isOpened())
         {
-            if (!_captureDevice.read(lastFrame))
+            SLbool isRead = _captureDevice.read(_captureFrame);
+
+            // Try to loop the video
+            if (!isRead && videoFilename != "" && videoLoops)
             {
-                // Try to loop the video
-                if (videoFilename != "" && videoLoops)
-                {
-                    _captureDevice.set(CV_CAP_PROP_POS_FRAMES, 0);
-                    if (!_captureDevice.read(lastFrame))
-                        return;
-                }
-                else
-                    return;
+                _captureDevice.set(CV_CAP_PROP_POS_FRAMES, 0);
+                isRead = _captureDevice.read(_captureFrame);
             }
 
+            // A failed read releases the capture frame and so the last frame
+            lastFrame = _captureFrame;
+            if (!isRead)
+                return;
+
             adjustForSL();
         }
         else
@@ -179,6 +183,7 @@ crop it on the sides.
 2) Some cameras toward a face mirror the image and some do not. If a input
 image should be mirrored or not is stored in SLCVCalibration::_isMirroredH
 (H for horizontal) and SLCVCalibration::_isMirroredV (V for vertical).
+The cropping and mirroring is fused into one copy into a reused buffer.
 \n
 3) Many of the further processing steps are faster done on grayscale images.
 We therefore create a copy that is grayscale converted.
@@ -195,59 +200,56 @@ void SLCVCapture::adjustForSL()
     // 1) Cropping //
     /////////////////
 
-    // Cropping is done almost always.
-    // So this is Android image copy loop #2
+    // Cropping is done almost always. The crop rectangle is only a view into
+    // the captured frame. The pixels are copied only once together with the
+    // mirroring in step 2. So this and step 2 is Android image copy loop #2
 
-    SLfloat inWdivH  = (SLfloat)lastFrame.cols / (SLfloat)lastFrame.rows;
-    SLfloat outWdivH = s->sceneViews()[0]->scrWdivH();
+    SLfloat  inWdivH  = (SLfloat)lastFrame.cols / (SLfloat)lastFrame.rows;
+    SLfloat  outWdivH = s->sceneViews()[0]->scrWdivH();
+    SLCVRect cropRect(0, 0, lastFrame.cols, lastFrame.rows);
 
     if (SL_abs(inWdivH - outWdivH) > 0.01f)
     {
-        SLint width  = 0; // width in pixels of the destination image
-        SLint height = 0; // height in pixels of the destination image
-        SLint cropH  = 0; // crop height in pixels of the source image
-        SLint cropW  = 0; // crop width in pixels of the source image
-
         if (inWdivH > outWdivH) // crop input image left & right
         {
-            width  = (SLint)((SLfloat)lastFrame.rows * outWdivH);
-            height = lastFrame.rows;
-            cropW  = (SLint)((SLfloat)(lastFrame.cols - width) * 0.5f);
+            cropRect.width = (SLint)((SLfloat)lastFrame.rows * outWdivH);
+            cropRect.x     = (SLint)((SLfloat)(lastFrame.cols - cropRect.width) * 0.5f);
         }
         else // crop input image at top & bottom
         {
-            width  = lastFrame.cols;
-            height = (SLint)((SLfloat)lastFrame.cols / outWdivH);
-            cropH  = (SLint)((SLfloat)(lastFrame.rows - height) * 0.5f);
+            cropRect.height = (SLint)((SLfloat)lastFrame.cols / outWdivH);
+            cropRect.y      = (SLint)((SLfloat)(lastFrame.rows - cropRect.height) * 0.5f);
         }
-        lastFrame(SLCVRect(cropW, cropH, width, height)).copyTo(lastFrame);
-        //imwrite("AfterCropping.bmp", lastFrame);
     }
 
+    SLbool  needsCropping = cropRect.size() != lastFrame.size();
+    SLCVMat croppedView   = lastFrame(cropRect);
+
     //////////////////
     // 2) Mirroring //
     //////////////////
 
-    // Mirroring is done for most selfie cameras.
-    // So this is Android image copy loop #3
+    // Mirroring is done for most selfie cameras. The flip reads directly from
+    // the crop view and writes into the reused _adjustedFrame buffer. The
+    // frames are captured into the separate _captureFrame buffer, so the two
+    // buffers never alias and keep their memory from frame to frame.
 
-    if (SLApplication::activeCalib->isMirroredH())
-    {
-        SLCVMat mirrored;
-        if (SLApplication::activeCalib->isMirroredV())
-            cv::flip(SLCVCapture::lastFrame, mirrored, -1);
-        else
-            cv::flip(SLCVCapture::lastFrame, mirrored, 1);
-        SLCVCapture::lastFrame = mirrored;
-    }
-    else if (SLApplication::activeCalib->isMirroredV())
+    SLbool mirrorH = SLApplication::activeCalib->isMirroredH();
+    SLbool mirrorV = SLApplication::activeCalib->isMirroredV();
+
+    if (mirrorH || mirrorV || needsCropping)
     {
-        SLCVMat mirrored;
-        if (SLApplication::activeCalib->isMirroredH())
-            cv::flip(SLCVCapture::lastFrame, mirrored, -1);
+        if (mirrorH && mirrorV)
+            cv::flip(croppedView, _adjustedFrame, -1);
+        else if (mirrorH)
+            cv::flip(croppedView, _adjustedFrame, 1);
+        else if (mirrorV)
+            cv::flip(croppedView, _adjustedFrame, 0);
         else
-            cv::flip(SLCVCapture::lastFrame, mirrored, 0);
-        SLCVCapture::lastFrame = mirrored;
+            croppedView.copyTo(_adjustedFrame);
+
+        lastFrame = _adjustedFrame;
+        //imwrite("AfterCropping.bmp", lastFrame);
     }
 
     /////////////////////////
@@ -284,13 +286,15 @@ void SLCVCapture::loadIntoLastFrame(const SLint         width,
         SLCVMat yuv(height + height / 2, width, CV_8UC1, (void*)data);
 
         // Android image copy loop #1
-        cvtColor(yuv, SLCVCapture::lastFrame, CV_YUV2RGB_NV21, 3);
+        cvtColor(yuv, _captureFrame, CV_YUV2RGB_NV21, 3);
+        SLCVCapture::lastFrame = _captureFrame;
     }
     // convert 4 channel images to 3 channel
     else if (format == PF_bgra || format == PF_rgba)
     {
         SLCVMat rgba(height, width, CV_8UC4, (void*)data);
-        cvtColor(rgba, SLCVCapture::lastFrame, CV_RGBA2RGB, 3);
+        cvtColor(rgba, _captureFrame, CV_RGBA2RGB, 3);
+        SLCVCapture::lastFrame = _captureFrame;
     }
     else
     {
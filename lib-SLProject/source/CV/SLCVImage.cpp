@@ -391,9 +391,10 @@ SLCVImage::load(SLint         width,
 }
 //-----------------------------------------------------------------------------
 //! Loads the image with the appropriate image loader
-void SLCVImage::load(const SLstring filename,
-                     SLbool         flipVertical,
-                     SLbool         loadGrayscaleIntoAlpha)
+SLbool SLCVImage::load(const SLstring filename,
+                       SLbool         flipVertical,
+                       SLbool         loadGrayscaleIntoAlpha,
+                       SLbool         exitOnFailure)
 {
     SLstring ext = SLUtils::getFileExt(filename);
     _name        = SLUtils::getFileName(filename);
@@ -404,6 +405,7 @@ void SLCVImage::load(const SLstring filename,
 
     if (!_cvMat.data)
     {
+        if (!exitOnFailure) return false;
         SLstring msg = "SLCVImage.load: Loading failed: " + filename;
         SL_EXIT_MSG(msg.c_str());
     }
@@ -462,6 +464,94 @@ void SLCVImage::load(const SLstring filename,
     // OpenCV loads top-left but OpenGL is bottom left
     if (flipVertical)
         flipY();
+
+    return true;
+}
+//-----------------------------------------------------------------------------
+/*! Reads the size and the alpha flag of a PNG or JPEG file from its header
+without decoding the pixel data. The alpha flag matches the format that load
+returns: A PNG gets an alpha channel with an alpha color type or a tRNS chunk.
+\return false for all other file formats or an unreadable header
+*/
+SLbool SLCVImage::readInfo(const SLstring filename,
+                           SLuint&        width,
+                           SLuint&        height,
+                           SLbool&        hasAlpha)
+{
+    ifstream file(filename, ios::binary);
+    if (!file) return false;
+
+    SLuchar buf[8];
+    if (!file.read((char*)buf, 2)) return false;
+
+    // Big endian 16 & 32 bit integers of the headers
+    auto read = [&](SLint numBytes) -> SLuint {
+        SLuint value = 0;
+        if (!file.read((char*)buf, numBytes)) return 0;
+        for (SLint i = 0; i < numBytes; ++i)
+            value = (value << 8) | buf[i];
+        return value;
+    };
+
+    // PNG: IHDR is the 1st chunk. Only chunks before IDAT can add a tRNS.
+    if (buf[0] == 0x89 && buf[1] == 'P')
+    {
+        static const SLuchar signature[6] = {'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+        if (!file.read((char*)buf, 6) || memcmp(buf, signature, 6) != 0)
+            return false;
+
+        SLuint length = read(4);
+        if (!file.read((char*)buf, 4) || memcmp(buf, "IHDR", 4) != 0 || length < 13)
+            return false;
+        width  = read(4);
+        height = read(4);
+        if (!file.read((char*)buf, 2)) return false;
+        hasAlpha = (buf[1] & 4) != 0; // color types 4 (gray alpha) & 6 (RGBA)
+        file.seekg(length - 10 + 4, ios::cur); // rest of IHDR & CRC
+
+        while (!hasAlpha)
+        {
+            length = read(4);
+            if (!file.read((char*)buf, 4) || memcmp(buf, "IDAT", 4) == 0)
+                break;
+            hasAlpha = memcmp(buf, "tRNS", 4) == 0;
+            file.seekg(length + 4, ios::cur);
+        }
+        return width > 0 && height > 0;
+    }
+
+    // JPEG: The size is in the start of frame segment (SOF0 - SOF15)
+    if (buf[0] == 0xFF && buf[1] == 0xD8)
+    {
+        hasAlpha = false;
+        while (file.read((char*)buf, 1))
+        {
+            if (buf[0] != 0xFF) return false;
+
+            SLuchar marker = 0xFF;
+            while (marker == 0xFF && file.read((char*)&marker, 1)) {}
+            if (!file) return false;
+
+            // Markers without a segment length
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+                continue;
+
+            SLuint length = read(2);
+            if (length < 2) return false;
+
+            if (marker >= 0xC0 && marker <= 0xCF &&
+                marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+            {
+                read(1); // precision
+                height = read(2);
+                width  = read(2);
+                return width > 0 && height > 0;
+            }
+            file.seekg(length - 2, ios::cur);
+        }
+    }
+
+    return false;
 }
 //-----------------------------------------------------------------------------
 //! Converts OpenCV mat type to OpenGL pixel format
@@ -23,6 +23,64 @@ for a good top down information.
 using namespace cv;
 using namespace std;
 
+//-----------------------------------------------------------------------------
+// Static ROI prediction parameters
+SLfloat SLCVTracked::roiMargin            = 0.5f;
+SLint   SLCVTracked::roiFullFrameInterval = 30;
+//-----------------------------------------------------------------------------
+/*! Returns the region of interest for the detection in the current frame. If
+no prediction is possible or a periodic full frame search is due, the full
+image rectangle is returned. Otherwise the last bounding rectangle is moved by
+its last displacement and enlarged by roiMargin on each side.
+@param imageSize Size of the full video frame
+@return Image rectangle to run the detection on
+*/
+SLCVRect SLCVTracked::predictROI(const SLCVSize& imageSize)
+{
+    SLCVRect fullFrame(0, 0, imageSize.width, imageSize.height);
+
+    if (!_useROI || !_roiIsValid || _framesSinceFullFrame >= roiFullFrameInterval)
+    {
+        _framesSinceFullFrame = 0;
+        return fullFrame;
+    }
+
+    _framesSinceFullFrame++;
+
+    // Constant velocity prediction of the rectangle center
+    SLCVRect predicted = _lastRect;
+    if (_prevRect.area() > 0)
+    {
+        predicted.x += _lastRect.x - _prevRect.x;
+        predicted.y += _lastRect.y - _prevRect.y;
+    }
+
+    SLint marginX = (SLint)(predicted.width * roiMargin);
+    SLint marginY = (SLint)(predicted.height * roiMargin);
+    predicted.x -= marginX;
+    predicted.y -= marginY;
+    predicted.width += 2 * marginX;
+    predicted.height += 2 * marginY;
+
+    SLCVRect roi = predicted & fullFrame;
+    return roi.area() > 0 ? roi : fullFrame;
+}
+//-----------------------------------------------------------------------------
+/*! Stores the bounding rectangle of the detected image points in full frame
+coordinates for the ROI prediction of the next frame.
+*/
+void SLCVTracked::updateROI(const SLCVVPoint2f& points)
+{
+    if (points.empty())
+    {
+        resetROI();
+        return;
+    }
+
+    _prevRect   = _roiIsValid ? _lastRect : SLCVRect();
+    _lastRect   = cv::boundingRect(points);
+    _roiIsValid = true;
+}
 // clang-format off
 //-----------------------------------------------------------------------------
 //! Create an OpenGL 4x4 matrix from an OpenCV translation & rotation vector
@@ -80,7 +80,12 @@ SLbool SLCVTrackedAruco::track(SLCVMat          imageGray,
         objectViewMats.clear();
         SLCVVVPoint2f corners, rejected;
 
-        aruco::detectMarkers(imageGray,
+        // The ROI of the tracker that does the shared detection covers all
+        // markers found in the last frame. New markers outside of it are
+        // found with the periodic full frame search.
+        SLCVRect roi = predictROI(imageGray.size());
+
+        aruco::detectMarkers(imageGray(roi),
                              params.dictionary,
                              corners,
                              arucoIDs,
@@ -91,6 +96,18 @@ SLbool SLCVTrackedAruco::track(SLCVMat          imageGray,
 
         if (arucoIDs.size() > 0)
         {
+            // Transform the corners back into full frame coordinates
+            SLCVVPoint2f allCorners;
+            for (auto& markerCorners : corners)
+            {
+                for (auto& corner : markerCorners)
+                {
+                    corner += SLCVPoint2f((SLfloat)roi.x, (SLfloat)roi.y);
+                    allCorners.push_back(corner);
+                }
+            }
+            updateROI(allCorners);
+
             if (drawDetection)
             {
                 aruco::drawDetectedMarkers(imageRgb, corners, arucoIDs, Scalar(0, 0, 255));
@@ -123,6 +140,9 @@ SLbool SLCVTrackedAruco::track(SLCVMat          imageGray,
             }
             //cout << endl;
         }
+        else
+            resetROI();
+
         trackAllOnce = false;
     }
 
@@ -133,14 +153,16 @@ SLbool SLCVTrackedAruco::track(SLCVMat          imageGray,
         {
             if (arucoIDs[i] == _arucoID)
             {
+                _objectViewMat = objectViewMats[i];
+
                 // set the object matrix depending if the
                 // tracked node is attached to a camera or not
                 if (typeid(*_node) == typeid(SLCamera))
-                    _node->om(objectViewMats[i].inverted());
+                    _node->om(_objectViewMat.inverted());
                 else
                 {
                     _node->om(calcObjectMatrix(sv->camera()->om(),
-                                               objectViewMats[i]));
+                                               _objectViewMat));
                     _node->setDrawBitsRec(SL_DB_HIDDEN, false);
                 }
             }
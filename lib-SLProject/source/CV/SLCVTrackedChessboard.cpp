@@ -60,7 +60,10 @@ bool SLCVTrackedChessboard::track(SLCVMat          imageGray,
 
     SLCVVPoint2f corners2D;
 
-    _isVisible = cv::findChessboardCorners(imageGray,
+    // Search only in the predicted region of the last detection
+    SLCVRect roi = predictROI(imageGray.size());
+
+    _isVisible = cv::findChessboardCorners(imageGray(roi),
                                            calib->boardSize(),
                                            corners2D,
                                            flags);
@@ -69,6 +72,11 @@ bool SLCVTrackedChessboard::track(SLCVMat          imageGray,
 
     if (_isVisible)
     {
+        // Transform the corners back into full frame coordinates
+        for (auto& corner : corners2D)
+            corner += SLCVPoint2f((SLfloat)roi.x, (SLfloat)roi.y);
+
+        updateROI(corners2D);
 
         if (drawDetection)
         {
@@ -111,6 +119,8 @@ bool SLCVTrackedChessboard::track(SLCVMat          imageGray,
             return true;
         }
     }
+    else
+        resetROI();
 
     // Hide tracked node if not visible
     if (_node != sv->camera())
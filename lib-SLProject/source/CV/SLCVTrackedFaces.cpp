@@ -136,11 +136,28 @@ SLbool SLCVTrackedFaces::track(SLCVMat          imageGray,
     SLint     max = (SLint)(imageGray.rows * 0.8f); // the smaller max the faster
     SLCVSize  minSize(min, min);
     SLCVSize  maxSize(max, max);
-    _faceDetector->detectMultiScale(imageGray, faces, 1.05, 3, 0, minSize, maxSize);
 
-    // Enlarge the face rect at the bottom to cover also the chin
+    // Search only in the predicted region of the last face
+    SLCVRect roi = predictROI(imageGray.size());
+    if (roi.width < minSize.width || roi.height < minSize.height)
+        roi = SLCVRect(0, 0, imageGray.cols, imageGray.rows);
+
+    _faceDetector->detectMultiScale(imageGray(roi), faces, 1.05, 3, 0, minSize, maxSize);
+
+    // Enlarge the face rect at the bottom to cover also the chin and
+    // transform it back into full frame coordinates
     for (SLuint f = 0; f < faces.size(); ++f)
+    {
         faces[f].height = (SLint)(faces[f].height * 1.2f);
+        faces[f].x += roi.x;
+        faces[f].y += roi.y;
+    }
+
+    if (faces.empty())
+        resetROI();
+    else
+        updateROI({SLCVPoint2f((SLfloat)faces[0].x, (SLfloat)faces[0].y),
+                   SLCVPoint2f((SLfloat)faces[0].br().x, (SLfloat)faces[0].br().y)});
 
     SLfloat time2MS = s->timeMilliSec();
     s->detect1TimesMS().set(time2MS - startMS);
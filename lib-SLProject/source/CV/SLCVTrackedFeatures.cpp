@@ -40,7 +40,6 @@ double sum_reprojection_error    = 0.0;
 float  sum_poseopt_difference    = 0.0f;
 double translationError          = 0;
 double rotationError             = 0;
-int    frames_since_posefound    = 0;
 
 //-----------------------------------------------------------------------------
 SLCVTrackedFeatures::SLCVTrackedFeatures(SLNode*  node,
@@ -58,6 +57,9 @@ SLCVTrackedFeatures::SLCVTrackedFeatures(SLNode*  node,
     _prevFrame.inlierPoints2D       = SLCVVPoint2f(nFeatures);
     _forceRelocation                = false;
     _frameCount                     = 0;
+    _framesSincePoseFound           = 0;
+    _lastKeyFrameNo                 = 0;
+    _numRelocalizations             = 0;
 
     loadMarker(markerFilename);
 
@@ -137,6 +139,10 @@ void SLCVTrackedFeatures::initFeaturesOnMarker()
     _marker.keypoints3D.clear();
     _marker.descriptors.release();
 
+    // Cached keyframes are only valid for the same marker descriptors
+    _keyFrames.clear();
+    _lastKeyFrameNo = 0;
+
     // Detect and compute features in marker image
     _featureManager.detectAndDescribe(_marker.imageGray,
                                       _marker.keypoints2D,
@@ -212,7 +218,7 @@ void SLCVTrackedFeatures::type(SLCVDetectDescribeType ddType)
 @param calib Calibration information
 @param drawDetection Flag if the detected features should be drawn
 @param sv The current scene view
-@return So far allways false
+@return True if the pose was found in the current frame
 */
 SLbool SLCVTrackedFeatures::track(SLCVMat          imageGray,
                                   SLCVMat          image,
@@ -239,7 +245,7 @@ SLbool SLCVTrackedFeatures::track(SLCVMat          imageGray,
     _currentFrame.imageGray = imageGray;
 
     // Determine if relocation or feature tracking should be performed
-    bool relocationNeeded = _forceRelocation || !_prevFrame.foundPose || _prevFrame.inlierMatches.size() < 100 || frames_since_posefound < 3;
+    bool relocationNeeded = _forceRelocation || !_prevFrame.foundPose || _prevFrame.inlierMatches.size() < 100 || _framesSincePoseFound < 3;
 
     // If relocation condition meets, calculate the Pose with feature detection, otherwise
     // track the previous determined features
@@ -254,31 +260,222 @@ SLbool SLCVTrackedFeatures::track(SLCVMat          imageGray,
     // Perform OpenCV drawning if flags are set (see SLCVTrackedFeatures.h)
     drawDebugInformation(drawDetection);
 
+    SLbool foundPose = _currentFrame.foundPose;
+
     // Prepare next frame and transfer necessary data
     transferFrameData();
 
     _frameCount++;
 
-    return false;
+    return foundPose;
 }
 //-----------------------------------------------------------------------------
 /*! If relocation should be done, the following steps are necessary:
 1. Detect keypoints
 2. Describe keypoints (Binary descriptors)
-3. Match keypoints in current frame and the reference tracker
-4. Try to calculate new Pose with Perspective-n-SLCVPoint algorithm
+3. If the tracking was lost try the most similar cached keyframes first
+4. Match keypoints in current frame and the reference tracker
+5. Try to calculate new Pose with Perspective-n-SLCVPoint algorithm
+6. Add the frame to the keyframe cache if the pose is good enough
 */
 void SLCVTrackedFeatures::relocate()
 {
     _isTracking = false;
     detectKeypointsAndDescriptors();
-    _currentFrame.matches   = getFeatureMatches();
-    _currentFrame.foundPose = calculatePose();
+
+    SLCVMat thumbnail = createThumbnail(_currentFrame.imageGray);
+
+    // The keyframe poses are only a better guess if the last pose is lost
+    _currentFrame.foundPose = !_prevFrame.foundPose &&
+                              relocateWithKeyFrames(thumbnail);
+
+    if (!_currentFrame.foundPose)
+    {
+        _currentFrame.matches   = getFeatureMatches();
+        _currentFrame.foundPose = calculatePose();
+    }
+
+    if (_currentFrame.foundPose)
+    {
+        addKeyFrame(thumbnail);
+        if (!_prevFrame.foundPose) _numRelocalizations++;
+    }
 
     // Zero time keeping on the tracking branch
     SLScene* s = SLApplication::scene;
     s->optFlowTimesMS().set(0);
 }
+//-----------------------------------------------------------------------------
+/*! Returns a small blurred and zero mean normalized version of the grayscale
+image. The dot product of two thumbnails divided by the number of pixels is
+their normalized cross correlation in the range of -1 to 1.
+*/
+SLCVMat SLCVTrackedFeatures::createThumbnail(const SLCVMat& imageGray)
+{
+    SLCVMat small, thumbnail;
+    cv::resize(imageGray,
+               small,
+               SLCVSize(kfThumbnailWidth, kfThumbnailHeight),
+               0,
+               0,
+               INTER_AREA);
+    cv::GaussianBlur(small, small, SLCVSize(3, 3), 0);
+    small.convertTo(thumbnail, CV_32F);
+
+    Scalar mean, stdDev;
+    cv::meanStdDev(thumbnail, mean, stdDev);
+    thumbnail = (thumbnail - mean[0]) / std::max(stdDev[0], 1.0);
+    return thumbnail;
+}
+//-----------------------------------------------------------------------------
+/*! Tries to find the pose by matching the current frame only against the
+inlier descriptors of the cached keyframes with the most similar thumbnails.
+The pose of the keyframe is used as extrinsic guess for the RANSAC PnP. On
+success the current frame data is filled like in calculatePose.
+@param thumbnail Thumbnail of the current frame
+@return True if the pose was found with one of the keyframes
+*/
+SLbool SLCVTrackedFeatures::relocateWithKeyFrames(const SLCVMat& thumbnail)
+{
+    if (_keyFrames.empty() || _currentFrame.descriptors.empty())
+        return false;
+
+    SLScene* s       = SLApplication::scene;
+    SLfloat  startMS = s->timeMilliSec();
+
+    // Sort the keyframes by their thumbnail similarity
+    vector<pair<SLfloat, size_t>> candidates;
+    for (size_t i = 0; i < _keyFrames.size(); i++)
+    {
+        SLfloat similarity = (SLfloat)(thumbnail.dot(_keyFrames[i].thumbnail) /
+                                       (double)thumbnail.total());
+        if (similarity > kfMinSimilarity)
+            candidates.push_back(make_pair(similarity, i));
+    }
+    sort(candidates.rbegin(), candidates.rend());
+
+    for (size_t c = 0; c < candidates.size() && c < (size_t)kfMaxCandidates; c++)
+    {
+        const SLFeatureKeyFrame& kf = _keyFrames[candidates[c].second];
+
+        SLCVVVDMatch knnMatches;
+        _matcher->knnMatch(_currentFrame.descriptors, kf.descriptors, knnMatches, 2);
+
+        // Ratio test and conversion of the train index into marker space
+        SLCVVDMatch matches;
+        for (auto& m : knnMatches)
+        {
+            if (m.size() < 2) continue;
+            if (m[1].distance == 0.0f || (m[0].distance / m[1].distance) < minRatio)
+            {
+                SLCVDMatch match = m[0];
+                match.trainIdx   = kf.markerIdx[(SLuint)match.trainIdx];
+                matches.push_back(match);
+            }
+        }
+
+        if (matches.size() < (size_t)kfMinMatches) continue;
+
+        SLCVVPoint3f modelPoints(matches.size());
+        SLCVVPoint2f framePoints(matches.size());
+        for (size_t i = 0; i < matches.size(); i++)
+        {
+            modelPoints[i] = _marker.keypoints3D[(SLuint)matches[i].trainIdx];
+            framePoints[i] = _currentFrame.keypoints[(SLuint)matches[i].queryIdx].pt;
+        }
+
+        SLCVMat rvec = kf.rvec.clone();
+        SLCVMat tvec = kf.tvec.clone();
+        SLVint  inliers;
+        SLbool  foundPose = cv::solvePnPRansac(modelPoints,
+                                              framePoints,
+                                              _calib->cameraMat(),
+                                              _calib->distortion(),
+                                              rvec,
+                                              tvec,
+                                              true,
+                                              kfIterations,
+                                              reprojection_error,
+                                              confidence,
+                                              inliers,
+                                              SOLVEPNP_ITERATIVE);
+
+        if (!foundPose || inliers.size() < (size_t)kfMinInliers) continue;
+
+        _currentFrame.matches = matches;
+        _currentFrame.rvec    = rvec;
+        _currentFrame.tvec    = tvec;
+        for (SLint idx : inliers)
+        {
+            _currentFrame.inlierMatches.push_back(matches[(SLuint)idx]);
+            _currentFrame.inlierPoints2D.push_back(framePoints[(SLuint)idx]);
+            _currentFrame.inlierPoints3D.push_back(modelPoints[(SLuint)idx]);
+        }
+
+        // Same refinement as in calculatePose
+        optimizeMatches();
+        foundPose = cv::solvePnP(_currentFrame.inlierPoints3D,
+                                 _currentFrame.inlierPoints2D,
+                                 _calib->cameraMat(),
+                                 _calib->distortion(),
+                                 _currentFrame.rvec,
+                                 _currentFrame.tvec,
+                                 true,
+                                 SOLVEPNP_ITERATIVE);
+
+        s->poseTimesMS().set(s->timeMilliSec() - startMS);
+
+        if (foundPose) return true;
+
+        // Undo the partial results for the full marker search
+        _currentFrame.matches.clear();
+        _currentFrame.inlierMatches.clear();
+        _currentFrame.inlierPoints2D.clear();
+        _currentFrame.inlierPoints3D.clear();
+        _currentFrame.rvec = SLCVMat::zeros(3, 1, CV_64FC1);
+        _currentFrame.tvec = SLCVMat::zeros(3, 1, CV_64FC1);
+    }
+
+    return false;
+}
+//-----------------------------------------------------------------------------
+/*! Adds the current frame to the keyframe cache if it has enough inliers, is
+not too close in time to the last keyframe and differs enough from the cached
+ones. If the cache is full the oldest keyframe gets replaced.
+@param thumbnail Thumbnail of the current frame
+*/
+void SLCVTrackedFeatures::addKeyFrame(const SLCVMat& thumbnail)
+{
+    if (_currentFrame.inlierMatches.size() < (size_t)kfMinInliersToAdd) return;
+    if (!_keyFrames.empty() && _frameCount - _lastKeyFrameNo < kfMinFrameDistance) return;
+
+    size_t oldest = 0;
+    for (size_t i = 0; i < _keyFrames.size(); i++)
+    {
+        SLfloat similarity = (SLfloat)(thumbnail.dot(_keyFrames[i].thumbnail) /
+                                       (double)thumbnail.total());
+        if (similarity > kfMaxSimilarity) return;
+        if (_keyFrames[i].frameNo < _keyFrames[oldest].frameNo) oldest = i;
+    }
+
+    SLFeatureKeyFrame kf;
+    kf.thumbnail = thumbnail;
+    kf.rvec      = _currentFrame.rvec.clone();
+    kf.tvec      = _currentFrame.tvec.clone();
+    kf.frameNo   = _frameCount;
+    for (auto& match : _currentFrame.inlierMatches)
+    {
+        kf.descriptors.push_back(_currentFrame.descriptors.row(match.queryIdx));
+        kf.markerIdx.push_back(match.trainIdx);
+    }
+
+    if (_keyFrames.size() < (size_t)kfCacheSize)
+        _keyFrames.push_back(kf);
+    else
+        _keyFrames[oldest] = kf;
+
+    _lastKeyFrameNo = _frameCount;
+}
 
 //-----------------------------------------------------------------------------
 /*! To track the already detected keypoints after a sucessful pose estimation,
@@ -455,13 +652,13 @@ void SLCVTrackedFeatures::updateSceneCamera(SLSceneView* sv)
     if (_prevFrame.foundPose && !_currentFrame.foundPose)
     {
         sv->drawBits()->on(SL_DB_HIDDEN);
-        frames_since_posefound = 0;
+        _framesSincePoseFound = 0;
     }
     else if (_currentFrame.foundPose)
     {
-        if (frames_since_posefound == 5)
+        if (_framesSincePoseFound == 5)
             sv->drawBits()->off(SL_DB_HIDDEN);
-        frames_since_posefound++;
+        _framesSincePoseFound++;
     }
 }
 //-----------------------------------------------------------------------------
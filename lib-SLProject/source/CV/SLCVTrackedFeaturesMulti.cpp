@@ -0,0 +1,394 @@
+//#############################################################################
+//  File:      SLCVTrackedFeaturesMulti.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch, Michael Goettlicher
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+/*
+The OpenCV library version 3.4 or above with extra module must be present.
+If the application captures the live video stream with OpenCV you have
+to define in addition the constant SL_USES_CVCAPTURE.
+All classes that use OpenCV begin with SLCV.
+See also the class docs for SLCVCapture, SLCVCalibration and SLCVTracked
+for a good top down information.
+*/
+
+#include <SLApplication.h>
+#include <SLCVTrackedFeaturesMulti.h>
+#include <SLSceneView.h>
+
+using namespace cv;
+
+//-----------------------------------------------------------------------------
+// Matching and pose estimation parameters
+static const float  multiMinRatio          = 0.7f; //!< Max. ratio of 1st to 2nd best match
+static const int    multiMinMatches        = 10;   //!< Min. NO. of matches for PnP
+static const int    multiRansacIterations  = 300;  //!< RANSAC iterations
+static const float  multiReprojectionError = 2.0f; //!< RANSAC max. reprojection error
+static const double multiConfidence        = 0.95; //!< RANSAC confidence
+static const int    multiMinInliers        = 15;   //!< Min. NO. of inliers for a valid pose
+
+//-----------------------------------------------------------------------------
+SLCVTrackedFeaturesMulti::SLCVTrackedFeaturesMulti() : SLCVTracked(nullptr)
+{
+    _calib           = nullptr;
+    _indexIsDirty    = true;
+    _numMarkersFound = 0;
+}
+//-----------------------------------------------------------------------------
+/*! Registers a new marker image that transforms the passed node. If the node
+is the active camera the camera is positioned relative to the marker (standard
+AR case). Otherwise the node is positioned relative to the camera.
+@param node Node that gets transformed by this marker
+@param markerFilename Filename of the marker image in the texture path
+@param markerWidthMM Real width of the printed marker in mm
+*/
+void SLCVTrackedFeaturesMulti::addMarker(SLNode*  node,
+                                         SLstring markerFilename,
+                                         SLfloat  markerWidthMM)
+{
+    assert(node && "Node pointer is null");
+    assert(markerWidthMM > 0.0f && "Marker width must be positive");
+
+    // Read reference marker
+    // (The images source is deallocated by SLScene::unInit)
+    SLGLTexture* markerTexture = new SLGLTexture(markerFilename);
+    SLCVImage*   img           = markerTexture->images()[0];
+
+    SLFeatureMarker marker;
+    marker.node              = node;
+    marker.widthMM           = markerWidthMM;
+    marker.foundPose         = false;
+    marker.useExtrinsicGuess = false;
+    marker.numInliers        = 0;
+    marker.rvec              = SLCVMat::zeros(3, 1, CV_64FC1);
+    marker.tvec              = SLCVMat::zeros(3, 1, CV_64FC1);
+
+    cvtColor(img->cvMat(), marker.imageGray, CV_RGB2GRAY);
+    cv::rotate(marker.imageGray, marker.imageGray, ROTATE_180);
+    cv::flip(marker.imageGray, marker.imageGray, 1);
+
+    _markers.push_back(marker);
+
+    // The first marker node is the representative node of the base class
+    if (!_node) _node = node;
+
+    _indexIsDirty = true;
+}
+//-----------------------------------------------------------------------------
+//! Setter of the feature detector & descriptor type
+void SLCVTrackedFeaturesMulti::type(SLCVDetectDescribeType ddType)
+{
+    _featureManager.createDetectorDescriptor(ddType);
+    _indexIsDirty = true;
+}
+//-----------------------------------------------------------------------------
+/*! Detects and describes the features on all marker images and builds the
+shared descriptor index. Binary descriptors (CV_8U) are indexed with locality
+sensitive hashing, float descriptors with randomized KD-trees. The markers are
+added in the order of _markers so that DMatch::imgIdx is the marker index.
+*/
+void SLCVTrackedFeaturesMulti::buildMarkerIndex()
+{
+    SLCVVMat allDescriptors;
+
+    for (auto& marker : _markers)
+    {
+        marker.keypoints2D.clear();
+        marker.keypoints3D.clear();
+        marker.descriptors.release();
+        marker.foundPose         = false;
+        marker.useExtrinsicGuess = false;
+
+        _featureManager.detectAndDescribe(marker.imageGray,
+                                          marker.keypoints2D,
+                                          marker.descriptors);
+
+        // Scaling factor for the 3D point in mm
+        SLfloat pixelPerMM = (SLfloat)marker.imageGray.cols / marker.widthMM;
+
+        // Here we can use Z=0 because the markers are planar
+        for (auto& kp : marker.keypoints2D)
+            marker.keypoints3D.push_back(Point3f(kp.pt.x / pixelPerMM,
+                                                 kp.pt.y / pixelPerMM,
+                                                 0.0f));
+
+        allDescriptors.push_back(marker.descriptors);
+    }
+
+    if (!_markers.empty() && _markers[0].descriptors.type() == CV_8U)
+        _matcher = makePtr<FlannBasedMatcher>(makePtr<flann::LshIndexParams>(12, 20, 2));
+    else
+        _matcher = makePtr<FlannBasedMatcher>(makePtr<flann::KDTreeIndexParams>(4));
+
+    _matcher->add(allDescriptors);
+    _matcher->train();
+
+    _indexIsDirty = false;
+}
+//-----------------------------------------------------------------------------
+/*! Tracks all registered markers in the current video frame.
+@param imageGray Current grayscale frame
+@param image Current RGB frame
+@param calib Calibration information
+@param drawDetection Flag if the detected features should be drawn
+@param sv The current scene view
+@return True if at least one marker was found
+*/
+SLbool SLCVTrackedFeaturesMulti::track(SLCVMat          imageGray,
+                                       SLCVMat          image,
+                                       SLCVCalibration* calib,
+                                       SLbool           drawDetection,
+                                       SLSceneView*     sv)
+{
+    assert(!image.empty() && "Image is empty");
+    assert(!calib->cameraMat().empty() && "Calibration is empty");
+    assert(sv && "No sceneview pointer passed");
+    assert(sv->camera() && "No active camera in sceneview");
+
+    if (_markers.empty()) return false;
+
+    _calib = calib;
+
+    if (_indexIsDirty)
+        buildMarkerIndex();
+
+    SLScene* s       = SLApplication::scene;
+    SLfloat  startMS = s->timeMilliSec();
+
+    ///////////////////////////////////////////
+    // 1. Detect & describe the frame once   //
+    ///////////////////////////////////////////
+
+    _frameKeypoints.clear();
+    _featureManager.detectAndDescribe(imageGray,
+                                      _frameKeypoints,
+                                      _frameDescriptors);
+
+    s->detectTimesMS().set(s->timeMilliSec() - startMS);
+
+    ///////////////////////////////////////////
+    // 2. Match against all markers at once  //
+    ///////////////////////////////////////////
+
+    matchAllMarkers();
+
+    ///////////////////////////////////////////
+    // 3. Parallel pose estimation           //
+    ///////////////////////////////////////////
+
+    calcAllPoses();
+
+    ///////////////////////////////////////////
+    // 4. Update nodes on the main thread    //
+    ///////////////////////////////////////////
+
+    updateNodes(sv);
+
+    if (drawDetection)
+    {
+        for (auto& marker : _markers)
+        {
+            if (!marker.foundPose) continue;
+            for (auto& m : marker.matches)
+                circle(image, _frameKeypoints[(SLuint)m.queryIdx].pt, 3, Scalar(0, 0, 255));
+        }
+    }
+
+    // No optical flow tracking is done in this tracker
+    s->optFlowTimesMS().set(0);
+
+    return _numMarkersFound > 0;
+}
+//-----------------------------------------------------------------------------
+/*! Matches the frame descriptors with the shared index of all markers and
+distributes the matches that pass the ratio test to their markers by the
+image index of the match.
+*/
+void SLCVTrackedFeaturesMulti::matchAllMarkers()
+{
+    SLScene* s       = SLApplication::scene;
+    SLfloat  startMS = s->timeMilliSec();
+
+    for (auto& marker : _markers)
+        marker.matches.clear();
+
+    if (_frameDescriptors.rows < 2)
+    {
+        s->matchTimesMS().set(s->timeMilliSec() - startMS);
+        return;
+    }
+
+    // The KD-tree index needs float descriptors
+    SLCVMat queryDescriptors = _frameDescriptors;
+    if (_frameDescriptors.type() != CV_8U && _frameDescriptors.type() != CV_32F)
+        _frameDescriptors.convertTo(queryDescriptors, CV_32F);
+
+    SLCVVVDMatch matches;
+    _matcher->knnMatch(queryDescriptors, matches, 2);
+
+    // The LSH index can return less than 2 neighbours
+    for (auto& knn : matches)
+    {
+        if (knn.empty()) continue;
+
+        const DMatch& match1 = knn[0];
+        if (knn.size() > 1)
+        {
+            const DMatch& match2 = knn[1];
+            if (match2.distance > 0.0f &&
+                match1.distance / match2.distance >= multiMinRatio)
+                continue;
+        }
+
+        if (match1.imgIdx >= 0 && match1.imgIdx < (SLint)_markers.size())
+            _markers[(SLuint)match1.imgIdx].matches.push_back(match1);
+    }
+
+    s->matchTimesMS().set(s->timeMilliSec() - startMS);
+}
+//-----------------------------------------------------------------------------
+/*! Calculates the poses of all markers on multiple threads with
+SL::parallelFor. The solvePnP functions only write to the marker they work on,
+so no locking is needed.
+*/
+void SLCVTrackedFeaturesMulti::calcAllPoses()
+{
+    SLScene* s       = SLApplication::scene;
+    SLfloat  startMS = s->timeMilliSec();
+
+    SL::parallelFor((SLuint)_markers.size(), [this](SLuint i) {
+        calcPose(i);
+    });
+
+    s->poseTimesMS().set(s->timeMilliSec() - startMS);
+}
+//-----------------------------------------------------------------------------
+/*! Calculates the pose of one marker with RANSAC EPnP followed by an iterative
+refinement on the inliers. The last valid pose is used as extrinsic guess.
+*/
+void SLCVTrackedFeaturesMulti::calcPose(size_t markerIndex)
+{
+    SLFeatureMarker& marker = _markers[markerIndex];
+
+    if (marker.matches.size() < (size_t)multiMinMatches)
+    {
+        marker.foundPose         = false;
+        marker.useExtrinsicGuess = false;
+        return;
+    }
+
+    SLCVVPoint3f modelPoints(marker.matches.size());
+    SLCVVPoint2f framePoints(marker.matches.size());
+
+    for (size_t i = 0; i < marker.matches.size(); i++)
+    {
+        modelPoints[i] = marker.keypoints3D[(SLuint)marker.matches[i].trainIdx];
+        framePoints[i] = _frameKeypoints[(SLuint)marker.matches[i].queryIdx].pt;
+    }
+
+    SLCVMat rvec, tvec;
+    if (marker.useExtrinsicGuess)
+    {
+        marker.rvec.copyTo(rvec);
+        marker.tvec.copyTo(tvec);
+    }
+
+    SLVint inliers;
+    bool   foundPose = cv::solvePnPRansac(modelPoints,
+                                        framePoints,
+                                        _calib->cameraMat(),
+                                        _calib->distortion(),
+                                        rvec,
+                                        tvec,
+                                        marker.useExtrinsicGuess,
+                                        multiRansacIterations,
+                                        multiReprojectionError,
+                                        multiConfidence,
+                                        inliers,
+                                        SOLVEPNP_EPNP);
+
+    if (foundPose && inliers.size() >= (size_t)multiMinInliers)
+    {
+        SLCVVPoint3f inlierPoints3D;
+        SLCVVPoint2f inlierPoints2D;
+        for (auto idx : inliers)
+        {
+            inlierPoints3D.push_back(modelPoints[(SLuint)idx]);
+            inlierPoints2D.push_back(framePoints[(SLuint)idx]);
+        }
+
+        foundPose = cv::solvePnP(inlierPoints3D,
+                                 inlierPoints2D,
+                                 _calib->cameraMat(),
+                                 _calib->distortion(),
+                                 rvec,
+                                 tvec,
+                                 true,
+                                 SOLVEPNP_ITERATIVE);
+    }
+    else
+        foundPose = false;
+
+    marker.foundPose         = foundPose;
+    marker.useExtrinsicGuess = foundPose;
+    marker.numInliers        = foundPose ? (SLint)inliers.size() : 0;
+
+    if (foundPose)
+    {
+        rvec.copyTo(marker.rvec);
+        tvec.copyTo(marker.tvec);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Sets the object matrices of the marker nodes depending if the tracked node
+is attached to a camera or not. The scene graph is only changed on the main
+thread. If multiple markers are found for the camera node the one with the
+most inliers wins. The camera is updated first because the other nodes are
+positioned relative to it.
+*/
+void SLCVTrackedFeaturesMulti::updateNodes(SLSceneView* sv)
+{
+    _numMarkersFound = 0;
+
+    // 1) Position the camera by the best marker bound to the camera
+    SLint bestCameraInliers = 0;
+    for (auto& marker : _markers)
+    {
+        if (marker.foundPose) _numMarkersFound++;
+
+        if (marker.foundPose &&
+            typeid(*marker.node) == typeid(SLCamera) &&
+            marker.numInliers > bestCameraInliers)
+        {
+            bestCameraInliers = marker.numInliers;
+            _objectViewMat    = createGLMatrix(marker.tvec, marker.rvec);
+        }
+    }
+
+    if (bestCameraInliers > 0)
+        sv->camera()->om(_objectViewMat.inverted());
+
+    // 2) Position all other nodes relative to the camera
+    for (auto& marker : _markers)
+    {
+        if (typeid(*marker.node) == typeid(SLCamera))
+            continue;
+
+        if (marker.foundPose)
+        {
+            SLMat4f ovm = createGLMatrix(marker.tvec, marker.rvec);
+            marker.node->om(calcObjectMatrix(sv->camera()->om(), ovm));
+            marker.node->setDrawBitsRec(SL_DB_HIDDEN, false);
+        }
+        else
+            marker.node->setDrawBitsRec(SL_DB_HIDDEN, true);
+    }
+}
+//-----------------------------------------------------------------------------
@@ -45,6 +45,8 @@ void SLGLImGui::init()
     _vboHandle         = 0;
     _vaoHandle         = 0;
     _elementsHandle    = 0;
+    _vboSize           = 0;
+    _elementsSize      = 0;
     _fontPropDots      = 13.0f;
     _fontFixedDots     = 16.0f;
 
@@ -198,35 +200,22 @@ void SLGLImGui::createOpenGLObjects()
     glGenBuffers(1, &_vboHandle);
     glGenBuffers(1, &_elementsHandle);
 
+    _vboSize      = 0;
+    _elementsSize = 0;
+    _projDisplaySize.set(0, 0);
+
+    // The index buffer binding is stored in the vertex array object
     glGenVertexArrays(1, &_vaoHandle);
     glBindVertexArray(_vaoHandle);
     glBindBuffer(GL_ARRAY_BUFFER, _vboHandle);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _elementsHandle);
     glEnableVertexAttribArray((SLuint)_attribLocPosition);
     glEnableVertexAttribArray((SLuint)_attribLocUV);
     glEnableVertexAttribArray((SLuint)_attribLocColor);
 
     GET_GL_ERROR;
 
-#define OFFSETOF(TYPE, ELEMENT) ((size_t) & (((TYPE*)nullptr)->ELEMENT))
-    glVertexAttribPointer((SLuint)_attribLocPosition,
-                          2,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          sizeof(ImDrawVert),
-                          (GLvoid*)OFFSETOF(ImDrawVert, pos));
-    glVertexAttribPointer((SLuint)_attribLocUV,
-                          2,
-                          GL_FLOAT,
-                          GL_FALSE,
-                          sizeof(ImDrawVert),
-                          (GLvoid*)OFFSETOF(ImDrawVert, uv));
-    glVertexAttribPointer((SLuint)_attribLocColor,
-                          4,
-                          GL_UNSIGNED_BYTE,
-                          GL_TRUE,
-                          sizeof(ImDrawVert),
-                          (GLvoid*)OFFSETOF(ImDrawVert, col));
-#undef OFFSETOF
+    setVertexAttribPointers(0);
 
     GET_GL_ERROR;
 
@@ -361,7 +350,8 @@ void SLGLImGui::onResize(SLint scrW, SLint scrH)
 //! Callback for main rendering for the ImGui GUI system
 void SLGLImGui::onPaint(ImDrawData* draw_data)
 {
-    ImGuiIO& io = ImGui::GetIO();
+    ImGuiIO&   io      = ImGui::GetIO();
+    SLGLState* stateGL = SLGLState::getInstance();
 
     // Avoid rendering when minimized, scale coordinates for retina displays
     // (screen coordinates != framebuffer coordinates)
@@ -371,143 +361,148 @@ void SLGLImGui::onPaint(ImDrawData* draw_data)
         return;
     draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
-    // Backup GL state
-    GLint last_active_texture;
-    glGetIntegerv(GL_ACTIVE_TEXTURE, &last_active_texture);
-    glActiveTexture(GL_TEXTURE0);
+    // Setup render state over the cached setters of SLGLState: alpha-blending
+    // enabled, no face culling, no depth testing, scissor enabled. The blend
+    // function is the same as for the scene (see SLGLState::onInitialize).
+    stateGL->blend(true);
+    stateGL->cullFace(false);
+    stateGL->depthTest(false);
+    stateGL->scissorTest(true);
+    stateGL->viewport(0, 0, fb_width, fb_height);
+    stateGL->useProgram((SLuint)_progHandle);
+    stateGL->activeTexture(GL_TEXTURE0);
+
+    // The uniforms keep their values in the program until the display changes
+    if (_projDisplaySize.x != io.DisplaySize.x ||
+        _projDisplaySize.y != io.DisplaySize.y)
+    {
+        const float ortho_projection[4][4] =
+          {
+            {2.0f / io.DisplaySize.x, 0.0f, 0.0f, 0.0f},
+            {0.0f, 2.0f / -io.DisplaySize.y, 0.0f, 0.0f},
+            {0.0f, 0.0f, -1.0f, 0.0f},
+            {-1.0f, 1.0f, 0.0f, 1.0f},
+          };
+        glUniform1i(_attribLocTex, 0);
+        glUniformMatrix4fv(_attribLocProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
+        _projDisplaySize.set(io.DisplaySize.x, io.DisplaySize.y);
+    }
 
-    GLint last_program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
-    GLint last_texture;
-    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
-    GLint last_array_buffer;
-    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &last_array_buffer);
-    GLint last_element_array_buffer;
-    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &last_element_array_buffer);
-    GLint last_vertex_array;
-    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &last_vertex_array);
-    GLint last_blend_src_rgb;
-    glGetIntegerv(GL_BLEND_SRC_RGB, &last_blend_src_rgb);
-    GLint last_blend_dst_rgb;
-    glGetIntegerv(GL_BLEND_DST_RGB, &last_blend_dst_rgb);
-    GLint last_blend_src_alpha;
-    glGetIntegerv(GL_BLEND_SRC_ALPHA, &last_blend_src_alpha);
-    GLint last_blend_dst_alpha;
-    glGetIntegerv(GL_BLEND_DST_ALPHA, &last_blend_dst_alpha);
-    GLint last_blend_equation_rgb;
-    glGetIntegerv(GL_BLEND_EQUATION_RGB, &last_blend_equation_rgb);
-    GLint last_blend_equation_alpha;
-    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &last_blend_equation_alpha);
-    GLint last_viewport[4];
-    glGetIntegerv(GL_VIEWPORT, last_viewport);
-    GLint last_scissor_box[4];
-    glGetIntegerv(GL_SCISSOR_BOX, last_scissor_box);
-
-    GLboolean last_enable_blend        = glIsEnabled(GL_BLEND);
-    GLboolean last_enable_cull_face    = glIsEnabled(GL_CULL_FACE);
-    GLboolean last_enable_depth_test   = glIsEnabled(GL_DEPTH_TEST);
-    GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
-
-    // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled
-    glEnable(GL_BLEND);
-    glBlendEquation(GL_FUNC_ADD);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_SCISSOR_TEST);
-
-    // Setup viewport, orthographic projection matrix
-    glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
-    const float ortho_projection[4][4] =
-      {
-        {2.0f / io.DisplaySize.x, 0.0f, 0.0f, 0.0f},
-        {0.0f, 2.0f / -io.DisplaySize.y, 0.0f, 0.0f},
-        {0.0f, 0.0f, -1.0f, 0.0f},
-        {-1.0f, 1.0f, 0.0f, 1.0f},
-      };
-
-    glUseProgram((SLuint)_progHandle);
-    glUniform1i(_attribLocTex, 0);
-    glUniformMatrix4fv(_attribLocProjMtx, 1, GL_FALSE, &ortho_projection[0][0]);
     glBindVertexArray((SLuint)_vaoHandle);
+    glBindBuffer(GL_ARRAY_BUFFER, _vboHandle);
 
+    // Grow the persistent buffers to the next power of 2 if needed and orphan
+    // them, so that the driver doesn't wait for the draw calls of the last frame.
+    SLuint vtxBytes = (SLuint)draw_data->TotalVtxCount * (SLuint)sizeof(ImDrawVert);
+    SLuint idxBytes = (SLuint)draw_data->TotalIdxCount * (SLuint)sizeof(ImDrawIdx);
+    if (vtxBytes > _vboSize) _vboSize = SLGLTexture::nextPowerOf2(vtxBytes);
+    if (idxBytes > _elementsSize) _elementsSize = SLGLTexture::nextPowerOf2(idxBytes);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)_vboSize, nullptr, GL_STREAM_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)_elementsSize, nullptr, GL_STREAM_DRAW);
+
+    // Upload all command lists behind each other
+    SLuint vtxOffset = 0;
+    SLuint idxOffset = 0;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
-        const ImDrawList* cmd_list          = draw_data->CmdLists[n];
-        const ImDrawIdx*  idx_buffer_offset = nullptr;
-
-        glBindBuffer(GL_ARRAY_BUFFER, _vboHandle);
-        glBufferData(GL_ARRAY_BUFFER,
-                     (GLsizeiptr)cmd_list->VtxBuffer.Size * (GLsizeiptr)sizeof(ImDrawVert),
-                     (const GLvoid*)cmd_list->VtxBuffer.Data,
-                     GL_STREAM_DRAW);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _elementsHandle);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     (GLsizeiptr)cmd_list->IdxBuffer.Size * (GLsizeiptr)sizeof(ImDrawIdx),
-                     (const GLvoid*)cmd_list->IdxBuffer.Data,
-                     GL_STREAM_DRAW);
-
-        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        SLuint            vtxSize  = (SLuint)cmd_list->VtxBuffer.Size * (SLuint)sizeof(ImDrawVert);
+        SLuint            idxSize  = (SLuint)cmd_list->IdxBuffer.Size * (SLuint)sizeof(ImDrawIdx);
+        glBufferSubData(GL_ARRAY_BUFFER, vtxOffset, vtxSize, cmd_list->VtxBuffer.Data);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, idxOffset, idxSize, cmd_list->IdxBuffer.Data);
+        vtxOffset += vtxSize;
+        idxOffset += idxSize;
+    }
+
+    // Draw all command lists
+    ImVec4 lastClipRect(-1, -1, -1, -1);
+    vtxOffset = 0;
+    idxOffset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+
+        // The indices of every command list start at 0
+        setVertexAttribPointers(vtxOffset);
+
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size;)
         {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
             if (pcmd->UserCallback)
             {
                 pcmd->UserCallback(cmd_list, pcmd);
+                idxOffset += pcmd->ElemCount * (SLuint)sizeof(ImDrawIdx);
+                cmd_i++;
+                continue;
             }
-            else
+
+            // Merge the following commands with the same texture & clip rect
+            const ImVec4& clip      = pcmd->ClipRect;
+            SLuint        elemCount = pcmd->ElemCount;
+            for (cmd_i++; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
             {
-                glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
-                glScissor((int)pcmd->ClipRect.x,
-                          (int)(fb_height - pcmd->ClipRect.w),
-                          (int)(pcmd->ClipRect.z - pcmd->ClipRect.x),
-                          (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
-                glDrawElements(GL_TRIANGLES,
-                               (GLsizei)pcmd->ElemCount,
-                               sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
-                               idx_buffer_offset);
+                const ImDrawCmd* next = &cmd_list->CmdBuffer[cmd_i];
+                if (next->UserCallback ||
+                    next->TextureId != pcmd->TextureId ||
+                    next->ClipRect.x != clip.x || next->ClipRect.y != clip.y ||
+                    next->ClipRect.z != clip.z || next->ClipRect.w != clip.w)
+                    break;
+                elemCount += next->ElemCount;
             }
-            idx_buffer_offset += pcmd->ElemCount;
+
+            stateGL->bindTexture(GL_TEXTURE_2D, (SLuint)(intptr_t)pcmd->TextureId);
+
+            if (clip.x != lastClipRect.x || clip.y != lastClipRect.y ||
+                clip.z != lastClipRect.z || clip.w != lastClipRect.w)
+            {
+                glScissor((int)clip.x,
+                          (int)(fb_height - clip.w),
+                          (int)(clip.z - clip.x),
+                          (int)(clip.w - clip.y));
+                lastClipRect = clip;
+            }
+
+            glDrawElements(GL_TRIANGLES,
+                           (GLsizei)elemCount,
+                           sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                           (const GLvoid*)(intptr_t)idxOffset);
+            idxOffset += elemCount * (SLuint)sizeof(ImDrawIdx);
         }
+
+        vtxOffset += (SLuint)cmd_list->VtxBuffer.Size * (SLuint)sizeof(ImDrawVert);
     }
 
-    // Restore modified GL state
-    glUseProgram((SLuint)last_program);
-    glBindTexture(GL_TEXTURE_2D, (SLuint)last_texture);
-    glActiveTexture((SLuint)last_active_texture);
-    glBindVertexArray((SLuint)last_vertex_array);
-    glBindBuffer(GL_ARRAY_BUFFER, (SLuint)last_array_buffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, (SLuint)last_element_array_buffer);
-    glBlendEquationSeparate((SLuint)last_blend_equation_rgb,
-                            (SLuint)last_blend_equation_alpha);
-    glBlendFuncSeparate((SLuint)last_blend_src_rgb,
-                        (SLuint)last_blend_dst_rgb,
-                        (SLuint)last_blend_src_alpha,
-                        (SLuint)last_blend_dst_alpha);
-    if (last_enable_blend)
-        glEnable(GL_BLEND);
-    else
-        glDisable(GL_BLEND);
-    if (last_enable_cull_face)
-        glEnable(GL_CULL_FACE);
-    else
-        glDisable(GL_CULL_FACE);
-    if (last_enable_depth_test)
-        glEnable(GL_DEPTH_TEST);
-    else
-        glDisable(GL_DEPTH_TEST);
-    if (last_enable_scissor_test)
-        glEnable(GL_SCISSOR_TEST);
-    else
-        glDisable(GL_SCISSOR_TEST);
-    glViewport(last_viewport[0],
-               last_viewport[1],
-               (GLsizei)last_viewport[2],
-               (GLsizei)last_viewport[3]);
-    glScissor(last_scissor_box[0],
-              last_scissor_box[1],
-              (GLsizei)last_scissor_box[2],
-              (GLsizei)last_scissor_box[3]);
+    // Unbind the vertex array so that no other code changes its index buffer.
+    // The scissor test must be off for the clear of the next frame.
+    glBindVertexArray(0);
+    stateGL->scissorTest(false);
+}
+//-----------------------------------------------------------------------------
+/*! Points the vertex attributes to the vertices at the byte offset vtxOffset
+of the vertex buffer. The vertex array object must be bound.
+*/
+void SLGLImGui::setVertexAttribPointers(SLuint vtxOffset)
+{
+#define OFFSETOF(TYPE, ELEMENT) ((size_t) & (((TYPE*)nullptr)->ELEMENT))
+    glVertexAttribPointer((SLuint)_attribLocPosition,
+                          2,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(ImDrawVert),
+                          (GLvoid*)(vtxOffset + OFFSETOF(ImDrawVert, pos)));
+    glVertexAttribPointer((SLuint)_attribLocUV,
+                          2,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(ImDrawVert),
+                          (GLvoid*)(vtxOffset + OFFSETOF(ImDrawVert, uv)));
+    glVertexAttribPointer((SLuint)_attribLocColor,
+                          4,
+                          GL_UNSIGNED_BYTE,
+                          GL_TRUE,
+                          sizeof(ImDrawVert),
+                          (GLvoid*)(vtxOffset + OFFSETOF(ImDrawVert, col)));
+#undef OFFSETOF
 }
 //-----------------------------------------------------------------------------
 //! Callback on mouse button down event
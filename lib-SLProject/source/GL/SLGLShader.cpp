@@ -16,6 +16,8 @@
 
 #include <SLGLProgram.h>
 #include <SLGLShader.h>
+#include <SLSkeletonInstance.h>
+#include <regex>
 
 //-----------------------------------------------------------------------------
 // Error Strings
@@ -107,6 +109,10 @@ SLbool SLGLShader::createAndCompile()
                 SL_EXIT_MSG("SLGLShader::load: Unknown shader type.");
         }
 
+        // Decode packed vertex attributes in all GLSL versions
+        if (_type == ST_vertex)
+            addPackedVertexDecoding();
+
         // Build version string as the first statement
         SLGLState* state      = SLGLState::getInstance();
         SLstring   verGLSL    = state->glSLVersionNO();
@@ -114,6 +120,11 @@ SLbool SLGLShader::createAndCompile()
         if (state->glIsES3()) srcVersion += " es";
         srcVersion += "\n";
 
+        // Size the joint matrix palette of the skinning shaders
+        if (_code.find("SL_MAX_JOINTS") != string::npos)
+            srcVersion += "#define SL_MAX_JOINTS " +
+                          std::to_string(SLSkeletonInstance::maxJointsGPU()) + "\n";
+
         // Replace "attribute" and "varying" that came in GLSL 310
         if (verGLSL > "120")
         {
@@ -186,6 +197,87 @@ SLbool SLGLShader::createAndCompile()
     return false;
 }
 //-----------------------------------------------------------------------------
+/*! Adds the decoding of packed vertex attributes to a vertex shader. Meshes
+with packed vertices (see SLMesh::generateVAO) pass their positions as shorts
+relative to their AABB and their normals and tangents as octahedron encoded
+shorts. The declarations of a_position, a_normal and a_tangent stay the same,
+so the attribute locations don't change. After the declarations a decode
+function per attribute gets added and a macro replaces all further uses of
+the attribute by a call of it. The uniform u_vertexPacked selects at runtime
+between packed and float data, so one program can draw both kinds of meshes.
+On OpenGL ES the positions get decoded with high precision even if the shader
+sets a medium default precision.
+*/
+void SLGLShader::addPackedVertexDecoding()
+{
+    if (_code.find("u_vertexPacked") != string::npos)
+        return;
+
+    static const std::regex declaration(
+      "attribute\\s+(vec[34])\\s+(a_position|a_normal|a_tangent)\\s*;");
+
+    SLstring decoders;
+    size_t   insertPos = string::npos;
+
+    for (sregex_iterator it(_code.begin(), _code.end(), declaration), end;
+         it != end;
+         ++it)
+    {
+        SLstring type = (*it)[1];
+        SLstring name = (*it)[2];
+        SLstring decoded;
+
+        if (name == "a_position")
+            decoded = type == "vec4"
+                        ? "vec4(a_position.xyz * u_posScale + u_posOffset, 1.0)"
+                        : "a_position * u_posScale + u_posOffset";
+        else if (name == "a_normal")
+            decoded = type == "vec4"
+                        ? "vec4(slOctDecode(a_normal.xy), 0.0)"
+                        : "slOctDecode(a_normal.xy)";
+        else
+            decoded = type == "vec4"
+                        ? "slTangentDecode(a_tangent.xy)"
+                        : "slTangentDecode(a_tangent.xy).xyz";
+
+        decoders += "SL_HIGHP " + type + " slDecode_" + name + "() { return u_vertexPacked ? " +
+                    decoded + " : " + name + "; }\n";
+        decoders += "#define " + name + " slDecode_" + name + "()\n";
+        insertPos = (size_t)(it->position() + it->length());
+    }
+
+    if (insertPos == string::npos)
+        return;
+
+    SLstring functions =
+      "\n"
+      "#ifdef GL_ES\n"
+      "#define SL_HIGHP highp\n"
+      "#else\n"
+      "#define SL_HIGHP\n"
+      "#endif\n"
+      "uniform bool          u_vertexPacked; // flag if the vertex attributes are packed\n"
+      "uniform SL_HIGHP vec3 u_posScale;     // scale of the packed positions\n"
+      "uniform SL_HIGHP vec3 u_posOffset;    // offset of the packed positions\n"
+      "vec3 slOctDecode(vec2 e)\n"
+      "{\n"
+      "    e *= 1.0 / 32767.0;\n"
+      "    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));\n"
+      "    if (n.z < 0.0)\n"
+      "        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0,\n"
+      "                                        n.y >= 0.0 ? 1.0 : -1.0);\n"
+      "    return normalize(n);\n"
+      "}\n"
+      "vec4 slTangentDecode(vec2 e)\n"
+      "{\n"
+      "    float w = e.y < 0.0 ? -1.0 : 1.0;\n"
+      "    e.y     = abs(e.y) * 2.0 - 32767.0;\n"
+      "    return vec4(slOctDecode(e), w);\n"
+      "}\n";
+
+    _code.insert(insertPos, functions + decoders);
+}
+//-----------------------------------------------------------------------------
 //! SLUtils::removeComments for C/C++ comments removal from shader code
 SLstring SLGLShader::removeComments(SLstring src)
 {
@@ -95,6 +95,19 @@ void SLGLState::initAll()
 
     globalAmbientLight.set(0.2f, 0.2f, 0.2f, 0.0f);
 
+    // Without a current OpenGL context (e.g. in the headless benchmark apps)
+    // glGetString returns null and no OpenGL state is queried or set.
+    if (glGetString(GL_VERSION) == nullptr)
+    {
+        _glVersionNO   = "0.0";
+        _glVersionNOf  = 0.0f;
+        _glSLVersionNO = "000";
+        _glIsES2       = false;
+        _glIsES3       = false;
+        _isInitialized = false;
+        return;
+    }
+
     _glVersion     = SLstring((const char*)glGetString(GL_VERSION));
     _glVersionNO   = getGLVersionNO();
     _glVersionNOf  = (SLfloat)atof(_glVersionNO.c_str());
@@ -123,6 +136,7 @@ void SLGLState::initAll()
 
     //initialize states a unset
     _blend                = false;
+    _scissorTest          = false;
     _cullFace             = false;
     _depthTest            = false;
     _depthMask            = false;
@@ -351,6 +365,22 @@ void SLGLState::blend(SLbool stateNew)
             glDisable(GL_BLEND);
         _blend = stateNew;
 
+#ifdef _GLDEBUG
+        GET_GL_ERROR;
+#endif
+    }
+}
+//-----------------------------------------------------------------------------
+void SLGLState::scissorTest(SLbool stateNew)
+{
+    if (_scissorTest != stateNew)
+    {
+        if (stateNew)
+            glEnable(GL_SCISSOR_TEST);
+        else
+            glDisable(GL_SCISSOR_TEST);
+        _scissorTest = stateNew;
+
 #ifdef _GLDEBUG
         GET_GL_ERROR;
 #endif
@@ -16,6 +16,7 @@
 
 #include <SLApplication.h>
 #include <SLGLTexture.h>
+#include <SLGLTextureStreamer.h>
 #include <SLScene.h>
 
 //-----------------------------------------------------------------------------
@@ -29,6 +30,9 @@ SLfloat SLGLTexture::maxAnisotropy = -1.0f;
 
 //! NO. of texture byte allocated on GPU
 SLuint SLGLTexture::numBytesInTextures = 0;
+
+//! NO. of pixel buffer objects for the asynchronous upload in fullUpdate
+SLuint SLGLTexture::numUpdatePBOs = 3;
 //-----------------------------------------------------------------------------
 //! Default ctor for all stack instances (not created with new)
 /*! Default ctor for all stack instances such as the video textures in SLScene
@@ -49,6 +53,14 @@ SLGLTexture::SLGLTexture()
     _resizeToPow2 = false;
     _autoCalcTM3D = false;
     _bytesOnGPU   = 0;
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = 0;
+    _streamHeight = 0;
+    _streamAlpha  = false;
+    _pboSize      = 0;
+    _pboIndex     = 0;
 }
 //-----------------------------------------------------------------------------
 //! ctor 2D textures with internal image allocation
@@ -64,7 +76,70 @@ SLGLTexture::SLGLTexture(SLstring      filename,
     _stateGL = SLGLState::getInstance();
     _texType = type == TT_unknown ? detectType(filename) : type;
 
-    load(filename);
+    // Only images with a known file header get streamed
+    SLuint streamWidth  = 0;
+    SLuint streamHeight = 0;
+    SLbool streamAlpha  = false;
+    SLbool isKTXFile    = SLUtils::getFileExt(filename) == "ktx";
+    SLbool isStreamed   = !isKTXFile && SLGLTextureStreamer::isOn &&
+                        SLCVImage::readInfo(findFile(filename),
+                                            streamWidth,
+                                            streamHeight,
+                                            streamAlpha);
+    if (isKTXFile)
+        loadKTX(filename);
+    else if (!isStreamed)
+        load(filename);
+
+    _min_filter   = min_filter;
+    _mag_filter   = mag_filter;
+    _wrap_s       = wrapS;
+    _wrap_t       = wrapT;
+    _target       = _ktx.numFaces == 6 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    _texName      = 0;
+    _bumpScale    = 1.0f;
+    _resizeToPow2 = false;
+    _autoCalcTM3D = false;
+    _needsUpdate  = false;
+    _bytesOnGPU   = 0;
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = streamWidth;
+    _streamHeight = streamHeight;
+    _streamAlpha  = streamAlpha;
+    _pboSize      = 0;
+    _pboIndex     = 0;
+
+    // The image gets decoded & uploaded by the streamer of the scene
+    if (isStreamed)
+    {
+        _isStreaming  = true;
+        _imagePending = true;
+        SLApplication::scene->textureStreamer().add(this,
+                                                    findFile(filename),
+                                                    _min_filter >= GL_NEAREST_MIPMAP_NEAREST);
+    }
+
+    // Add pointer to the global resource vectors for deallocation
+    SLApplication::scene->textures().push_back(this);
+}
+//-----------------------------------------------------------------------------
+/*! ctor 2D textures with an image that was already loaded e.g. in parallel by
+SLAssimpImporter. The texture takes the ownership of the image.
+*/
+SLGLTexture::SLGLTexture(SLCVImage*    image,
+                         SLint         min_filter,
+                         SLint         mag_filter,
+                         SLTextureType type,
+                         SLint         wrapS,
+                         SLint         wrapT)
+  : SLObject(image->name(), image->path() + image->name())
+{
+    _stateGL = SLGLState::getInstance();
+    _texType = type == TT_unknown ? detectType(image->name()) : type;
+
+    _images.push_back(image);
 
     _min_filter   = min_filter;
     _mag_filter   = mag_filter;
@@ -77,6 +152,14 @@ SLGLTexture::SLGLTexture(SLstring      filename,
     _autoCalcTM3D = false;
     _needsUpdate  = false;
     _bytesOnGPU   = 0;
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = 0;
+    _streamHeight = 0;
+    _streamAlpha  = false;
+    _pboSize      = 0;
+    _pboIndex     = 0;
 
     // Add pointer to the global resource vectors for deallocation
     SLApplication::scene->textures().push_back(this);
@@ -110,6 +193,14 @@ SLGLTexture::SLGLTexture(SLVstring files,
     _autoCalcTM3D = true;
     _needsUpdate  = false;
     _bytesOnGPU   = 0;
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = 0;
+    _streamHeight = 0;
+    _streamAlpha  = false;
+    _pboSize      = 0;
+    _pboIndex     = 0;
 
     // Add pointer to the global resource vectors for deallocation
     SLApplication::scene->textures().push_back(this);
@@ -143,6 +234,14 @@ SLGLTexture::SLGLTexture(SLVCol4f colors,
     _autoCalcTM3D = true;
     _needsUpdate  = false;
     _bytesOnGPU   = 0;
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = 0;
+    _streamHeight = 0;
+    _streamAlpha  = false;
+    _pboSize      = 0;
+    _pboIndex     = 0;
 
     // Add pointer to the global resource vectors for deallocation
     SLApplication::scene->textures().push_back(this);
@@ -186,6 +285,14 @@ SLGLTexture::SLGLTexture(SLstring      filenameXPos,
     _autoCalcTM3D = false;
     _needsUpdate  = false;
     _bytesOnGPU   = 0;
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = 0;
+    _streamHeight = 0;
+    _streamAlpha  = false;
+    _pboSize      = 0;
+    _pboIndex     = 0;
 
     SLApplication::scene->textures().push_back(this);
 }
@@ -198,6 +305,18 @@ SLGLTexture::~SLGLTexture()
 //-----------------------------------------------------------------------------
 void SLGLTexture::clearData()
 {
+    // Abort the streaming before the image gets deleted
+    if (_isStreaming && SLApplication::scene)
+        SLApplication::scene->textureStreamer().remove(this);
+    _isStreaming  = false;
+    _imagePending = false;
+    _streamLevel  = -1;
+    _streamWidth  = 0;
+    _streamHeight = 0;
+    _streamAlpha  = false;
+
+    deletePBOs();
+
     glDeleteTextures(1, &_texName);
 
     numBytesInTextures -= _bytesOnGPU;
@@ -209,6 +328,10 @@ void SLGLTexture::clearData()
     }
     _images.clear();
 
+    _ktx.fileData.clear();
+    _ktx.imageOffsets.clear();
+    _ktx.imageSizes.clear();
+
     _texName    = 0;
     _bytesOnGPU = 0;
     _vaoSprite.clearAttribs();
@@ -219,7 +342,14 @@ void SLGLTexture::load(SLstring filename,
                        SLbool   flipVertical,
                        SLbool   loadGrayscaleIntoAlpha)
 {
-    // Load the file directly
+    _images.push_back(new SLCVImage(findFile(filename),
+                                    flipVertical,
+                                    loadGrayscaleIntoAlpha));
+}
+//-----------------------------------------------------------------------------
+//! Returns the filename if it exists or otherwise the file in defaultPath
+SLstring SLGLTexture::findFile(SLstring filename)
+{
     if (!SLFileSystem::fileExists(filename))
     {
         filename = defaultPath + filename;
@@ -229,10 +359,81 @@ void SLGLTexture::load(SLstring filename,
             SL_EXIT_MSG(msg.c_str());
         }
     }
+    return filename;
+}
+//-----------------------------------------------------------------------------
+/*! Loads a KTX file (version 1.1) into _ktx without decoding any pixel data.
+Only 2D textures and cube maps in the native byte order are supported.
+The offsets and sizes of all mip levels and cube faces get stored so that
+SLGLTexture::buildKTX can upload them directly from the file data.
+*/
+void SLGLTexture::loadKTX(SLstring filename)
+{
+    filename = findFile(filename);
+
+    ifstream file(filename, ios::binary | ios::ate);
+    size_t   fileSize = (size_t)file.tellg();
+    file.seekg(0, ios::beg);
+    _ktx.fileData.resize(fileSize);
+    if (fileSize < 64 || !file.read((char*)&_ktx.fileData[0], (streamsize)fileSize))
+        SL_EXIT_MSG(("SLGLTexture::loadKTX: Reading failed: " + filename).c_str());
+
+    // The 12 byte identifier is followed by 13 uint32 header fields
+    static const SLuchar identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31,
+                                           0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    SLuint header[13];
+    memcpy(header, &_ktx.fileData[12], sizeof(header));
+
+    if (memcmp(&_ktx.fileData[0], identifier, 12) != 0)
+        SL_EXIT_MSG(("SLGLTexture::loadKTX: No KTX 1.1 file: " + filename).c_str());
+    if (header[0] != 0x04030201)
+        SL_EXIT_MSG(("SLGLTexture::loadKTX: Wrong byte order: " + filename).c_str());
+    if (header[8] != 0 || header[9] != 0)
+        SL_EXIT_MSG(("SLGLTexture::loadKTX: No 2D texture or cube map: " + filename).c_str());
+    if (header[10] != 1 && header[10] != 6)
+        SL_EXIT_MSG(("SLGLTexture::loadKTX: Wrong NO. of faces: " + filename).c_str());
+
+    _ktx.glType               = header[1];
+    _ktx.glFormat             = header[3];
+    _ktx.glInternalFormat     = header[4];
+    _ktx.glBaseInternalFormat = header[5];
+    _ktx.width                = header[6];
+    _ktx.height               = std::max(header[7], 1u);
+    _ktx.numFaces             = header[10];
+    _ktx.numLevels            = std::max(header[11], 1u);
+
+    // Skip the key value data and collect the images of all levels & faces
+    size_t offset = 64 + (size_t)header[12];
+    _ktx.imageOffsets.clear();
+    _ktx.imageSizes.clear();
+
+    for (SLuint level = 0; level < _ktx.numLevels; ++level)
+    {
+        if (offset + 4 > fileSize)
+            SL_EXIT_MSG(("SLGLTexture::loadKTX: File too short: " + filename).c_str());
 
-    _images.push_back(new SLCVImage(filename,
-                                    flipVertical,
-                                    loadGrayscaleIntoAlpha));
+        SLuint imageSize;
+        memcpy(&imageSize, &_ktx.fileData[offset], 4);
+        offset += 4;
+
+        for (SLuint face = 0; face < _ktx.numFaces; ++face)
+        {
+            if (offset + imageSize > fileSize)
+                SL_EXIT_MSG(("SLGLTexture::loadKTX: File too short: " + filename).c_str());
+
+            _ktx.imageOffsets.push_back((SLuint)offset);
+            _ktx.imageSizes.push_back(imageSize);
+
+            // Cube faces & mip levels are padded to 4 bytes
+            offset += (imageSize + 3) & ~3u;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+//! Waits until the streamer has decoded the image and passed it to _images
+void SLGLTexture::waitForImage()
+{
+    SLApplication::scene->textureStreamer().waitForImage(this);
 }
 //-----------------------------------------------------------------------------
 //! Loads the 1D color data into an image of height 1
@@ -308,13 +509,16 @@ SLbool SLGLTexture::copyVideoImage(SLint         camWidth,
 Builds an OpenGL texture object with the according OpenGL commands.
 This texture creation must be done only once when a valid OpenGL rendering
 context is present. This function is called the first time within the enable
-method which is called by object that uses the texture.
+method which is called by object that uses the texture. A streamed texture
+gets built level by level by SLGLTextureStreamer::update.
 */
 void SLGLTexture::build(SLint texID)
 {
     assert(texID >= 0 && texID < 32);
 
-    if (_images.size() == 0)
+    if (_isStreaming) return;
+
+    if (_images.size() == 0 && !isKTX())
         SL_EXIT_MSG("No images loaded in SLGLTexture::build");
 
     // delete texture name if it already exits
@@ -324,7 +528,7 @@ void SLGLTexture::build(SLint texID)
         glDeleteTextures(1, &_texName);
         SL_LOG("SLGLTexture::build: Deleted: %d, %s\n",
                _texName,
-               _images[0]->name().c_str());
+               name().c_str());
         glBindTexture(_target, 0);
         _texName = 0;
         numBytesInTextures -= _bytesOnGPU;
@@ -335,7 +539,7 @@ void SLGLTexture::build(SLint texID)
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &texMaxSize);
 
     // check if texture has to be resized
-    if (_resizeToPow2)
+    if (_resizeToPow2 && !isKTX())
     {
         SLuint w2 = closestPowerOf2(_images[0]->width());
         SLuint h2 = closestPowerOf2(_images[0]->height());
@@ -348,9 +552,9 @@ void SLGLTexture::build(SLint texID)
     // check 2D size
     if (_target == GL_TEXTURE_2D)
     {
-        if (_images[0]->width() > (SLuint)texMaxSize)
+        if (width() > (SLuint)texMaxSize)
             SL_EXIT_MSG("SLGLTexture::build: Texture width is too big.");
-        if (_images[0]->height() > (SLuint)texMaxSize)
+        if (height() > (SLuint)texMaxSize)
             SL_EXIT_MSG("SLGLTexture::build: Texture height is too big.");
     }
 
@@ -376,9 +580,9 @@ void SLGLTexture::build(SLint texID)
     {
         SLint texMaxCubeSize;
         glGetIntegerv(GL_MAX_CUBE_MAP_TEXTURE_SIZE, &texMaxCubeSize);
-        if (_images[0]->width() > (SLuint)texMaxCubeSize)
+        if (width() > (SLuint)texMaxCubeSize)
             SL_EXIT_MSG("SLGLTexture::build: Cube Texture width is too big.");
-        if (_images.size() != 6)
+        if (_images.size() != 6 && !isKTX())
             SL_EXIT_MSG("SLGLTexture::build: Not six images provided for cube map texture.");
     }
 
@@ -389,48 +593,17 @@ void SLGLTexture::build(SLint texID)
 
     // create binding and apply texture properties
     _stateGL->bindTexture(_target, _texName);
-
-    // check if anisotropic texture filter extension is available
-    if (maxAnisotropy < 0.0f)
-    {
-        if (_stateGL->hasExtension("GL_EXT_texture_filter_anisotropic"))
-            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
-        else
-        {
-            maxAnisotropy = 0.0f;
-            cout << "GL_EXT_texture_filter_anisotropic not available.\n";
-        }
-    }
-
-    // apply anisotropic or minification filter
-    SLfloat anisotropy = 1.0f; // = off
-    if (_min_filter > GL_LINEAR_MIPMAP_LINEAR)
-    {
-        if (_min_filter == SL_ANISOTROPY_MAX)
-            anisotropy = maxAnisotropy;
-        else
-            anisotropy = min((SLfloat)(_min_filter - GL_LINEAR_MIPMAP_LINEAR),
-                             maxAnisotropy);
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
-    }
-    else
-        glTexParameteri(_target, GL_TEXTURE_MIN_FILTER, _min_filter);
-
-    // apply magnification filter only GL_NEAREST & GL_LINEAR is allowed
-    glTexParameteri(_target, GL_TEXTURE_MAG_FILTER, _mag_filter);
-
-    // apply texture wrapping modes
-    glTexParameteri(_target, GL_TEXTURE_WRAP_S, _wrap_s);
-    glTexParameteri(_target, GL_TEXTURE_WRAP_T, _wrap_t);
-    glTexParameteri(_target, GL_TEXTURE_WRAP_R, _wrap_t);
+    setTexParameters();
 
     // Handle special stupid case on iOS
-    SLint internalFormat = _images[0]->format();
+    SLint internalFormat = isKTX() ? (SLint)_ktx.glInternalFormat : _images[0]->format();
     if (internalFormat == PF_red)
         internalFormat = GL_R8;
 
     // Build textures
-    if (_target == GL_TEXTURE_2D)
+    if (isKTX())
+        buildKTX();
+    else if (_target == GL_TEXTURE_2D)
     {
         //////////////////////////////////////////
         glTexImage2D(GL_TEXTURE_2D,
@@ -529,16 +702,144 @@ void SLGLTexture::build(SLint texID)
     GET_GL_ERROR;
 }
 //-----------------------------------------------------------------------------
+//! Applies the filter & wrapping parameters to the bound texture
+void SLGLTexture::setTexParameters()
+{
+    // check if anisotropic texture filter extension is available
+    if (maxAnisotropy < 0.0f)
+    {
+        if (_stateGL->hasExtension("GL_EXT_texture_filter_anisotropic"))
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+        else
+        {
+            maxAnisotropy = 0.0f;
+            cout << "GL_EXT_texture_filter_anisotropic not available.\n";
+        }
+    }
+
+    // apply anisotropic or minification filter
+    SLfloat anisotropy = 1.0f; // = off
+    if (_min_filter > GL_LINEAR_MIPMAP_LINEAR)
+    {
+        if (_min_filter == SL_ANISOTROPY_MAX)
+            anisotropy = maxAnisotropy;
+        else
+            anisotropy = min((SLfloat)(_min_filter - GL_LINEAR_MIPMAP_LINEAR),
+                             maxAnisotropy);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+    }
+    else
+        glTexParameteri(_target, GL_TEXTURE_MIN_FILTER, _min_filter);
+
+    // apply magnification filter only GL_NEAREST & GL_LINEAR is allowed
+    glTexParameteri(_target, GL_TEXTURE_MAG_FILTER, _mag_filter);
+
+    // apply texture wrapping modes
+    glTexParameteri(_target, GL_TEXTURE_WRAP_S, _wrap_s);
+    glTexParameteri(_target, GL_TEXTURE_WRAP_T, _wrap_t);
+    glTexParameteri(_target, GL_TEXTURE_WRAP_R, _wrap_t);
+}
+//-----------------------------------------------------------------------------
+/*! Uploads all mip levels and cube faces of a KTX file to the bound texture.
+Compressed formats are passed as they are to glCompressedTexImage2D. If the
+file has no mip chain, the mipmaps of uncompressed formats get generated and
+compressed formats are filtered without mipmaps. If the GPU doesn't support
+the format the application exits with a message.
+*/
+void SLGLTexture::buildKTX()
+{
+    SLbool isCompressed = _ktx.glType == 0;
+
+    // The rows of uncompressed KTX images are 4 byte aligned
+    if (!isCompressed) glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    for (SLuint level = 0; level < _ktx.numLevels; ++level)
+    {
+        SLsizei w = (SLsizei)std::max(_ktx.width >> level, 1u);
+        SLsizei h = (SLsizei)std::max(_ktx.height >> level, 1u);
+
+        for (SLuint face = 0; face < _ktx.numFaces; ++face)
+        {
+            SLuint   i      = level * _ktx.numFaces + face;
+            GLvoid*  data   = &_ktx.fileData[_ktx.imageOffsets[i]];
+            SLenum   target = _ktx.numFaces == 6
+                              ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face
+                              : GL_TEXTURE_2D;
+
+            if (isCompressed)
+                glCompressedTexImage2D(target,
+                                       (SLint)level,
+                                       _ktx.glInternalFormat,
+                                       w,
+                                       h,
+                                       0,
+                                       (SLsizei)_ktx.imageSizes[i],
+                                       data);
+            else
+                glTexImage2D(target,
+                             (SLint)level,
+                             (SLint)_ktx.glInternalFormat,
+                             w,
+                             h,
+                             0,
+                             _ktx.glFormat,
+                             _ktx.glType,
+                             data);
+
+            _bytesOnGPU += _ktx.imageSizes[i];
+        }
+    }
+
+    if (!isCompressed) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        SLchar msg[256];
+        sprintf(msg,
+                "SLGLTexture::buildKTX: Format 0x%04X not supported: %s",
+                _ktx.glInternalFormat,
+                name().c_str());
+        SL_EXIT_MSG(msg);
+    }
+
+    SLbool useMipmaps = _min_filter >= GL_NEAREST_MIPMAP_NEAREST;
+    if (useMipmaps && _ktx.numLevels == 1)
+    {
+        if (isCompressed)
+            glTexParameteri(_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        else
+        {
+            glGenerateMipmap(_target);
+
+            // Mipmaps use 1/3 more memory on GPU
+            _bytesOnGPU = (SLuint)((SLfloat)_bytesOnGPU * 1.333333333f);
+        }
+    }
+#ifndef SL_GLES2
+    else if (useMipmaps)
+        glTexParameteri(_target, GL_TEXTURE_MAX_LEVEL, (SLint)_ktx.numLevels - 1);
+#endif
+
+    numBytesInTextures += _bytesOnGPU;
+}
+//-----------------------------------------------------------------------------
 /*!
 SLGLTexture::bindActive binds the active texture. This method must be called 
 by the object that uses the texture every time BEFORE the its rendering. 
 The texID is only used for multi texturing. Before the first time the texture
-is passed to OpenGL.
+is passed to OpenGL. A streamed texture binds a placeholder texture until its
+coarsest mip level is uploaded.
 */
 void SLGLTexture::bindActive(SLint texID)
 {
     assert(texID >= 0 && texID < 32);
 
+    if (_isStreaming && _streamLevel < 0)
+    {
+        SLApplication::scene->textureStreamer().bindPlaceholder(texID, _texType);
+        return;
+    }
+
     // if texture not exists build it
     if (!_texName)
         build(texID);
@@ -569,7 +870,10 @@ void SLGLTexture::bindActive(SLint texID)
 }
 //-----------------------------------------------------------------------------
 /*!
-Fully updates the OpenGL internal texture data by the image data 
+Fully updates the OpenGL internal texture data by the image data. This is done
+for the live video texture every frame. If numUpdatePBOs is > 0 the image gets
+uploaded asynchronously through a pixel buffer object (see updateWithPBO).
+The texture must be bound.
 */
 void SLGLTexture::fullUpdate()
 {
@@ -582,17 +886,20 @@ void SLGLTexture::fullUpdate()
         {
             numBytesInTextures -= _bytesOnGPU;
 
-            /////////////////////////////////////////////
-            glTexSubImage2D(_target,
-                            0,
-                            0,
-                            0,
-                            (SLsizei)_images[0]->width(),
-                            (SLsizei)_images[0]->height(),
-                            _images[0]->format(),
-                            GL_UNSIGNED_BYTE,
-                            (GLvoid*)_images[0]->data());
-            /////////////////////////////////////////////
+            if (!updateWithPBO())
+            {
+                /////////////////////////////////////////////
+                glTexSubImage2D(_target,
+                                0,
+                                0,
+                                0,
+                                (SLsizei)_images[0]->width(),
+                                (SLsizei)_images[0]->height(),
+                                _images[0]->format(),
+                                GL_UNSIGNED_BYTE,
+                                (GLvoid*)_images[0]->data());
+                /////////////////////////////////////////////
+            }
 
             _bytesOnGPU = _images[0]->bytesPerImage();
             numBytesInTextures += _bytesOnGPU;
@@ -601,6 +908,97 @@ void SLGLTexture::fullUpdate()
     GET_GL_ERROR;
 }
 //-----------------------------------------------------------------------------
+/*! Uploads _images[0] through the next of numUpdatePBOs pixel buffer objects.
+The image gets copied into the mapped buffer and glTexSubImage2D returns
+without waiting for the transfer, because the driver reads the pixels from the
+buffer asynchronously. A buffer gets reused after numUpdatePBOs frames: If the
+fence of its last upload is signaled, it is mapped unsynchronized. Otherwise
+its storage gets orphaned, so that the copy never waits for the GPU.
+\return false if the PBO path is not available (OpenGL < 3.2 or ES2)
+*/
+SLbool SLGLTexture::updateWithPBO()
+{
+#ifndef SL_GLES2
+    if (numUpdatePBOs == 0 ||
+        _stateGL->glIsES2() ||
+        (!_stateGL->glIsES3() && _stateGL->glVersionNOf() < 3.2f))
+        return false;
+
+    SLCVImage* img  = _images[0];
+    SLuint     size = img->bytesPerImage();
+
+    // (Re)create the buffers if the image size or the NO. of buffers changed
+    if (_pbos.size() != numUpdatePBOs || _pboSize != size)
+    {
+        deletePBOs();
+        _pbos.resize(numUpdatePBOs);
+        _pboFences.assign(numUpdatePBOs, nullptr);
+        _pboSize = size;
+        glGenBuffers((SLsizei)numUpdatePBOs, &_pbos[0]);
+        for (auto pbo : _pbos)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        }
+    }
+
+    _pboIndex = (_pboIndex + 1) % numUpdatePBOs;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[_pboIndex]);
+
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+    GLsync&    fence  = _pboFences[_pboIndex];
+    if (fence)
+    {
+        if (glClientWaitSync(fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+            access |= GL_MAP_UNSYNCHRONIZED_BIT;
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access);
+    if (!dst)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+    memcpy(dst, img->data(), size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    /////////////////////////////////////////////
+    glTexSubImage2D(_target,
+                    0,
+                    0,
+                    0,
+                    (SLsizei)img->width(),
+                    (SLsizei)img->height(),
+                    img->format(),
+                    GL_UNSIGNED_BYTE,
+                    nullptr); // offset 0 in the bound PBO
+    /////////////////////////////////////////////
+
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Deletes the pixel buffer objects and fences of updateWithPBO
+void SLGLTexture::deletePBOs()
+{
+#ifndef SL_GLES2
+    for (auto fence : _pboFences)
+        if (fence) glDeleteSync(fence);
+    if (_pbos.size())
+        glDeleteBuffers((SLsizei)_pbos.size(), &_pbos[0]);
+#endif
+    _pboFences.clear();
+    _pbos.clear();
+    _pboSize  = 0;
+    _pboIndex = 0;
+}
+//-----------------------------------------------------------------------------
 //! Draws the texture as 2D sprite with OpenGL buffers
 /*! Draws the texture as a flat 2D sprite with a height and a width on two
 triangles with zero in the bottom left corner: <br>
@@ -616,8 +1014,8 @@ triangles with zero in the bottom left corner: <br>
 */
 void SLGLTexture::drawSprite(SLbool doUpdate)
 {
-    SLfloat w = (SLfloat)_images[0]->width();
-    SLfloat h = (SLfloat)_images[0]->height();
+    SLfloat w = (SLfloat)width();
+    SLfloat h = (SLfloat)height();
 
     // build buffer object once
     if (!_vaoSprite.id())
@@ -663,9 +1061,13 @@ void SLGLTexture::drawSprite(SLbool doUpdate)
 //! SLGLTexture::getTexelf returns a pixel color from s & t texture coordinates.
 /*! If the OpenGL filtering is set to GL_LINEAR a bilinear interpolated color out
 of four neighboring pixels is return. Otherwise the nearest pixel is returned.
+Textures loaded from KTX files have no image on the CPU and return white.
 */
 SLCol4f SLGLTexture::getTexelf(SLfloat s, SLfloat t, SLuint imgIndex)
 {
+    if (isKTX()) return SLCol4f::WHITE;
+    if (_imagePending) waitForImage();
+
     assert(imgIndex < _images.size() && "Image index to big!");
 
     // transform tex coords with the texture matrix
@@ -683,6 +1085,8 @@ SLCol4f SLGLTexture::getTexelf(SLfloat s, SLfloat t, SLuint imgIndex)
 //! SLGLTexture::getTexelf returns a pixel color at the specified cubemap direction
 SLCol4f SLGLTexture::getTexelf(SLVec3f cubemapDir)
 {
+    if (isKTX()) return SLCol4f::WHITE;
+
     assert(_images.size() == 6 &&
            _target == GL_TEXTURE_CUBE_MAP &&
            "SLGLTexture::getTexelf: Not a cubemap!");
@@ -702,6 +1106,9 @@ mapping either from a height map or a normal map
 SLVec2f SLGLTexture::dsdt(SLfloat s, SLfloat t)
 {
     SLVec2f dsdt(0, 0);
+    if (isKTX()) return dsdt;
+    if (_imagePending) waitForImage();
+
     SLfloat ds = 1.0f / _images[0]->width();
     SLfloat dt = 1.0f / _images[0]->height();
 
@@ -828,16 +1235,18 @@ SLstring SLGLTexture::typeName()
 }
 //-----------------------------------------------------------------------------
 /*! SLGLTexture::calc3DGradients calculates the normals based on the 3D
-gradient of all images and stores them in the RGB components.
+gradient of all images and stores them in the RGB components. The gradient is
+the central difference of the alpha channel, which is read through raw row
+pointers of the slices. The slices are processed in parallel because each
+slice only writes its own RGB channels and only reads the alpha channels.
 \param sampleRadius Distance from center to calculate the gradient
 */
 void SLGLTexture::calc3DGradients(SLint sampleRadius)
 {
-    SLint   r          = sampleRadius;
-    SLint   volX       = (SLint)_images[0]->width();
-    SLint   volY       = (SLint)_images[0]->height();
-    SLint   volZ       = (SLint)_images.size();
-    SLfloat oneOver255 = 1.0f / 255.0f;
+    SLint r    = sampleRadius;
+    SLint volX = (SLint)_images[0]->width();
+    SLint volY = (SLint)_images[0]->height();
+    SLint volZ = (SLint)_images.size();
 
     // check that all images in depth have the same size
     for (auto img : _images)
@@ -845,36 +1254,45 @@ void SLGLTexture::calc3DGradients(SLint sampleRadius)
             (SLint)img->height() != volY || img->format() != PF_rgba)
             SL_EXIT_MSG("SLGLTexture::calc3DGradients: Not all images have the same size!");
 
-    for (int z = r; z < volZ - r; ++z)
+    if (volX > 2 * r && volY > 2 * r && volZ > 2 * r)
     {
-        for (int y = r; y < volY - r; ++y)
-        {
-            for (int x = r; x < volX - r; ++x)
+        SLint stride = (SLint)_images[0]->bytesPerLine();
+        SLint dx     = 4 * r;      // byte offset of the x neighbours
+        SLint dy     = stride * r; // byte offset of the y neighbours
+        SLint a      = 3;          // byte offset of the alpha channel
+
+        SL::parallelFor((SLuint)(volZ - 2 * r), [&](SLuint i) {
+            SLint    z     = (SLint)i + r;
+            SLuchar* slice = _images[(SLuint)z]->data();
+            SLuchar* prev  = _images[(SLuint)(z - r)]->data();
+            SLuchar* next  = _images[(SLuint)(z + r)]->data();
+
+            for (SLint y = r; y < volY - r; ++y)
             {
-                // Calculate the min & max vectors
-                SLVec3f min, max;
-                min.x = (SLfloat)_images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x - r)[3] * oneOver255;
-                max.x = (SLfloat)_images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x + r)[3] * oneOver255;
-                min.y = (SLfloat)_images[(SLuint)z]->cvMat().at<cv::Vec4b>(y - r, x)[3] * oneOver255;
-                max.y = (SLfloat)_images[(SLuint)z]->cvMat().at<cv::Vec4b>(y + r, x)[3] * oneOver255;
-                min.z = (SLfloat)_images[(SLuint)z - (SLuint)r]->cvMat().at<cv::Vec4b>(y, x)[3] * oneOver255;
-                max.z = (SLfloat)_images[(SLuint)z + (SLuint)r]->cvMat().at<cv::Vec4b>(y, x)[3] * oneOver255;
-
-                // Calculate normal as the difference between max & min
-                SLVec3f normal = max - min;
-                SLfloat length = normal.length();
-                if (length > 0.0001f)
-                    normal /= length;
-                else
-                    normal.set(0, 0, 0);
-
-                // Store normal in the rgb channels. Scale range from -1 - 1 to 0 - 1 to 0 - 255
-                normal += 1.0f;
-                _images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[0] = (SLuchar)(normal.x * 0.5f * 255.0f);
-                _images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[1] = (SLuchar)(normal.y * 0.5f * 255.0f);
-                _images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[2] = (SLuchar)(normal.z * 0.5f * 255.0f);
+                SLint rowStart = y * stride;
+                for (SLint x = r; x < volX - r; ++x)
+                {
+                    SLint    v = rowStart + x * 4;
+                    SLuchar* p = slice + v;
+
+                    // Calculate the normal as the difference between max & min
+                    SLVec3f normal((SLfloat)(p[dx + a] - p[-dx + a]),
+                                   (SLfloat)(p[dy + a] - p[-dy + a]),
+                                   (SLfloat)(next[v + a] - prev[v + a]));
+                    SLfloat length = normal.length();
+                    if (length > 0.0f)
+                        normal /= length;
+                    else
+                        normal.set(0, 0, 0);
+
+                    // Store normal in the rgb channels. Scale range from -1 - 1 to 0 - 1 to 0 - 255
+                    normal += 1.0f;
+                    p[0] = (SLuchar)(normal.x * 0.5f * 255.0f);
+                    p[1] = (SLuchar)(normal.y * 0.5f * 255.0f);
+                    p[2] = (SLuchar)(normal.z * 0.5f * 255.0f);
+                }
             }
-        }
+        });
     }
 
     smooth3DGradients(1);
@@ -884,58 +1302,172 @@ void SLGLTexture::calc3DGradients(SLint sampleRadius)
     //   img->savePNG(img->path() + "Normals_" + img->name());
 }
 //-----------------------------------------------------------------------------
+/*! Sums the RGB channels of an RGBA slice over a box of (2r+1)^2 voxels in x
+and y. The sum is separable: The first pass sums the rows into xSums and the
+second pass sums the columns with a running sum per column into xySums. Only
+the voxels with the full box inside the slice get a sum.
+*/
+static void sumSliceXY(const SLuchar* slice,
+                       SLint          stride,
+                       SLint          volX,
+                       SLint          volY,
+                       SLint          r,
+                       SLVuint&       xSums,
+                       SLVuint&       xySums)
+{
+    // Pass 1: sliding sum along the rows
+    for (SLint y = 0; y < volY; ++y)
+    {
+        const SLuchar* row = slice + y * stride;
+        SLuint*        out  = &xSums[(SLuint)(y * volX * 3)];
+        SLuint         s[3] = {0, 0, 0};
+
+        for (SLint x = 0; x < 2 * r; ++x)
+            for (SLint c = 0; c < 3; ++c)
+                s[c] += row[x * 4 + c];
+
+        for (SLint x = r; x < volX - r; ++x)
+        {
+            for (SLint c = 0; c < 3; ++c)
+            {
+                s[c] += row[(x + r) * 4 + c];
+                out[x * 3 + c] = s[c];
+                s[c] -= row[(x - r) * 4 + c];
+            }
+        }
+    }
+
+    // Pass 2: sliding sum along the columns row by row
+    SLint rowLen = volX * 3;
+    for (SLint y = r; y < volY - r; ++y)
+    {
+        SLuint* out = &xySums[(SLuint)(y * rowLen)];
+        if (y == r)
+        {
+            memset(out, 0, (SLuint)rowLen * sizeof(SLuint));
+            for (SLint fy = 0; fy <= 2 * r; ++fy)
+            {
+                const SLuint* in = &xSums[(SLuint)(fy * rowLen)];
+                for (SLint i = r * 3; i < rowLen - r * 3; ++i)
+                    out[i] += in[i];
+            }
+        }
+        else
+        {
+            const SLuint* above  = &xySums[(SLuint)((y - 1) * rowLen)];
+            const SLuint* add    = &xSums[(SLuint)((y + r) * rowLen)];
+            const SLuint* remove = &xSums[(SLuint)((y - r - 1) * rowLen)];
+            for (SLint i = r * 3; i < rowLen - r * 3; ++i)
+                out[i] = above[i] + add[i] - remove[i];
+        }
+    }
+}
+//-----------------------------------------------------------------------------
 /*! SLGLTexture::smooth3DGradients smooths the 3D gradients in the RGB channels
-of all images.
+of all images with a box filter of (2*smoothRadius+1)^3 voxels. Only the
+voxels with the full box inside the volume get filtered.
+\n
+The box filter is separable and works on the raw bytes: Averaging the decoded
+normals in the range -1 to 1 and encoding them again to 0 to 255 is the same
+as averaging the bytes. Each slice gets summed in x and y (sumSliceXY) and the
+sums of the 2*smoothRadius+1 slices in z are added. The volume is split into
+blocks of slices in z that are filtered in parallel. Each block keeps the xy
+sums of the slices in its z window in a ring buffer, so a slice is summed only
+once and every pass runs along contiguous rows. Because the slices get
+overwritten with the result, the sums of the slices that the neighbour blocks
+overwrite are calculated before the filtering starts.
 \param smoothRadius Soothing radius
 */
 void SLGLTexture::smooth3DGradients(SLint smoothRadius)
 {
-    SLint   r          = smoothRadius;
-    SLint   volX       = (SLint)_images[0]->width();
-    SLint   volY       = (SLint)_images[0]->height();
-    SLint   volZ       = (SLint)_images.size();
-    SLfloat oneOver255 = 1.0f / 255.0f;
+    SLint r    = smoothRadius;
+    SLint volX = (SLint)_images[0]->width();
+    SLint volY = (SLint)_images[0]->height();
+    SLint volZ = (SLint)_images.size();
 
     // check that all images in depth have the same size
     for (auto img : _images)
         if ((SLint)img->width() != volX ||
             (SLint)img->height() != volY || img->format() != PF_rgba)
-            SL_EXIT_MSG("SLGLTexture::calc3DGradients: Not all images have the same size3@!");
+            SL_EXIT_MSG("SLGLTexture::smooth3DGradients: Not all images have the same size!");
+
+    if (r < 1 || volX <= 2 * r || volY <= 2 * r || volZ <= 2 * r) return;
 
-    //@todo This is very slow and should be implemented as separable filter
-    for (int z = r; z < volZ - r; ++z)
+    SLint  stride      = (SLint)_images[0]->bytesPerLine();
+    SLint  window      = 2 * r + 1;
+    SLuint numBox      = (SLuint)(window * window * window);
+    SLuint sliceSums   = (SLuint)(volX * volY * 3);
+    SLint  numOut      = volZ - 2 * r;
+    SLint  numBlocks   = std::min((SLint)SL::maxThreads(), numOut);
+    SLint  blockSlices = (numOut + numBlocks - 1) / numBlocks;
+    numBlocks          = (numOut + blockSlices - 1) / blockSlices;
+
+    // Blocks of output slices that get filtered in parallel
+    struct Block
     {
-        for (int y = r; y < volY - r; ++y)
+        SLint           z0, z1; // output slices z0 to z1-1
+        vector<SLVuint> ring;   // xy sums of the window in z
+        vector<SLVuint> after;  // xy sums of the r slices after the block
+        SLVuint         xSums;  // x sums of the slice that gets summed
+    };
+    vector<Block> blocks((SLuint)numBlocks);
+
+    auto sumSlice = [&](SLint z, Block& b, SLVuint& xySums) {
+        sumSliceXY(_images[(SLuint)z]->data(), stride, volX, volY, r, b.xSums, xySums);
+    };
+
+    // Phase 1: Sums of the slices that are overwritten by other blocks
+    SL::parallelFor((SLuint)numBlocks, [&](SLuint i) {
+        Block& b = blocks[i];
+        b.z0     = r + (SLint)i * blockSlices;
+        b.z1     = std::min(b.z0 + blockSlices, volZ - r);
+        b.xSums.resize(sliceSums);
+        b.ring.assign((SLuint)window, SLVuint(sliceSums, 0));
+
+        // The first 2r slices of the window around z0
+        for (SLint z = b.z0 - r; z < b.z0 + r; ++z)
+            sumSlice(z, b, b.ring[(SLuint)(z % window)]);
+
+        // The r slices after the block that the next block overwrites
+        if ((SLint)i < numBlocks - 1)
         {
-            for (int x = r; x < volX - r; ++x)
-            {
-                SLVec3f filtered(0, 0, 0);
+            b.after.assign((SLuint)r, SLVuint(sliceSums, 0));
+            for (SLint z = b.z1; z < b.z1 + r; ++z)
+                sumSlice(z, b, b.after[(SLuint)(z - b.z1)]);
+        }
+    });
 
-                // box filter (= average)
-                SLint num = 0;
-                for (int fz = z - r; fz <= z + r; ++fz)
+    // Phase 2: Filter the slices of each block from front to back
+    SL::parallelFor((SLuint)numBlocks, [&](SLuint i) {
+        Block& b = blocks[i];
+        for (SLint z = b.z0; z < b.z1; ++z)
+        {
+            // Add the slice at the front of the window to the ring
+            SLint zNew = z + r;
+            if (zNew >= b.z1 && !b.after.empty())
+                b.ring[(SLuint)(zNew % window)].swap(b.after[(SLuint)(zNew - b.z1)]);
+            else
+                sumSlice(zNew, b, b.ring[(SLuint)(zNew % window)]);
+
+            // Add the xy sums of the window in z and store the average
+            for (SLint y = r; y < volY - r; ++y)
+            {
+                SLuchar* row   = _images[(SLuint)z]->data() + y * stride;
+                SLuint   first = (SLuint)(y * volX * 3);
+                for (SLint x = r; x < volX - r; ++x)
                 {
-                    for (int fy = y - r; fy <= y + r; ++fy)
+                    for (SLint c = 0; c < 3; ++c)
                     {
-                        for (int fx = x - r; fx <= x + r; ++fx)
-                        {
-                            filtered += SLVec3f((SLfloat)_images[(SLuint)fz]->cvMat().at<cv::Vec4b>(fy, fx)[0] * oneOver255 * 2.0f - 1.0f,
-                                                (SLfloat)_images[(SLuint)fz]->cvMat().at<cv::Vec4b>(fy, fx)[1] * oneOver255 * 2.0f - 1.0f,
-                                                (SLfloat)_images[(SLuint)fz]->cvMat().at<cv::Vec4b>(fy, fx)[2] * oneOver255 * 2.0f - 1.0f);
-                            num++;
-                        }
+                        SLuint v   = first + (SLuint)(x * 3 + c);
+                        SLuint sum = 0;
+                        for (auto& sums : b.ring)
+                            sum += sums[v];
+                        row[x * 4 + c] = (SLuchar)(sum / numBox);
                     }
                 }
-                filtered /= (SLfloat)num;
-
-                // Store normal in the rgb channels. Scale range from -1 - 1 to 0 - 1 to 0 - 255
-                filtered += 1.0f;
-                _images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[0] = (SLuchar)(filtered.x * 0.5f * 255.0f);
-                _images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[1] = (SLuchar)(filtered.y * 0.5f * 255.0f);
-                _images[(SLuint)z]->cvMat().at<cv::Vec4b>(y, x)[2] = (SLuchar)(filtered.z * 0.5f * 255.0f);
             }
         }
-    }
+    });
 }
 //-----------------------------------------------------------------------------
 //! Computes the unnormalised vector x,y,z from tex. coords. uv with cubemap index.
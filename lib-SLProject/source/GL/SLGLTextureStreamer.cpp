@@ -0,0 +1,614 @@
+//#############################################################################
+//  File:      SLGLTextureStreamer.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+
+#include <SLGLTexture.h>
+#include <SLGLTextureStreamer.h>
+#include <SLProfiler.h>
+
+//-----------------------------------------------------------------------------
+//! Band of rows of a mip level that gets uploaded in the current frame
+struct SLStreamBand
+{
+    SLStreamJob* job;      //!< Job of the texture
+    SLint        level;    //!< Mip level
+    SLint        y;        //!< First row
+    SLint        rows;     //!< NO. of rows
+    size_t       offset;   //!< Offset in the PBO segment
+    SLbool       lastBand; //!< Flag if the band completes the level
+};
+//-----------------------------------------------------------------------------
+SLbool SLGLTextureStreamer::isOn              = false;
+SLuint SLGLTextureStreamer::uploadBudgetBytes = 4 * 1024 * 1024;
+SLuint SLGLTextureStreamer::numSegments       = 3;
+//-----------------------------------------------------------------------------
+SLGLTextureStreamer::SLGLTextureStreamer()
+  : _stop(false),
+    _pbo(0),
+    _segment(0),
+    _segmentBytes(0)
+{
+    _placeholders[0] = 0;
+    _placeholders[1] = 0;
+}
+//-----------------------------------------------------------------------------
+//! The destructor only stops the workers. The OpenGL objects get freed in clear.
+SLGLTextureStreamer::~SLGLTextureStreamer()
+{
+    stopWorkers();
+    for (auto job : _jobs)
+        deleteJob(job);
+    _jobs.clear();
+}
+//-----------------------------------------------------------------------------
+/*! Adds a texture whose image gets decoded from the passed file. The mip
+levels get reduced from the image if mipmaps is true. Can be called from any
+thread e.g. from the loader thread of an asynchronous import.
+*/
+void SLGLTextureStreamer::add(SLGLTexture*    texture,
+                              const SLstring& filename,
+                              SLbool          mipmaps)
+{
+    SLStreamJob* job  = new SLStreamJob;
+    job->texture      = texture;
+    job->filename     = filename;
+    job->mipmaps      = mipmaps;
+    job->resizeToPow2 = texture->_resizeToPow2;
+    job->state        = SJS_queued;
+    job->canceled     = false;
+    job->failed       = false;
+    job->image        = nullptr;
+    job->level        = 0;
+    job->row          = 0;
+
+    lock_guard<mutex> lock(_mutex);
+    if (_workers.empty())
+        startWorkers();
+    _jobs.push_back(job);
+    _queued.notify_one();
+}
+//-----------------------------------------------------------------------------
+/*! Removes the job of a texture that gets deleted. A job that is decoded right
+now gets deleted by its worker thread.
+*/
+void SLGLTextureStreamer::remove(SLGLTexture* texture)
+{
+    lock_guard<mutex> lock(_mutex);
+    for (auto it = _jobs.begin(); it != _jobs.end(); ++it)
+    {
+        SLStreamJob* job = *it;
+        if (job->texture == texture)
+        {
+            _jobs.erase(it);
+            if (job->state == SJS_decoding)
+                job->canceled = true;
+            else
+                deleteJob(job);
+            return;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Waits until the image of the texture is decoded and passes it to the
+texture. A job that no worker has started yet gets decoded on the calling
+thread. The upload of the mip levels continues in update.
+*/
+void SLGLTextureStreamer::waitForImage(SLGLTexture* texture)
+{
+    unique_lock<mutex> lock(_mutex);
+    while (texture->_imagePending)
+    {
+        SLStreamJob* job = nullptr;
+        for (auto j : _jobs)
+            if (j->texture == texture) job = j;
+        if (!job) break;
+
+        if (job->state == SJS_queued)
+        {
+            job->state = SJS_decoding;
+            lock.unlock();
+            decode(job);
+            lock.lock();
+            _decoded.notify_all();
+            if (job->canceled)
+            {
+                deleteJob(job);
+                break;
+            }
+            job->state = SJS_decoded;
+        }
+        else if (job->state == SJS_decoding)
+            _decoded.wait(lock);
+        else
+            takeImage(job);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Uploads the decoded mip levels within the frame budget and must be called
+once per frame on the render thread (see SLScene::onUpdate).
+\return true if there are textures in the streamer
+*/
+SLbool SLGLTextureStreamer::update()
+{
+    SL_PROFILE_SCOPE("Texture Upload");
+
+    SLGLState*   stateGL = SLGLState::getInstance();
+    SLVStreamJob uploads;
+
+    // Take over the decoded jobs. OpenGL ES 2 has no texture base level and
+    // builds the texture with the decoded image as usual.
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (_jobs.empty()) return false;
+
+        for (SLuint i = 0; i < _jobs.size();)
+        {
+            SLStreamJob* job = _jobs[i];
+            if (job->state == SJS_decoded)
+            {
+                if (job->image || job->failed) takeImage(job);
+
+                if (stateGL->glIsES2())
+                {
+                    job->texture->_isStreaming = false;
+                    _jobs.erase(_jobs.begin() + i);
+                    deleteJob(job);
+                    continue;
+                }
+                startUpload(job);
+            }
+            if (job->state == SJS_uploading)
+                uploads.push_back(job);
+            i++;
+        }
+    }
+
+    if (uploads.empty()) return true;
+
+    SLbool usePBO = stateGL->glIsES3() || stateGL->glVersionNOf() >= 3.2f;
+
+#ifndef SL_GLES2
+    if (usePBO && !_pbo)
+    {
+        // A segment holds at least one RGBA row of the max. texture size
+        SLint texMaxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &texMaxSize);
+        _segmentBytes = SL_max(uploadBudgetBytes, (SLuint)texMaxSize * 4);
+        _fences.assign(numSegments, nullptr);
+        _segment = 0;
+        glGenBuffers(1, &_pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER,
+                     (GLsizeiptr)_segmentBytes * numSegments,
+                     nullptr,
+                     GL_STREAM_DRAW);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    // Skip this frame if the GPU still reads from the next segment
+    if (usePBO && _fences[_segment])
+    {
+        if (glClientWaitSync(_fences[_segment], 0, 0) == GL_TIMEOUT_EXPIRED)
+            return true;
+        glDeleteSync(_fences[_segment]);
+        _fences[_segment] = nullptr;
+    }
+#else
+    usePBO = false;
+#endif
+
+    // Plan the bands of rows: The pending level with the fewest bytes first
+    vector<SLStreamBand> bands;
+    size_t               budget = usePBO ? _segmentBytes : uploadBudgetBytes;
+    size_t               used   = 0;
+    while (true)
+    {
+        SLStreamJob* next      = nullptr;
+        size_t       nextBytes = 0;
+        for (auto job : uploads)
+        {
+            if (job->level < 0) continue;
+            SLCVMat& mat   = job->levels[(SLuint)job->level];
+            size_t   bytes = (size_t)(mat.rows - job->row) * mat.cols * mat.elemSize();
+            if (!next || bytes < nextBytes)
+            {
+                next      = job;
+                nextBytes = bytes;
+            }
+        }
+        if (!next) break;
+
+        SLCVMat& mat         = next->levels[(SLuint)next->level];
+        size_t   bytesPerRow = (size_t)mat.cols * mat.elemSize();
+        SLint    rows        = SL_min(mat.rows - next->row,
+                                      (SLint)((budget - used) / bytesPerRow));
+        if (rows <= 0 && bands.empty()) rows = 1; // a row bigger than the budget
+        if (rows <= 0) break;
+
+        SLStreamBand band;
+        band.job      = next;
+        band.level    = next->level;
+        band.y        = next->row;
+        band.rows     = rows;
+        band.offset   = used;
+        band.lastBand = next->row + rows == mat.rows;
+        bands.push_back(band);
+
+        // Keep the offsets 16 byte aligned
+        used += ((size_t)rows * bytesPerRow + 15) & ~(size_t)15;
+        used = SL_min(used, budget);
+
+        next->row += rows;
+        if (band.lastBand)
+        {
+            next->row = 0;
+            next->level--;
+        }
+    }
+
+    if (bands.empty()) return true;
+
+    // Allocate the levels that start in this frame
+    for (auto& band : bands)
+    {
+        if (band.y == 0)
+        {
+            SLCVMat&   mat = band.job->levels[(SLuint)band.level];
+            SLCVImage* img = band.job->texture->_images[0];
+            SLint      internalFormat = img->format() == PF_red ? GL_R8 : img->format();
+            stateGL->bindTexture(GL_TEXTURE_2D, band.job->texture->_texName);
+            glTexImage2D(GL_TEXTURE_2D,
+                         band.level,
+                         internalFormat,
+                         mat.cols,
+                         mat.rows,
+                         0,
+                         img->format(),
+                         GL_UNSIGNED_BYTE,
+                         nullptr);
+        }
+    }
+
+    // Copy the bands into the PBO segment of this frame without any sync.
+    // The fence of the segment guarantees that the GPU doesn't read it anymore.
+    size_t segmentStart = (size_t)_segment * _segmentBytes;
+#ifndef SL_GLES2
+    if (usePBO)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbo);
+        SLuchar* mapped = (SLuchar*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                                     (GLintptr)segmentStart,
+                                                     (GLsizeiptr)used,
+                                                     GL_MAP_WRITE_BIT |
+                                                       GL_MAP_INVALIDATE_RANGE_BIT |
+                                                       GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped)
+        {
+            for (auto& band : bands)
+            {
+                SLCVMat& mat         = band.job->levels[(SLuint)band.level];
+                size_t   bytesPerRow = (size_t)mat.cols * mat.elemSize();
+                for (SLint r = 0; r < band.rows; ++r)
+                    memcpy(mapped + band.offset + (size_t)r * bytesPerRow,
+                           mat.ptr(band.y + r),
+                           bytesPerRow);
+            }
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        else
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            usePBO = false;
+        }
+    }
+#endif
+
+    // Upload the bands from the PBO or directly from the levels
+    for (auto& band : bands)
+    {
+        SLCVMat&   mat  = band.job->levels[(SLuint)band.level];
+        SLCVImage* img  = band.job->texture->_images[0];
+        GLvoid*    data = usePBO
+                         ? (GLvoid*)(segmentStart + band.offset)
+                         : (GLvoid*)mat.ptr(band.y);
+
+        stateGL->bindTexture(GL_TEXTURE_2D, band.job->texture->_texName);
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        band.level,
+                        0,
+                        band.y,
+                        mat.cols,
+                        band.rows,
+                        img->format(),
+                        GL_UNSIGNED_BYTE,
+                        data);
+
+        if (band.lastBand)
+            finishLevel(band.job, band.level);
+    }
+
+#ifndef SL_GLES2
+    if (usePBO)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        _fences[_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        _segment          = (_segment + 1) % numSegments;
+    }
+#endif
+
+    GET_GL_ERROR;
+
+    // Remove the jobs with all levels on the GPU
+    lock_guard<mutex> lock(_mutex);
+    for (auto job : uploads)
+    {
+        if (job->level < 0)
+        {
+            _jobs.erase(std::find(_jobs.begin(), _jobs.end(), job));
+            job->texture->_isStreaming = false;
+            deleteJob(job);
+        }
+    }
+
+    return true;
+}
+//-----------------------------------------------------------------------------
+/*! Binds the placeholder texture of a streamed texture that has no mip level
+on the GPU yet. Normal maps get a flat normal and all others a gray texel.
+*/
+void SLGLTextureStreamer::bindPlaceholder(SLint texID, SLTextureType type)
+{
+    SLGLState* stateGL = SLGLState::getInstance();
+    SLuint     i       = type == TT_normal ? 1 : 0;
+
+    stateGL->activeTexture(GL_TEXTURE0 + (SLuint)texID);
+
+    if (!_placeholders[i])
+    {
+        static const SLuchar texels[2][4] = {{128, 128, 128, 255},
+                                             {128, 128, 255, 255}};
+        glGenTextures(1, &_placeholders[i]);
+        stateGL->bindTexture(GL_TEXTURE_2D, _placeholders[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GL_RGBA,
+                     1,
+                     1,
+                     0,
+                     GL_RGBA,
+                     GL_UNSIGNED_BYTE,
+                     texels[i]);
+    }
+    else
+        stateGL->bindTexture(GL_TEXTURE_2D, _placeholders[i]);
+
+    GET_GL_ERROR;
+}
+//-----------------------------------------------------------------------------
+/*! Stops the workers and deletes the remaining jobs and the OpenGL objects.
+Is called in SLScene::unInit after all textures got deleted.
+*/
+void SLGLTextureStreamer::clear()
+{
+    stopWorkers();
+
+    for (auto job : _jobs)
+    {
+        job->texture->_isStreaming  = false;
+        job->texture->_imagePending = false;
+        deleteJob(job);
+    }
+    _jobs.clear();
+
+    glDeleteTextures(2, _placeholders);
+    _placeholders[0] = 0;
+    _placeholders[1] = 0;
+
+#ifndef SL_GLES2
+    for (auto fence : _fences)
+        if (fence) glDeleteSync(fence);
+    _fences.clear();
+
+    if (_pbo) glDeleteBuffers(1, &_pbo);
+    _pbo = 0;
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Returns the NO. of textures that are not completely uploaded
+SLuint SLGLTextureStreamer::numJobs()
+{
+    lock_guard<mutex> lock(_mutex);
+    return (SLuint)_jobs.size();
+}
+//-----------------------------------------------------------------------------
+//! Starts the worker threads. The render thread keeps its own core.
+void SLGLTextureStreamer::startWorkers()
+{
+    SLuint numWorkers = SL_max(SL::maxThreads() - 1, 1U);
+    for (SLuint i = 0; i < numWorkers; ++i)
+        _workers.push_back(thread(&SLGLTextureStreamer::decodeJobs, this));
+}
+//-----------------------------------------------------------------------------
+//! Stops the worker threads after they have finished their current job
+void SLGLTextureStreamer::stopWorkers()
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _queued.notify_all();
+
+    for (auto& worker : _workers)
+        worker.join();
+    _workers.clear();
+    _stop = false;
+}
+//-----------------------------------------------------------------------------
+//! Loop of the worker threads that decode the queued jobs in the adding order
+void SLGLTextureStreamer::decodeJobs()
+{
+    unique_lock<mutex> lock(_mutex);
+    while (true)
+    {
+        SLStreamJob* job = nullptr;
+        _queued.wait(lock, [&] {
+            if (_stop) return true;
+            for (auto j : _jobs)
+            {
+                if (j->state == SJS_queued)
+                {
+                    job = j;
+                    return true;
+                }
+            }
+            return false;
+        });
+        if (_stop) return;
+
+        job->state = SJS_decoding;
+        lock.unlock();
+        decode(job);
+        lock.lock();
+
+        if (job->canceled)
+            deleteJob(job);
+        else
+            job->state = SJS_decoded;
+        _decoded.notify_all();
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Decodes the image and reduces its mip levels down to 1x1 pixel with the
+same sizes as OpenGL expects them (max(1, size >> level)). Level 0 shares the
+image data.
+*/
+void SLGLTextureStreamer::decode(SLStreamJob* job)
+{
+    SL_PROFILE_SCOPE("Texture Decode");
+
+    // A failure gets reported by takeImage and not here on the worker thread
+    job->image = new SLCVImage();
+    if (!job->image->load(job->filename, true, false, false))
+    {
+        delete job->image;
+        job->image  = nullptr;
+        job->failed = true;
+        return;
+    }
+
+    if (job->resizeToPow2)
+    {
+        SLuint w2 = SLGLTexture::closestPowerOf2(job->image->width());
+        SLuint h2 = SLGLTexture::closestPowerOf2(job->image->height());
+        if (w2 != job->image->width() || h2 != job->image->height())
+            job->image->resize((SLint)w2, (SLint)h2);
+    }
+
+    job->levels.push_back(job->image->cvMat());
+
+    if (job->mipmaps)
+    {
+        SLint w         = job->levels[0].cols;
+        SLint h         = job->levels[0].rows;
+        SLint numLevels = (SLint)floor(log2((SLfloat)SL_max(w, h))) + 1;
+
+        for (SLint l = 1; l < numLevels; ++l)
+        {
+            SLCVMat level;
+            cv::resize(job->levels[(SLuint)l - 1],
+                       level,
+                       cv::Size(SL_max(w >> l, 1), SL_max(h >> l, 1)),
+                       0,
+                       0,
+                       cv::INTER_AREA);
+            job->levels.push_back(level);
+        }
+    }
+
+    job->level = (SLint)job->levels.size() - 1;
+    job->row   = 0;
+}
+//-----------------------------------------------------------------------------
+//! Passes the decoded image to the texture (called with locked _mutex)
+void SLGLTextureStreamer::takeImage(SLStreamJob* job)
+{
+    if (job->failed)
+        SL_EXIT_MSG(("SLGLTextureStreamer: Decoding failed: " + job->filename).c_str());
+
+    job->texture->_images.push_back(job->image);
+    job->image                  = nullptr;
+    job->texture->_imagePending = false;
+}
+//-----------------------------------------------------------------------------
+/*! Creates the OpenGL texture of a decoded job on the render thread. Only the
+coarsest level is used by the sampler until finer levels are uploaded.
+*/
+void SLGLTextureStreamer::startUpload(SLStreamJob* job)
+{
+    SLGLTexture* texture = job->texture;
+    SLGLState*   stateGL = SLGLState::getInstance();
+
+    SLint texMaxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &texMaxSize);
+    if (job->levels[0].cols > texMaxSize || job->levels[0].rows > texMaxSize)
+        SL_EXIT_MSG(("SLGLTextureStreamer: Texture is too big: " +
+                     texture->name())
+                      .c_str());
+
+    glGenTextures(1, &texture->_texName);
+    stateGL->bindTexture(GL_TEXTURE_2D, texture->_texName);
+    texture->setTexParameters();
+
+#ifndef SL_GLES2
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, job->level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, job->level);
+#endif
+
+    job->state = SJS_uploading;
+}
+//-----------------------------------------------------------------------------
+/*! Lets the sampler use the completed level and frees its CPU copy. After
+level 0 the texture is complete and the GPU memory gets counted.
+*/
+void SLGLTextureStreamer::finishLevel(SLStreamJob* job, SLint level)
+{
+    SLGLTexture* texture = job->texture;
+
+#ifndef SL_GLES2
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+#endif
+    texture->_streamLevel = level;
+
+    if (level > 0)
+        job->levels[(SLuint)level].release();
+    else
+    {
+        SLCVImage* img = texture->_images[0];
+        texture->_bytesOnGPU = img->bytesPerImage();
+        if (job->levels.size() > 1)
+            texture->_bytesOnGPU = (SLuint)((SLfloat)texture->_bytesOnGPU * 1.333333333f);
+        SLGLTexture::numBytesInTextures += texture->_bytesOnGPU;
+    }
+}
+//-----------------------------------------------------------------------------
+//! Deletes a job with its image if the texture hasn't taken it over
+void SLGLTextureStreamer::deleteJob(SLStreamJob* job)
+{
+    delete job->image;
+    delete job;
+}
+//-----------------------------------------------------------------------------
@@ -30,7 +30,6 @@ SLGLVertexArray::SLGLVertexArray()
     _hasGL3orGreater = SLGLState::getInstance()->glVersionNOf() >= 3.0f;
     _idVAO           = 0;
 
-    _VBOf.dataType(BT_float);
     _VBOf.clear();
     _idVBOIndices = 0;
     _numIndices   = 0;
@@ -78,12 +77,15 @@ If all attributes of a vertex array have the same data pointer the data input
 will be interpreted as an interleaved array. See example in SLGLOculus::init.
 Be aware that the VBO for the attribute will not be generated until generate 
 is called. The data pointer must still be valid when SLGLVertexArray::generate 
-is called.
+is called. The components are floats by default. Integer components are
+converted to floats by OpenGL either directly or normalized to [0,1] or [-1,1].
 */
 void SLGLVertexArray::setAttrib(SLGLAttributeType type,
                                 SLint             elementSize,
                                 SLint             location,
-                                void*             dataPointer)
+                                void*             dataPointer,
+                                SLGLBufferType    dataType,
+                                SLbool            normalized)
 {
     assert(dataPointer);
     assert(elementSize);
@@ -97,6 +99,8 @@ void SLGLVertexArray::setAttrib(SLGLAttributeType type,
     SLGLAttribute va;
     va.type            = type;
     va.elementSize     = elementSize;
+    va.dataType        = dataType;
+    va.normalized      = normalized;
     va.dataPointer     = dataPointer;
     va.location        = location;
     va.bufferSizeBytes = 0;
@@ -132,7 +136,8 @@ with vertex skinning. See SLMesh::draw where we have joint attributes.
 */
 void SLGLVertexArray::updateAttrib(SLGLAttributeType type,
                                    SLint             elementSize,
-                                   void*             dataPointer)
+                                   void*             dataPointer,
+                                   SLuint            numVertices)
 {
     assert(dataPointer && "No data pointer passed");
     assert(elementSize > 0 && elementSize < 5 && "Element size invalid");
@@ -153,7 +158,7 @@ void SLGLVertexArray::updateAttrib(SLGLAttributeType type,
 
     // update the appropriate VBO
     if (indexf > -1)
-        _VBOf.updateAttrib(type, elementSize, dataPointer);
+        _VBOf.updateAttrib(type, elementSize, dataPointer, numVertices);
 
 #ifndef SL_GLES2
     if (_hasGL3orGreater)
@@ -31,7 +31,6 @@ SLGLVertexBuffer::SLGLVertexBuffer()
     _sizeBytes         = 0;
     _outputInterleaved = false;
     _usage             = BU_stream;
-    _dataType          = BT_float;
 }
 //-----------------------------------------------------------------------------
 /*! Deletes the OpenGL objects for the vertex array and the vertex buffer.
@@ -68,7 +67,8 @@ with vertex skinning. See SLMesh::draw where we have joint attributes.
 */
 void SLGLVertexBuffer::updateAttrib(SLGLAttributeType type,
                                     SLint             elementSize,
-                                    void*             dataPointer)
+                                    void*             dataPointer,
+                                    SLuint            numVertices)
 {
     assert(dataPointer && "No data pointer passed");
     assert(elementSize > 0 && elementSize < 5 && "Element size invalid");
@@ -88,6 +88,13 @@ void SLGLVertexBuffer::updateAttrib(SLGLAttributeType type,
 
     _attribs[(SLuint)index].dataPointer = dataPointer;
 
+    // Only the first numVertices get copied if it is not 0
+    SLuint sizeBytes = _attribs[(SLuint)index].bufferSizeBytes;
+    if (numVertices)
+        sizeBytes = std::min(sizeBytes,
+                             numVertices * (SLuint)elementSize *
+                               sizeOfType(_attribs[(SLuint)index].dataType));
+
     ////////////////////////////////////////////
     // copy sub-data into existing buffer object
     ////////////////////////////////////////////
@@ -95,7 +102,7 @@ void SLGLVertexBuffer::updateAttrib(SLGLAttributeType type,
     glBindBuffer(GL_ARRAY_BUFFER, _id);
     glBufferSubData(GL_ARRAY_BUFFER,
                     _attribs[(SLuint)index].offsetBytes,
-                    _attribs[(SLuint)index].bufferSizeBytes,
+                    sizeBytes,
                     _attribs[(SLuint)index].dataPointer);
 
 #ifdef _GLDEBUG
@@ -178,7 +185,7 @@ void SLGLVertexBuffer::generate(SLuint          numVertices,
         _outputInterleaved = true;
         for (SLuint i = 0; i < _attribs.size(); ++i)
         {
-            SLuint elementSizeBytes     = (SLuint)_attribs[i].elementSize * sizeOfType(_dataType);
+            SLuint elementSizeBytes     = (SLuint)_attribs[i].elementSize * sizeOfType(_attribs[i].dataType);
             _attribs[i].offsetBytes     = _strideBytes;
             _attribs[i].bufferSizeBytes = elementSizeBytes * _numVertices;
             _sizeBytes += _attribs[i].bufferSizeBytes;
@@ -189,7 +196,7 @@ void SLGLVertexBuffer::generate(SLuint          numVertices,
     {
         for (SLuint i = 0; i < _attribs.size(); ++i)
         {
-            SLuint elementSizeBytes = (SLuint)_attribs[i].elementSize * sizeOfType(_dataType);
+            SLuint elementSizeBytes = (SLuint)_attribs[i].elementSize * sizeOfType(_attribs[i].dataType);
             if (_outputInterleaved)
                 _attribs[i].offsetBytes = _strideBytes;
             else
@@ -212,8 +219,8 @@ void SLGLVertexBuffer::generate(SLuint          numVertices,
             { // Sets the vertex attribute data pointer to its corresponding GLSL variable
                 glVertexAttribPointer((SLuint)a.location,
                                       a.elementSize,
-                                      _dataType,
-                                      GL_FALSE,
+                                      a.dataType,
+                                      a.normalized,
                                       (SLint)_strideBytes,
                                       (void*)(size_t)a.offsetBytes);
 
@@ -234,7 +241,7 @@ void SLGLVertexBuffer::generate(SLuint          numVertices,
 
             for (auto a : _attribs)
             {
-                SLuint elementSizeBytes = (SLuint)a.elementSize * sizeOfType(_dataType);
+                SLuint elementSizeBytes = (SLuint)a.elementSize * sizeOfType(a.dataType);
 
                 // Copy attributes interleaved
                 for (SLuint v = 0; v < _numVertices; ++v)
@@ -249,8 +256,8 @@ void SLGLVertexBuffer::generate(SLuint          numVertices,
                 { // Sets the vertex attribute data pointer to its corresponding GLSL variable
                     glVertexAttribPointer((SLuint)a.location,
                                           a.elementSize,
-                                          _dataType,
-                                          GL_FALSE,
+                                          a.dataType,
+                                          a.normalized,
                                           (SLint)_strideBytes,
                                           (void*)(size_t)a.offsetBytes);
 
@@ -280,8 +287,8 @@ void SLGLVertexBuffer::generate(SLuint          numVertices,
                     // Sets the vertex attribute data pointer to its corresponding GLSL variable
                     glVertexAttribPointer((SLuint)a.location,
                                           a.elementSize,
-                                          _dataType,
-                                          GL_FALSE,
+                                          a.dataType,
+                                          a.normalized,
                                           0,
                                           (void*)(size_t)a.offsetBytes);
 
@@ -317,8 +324,8 @@ void SLGLVertexBuffer::bindAndEnableAttrib()
                 // Sets the vertex attribute data pointer to its corresponding GLSL variable
                 glVertexAttribPointer((SLuint)a.location,
                                       a.elementSize,
-                                      _dataType,
-                                      GL_FALSE,
+                                      a.dataType,
+                                      a.normalized,
                                       (SLsizei)_strideBytes,
                                       (void*)(size_t)a.offsetBytes);
 
@@ -349,6 +356,8 @@ SLuint SLGLVertexBuffer::sizeOfType(SLGLBufferType type)
     switch (type)
     {
         case BT_float: return sizeof(float);
+        case BT_half: return sizeof(unsigned short);
+        case BT_short: return sizeof(short);
         case BT_ubyte: return sizeof(unsigned char);
         case BT_ushort: return sizeof(unsigned short);
         case BT_uint: return sizeof(unsigned int);
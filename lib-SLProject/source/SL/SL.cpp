@@ -14,6 +14,9 @@
 #    include <debug_new.h> // memory leak detector
 #endif
 
+#include <condition_variable>
+#include <mutex>
+
 //-----------------------------------------------------------------------------
 //! SL::log logs a formatted string platform independently
 void SL::log(const char* format, ...)
@@ -80,3 +83,207 @@ SLuint SL::maxThreads()
 #endif
 }
 //-----------------------------------------------------------------------------
+/*! A job of the SL thread pool that processes the stages passed to
+SL::parallelStages. The current stage and the next unprocessed index are
+packed into one 64-bit atomic so that a thread can claim an index with a single
+compare and swap. The thread that finishes the last index of a stage starts the
+next stage.
+*/
+class SLParallelJob
+{
+    public:
+    SLParallelJob(const SLVParallelStage& stages)
+      : stages(stages),
+        done(new atomic<SLuint>[stages.size()]),
+        numWorkers(0)
+    {
+        for (SLuint s = 0; s < stages.size(); ++s)
+            done[s] = 0;
+        state = pack(nextStage(0), 0);
+    }
+
+    //! Returns the current stage
+    SLuint stage() { return stageOf(state); }
+
+    //! Returns true if all stages are processed
+    SLbool finished() { return stage() >= stages.size(); }
+
+    //! Returns true if an index of the current stage is unclaimed
+    SLbool claimable()
+    {
+        SLuint64 s = state;
+        return stageOf(s) < stages.size() &&
+               indexOf(s) < stages[stageOf(s)].num;
+    }
+
+    //! Claims and processes one index. Returns false if none is claimable
+    SLbool work()
+    {
+        SLuint64 s = state;
+        while (stageOf(s) < stages.size() &&
+               indexOf(s) < stages[stageOf(s)].num)
+        {
+            if (state.compare_exchange_weak(s, s + 1))
+            {
+                SLuint stage = stageOf(s);
+                stages[stage].function(indexOf(s));
+                if (++done[stage] == stages[stage].num)
+                    state = pack(nextStage(stage + 1), 0);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const SLVParallelStage&      stages;     //!< Stages processed in order
+    unique_ptr<atomic<SLuint>[]> done;       //!< NO. of finished indices per stage
+    atomic<SLuint64>             state;      //!< Current stage << 32 | next index
+    SLuint                       numWorkers; //!< NO. of pool threads in the job
+
+    private:
+    //! Returns the first stage from stage on with indices to process
+    SLuint nextStage(SLuint stage)
+    {
+        while (stage < stages.size() && stages[stage].num == 0)
+            stage++;
+        return stage;
+    }
+    static SLuint64 pack(SLuint stage, SLuint i) { return ((SLuint64)stage << 32) | i; }
+    static SLuint   stageOf(SLuint64 s) { return (SLuint)(s >> 32); }
+    static SLuint   indexOf(SLuint64 s) { return (SLuint)(s & 0xFFFFFFFF); }
+};
+//-----------------------------------------------------------------------------
+/*! The thread pool of SL::parallelStages with SL::maxThreads - 1 worker
+threads. It is created on the first parallel call and reused by all later
+calls. The workers help on all pending jobs. Jobs can be nested and issued from
+several threads because the calling thread always works on its own job.
+*/
+class SLThreadPool
+{
+    public:
+    SLThreadPool()
+    {
+        for (SLuint t = 0; t < SL::maxThreads() - 1; t++)
+            _threads.push_back(thread(&SLThreadPool::workerLoop, this));
+    }
+
+    ~SLThreadPool()
+    {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (auto& t : _threads)
+            t.join();
+    }
+
+    //! Lazily created pool instance
+    static SLThreadPool& instance()
+    {
+        static SLThreadPool pool;
+        return pool;
+    }
+
+    //! Processes the job on the pool and the calling thread
+    void run(SLParallelJob& job)
+    {
+        {
+            lock_guard<mutex> lock(_mutex);
+            _jobs.push_back(&job);
+        }
+        _condition.notify_all();
+
+        // The job lives on the callers stack, so wait for all workers to leave
+        unique_lock<mutex> lock(_mutex);
+        while (!job.finished() || job.numWorkers > 0)
+        {
+            if (job.claimable())
+            {
+                lock.unlock();
+                workOn(job);
+                lock.lock();
+            }
+            else
+                _condition.wait(lock);
+        }
+        _jobs.erase(std::find(_jobs.begin(), _jobs.end(), &job));
+    }
+
+    private:
+    //! Worker thread function that helps on the first claimable job
+    void workerLoop()
+    {
+        unique_lock<mutex> lock(_mutex);
+        while (!_stop)
+        {
+            SLParallelJob* job = nullptr;
+            for (auto j : _jobs)
+                if (j->claimable())
+                {
+                    job = j;
+                    break;
+                }
+
+            if (!job)
+            {
+                _condition.wait(lock);
+                continue;
+            }
+
+            job->numWorkers++;
+            lock.unlock();
+            workOn(*job);
+            lock.lock();
+            job->numWorkers--;
+            _condition.notify_all();
+        }
+    }
+
+    //! Works on the job and wakes up the waiting threads on a new stage
+    void workOn(SLParallelJob& job)
+    {
+        SLuint stage = job.stage();
+        while (job.work())
+        {
+            if (job.stage() != stage)
+            {
+                stage = job.stage();
+                { lock_guard<mutex> lock(_mutex); }
+                _condition.notify_all();
+            }
+        }
+    }
+
+    vector<thread>         _threads;      //!< Worker threads
+    vector<SLParallelJob*> _jobs;         //!< Pending jobs
+    mutex                  _mutex;        //!< Mutex for _jobs and _stop
+    condition_variable     _condition;    //!< Signals new jobs and stages
+    SLbool                 _stop = false; //!< Flag to end the workers
+};
+//-----------------------------------------------------------------------------
+/*! Processes the stages in order. The function of a stage is called for all
+its indices from 0 to num-1 and a stage starts only when all indices of the
+previous one are finished. The indices are processed by the worker threads of
+a static thread pool that is created on the first call, so no threads are
+started per call. The calling thread works as well and returns when all stages
+are finished. Chaining dependent stages in one call avoids that the pool
+threads fall asleep between them.
+*/
+void SL::parallelStages(const SLVParallelStage& stages)
+{
+    SLParallelJob job(stages);
+    if (job.finished()) return;
+
+    // No pool for a single thread or a single index
+    if (SL::maxThreads() == 1 ||
+        (stages.size() == 1 && stages[0].num == 1))
+    {
+        while (job.work())
+            ;
+        return;
+    }
+
+    SLThreadPool::instance().run(job);
+}
+//-----------------------------------------------------------------------------
@@ -17,12 +17,16 @@
 #include <SLAssimpImporter.h>
 #include <SLGLProgram.h>
 #include <SLGLTexture.h>
+#include <SLGLTextureStreamer.h>
 #include <SLMaterial.h>
 #include <SLScene.h>
+#include <SLMeshOptimizer.h>
+#include <SLSceneCache.h>
 #include <SLSkeleton.h>
 
 // assimp is only included in the source file to not expose it to the rest of the framework
 #include <assimp/Importer.hpp>
+#include <assimp/ProgressHandler.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
@@ -259,7 +263,71 @@ SLQuat4f getRotation(SLfloat time, const KeyframeMap& keyframes)
 
     return SLQuat4f(result.x, result.y, result.z, result.w);
 }
+//-----------------------------------------------------------------------------
+//! AssImp progress handler that aborts the file reading of a canceled load
+class SLAssimpProgressHandler : public Assimp::ProgressHandler
+{
+    public:
+    SLAssimpProgressHandler(atomic<bool>& cancel) : _cancel(cancel) {}
 
+    virtual bool Update(float) { return !_cancel; }
+
+    private:
+    atomic<bool>& _cancel; //!< cancel flag of the importer
+};
+//-----------------------------------------------------------------------------
+// Static members
+SLfloat SLAssimpImporter::uploadBudgetMS            = 4.0f;
+SLbool  SLAssimpImporter::compileSkeletonAnimations = false;
+//-----------------------------------------------------------------------------
+SLAssimpImporter::SLAssimpImporter()
+  : _asyncState(ALS_none),
+    _cancel(false),
+    _progressPC(0),
+    _numUploaded(0)
+{
+}
+//-----------------------------------------------------------------------------
+SLAssimpImporter::SLAssimpImporter(SLLogVerbosity consoleVerb)
+  : SLImporter(consoleVerb),
+    _asyncState(ALS_none),
+    _cancel(false),
+    _progressPC(0),
+    _numUploaded(0)
+{
+}
+//-----------------------------------------------------------------------------
+SLAssimpImporter::SLAssimpImporter(SLstring&      logFile,
+                                   SLLogVerbosity logConsoleVerb,
+                                   SLLogVerbosity logFileVerb)
+  : SLImporter(logFile, logConsoleVerb, logFileVerb),
+    _asyncState(ALS_none),
+    _cancel(false),
+    _progressPC(0),
+    _numUploaded(0)
+{
+}
+//-----------------------------------------------------------------------------
+/*! Aborts a running asynchronous load and deletes the resources and nodes
+that were not yet passed to the scene.
+*/
+SLAssimpImporter::~SLAssimpImporter()
+{
+    _cancel = true;
+    if (_loadThread.joinable())
+        _loadThread.join();
+
+    if (_asyncState != ALS_none && _asyncState != ALS_finished)
+    {
+        delete _sceneRoot;
+        for (auto m : _staging.meshes) delete m;
+        for (auto m : _staging.materials) delete m;
+        for (auto t : _staging.textures) delete t;
+        // The skeletons and animations get deleted by the staging animManager
+    }
+
+    clear();
+}
 //-----------------------------------------------------------------------------
 /*! Loads the scene from a file and creates materials with textures, the 
 meshes and the nodes for the scene graph. Materials, textures and meshes are
@@ -291,38 +359,93 @@ SLNode* SLAssimpImporter::load(SLstring    file,           //!< File with path o
         }
     }
 
+    // Read the scene data from the binary cache of an earlier import
+    SLstring fileName  = SLUtils::getFileName(file);
+    SLstring cacheFile = SLSceneCache::isOn
+                           ? SLSceneCache::cacheFile(file, loadMeshesOnly, overrideMat != nullptr, flags)
+                           : "";
+    if (!cacheFile.empty() && SLFileSystem::fileExists(cacheFile))
+    {
+        progress(0, "Reading cache of " + fileName);
+        SLTimer timer;
+        timer.start();
+        _sceneRoot = SLSceneCache::read(cacheFile, overrideMat, _meshes, _skeleton, _nodeAnimations);
+        if (_sceneRoot)
+        {
+            logMessage(LV_minimal,
+                       "Loaded %s from cache in %.1f ms\n",
+                       fileName.c_str(),
+                       timer.elapsedTimeInMilliSec());
+            _sceneRoot->name(fileName);
+            return _sceneRoot;
+        }
+    }
+
     // Import file with assimp importer
+    progress(0, "Reading " + fileName);
     Assimp::Importer ai;
-    const aiScene*   scene = ai.ReadFile(file.c_str(), (SLuint)flags);
+    ai.SetProgressHandler(new SLAssimpProgressHandler(_cancel));
+    const aiScene* scene = ai.ReadFile(file.c_str(), (SLuint)flags);
     if (!scene)
     {
-        SLstring msg = "Failed to load file: " + file + "\n" + ai.GetErrorString() + "\n";
-        SL_WARN_MSG(msg.c_str());
+        if (!_cancel)
+        {
+            SLstring msg = "Failed to load file: " + file + "\n" + ai.GetErrorString() + "\n";
+            SL_WARN_MSG(msg.c_str());
+        }
         return nullptr;
     }
 
     // initial scan of the scene
+    progress(50, "Converting " + fileName);
     performInitialScan(scene);
 
     // load skeleton
     loadSkeleton(nullptr, _skeletonRoot);
 
-    // load materials
+    // load materials with the texture images decoded in parallel. Streamed
+    // textures get decoded by the SLGLTextureStreamer without blocking the load.
     SLstring    modelPath = SLUtils::getPath(file);
     SLVMaterial materials;
     if (!overrideMat)
     {
+        if (!SLGLTextureStreamer::isOn)
+            loadTextureImages(scene, modelPath);
+
         for (SLint i = 0; i < (SLint)scene->mNumMaterials; i++)
             materials.push_back(loadMaterial(i, scene->mMaterials[i], modelPath));
     }
 
     // load meshes & set their material
     std::map<int, SLMesh*> meshMap; // map from the ai index to our mesh
+    SLfloat                missesBefore = 0.0f, missesAfter = 0.0f;
+    SLuint                 numOptTriangles = 0;
     for (SLint i = 0; i < (SLint)scene->mNumMeshes; i++)
     {
+        if (_cancel)
+            return nullptr;
+
+        progress(60 + 20 * i / (SLint)scene->mNumMeshes, "Converting " + fileName);
+
         SLMesh* mesh = loadMesh(scene->mMeshes[i]);
         if (mesh != nullptr)
         {
+            // reorder triangles & vertices for the GPU caches
+            if (SLMeshOptimizer::isOn && mesh->primitive() == PT_triangles)
+            {
+                SLuint  numT = mesh->numI() / 3;
+                SLfloat acmrBefore, acmrAfter;
+                SLMeshOptimizer::optimize(mesh, &acmrBefore, &acmrAfter);
+                logMessage(LV_detailed,
+                           "  Optimized mesh %s: ACMR %.3f -> %.3f\n",
+                           mesh->name().c_str(),
+                           acmrBefore,
+                           acmrAfter);
+                missesBefore += acmrBefore * (SLfloat)numT;
+                missesAfter += acmrAfter * (SLfloat)numT;
+                numOptTriangles += numT;
+            }
+
             if (overrideMat)
                 mesh->mat(overrideMat);
             else
@@ -336,6 +459,13 @@ SLNode* SLAssimpImporter::load(SLstring    file,           //!< File with path o
                    modelPath.c_str());
     }
 
+    if (numOptTriangles)
+        logMessage(LV_minimal,
+                   "Mesh optimization: ACMR %.3f -> %.3f of %u triangles\n",
+                   missesBefore / (SLfloat)numOptTriangles,
+                   missesAfter / (SLfloat)numOptTriangles,
+                   numOptTriangles);
+
     // load the scene nodes recursively
     _sceneRoot = loadNodesRec(nullptr, scene->mRootNode, meshMap, loadMeshesOnly);
 
@@ -344,15 +474,149 @@ SLNode* SLAssimpImporter::load(SLstring    file,           //!< File with path o
     for (SLint i = 0; i < (SLint)scene->mNumAnimations; i++)
         animations.push_back(loadAnimation(scene->mAnimations[i]));
 
+    // delete the decoded images that were not used by a texture
+    for (auto it : _texImages)
+        delete it.second;
+    _texImages.clear();
+
     logMessage(LV_minimal, "\n---------------------------\n\n");
 
     // Rename root node to the more meaningfull filename
     if (_sceneRoot)
         _sceneRoot->name(SLUtils::getFileName(file));
 
+    // Write the scene data into the binary cache for the next load
+    if (_sceneRoot && !cacheFile.empty())
+        SLSceneCache::write(cacheFile, _sceneRoot, _skeleton, _nodeAnimations);
+
     return _sceneRoot;
 }
 //-----------------------------------------------------------------------------
+/*! Starts loading the file on a loader thread and returns immediately. The
+importer gets added to SLScene::asyncImporters. The scene finishes the load on
+the render thread with finishAsync and deletes the importer afterwards. The
+callback gets the loaded root node or nullptr if the loading failed. The node
+is not yet added to the scene graph.
+*/
+void SLAssimpImporter::loadAsync(SLstring       file,
+                                 SLLoadCallback onLoaded,
+                                 SLbool         loadMeshesOnly,
+                                 SLMaterial*    overrideMat,
+                                 SLuint         flags)
+{
+    assert(_asyncState == ALS_none &&
+           "SLAssimpImporter::loadAsync: An importer loads only once asynchronously.");
+
+    _onLoaded   = onLoaded;
+    _asyncState = ALS_loading;
+    progress(0, "Loading " + SLUtils::getFileName(file));
+
+    SLApplication::scene->asyncImporters().push_back(this);
+
+    _loadThread = thread([=]() {
+        // All resources created on this thread are added to the staging
+        SLScene::staging(&_staging);
+        load(file, loadMeshesOnly, overrideMat, flags);
+        SLScene::staging(nullptr);
+
+        _asyncState = ALS_converted;
+    });
+}
+//-----------------------------------------------------------------------------
+/*! Finishes an asynchronous load on the render thread and must be called once
+per frame (see SLScene::onUpdate). After the loader thread has finished the
+OpenGL textures and vertex array objects are created one by one until the
+passed time budget is used up, but at least one per call. When all exist the
+resources are moved into the scene and the loaded root node is passed to the
+callback.
+\return true if the load is finished and the importer can be deleted
+*/
+SLbool SLAssimpImporter::finishAsync(SLfloat budgetMS)
+{
+    if (_asyncState == ALS_loading)
+        return false;
+
+    if (_asyncState == ALS_converted)
+    {
+        _loadThread.join();
+        _numUploaded = 0;
+        _asyncState  = ALS_uploading;
+    }
+
+    if (_asyncState == ALS_uploading)
+    {
+        SLTimer timer;
+        timer.start();
+
+        SLbool objectsLeft;
+        do
+        {
+            objectsLeft = uploadNext();
+        } while (objectsLeft && timer.elapsedTimeInMilliSec() < budgetMS);
+
+        if (objectsLeft)
+            return false;
+
+        SLApplication::scene->addStaging(_staging);
+        _asyncState = ALS_finished;
+        progress(100, "Finished " + (_sceneRoot ? _sceneRoot->name() : "loading"));
+
+        if (_onLoaded)
+            _onLoaded(_sceneRoot);
+    }
+
+    return true;
+}
+//-----------------------------------------------------------------------------
+/*! Creates the OpenGL object of the next texture or mesh of an asynchronous
+load. The textures are built first and then the vertex array objects of the
+meshes with the shader program of their material.
+\return true if there are objects left
+*/
+SLbool SLAssimpImporter::uploadNext()
+{
+    SLuint numTextures = (SLuint)_staging.textures.size();
+    SLuint numObjects  = numTextures + (SLuint)_staging.meshes.size();
+
+    if (_numUploaded < numTextures)
+        _staging.textures[_numUploaded]->build();
+    else if (_numUploaded < numObjects)
+    {
+        SLMesh* mesh = _staging.meshes[_numUploaded - numTextures];
+        if (mesh->mat())
+        {
+            mesh->mat()->assignDefaultProgram();
+            SLGLProgram* sp = mesh->mat()->program();
+            if (!sp->programObjectGL() && sp->shaders().size())
+                sp->init();
+            mesh->generateVAO(sp);
+        }
+    }
+
+    if (_numUploaded < numObjects)
+        _numUploaded++;
+
+    progress(80 + (SLint)(20 * _numUploaded / SL_max(numObjects, 1U)),
+             "Uploading to GPU");
+
+    return _numUploaded < numObjects;
+}
+//-----------------------------------------------------------------------------
+//! Sets the loading progress in percent and a message for the UI
+void SLAssimpImporter::progress(SLint percent, const SLstring& msg)
+{
+    lock_guard<mutex> lock(_progressMutex);
+    _progressPC  = percent;
+    _progressMsg = msg;
+}
+//-----------------------------------------------------------------------------
+//! Returns the loading progress message. Can be called from any thread.
+SLstring SLAssimpImporter::progressMsg()
+{
+    lock_guard<mutex> lock(_progressMutex);
+    return _progressMsg;
+}
+//-----------------------------------------------------------------------------
 //! Clears all helper containers
 void SLAssimpImporter::clear()
 {
@@ -361,6 +625,12 @@ void SLAssimpImporter::clear()
     _skeletonRoot = nullptr;
     _skeleton     = nullptr;
     _skinnedMeshes.clear();
+
+    // delete the decoded images that were not used by a texture
+    for (auto it : _texImages)
+        delete it.second;
+    _texImages.clear();
+    _texFiles.clear();
 }
 //-----------------------------------------------------------------------------
 //! Return an aiNode ptr if name exists, or null if it doesn't
@@ -685,7 +955,9 @@ SLMaterial* SLAssimpImporter::loadMaterial(SLint       index,
                                                   : textureTypes[i] == aiTextureType_OPACITY
                                                       ? TT_color
                                                       : TT_unknown;
-            SLstring texFile = checkFilePath(modelPath, aipath.data);
+            SLstring texFile = _texFiles.count(aipath.data)
+                                 ? _texFiles[aipath.data]
+                                 : checkFilePath(modelPath, aipath.data);
 
             // Only color texture are loaded so far
             // For normal maps we have to adjust first the normal and tangent generation
@@ -744,14 +1016,80 @@ SLGLTexture* SLAssimpImporter::loadTexture(SLstring&     textureFile,
             return sceneTex[i];
 
     // Create the new texture. It is also push back to SLScene::_textures
-    SLGLTexture* texture = new SLGLTexture(textureFile,
-                                           GL_LINEAR_MIPMAP_LINEAR,
-                                           GL_LINEAR,
-                                           texType);
+    // If the image was decoded in advance the texture takes it over.
+    SLGLTexture* texture;
+    auto         it = _texImages.find(textureFile);
+    if (it != _texImages.end())
+    {
+        texture = new SLGLTexture(it->second,
+                                  GL_LINEAR_MIPMAP_LINEAR,
+                                  GL_LINEAR,
+                                  texType);
+        _texImages.erase(it);
+    }
+    else
+        texture = new SLGLTexture(textureFile,
+                                  GL_LINEAR_MIPMAP_LINEAR,
+                                  GL_LINEAR,
+                                  texType);
     return texture;
 }
 //-----------------------------------------------------------------------------
 /*!
+SLAssimpImporter::loadTextureImages finds the files of all textures that get
+loaded by loadMaterial and decodes their images in parallel. loadTexture then
+creates the textures with the decoded images.
+*/
+void SLAssimpImporter::loadTextureImages(const aiScene* scene,
+                                         SLstring       modelPath)
+{
+    // Only the color textures are loaded so far (see loadMaterial)
+    const aiTextureType textureTypes[2] = {aiTextureType_DIFFUSE,
+                                           aiTextureType_OPACITY};
+
+    // get the unique texture paths of all materials
+    SLVstring aiTexFiles;
+    for (SLuint m = 0; m < scene->mNumMaterials; ++m)
+    {
+        for (auto texType : textureTypes)
+        {
+            if (scene->mMaterials[m]->GetTextureCount(texType) > 0)
+            {
+                aiString aipath;
+                scene->mMaterials[m]->GetTexture(texType, 0, &aipath, nullptr, nullptr, nullptr, nullptr, nullptr);
+                if (_texFiles.find(aipath.data) == _texFiles.end())
+                {
+                    _texFiles[aipath.data] = "";
+                    aiTexFiles.push_back(aipath.data);
+                }
+            }
+        }
+    }
+
+    // find and decode the texture files in parallel
+    // KTX files are not decoded by OpenCV. SLGLTexture loads them itself.
+    SLVstring  texFiles(aiTexFiles.size());
+    SLCVVImage images(aiTexFiles.size(), nullptr);
+
+    SL::parallelFor((SLuint)aiTexFiles.size(), [&](SLuint i) {
+        texFiles[i] = checkFilePath(modelPath, aiTexFiles[i]);
+        if (SLUtils::getFileExt(texFiles[i]) != "ktx")
+            images[i] = new SLCVImage(texFiles[i]);
+    });
+
+    for (SLuint i = 0; i < aiTexFiles.size(); ++i)
+    {
+        _texFiles[aiTexFiles[i]] = texFiles[i];
+
+        // different paths in the file can point to the same texture file
+        if (images[i] && _texImages.find(texFiles[i]) == _texImages.end())
+            _texImages[texFiles[i]] = images[i];
+        else
+            delete images[i];
+    }
+}
+//-----------------------------------------------------------------------------
+/*!
 SLAssimpImporter::loadMesh creates a new SLMesh an copies the meshs vertex data and
 triangle face indices. Normals & tangents are not loaded. They are calculated
 in SLMesh.
@@ -1229,6 +1567,12 @@ SLAnimation* SLAssimpImporter::loadAnimation(aiAnimation* anim)
         }
     }
 
+    // Skeleton animations evaluate all joint tracks every frame and profit
+    // most from the compiled structure of arrays clip. Compiling resamples the
+    // keys at a fixed rate with nlerp, so it must be requested explicitly.
+    if (isSkeletonAnim && compileSkeletonAnimations)
+        result->compile();
+
     return result;
 }
 //-----------------------------------------------------------------------------
@@ -197,7 +197,8 @@ void slTerminate()
 device inputs and due to active animations. This happens only if all sceneviews
 where finished with rendering. After the update sceneviews onPaint routine is
 called to initiate the rendering of the frame. If either the onUpdate or onPaint
-returned true a new frame should be drawn.
+returned true or the frame scheduler got a dirty source a new frame should be
+drawn.
 */
 bool slUpdateAndPaint(int sceneViewIndex)
 {
@@ -207,7 +208,34 @@ bool slUpdateAndPaint(int sceneViewIndex)
 
     bool viewNeedsUpdate = sv->onPaint();
 
-    return sceneGotUpdated || viewNeedsUpdate;
+    bool frameIsDirty = SLApplication::scene->frameScheduler().endFrame();
+
+    return sceneGotUpdated || viewNeedsUpdate || frameIsDirty;
+}
+//-----------------------------------------------------------------------------
+/*! Global function that waits after the buffer swap until the next frame of
+the target frame rate is due. It returns immediately without a target frame
+rate.
+*/
+void slWaitForNextFrame()
+{
+    SLApplication::scene->frameScheduler().waitForNextFrame();
+}
+//-----------------------------------------------------------------------------
+/*! Global function that returns the NO. of vertical syncs per frame that the
+window system should pass to its swap interval function.
+*/
+int slGetSwapInterval()
+{
+    return SLApplication::scene->frameScheduler().swapInterval();
+}
+//-----------------------------------------------------------------------------
+/*! Global function to set the refresh rate of the display in Hz. The frame
+scheduler rounds the target frame rate to a divisor of it.
+*/
+void slSetRefreshRate(float hz)
+{
+    SLApplication::scene->frameScheduler().refreshRateHz(hz);
 }
 //-----------------------------------------------------------------------------
 /*! Global resize function that must be called whenever the OpenGL frame
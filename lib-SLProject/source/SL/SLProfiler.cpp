@@ -0,0 +1,379 @@
+//#############################################################################
+//  File:      SL/SLProfiler.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+
+#include <SLProfiler.h>
+#include <fstream>
+
+//-----------------------------------------------------------------------------
+atomic<SLbool>           SLProfiler::isOn(false);
+SLuint                   SLProfiler::eventsPerThread = 16384;
+mutex                    SLProfiler::_mutex;
+vector<SLProfileThread*> SLProfiler::_threads;
+SLint64                  SLProfiler::_frameStartNS = 0;
+//-----------------------------------------------------------------------------
+//! Time base of the profiler
+static const chrono::steady_clock::time_point profilerStart = chrono::steady_clock::now();
+//-----------------------------------------------------------------------------
+//! Releases the ring buffer of a thread for reuse when the thread ends
+struct SLProfileThreadOwner
+{
+    SLProfileThread* thread = nullptr;
+    ~SLProfileThreadOwner()
+    {
+        if (thread) thread->isUsed = false;
+    }
+};
+//-----------------------------------------------------------------------------
+//! A pooled OpenGL timer query
+struct SLProfileQuery
+{
+    GLuint        id;        //!< OpenGL query object
+    const SLchar* name;      //!< Static name of the GPU scope
+    SLint64       startNS;   //!< CPU time of the submission
+    SLbool        isPending; //!< Flag if the result is not yet read back
+};
+static vector<SLProfileQuery> gpuQueries;           //!< Pool of the timer queries
+static SLint                  gpuActiveQuery  = -1; //!< Index of the running query
+static SLint64                gpuEndNS        = 0;  //!< End of the last GPU event
+static const SLuint           GPU_MAX_QUERIES = 64; //!< Max. NO. of pending queries
+//-----------------------------------------------------------------------------
+//! Returns the nanoseconds since the start of the application
+SLint64 SLProfiler::timeNS()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() -
+                                                      profilerStart)
+      .count();
+}
+//-----------------------------------------------------------------------------
+//! Returns the ring buffer of the calling thread and registers it on first use
+SLProfileThread* SLProfiler::thread()
+{
+    static thread_local SLProfileThreadOwner owner;
+    if (!owner.thread)
+        owner.thread = addThread("Thread");
+    return owner.thread;
+}
+//-----------------------------------------------------------------------------
+//! Sets the name of the calling thread in the trace
+void SLProfiler::threadName(SLstring name)
+{
+    SLProfileThread* t = thread();
+    lock_guard<mutex> lock(_mutex);
+    t->name = name;
+}
+//-----------------------------------------------------------------------------
+/*! Adds a new ring buffer or reuses the one of a finished thread. The first
+two ring buffers are the GPU and the frame track.
+*/
+SLProfileThread* SLProfiler::addThread(SLstring name)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    auto newThread = [&](SLstring threadName) {
+        SLProfileThread* t = new SLProfileThread;
+        t->id              = (SLuint)_threads.size();
+        t->name            = threadName;
+        t->head            = 0;
+        t->depth           = 0;
+        t->isUsed          = true;
+        t->events.resize(eventsPerThread);
+        _threads.push_back(t);
+        return t;
+    };
+
+    if (_threads.empty())
+    {
+        newThread("GPU");
+        newThread("Frames");
+    }
+
+    for (SLuint i = FRAME_THREAD + 1; i < _threads.size(); ++i)
+    {
+        SLProfileThread* t = _threads[i];
+        if (!t->isUsed)
+        {
+            t->name   = name + " " + to_string(t->id);
+            t->depth  = 0;
+            t->isUsed = true;
+            return t;
+        }
+    }
+
+    SLProfileThread* t = newThread(name);
+    t->name += " " + to_string(t->id);
+    return t;
+}
+//-----------------------------------------------------------------------------
+//! Writes an event into the ring buffer and publishes it
+void SLProfiler::addEvent(SLProfileThread* thread,
+                          const SLchar*    name,
+                          SLint64          startNS,
+                          SLint64          endNS)
+{
+    SLuint64        h = thread->head.load(memory_order_relaxed);
+    SLProfileEvent& e = thread->events[h % thread->events.size()];
+    e.name            = name;
+    e.startNS         = startNS;
+    e.endNS           = endNS;
+    e.depth           = thread->depth;
+    thread->head.store(h + 1, memory_order_release);
+}
+//-----------------------------------------------------------------------------
+//! Ends a CPU scope that SLProfileScope started
+void SLProfiler::endScope(SLProfileThread* thread,
+                          const SLchar*    name,
+                          SLint64          startNS)
+{
+    thread->depth--;
+    addEvent(thread, name, startNS, timeNS());
+}
+//-----------------------------------------------------------------------------
+/*! Marks the start of a new frame on the frame track and adds the finished
+GPU queries to the GPU track. Must be called from the OpenGL thread.
+*/
+void SLProfiler::beginFrame()
+{
+    if (!isOn)
+    {
+        _frameStartNS = 0;
+        return;
+    }
+
+    SLProfileThread* mainThread = thread();
+    SLint64          nowNS      = timeNS();
+
+    if (mainThread->name.find("Thread") == 0)
+        threadName("Main");
+
+    if (_frameStartNS > 0)
+        addEvent(_threads[FRAME_THREAD], "Frame", _frameStartNS, nowNS);
+    _frameStartNS = nowNS;
+
+#ifndef SL_GLES
+    for (auto& q : gpuQueries)
+    {
+        if (!q.isPending) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(q.id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 elapsedNS = 0;
+        glGetQueryObjectui64v(q.id, GL_QUERY_RESULT, &elapsedNS);
+
+        // The GPU works the passes in order after their submission
+        SLint64 startNS = std::max(q.startNS, gpuEndNS);
+        gpuEndNS        = startNS + (SLint64)elapsedNS;
+        addEvent(_threads[GPU_THREAD], q.name, startNS, gpuEndNS);
+        q.isPending = false;
+    }
+#endif
+}
+//-----------------------------------------------------------------------------
+/*! Starts a GPU timer query and returns its index. Returns -1 if a query is
+already running, too many are pending or the platform has no timer queries.
+*/
+SLint SLProfiler::beginGPU(const SLchar* name)
+{
+#ifndef SL_GLES
+    if (gpuActiveQuery >= 0) return -1;
+
+    SLint index = -1;
+    for (SLuint i = 0; i < gpuQueries.size(); ++i)
+    {
+        if (!gpuQueries[i].isPending)
+        {
+            index = (SLint)i;
+            break;
+        }
+    }
+
+    if (index < 0)
+    {
+        if (gpuQueries.size() >= GPU_MAX_QUERIES) return -1;
+        SLProfileQuery q;
+        glGenQueries(1, &q.id);
+        q.isPending = false;
+        gpuQueries.push_back(q);
+        index = (SLint)gpuQueries.size() - 1;
+    }
+
+    SLProfileQuery& q = gpuQueries[(SLuint)index];
+    q.name            = name;
+    q.startNS         = timeNS();
+    glBeginQuery(GL_TIME_ELAPSED, q.id);
+    gpuActiveQuery = index;
+    return index;
+#else
+    return -1;
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Ends the GPU timer query that beginGPU started
+void SLProfiler::endGPU(SLint query)
+{
+#ifndef SL_GLES
+    glEndQuery(GL_TIME_ELAPSED);
+    gpuQueries[(SLuint)query].isPending = true;
+    gpuActiveQuery                      = -1;
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Deletes the OpenGL query objects (needs the OpenGL context)
+void SLProfiler::deleteGPUQueries()
+{
+#ifndef SL_GLES
+    for (auto& q : gpuQueries)
+        glDeleteQueries(1, &q.id);
+#endif
+    gpuQueries.clear();
+    gpuActiveQuery = -1;
+}
+//-----------------------------------------------------------------------------
+//! Returns the start and end time of the last finished frame
+void SLProfiler::lastFrame(SLint64& startNS, SLint64& endNS)
+{
+    startNS = endNS = 0;
+
+    lock_guard<mutex> lock(_mutex);
+    if (_threads.size() <= FRAME_THREAD) return;
+
+    SLProfileThread* t = _threads[FRAME_THREAD];
+    SLuint64         h = t->head.load(memory_order_acquire);
+    if (h == 0) return;
+
+    SLProfileEvent& e = t->events[(h - 1) % t->events.size()];
+    startNS           = e.startNS;
+    endNS             = e.endNS;
+}
+//-----------------------------------------------------------------------------
+SLuint SLProfiler::numThreads()
+{
+    lock_guard<mutex> lock(_mutex);
+    return (SLuint)_threads.size();
+}
+//-----------------------------------------------------------------------------
+SLstring SLProfiler::threadName(SLuint index)
+{
+    lock_guard<mutex> lock(_mutex);
+    return index < _threads.size() ? _threads[index]->name : "";
+}
+//-----------------------------------------------------------------------------
+/*! Copies the events of a thread that overlap the time range from startNS to
+endNS. Events that the thread overwrote during the copy are dropped.
+*/
+void SLProfiler::threadEvents(SLuint           index,
+                              SLint64          startNS,
+                              SLint64          endNS,
+                              SLVProfileEvent& events)
+{
+    events.clear();
+
+    SLProfileThread* t;
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (index >= _threads.size()) return;
+        t = _threads[index];
+    }
+
+    SLuint64 size  = t->events.size();
+    SLuint64 head  = t->head.load(memory_order_acquire);
+    SLuint64 first = head > size ? head - size : 0;
+
+    vector<SLuint64> indices;
+    for (SLuint64 i = first; i < head; ++i)
+    {
+        SLProfileEvent e = t->events[i % size];
+        if (e.endNS >= startNS && e.startNS <= endNS)
+        {
+            events.push_back(e);
+            indices.push_back(i);
+        }
+    }
+
+    // Drop the events that got overwritten while copying
+    SLuint64 newHead = t->head.load(memory_order_acquire);
+    SLuint   keep    = 0;
+    for (SLuint i = 0; i < events.size(); ++i)
+        if (indices[i] + size > newHead)
+            events[keep++] = events[i];
+    events.resize(keep);
+}
+//-----------------------------------------------------------------------------
+//! Writes a string with the JSON escapes
+static void writeJSONString(ofstream& file, const SLchar* str)
+{
+    file << '"';
+    for (const SLchar* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            file << '\\' << *c;
+        else if ((SLuchar)*c >= 32)
+            file << *c;
+    }
+    file << '"';
+}
+//-----------------------------------------------------------------------------
+/*! Exports all events in the ring buffers in the Chrome trace event format.
+Every thread gets its own track with its name. The times are in microseconds.
+*/
+SLbool SLProfiler::exportChromeTrace(SLstring filename)
+{
+    ofstream file(filename);
+    if (!file.is_open())
+    {
+        SL_LOG("SLProfiler::exportChromeTrace: Can't open %s\n", filename.c_str());
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file.precision(3);
+    file << fixed;
+
+    SLbool          isFirst   = true;
+    SLuint          numEvents = 0;
+    SLVProfileEvent events;
+
+    for (SLuint t = 0; t < numThreads(); ++t)
+    {
+        SLstring name = threadName(t);
+        file << (isFirst ? "" : ",\n");
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+             << ",\"args\":{\"name\":";
+        writeJSONString(file, name.c_str());
+        file << "}}";
+        isFirst = false;
+
+        threadEvents(t, INT64_MIN, INT64_MAX, events);
+        for (auto& e : events)
+        {
+            file << ",\n{\"name\":";
+            writeJSONString(file, e.name);
+            file << ",\"cat\":\"" << (t == GPU_THREAD ? "GPU" : "CPU") << "\""
+                 << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << t
+                 << ",\"ts\":" << (SLdouble)e.startNS * 0.001
+                 << ",\"dur\":" << (SLdouble)(e.endNS - e.startNS) * 0.001 << "}";
+        }
+        numEvents += (SLuint)events.size();
+    }
+
+    file << "\n]}\n";
+    file.close();
+
+    SL_LOG("Profiler trace  : %u events written to %s\n", numEvents, filename.c_str());
+    return true;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,817 @@
+//#############################################################################
+//  File:      SL/SLSceneCache.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+
+#include <SLApplication.h>
+#include <SLAssimpImporter.h>
+#include <SLGLTexture.h>
+#include <SLMaterial.h>
+#include <SLMeshOptimizer.h>
+#include <SLNode.h>
+#include <SLScene.h>
+#include <SLSceneCache.h>
+#include <SLSkeleton.h>
+
+#ifndef SL_OS_WINDOWS
+#    include <fcntl.h>    // open
+#    include <sys/mman.h> // mmap
+#    include <unistd.h>   // close
+#endif
+
+//-----------------------------------------------------------------------------
+SLbool       SLSceneCache::isOn    = false;
+const SLuint SLSceneCache::version = 1;
+//-----------------------------------------------------------------------------
+static const SLuint cacheMagic     = 0x43534C53; //!< "SLSC" in little-endian
+static const SLuint cacheByteOrder = 0x01020304; //!< byte order mark
+static const size_t cacheAlignment = 16;         //!< alignment of all arrays
+//-----------------------------------------------------------------------------
+//! Header at the beginning of a cache file
+struct SLSceneCacheHeader
+{
+    SLuint   magic;     //!< magic number cacheMagic
+    SLuint   version;   //!< format version SLSceneCache::version
+    SLuint   byteOrder; //!< byte order mark cacheByteOrder
+    SLuint   reserved;  //!< padding for the alignment of size
+    SLuint64 size;      //!< total file size in bytes
+};
+//-----------------------------------------------------------------------------
+//! Returns the passed position rounded up to the array alignment
+static size_t alignedPos(size_t pos)
+{
+    return (pos + cacheAlignment - 1) / cacheAlignment * cacheAlignment;
+}
+//-----------------------------------------------------------------------------
+//! Read-only memory mapping of a whole file
+class SLMappedFile
+{
+    public:
+    SLMappedFile(const SLstring& file);
+    ~SLMappedFile();
+
+    const SLuchar* data() const { return _data; }
+    size_t         size() const { return _size; }
+
+    private:
+    const SLuchar* _data; //!< pointer to the mapped file or nullptr
+    size_t         _size; //!< size of the mapping in bytes
+#ifdef SL_OS_WINDOWS
+    HANDLE _file;    //!< handle of the opened file
+    HANDLE _mapping; //!< handle of the file mapping object
+#endif
+};
+//-----------------------------------------------------------------------------
+SLMappedFile::SLMappedFile(const SLstring& file) : _data(nullptr), _size(0)
+{
+#ifdef SL_OS_WINDOWS
+    _mapping = nullptr;
+    _file    = CreateFileA(file.c_str(),
+                        GENERIC_READ,
+                        FILE_SHARE_READ,
+                        nullptr,
+                        OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_file, &fileSize) || fileSize.QuadPart == 0)
+        return;
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping)
+        return;
+
+    _data = (const SLuchar*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (_data)
+        _size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+
+    // The mapping stays valid after closing the file descriptor
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            _data = (const SLuchar*)data;
+            _size = (size_t)info.st_size;
+        }
+    }
+    close(fd);
+#endif
+}
+//-----------------------------------------------------------------------------
+SLMappedFile::~SLMappedFile()
+{
+#ifdef SL_OS_WINDOWS
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(_mapping);
+    if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+#else
+    if (_data) munmap((void*)_data, _size);
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Sequential writer of a cache file
+class SLSceneCacheWriter
+{
+    public:
+    SLSceneCacheWriter(const SLstring& file) : _stream(file, ios::binary) {}
+
+    template<class T>
+    void write(const T& value)
+    {
+        _stream.write((const char*)&value, sizeof(T));
+    }
+
+    void writeString(const SLstring& s)
+    {
+        write((SLuint)s.size());
+        _stream.write(s.data(), (streamsize)s.size());
+    }
+
+    void writeMat(const SLMat4f& m)
+    {
+        _stream.write((const char*)m.m(), 16 * sizeof(SLfloat));
+    }
+
+    //! Writes the number of elements and the elements at an aligned offset
+    template<class T>
+    void writeArray(const vector<T>& v)
+    {
+        static const char zeros[cacheAlignment] = {0};
+        write((SLuint)v.size());
+        size_t pos = (size_t)_stream.tellp();
+        _stream.write(zeros, (streamsize)(alignedPos(pos) - pos));
+        if (!v.empty())
+            _stream.write((const char*)v.data(), (streamsize)(v.size() * sizeof(T)));
+    }
+
+    ofstream& stream() { return _stream; }
+
+    private:
+    ofstream _stream; //!< binary output file stream
+};
+//-----------------------------------------------------------------------------
+//! Sequential reader of a memory mapped cache file
+/*! All reads are bounds checked. After the first read beyond the end ok
+returns false and all further reads return empty values.
+*/
+class SLSceneCacheReader
+{
+    public:
+    SLSceneCacheReader(const SLuchar* data, size_t size)
+      : _data(data), _size(size), _pos(0), _ok(true) {}
+
+    template<class T>
+    T read()
+    {
+        T value = T();
+        if (checkSize(sizeof(T)))
+        {
+            memcpy(&value, _data + _pos, sizeof(T));
+            _pos += sizeof(T);
+        }
+        return value;
+    }
+
+    SLstring readString()
+    {
+        SLuint length = read<SLuint>();
+        if (!checkSize(length))
+            return SLstring();
+        SLstring s((const char*)_data + _pos, length);
+        _pos += length;
+        return s;
+    }
+
+    SLMat4f readMat()
+    {
+        SLfloat m[16] = {0};
+        if (checkSize(sizeof(m)))
+        {
+            memcpy(m, _data + _pos, sizeof(m));
+            _pos += sizeof(m);
+        }
+        return SLMat4f(m);
+    }
+
+    //! Copies the aligned elements with one memcpy into the vector
+    template<class T>
+    void readArray(vector<T>& v)
+    {
+        SLuint count = read<SLuint>();
+        _pos         = alignedPos(_pos);
+        size_t bytes = (size_t)count * sizeof(T);
+        if (!checkSize(bytes))
+            return;
+        v.resize(count);
+        if (count)
+            memcpy((void*)v.data(), _data + _pos, bytes);
+        _pos += bytes;
+    }
+
+    SLbool ok() const { return _ok; }
+    void   fail() { _ok = false; }
+
+    private:
+    SLbool checkSize(size_t bytes)
+    {
+        if (_ok && (_pos > _size || bytes > _size - _pos))
+            _ok = false;
+        return _ok;
+    }
+
+    const SLuchar* _data; //!< pointer to the mapped file
+    size_t         _size; //!< size of the mapped file
+    size_t         _pos;  //!< current read position
+    SLbool         _ok;   //!< false after a read beyond the end
+};
+//-----------------------------------------------------------------------------
+//! Writes a node and its children in depth first order
+static void writeNodeRec(SLSceneCacheWriter&     w,
+                         SLNode*                 node,
+                         std::map<SLMesh*, SLuint>& meshIDs,
+                         std::map<SLNode*, SLint>&  nodeIDs)
+{
+    SLint id      = (SLint)nodeIDs.size();
+    nodeIDs[node] = id;
+
+    SLVuint meshes;
+    for (auto mesh : node->meshes())
+        meshes.push_back(meshIDs[mesh]);
+
+    w.writeString(node->name());
+    w.writeMat(node->om());
+    w.writeArray(meshes);
+    w.write((SLuint)node->children().size());
+
+    for (auto child : node->children())
+        writeNodeRec(w, child, meshIDs, nodeIDs);
+}
+//-----------------------------------------------------------------------------
+//! Reads a node and its children in depth first order
+static SLNode* readNodeRec(SLSceneCacheReader& r,
+                           const SLVMesh&      meshes,
+                           SLVNode&            nodes)
+{
+    SLNode* node = new SLNode(r.readString());
+    nodes.push_back(node);
+
+    node->om(r.readMat());
+
+    SLVuint meshIDs;
+    r.readArray(meshIDs);
+    for (auto id : meshIDs)
+        if (id < meshes.size())
+            node->addMesh(meshes[id]);
+
+    SLuint numChildren = r.read<SLuint>();
+    for (SLuint i = 0; i < numChildren && r.ok(); ++i)
+        node->addChild(readNodeRec(r, meshes, nodes));
+
+    return node;
+}
+//-----------------------------------------------------------------------------
+//! Writes an animation with all node tracks and their keyframes
+static void writeAnimation(SLSceneCacheWriter&       w,
+                           SLAnimation*              anim,
+                           std::map<SLNode*, SLint>& nodeIDs)
+{
+    w.writeString(anim->name());
+    w.write(anim->lengthSec());
+    w.write((SLuint)anim->nodeAnimTracks().size());
+
+    for (auto it : anim->nodeAnimTracks())
+    {
+        SLNodeAnimTrack* track  = it.second;
+        SLint            nodeID = -1;
+        if (track->animatedNode() && nodeIDs.count(track->animatedNode()))
+            nodeID = nodeIDs[track->animatedNode()];
+
+        // time, translation, rotation & scale per keyframe
+        SLVfloat keys;
+        keys.reserve((SLuint)track->numKeyframes() * 11);
+        for (SLint k = 0; k < track->numKeyframes(); ++k)
+        {
+            SLTransformKeyframe* kf = (SLTransformKeyframe*)track->keyframe(k);
+            keys.push_back(kf->time());
+            keys.push_back(kf->translation().x);
+            keys.push_back(kf->translation().y);
+            keys.push_back(kf->translation().z);
+            keys.push_back(kf->rotation().x());
+            keys.push_back(kf->rotation().y());
+            keys.push_back(kf->rotation().z());
+            keys.push_back(kf->rotation().w());
+            keys.push_back(kf->scale().x);
+            keys.push_back(kf->scale().y);
+            keys.push_back(kf->scale().z);
+        }
+
+        w.write(it.first);
+        w.write(nodeID);
+        w.writeArray(keys);
+    }
+}
+//-----------------------------------------------------------------------------
+//! Reads the tracks and keyframes of an animation written by writeAnimation
+static void readAnimationTracks(SLSceneCacheReader& r,
+                                SLAnimation*        anim,
+                                const SLVNode&      nodes)
+{
+    SLuint numTracks = r.read<SLuint>();
+    for (SLuint t = 0; t < numTracks && r.ok(); ++t)
+    {
+        SLuint handle = r.read<SLuint>();
+        SLint  nodeID = r.read<SLint>();
+
+        SLVfloat keys;
+        r.readArray(keys);
+
+        SLNodeAnimTrack* track = anim->createNodeAnimationTrack(handle);
+        if (nodeID >= 0 && nodeID < (SLint)nodes.size())
+            track->animatedNode(nodes[(SLuint)nodeID]);
+
+        for (SLuint k = 0; k + 11 <= keys.size(); k += 11)
+        {
+            const SLfloat*       key = &keys[k];
+            SLTransformKeyframe* kf  = track->createNodeKeyframe(key[0]);
+            kf->translation(SLVec3f(key[1], key[2], key[3]));
+            kf->rotation(SLQuat4f(key[4], key[5], key[6], key[7]));
+            kf->scale(SLVec3f(key[8], key[9], key[10]));
+        }
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Returns the cache file for a source file and the import options or an empty
+string if the source file doesn't exist or there is no config path. The key
+in the file name is a 64 bit FNV-1a hash of the source file path, its size and
+modification time, the import options and the format version.
+*/
+SLstring SLSceneCache::cacheFile(const SLstring& sourceFile,
+                                 SLbool          loadMeshesOnly,
+                                 SLbool          hasOverrideMat,
+                                 SLuint          flags)
+{
+    struct stat info;
+    if (SLApplication::configPath.empty() ||
+        stat(sourceFile.c_str(), &info) != 0)
+        return "";
+
+    ostringstream key;
+    key << sourceFile << "|" << info.st_size << "|" << info.st_mtime << "|"
+        << flags << "|" << loadMeshesOnly << "|" << hasOverrideMat << "|"
+        << SLMeshOptimizer::isOn << "|" << version;
+
+    SLuint64 hash = 14695981039346656037ULL;
+    for (auto c : key.str())
+    {
+        hash ^= (SLuchar)c;
+        hash *= 1099511628211ULL;
+    }
+
+    ostringstream file;
+    file << SLApplication::configPath << SLUtils::getFileName(sourceFile) << "."
+         << hex << setw(16) << setfill('0') << hash << ".slcache";
+    return file.str();
+}
+//-----------------------------------------------------------------------------
+/*! Deletes the other cache files of the same source file name. They were
+written for an older version of the source file or with other import options
+and would otherwise let the cache directory grow without bound.
+*/
+static void deleteOutdatedFiles(const SLstring& cacheFile)
+{
+    // <source file name>.<16 hex digits key>.slcache
+    SLstring fileName = SLUtils::getFileName(cacheFile);
+    SLstring prefix   = fileName.substr(0, fileName.length() - 24);
+
+    for (auto& file : SLUtils::getFileNamesInDir(SLUtils::getPath(cacheFile)))
+    {
+        SLstring name = SLUtils::getFileName(file);
+        if (name != fileName &&
+            name.length() == fileName.length() &&
+            name.compare(0, prefix.length(), prefix) == 0 &&
+            SLUtils::getFileExt(name) == "slcache")
+            remove(file.c_str());
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Writes the scene data of an import into a cache file. The meshes and
+materials are collected from the node hierarchy below root. The file is first
+written under a temporary name and then renamed, so that a concurrent reader
+never sees an incomplete file. Outdated cache files of the same source file
+are deleted afterwards.
+*/
+SLbool SLSceneCache::write(const SLstring&     cacheFile,
+                           SLNode*             root,
+                           SLSkeleton*         skeleton,
+                           const SLVAnimation& nodeAnimations)
+{
+    if (!root || cacheFile.empty())
+        return false;
+
+    // collect the meshes & materials of the node hierarchy
+    SLVMesh                        meshes;
+    SLVMaterial                    materials;
+    std::map<SLMesh*, SLuint>      meshIDs;
+    std::map<SLMaterial*, SLint>   materialIDs;
+    SLVNode                        stack = {root};
+    while (!stack.empty())
+    {
+        SLNode* node = stack.back();
+        stack.pop_back();
+        for (auto mesh : node->meshes())
+        {
+            if (meshIDs.count(mesh)) continue;
+            meshIDs[mesh] = (SLuint)meshes.size();
+            meshes.push_back(mesh);
+
+            if (mesh->mat() && !materialIDs.count(mesh->mat()))
+            {
+                materialIDs[mesh->mat()] = (SLint)materials.size();
+                materials.push_back(mesh->mat());
+            }
+        }
+        for (auto child : node->children())
+            stack.push_back(child);
+    }
+
+    SLstring           tmpFile = cacheFile + ".tmp";
+    SLSceneCacheWriter w(tmpFile);
+    if (!w.stream().good())
+        return false;
+
+    // header with the file size written at the end
+    SLSceneCacheHeader header = {cacheMagic, version, cacheByteOrder, 0, 0};
+    w.write(header);
+
+    // materials with their texture files
+    w.write((SLuint)materials.size());
+    for (auto mat : materials)
+    {
+        w.writeString(mat->name());
+        w.write(mat->ambient());
+        w.write(mat->diffuse());
+        w.write(mat->specular());
+        w.write(mat->emissive());
+        w.write(mat->shininess());
+        w.write(mat->kr());
+        w.write(mat->kt());
+        w.write(mat->kn());
+        w.write((SLuint)mat->textures().size());
+        for (auto tex : mat->textures())
+        {
+            w.writeString(tex->url());
+            w.write((SLuint)tex->texType());
+        }
+    }
+
+    // skeleton joints in depth first order with their animations
+    std::map<SLNode*, SLint> nodeIDs;
+    w.write((SLuchar)(skeleton && skeleton->rootJoint() ? 1 : 0));
+    if (skeleton && skeleton->rootJoint())
+    {
+        SLVJoint joints = {skeleton->rootJoint()};
+        SLVJoint ordered;
+        while (!joints.empty())
+        {
+            SLJoint* joint = joints.back();
+            joints.pop_back();
+            ordered.push_back(joint);
+            for (auto child : joint->children())
+                if (SLJoint* childJoint = dynamic_cast<SLJoint*>(child))
+                    joints.push_back(childJoint);
+        }
+
+        w.write((SLuint)ordered.size());
+        for (auto joint : ordered)
+        {
+            SLJoint* parent = dynamic_cast<SLJoint*>(joint->parent());
+            w.write(joint->id());
+            w.write(parent ? (SLint)parent->id() : -1);
+            w.writeString(joint->name());
+            w.writeMat(joint->offsetMat());
+            w.writeMat(joint->om());
+            w.writeMat(joint->initialOM());
+            w.write(joint->radius());
+        }
+
+        SLMAnimation animations = skeleton->animations();
+        w.write((SLuint)animations.size());
+        for (auto it : animations)
+            writeAnimation(w, it.second, nodeIDs);
+    }
+
+    // meshes with their vertex attributes
+    w.write((SLuint)meshes.size());
+    for (auto mesh : meshes)
+    {
+        w.writeString(mesh->name());
+        w.write((SLuint)mesh->primitive());
+        w.write(mesh->mat() ? materialIDs[mesh->mat()] : -1);
+        w.write((SLuchar)(mesh->skeleton() ? 1 : 0));
+        w.writeArray(mesh->P);
+        w.writeArray(mesh->N);
+        w.writeArray(mesh->Tc);
+        w.writeArray(mesh->C);
+        w.writeArray(mesh->T);
+        w.writeArray(mesh->I16);
+        w.writeArray(mesh->I32);
+
+        // joint ids & weights as flat arrays with the count per vertex
+        SLVuchar jointCounts, jointIDs;
+        SLVfloat jointWeights;
+        for (SLuint v = 0; v < mesh->Ji.size(); ++v)
+        {
+            jointCounts.push_back((SLuchar)mesh->Ji[v].size());
+            jointIDs.insert(jointIDs.end(), mesh->Ji[v].begin(), mesh->Ji[v].end());
+            jointWeights.insert(jointWeights.end(), mesh->Jw[v].begin(), mesh->Jw[v].end());
+        }
+        w.writeArray(jointCounts);
+        w.writeArray(jointIDs);
+        w.writeArray(jointWeights);
+    }
+
+    // node hierarchy
+    writeNodeRec(w, root, meshIDs, nodeIDs);
+
+    // node animations
+    w.write((SLuint)nodeAnimations.size());
+    for (auto anim : nodeAnimations)
+        writeAnimation(w, anim, nodeIDs);
+
+    // patch the file size into the header
+    header.size = (SLuint64)w.stream().tellp();
+    w.stream().seekp(0);
+    w.write(header);
+    w.stream().close();
+
+    if (w.stream().fail())
+    {
+        remove(tmpFile.c_str());
+        return false;
+    }
+
+    remove(cacheFile.c_str());
+    if (rename(tmpFile.c_str(), cacheFile.c_str()) != 0)
+        return false;
+
+    deleteOutdatedFiles(cacheFile);
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Removes the objects from a resource vector of the scene and deletes them
+template<class T>
+static void deleteFromScene(vector<T*>& sceneObjects, const vector<T*>& objects)
+{
+    for (auto object : objects)
+    {
+        sceneObjects.erase(std::remove(sceneObjects.begin(), sceneObjects.end(), object),
+                           sceneObjects.end());
+        delete object;
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Reads the scene data of a cache file written by write over a memory
+mapping. The created meshes, the skeleton and the node animations are returned
+over the passed references. If an override material is passed the materials in
+the file are skipped. Returns the root node or nullptr if the file is not a
+valid cache file of this version.
+*/
+SLNode* SLSceneCache::read(const SLstring& cacheFile,
+                           SLMaterial*     overrideMat,
+                           SLVMesh&        meshes,
+                           SLSkeleton*&    skeleton,
+                           SLVAnimation&   nodeAnimations)
+{
+    SLMappedFile file(cacheFile);
+    if (!file.data())
+        return nullptr;
+
+    SLSceneCacheReader r(file.data(), file.size());
+    SLSceneCacheHeader header = r.read<SLSceneCacheHeader>();
+    if (!r.ok() ||
+        header.magic != cacheMagic ||
+        header.version != version ||
+        header.byteOrder != cacheByteOrder ||
+        header.size != (SLuint64)file.size())
+        return nullptr;
+
+    // materials with their textures
+    SLVMaterial   materials;
+    SLVGLTexture  newTextures;
+    SLVGLTexture& sceneTex     = SLApplication::scene->textures();
+    SLuint        numMaterials = r.read<SLuint>();
+    for (SLuint i = 0; i < numMaterials && r.ok(); ++i)
+    {
+        SLstring name      = r.readString();
+        SLCol4f  ambient   = r.read<SLCol4f>();
+        SLCol4f  diffuse   = r.read<SLCol4f>();
+        SLCol4f  specular  = r.read<SLCol4f>();
+        SLCol4f  emissive  = r.read<SLCol4f>();
+        SLfloat  shininess = r.read<SLfloat>();
+        SLfloat  kr        = r.read<SLfloat>();
+        SLfloat  kt        = r.read<SLfloat>();
+        SLfloat  kn        = r.read<SLfloat>();
+
+        SLVstring     texFiles;
+        SLVuint       texTypes;
+        SLuint        numTextures = r.read<SLuint>();
+        for (SLuint t = 0; t < numTextures && r.ok(); ++t)
+        {
+            texFiles.push_back(r.readString());
+            texTypes.push_back(r.read<SLuint>());
+        }
+
+        if (overrideMat || !r.ok())
+            continue;
+
+        // The material is also added to the SLScene::_materials vector
+        SLMaterial* mat = new SLMaterial(name.c_str());
+        mat->kr(kr);
+        mat->kt(kt);
+        mat->kn(kn);
+        mat->ambient(ambient);
+        mat->diffuse(diffuse);
+        mat->specular(specular);
+        mat->emissive(emissive);
+        mat->shininess(shininess);
+
+        for (SLuint t = 0; t < texFiles.size(); ++t)
+        {
+            // reuse a texture with the same file
+            SLGLTexture* tex = nullptr;
+            for (auto sceneTexture : sceneTex)
+                if (sceneTexture->url() == texFiles[t])
+                    tex = sceneTexture;
+
+            if (!tex)
+            {
+                tex = new SLGLTexture(texFiles[t],
+                                      GL_LINEAR_MIPMAP_LINEAR,
+                                      GL_LINEAR,
+                                      (SLTextureType)texTypes[t]);
+                newTextures.push_back(tex);
+            }
+            mat->textures().push_back(tex);
+        }
+        materials.push_back(mat);
+    }
+
+    // skeleton with its animations
+    SLSkeleton* skel = nullptr;
+    SLVNode     nodes;
+    if (r.read<SLuchar>())
+    {
+        // The skeleton is also added to the SLAnimManager of the scene
+        skel             = new SLSkeleton;
+        SLuint numJoints = r.read<SLuint>();
+        for (SLuint j = 0; j < numJoints && r.ok(); ++j)
+        {
+            SLuint   id        = r.read<SLuint>();
+            SLint    parentID  = r.read<SLint>();
+            SLstring name      = r.readString();
+            SLMat4f  offsetMat = r.readMat();
+            SLMat4f  om        = r.readMat();
+            SLMat4f  initialOM = r.readMat();
+            SLfloat  radius    = r.read<SLfloat>();
+            if (!r.ok()) break;
+
+            SLJoint* joint;
+            if (parentID < 0)
+            {
+                joint = skel->createJoint(name, id);
+                skel->rootJoint(joint);
+            }
+            else
+            {
+                SLJoint* parent = skel->getJoint((SLuint)parentID);
+                if (!parent)
+                {
+                    r.fail();
+                    break;
+                }
+                joint = parent->createChild(name, id);
+            }
+
+            joint->offsetMat(offsetMat);
+            joint->radius(radius);
+            joint->om(initialOM);
+            joint->setInitialState();
+            joint->om(om);
+        }
+
+        SLuint numAnimations = r.read<SLuint>();
+        for (SLuint a = 0; a < numAnimations && r.ok(); ++a)
+        {
+            SLstring     name      = r.readString();
+            SLfloat      lengthSec = r.read<SLfloat>();
+            SLAnimation* anim      = skel->createAnimation(name, lengthSec);
+            readAnimationTracks(r, anim, nodes);
+            if (SLAssimpImporter::compileSkeletonAnimations)
+                anim->compile();
+        }
+    }
+
+    // meshes with their vertex attributes
+    SLVMesh loadedMeshes;
+    SLuint  numMeshes = r.read<SLuint>();
+    for (SLuint i = 0; i < numMeshes && r.ok(); ++i)
+    {
+        // The mesh is also added to the SLScene::_meshes vector
+        SLMesh* mesh = new SLMesh(r.readString());
+        mesh->primitive((SLGLPrimitiveType)r.read<SLuint>());
+
+        SLint matID = r.read<SLint>();
+        if (overrideMat)
+            mesh->mat(overrideMat);
+        else if (matID >= 0 && matID < (SLint)materials.size())
+            mesh->mat(materials[(SLuint)matID]);
+
+        if (r.read<SLuchar>())
+            mesh->skeleton(skel);
+
+        r.readArray(mesh->P);
+        r.readArray(mesh->N);
+        r.readArray(mesh->Tc);
+        r.readArray(mesh->C);
+        r.readArray(mesh->T);
+        r.readArray(mesh->I16);
+        r.readArray(mesh->I32);
+
+        SLVuchar jointCounts, jointIDs;
+        SLVfloat jointWeights;
+        r.readArray(jointCounts);
+        r.readArray(jointIDs);
+        r.readArray(jointWeights);
+        if (!jointCounts.empty() && jointIDs.size() == jointWeights.size())
+        {
+            mesh->Ji.resize(jointCounts.size());
+            mesh->Jw.resize(jointCounts.size());
+            SLuint j = 0;
+            for (SLuint v = 0; v < jointCounts.size() && j + jointCounts[v] <= jointIDs.size(); ++v)
+            {
+                mesh->Ji[v].assign(jointIDs.begin() + j, jointIDs.begin() + j + jointCounts[v]);
+                mesh->Jw[v].assign(jointWeights.begin() + j, jointWeights.begin() + j + jointCounts[v]);
+                j += jointCounts[v];
+            }
+        }
+
+        loadedMeshes.push_back(mesh);
+    }
+
+    // node hierarchy
+    SLNode* root = r.ok() ? readNodeRec(r, loadedMeshes, nodes) : nullptr;
+
+    // node animations are also added to the SLAnimManager of the scene
+    SLVAnimation animations;
+    SLuint       numAnimations = r.read<SLuint>();
+    for (SLuint a = 0; a < numAnimations && r.ok(); ++a)
+    {
+        SLstring     name      = r.readString();
+        SLfloat      lengthSec = r.read<SLfloat>();
+        SLAnimation* anim      = SLApplication::scene->animManager().createNodeAnimation(name, lengthSec);
+        readAnimationTracks(r, anim, nodes);
+        animations.push_back(anim);
+    }
+
+    // Remove everything a broken file created from the scene again
+    if (!r.ok())
+    {
+        SLScene*       s       = SLApplication::scene;
+        SLAnimManager& animMan = s->animManager();
+        delete root;
+        deleteFromScene(s->meshes(), loadedMeshes);
+        deleteFromScene(s->materials(), materials);
+        deleteFromScene(s->textures(), newTextures);
+        for (auto anim : animations)
+            animMan.deleteNodeAnimation(anim);
+        if (skel)
+            animMan.deleteSkeleton(skel);
+        return nullptr;
+    }
+
+    meshes.insert(meshes.end(), loadedMeshes.begin(), loadedMeshes.end());
+    nodeAnimations.insert(nodeAnimations.end(), animations.begin(), animations.end());
+    skeleton = skel;
+    return root;
+}
+//-----------------------------------------------------------------------------
@@ -31,6 +31,8 @@ SLTexFont* SLTexFont::font18 = nullptr;
 SLTexFont* SLTexFont::font20 = nullptr;
 SLTexFont* SLTexFont::font22 = nullptr;
 SLTexFont* SLTexFont::font24 = nullptr;
+
+SLGLTexture* SLTexFont::atlas = nullptr;
 //-----------------------------------------------------------------------------
 SLTexFont::SLTexFont(SLstring fontFilename)
 {
@@ -322,53 +324,43 @@ SLVstring SLTexFont::wrapTextToLines(SLstring text, // text to wrap
 }
 //-----------------------------------------------------------------------------
 /*! 
-Builds the buffer objects bufP, bufT & bufI with 2 texture mapped triangles per 
-character. The text width < maxWidth the text will be on one line. If it is 
-wider it will be split into multiple lines with a 
-height = font height * lineHeight.
+Builds the vertex positions P and the texture coordinates T of 2 texture mapped
+triangles per character. Each character quad has 4 vertices in the order
+lower-left, lower-right, upper-right and upper-left. If the text width < maxWidth
+the text will be on one line. If it is wider it will be split into multiple
+lines with a height = font height * lineHeight.
 */
-void SLTexFont::buildTextBuffers(SLGLVertexArray& vao,
-                                 SLstring         text,     // text
-                                 SLfloat          maxWidth, // max. width for multi-line text
-                                 SLfloat          lineHeight)        // line height factor
+void SLTexFont::buildTextQuads(SLVVec3f& P,
+                               SLVVec2f& T,
+                               SLstring  text,       // text
+                               SLfloat   maxWidth,   // max. width for multi-line text
+                               SLfloat   lineHeight) // line height factor
 {
     SLVstring lines;    // Vector of text lines
-    SLVVec2f  sizes;    // Sizes of text lines
     SLuint    numP = 0; // No. of vertices
-    SLuint    numI = 0; // No. of indices (3 per triangle)
     SLfloat   x;        // current lower-left x position
     SLfloat   y;        // current lower-left y position
     SLuint    iV;       // current vertex index
-    SLuint    iI;       // current vertex index index
 
-    // Calculate number of vertices & indices
+    // Calculate number of vertices
     if (maxWidth > 0.0f)
     { // multiple text lines
         lines = wrapTextToLines(text, maxWidth);
         for (SLuint l = 0; l < lines.size(); ++l)
-        {
             numP += lines[l].length();
-            sizes.push_back(calcTextSize(lines[l]));
-        }
         numP *= 4;
-        numI = numP * 2 * 3;
     }
     else
     { // single text line
         lines.push_back(text);
         numP = (SLuint)text.length() * 4;
-        numI = (SLuint)text.length() * 2 * 3;
     }
 
-    SLVVec3f P;
     P.resize(numP); // Vertex positions
-    SLVVec2f T;
     T.resize(numP); // Vertex texture coords.
-    SLVushort I;
-    I.resize(numI); // Indexes
 
-    iV = iI = 0;
-    y       = (lines.size() - 1) * (SLfloat)charsHeight * lineHeight;
+    iV = 0;
+    y  = (lines.size() - 1) * (SLfloat)charsHeight * lineHeight;
 
     for (SLuint l = 0; l < lines.size(); ++l)
     {
@@ -395,14 +387,6 @@ void SLTexFont::buildTextBuffers(SLGLVertexArray& vao,
             P[iV + 2].set(x + w, y + h);
             P[iV + 3].set(x, y + h);
 
-            // triangle indices of the character quad
-            I[iI++] = (SLushort)iV;
-            I[iI++] = (SLushort)iV + 1;
-            I[iI++] = (SLushort)iV + 3;
-            I[iI++] = (SLushort)iV + 1;
-            I[iI++] = (SLushort)iV + 2;
-            I[iI++] = (SLushort)iV + 3;
-
             // Move to next character
             iV += 4;
             x += w;
@@ -410,14 +394,6 @@ void SLTexFont::buildTextBuffers(SLGLVertexArray& vao,
 
         y -= (SLfloat)charsHeight * lineHeight;
     }
-
-    // create buffers on GPU
-    SLGLProgram* sp = SLApplication::scene->programs(SP_fontTex);
-    sp->useProgram();
-    vao.setAttrib(AT_position, sp->getAttribLocation("a_position"), &P);
-    vao.setAttrib(AT_texCoord, sp->getAttribLocation("a_texCoord"), &T);
-    vao.setIndices(&I);
-    vao.generate(numP);
 }
 //-----------------------------------------------------------------------------
 //! Generates all static fonts
@@ -445,6 +421,72 @@ void SLTexFont::generateFonts()
     assert(font22);
     font24 = new SLTexFont("Font24.png");
     assert(font24);
+
+    buildAtlas();
+}
+//-----------------------------------------------------------------------------
+/*! Copies the bitmaps of all fonts below each other into one glyph atlas
+texture and maps the texture coordinates of all characters into the atlas.
+The font bitmaps are released afterwards.
+*/
+void SLTexFont::buildAtlas()
+{
+    const SLint MARGIN_Y = 2; // empty rows between the fonts against bleeding
+
+    SLTexFont* fonts[] = {font07, font08, font09, font10, font12, font14, font16, font18, font20, font22, font24};
+
+    // Find the size of the atlas
+    SLint atlasW = 0;
+    SLint atlasH = 0;
+    for (auto font : fonts)
+    {
+        atlasW = std::max(atlasW, (SLint)font->_images[0]->width());
+        atlasH += (SLint)font->_images[0]->height() + MARGIN_Y;
+    }
+    atlasH = (SLint)nextPowerOf2((SLuint)atlasH);
+
+    SLPixelFormat format = font07->_images[0]->format();
+    SLCVImage*    img    = new SLCVImage(atlasW, atlasH, format, "FontAtlas");
+    memset(img->data(), 0, img->bytesPerImage());
+
+    SLint offsetY = 0;
+    for (auto font : fonts)
+    {
+        SLCVImage* fontImg = font->_images[0];
+        SLint      fontW   = (SLint)fontImg->width();
+        SLint      fontH   = (SLint)fontImg->height();
+
+        for (SLint y = 0; y < fontH; ++y)
+            memcpy(img->data() + (offsetY + y) * (SLint)img->bytesPerLine(),
+                   fontImg->data() + y * (SLint)fontImg->bytesPerLine(),
+                   fontImg->bytesPerLine());
+
+        // Map the texture coords. from the font bitmap into the atlas
+        SLfloat scaleX = (SLfloat)fontW / (SLfloat)atlasW;
+        SLfloat scaleY = (SLfloat)fontH / (SLfloat)atlasH;
+        SLfloat shiftY = (SLfloat)offsetY / (SLfloat)atlasH;
+        for (SLint i = 0; i < 256; ++i)
+        {
+            font->chars[i].tx1 *= scaleX;
+            font->chars[i].tx2 *= scaleX;
+            font->chars[i].ty1 = font->chars[i].ty1 * scaleY + shiftY;
+            font->chars[i].ty2 = font->chars[i].ty2 * scaleY + shiftY;
+        }
+
+        font->clearData();
+        offsetY += fontH + MARGIN_Y;
+    }
+
+    // Same sampling as the single fonts: No mipmaps that would mix the fonts
+    // and no wrapping of the glyphs at the atlas border.
+    atlas = new SLGLTexture();
+    atlas->name("FontAtlas");
+    atlas->texType(TT_font);
+    atlas->minFiler(GL_NEAREST);
+    atlas->magFiler(GL_NEAREST);
+    atlas->wrapS(GL_CLAMP_TO_EDGE);
+    atlas->wrapT(GL_CLAMP_TO_EDGE);
+    atlas->images().push_back(img);
 }
 //-----------------------------------------------------------------------------
 //! Deletes all static fonts
@@ -472,6 +514,8 @@ void SLTexFont::deleteFonts()
     font22 = nullptr;
     if (font24) delete font24;
     font24 = nullptr;
+    if (atlas) delete atlas;
+    atlas = nullptr;
 }
 //-----------------------------------------------------------------------------
 //! returns nearest font for a given height in mm
@@ -0,0 +1,294 @@
+//#############################################################################
+//  File:      SLAnimClip.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+#include <SLAnimClip.h>
+#include <SLAnimation.h>
+
+//-----------------------------------------------------------------------------
+//! Scale factor between quantized and float quaternion components
+static const SLfloat quatQuantScale = 32767.0f;
+//-----------------------------------------------------------------------------
+void SLAnimPose::resize(SLuint numTracks)
+{
+    if (tx.size() == numTracks) return;
+    tx.resize(numTracks);
+    ty.resize(numTracks);
+    tz.resize(numTracks);
+    qx.resize(numTracks);
+    qy.resize(numTracks);
+    qz.resize(numTracks);
+    qw.resize(numTracks);
+    sx.resize(numTracks);
+    sy.resize(numTracks);
+    sz.resize(numTracks);
+}
+//-----------------------------------------------------------------------------
+//! Linear interpolation of one channel for all tracks
+static void lerpChannel(const SLfloat* a,
+                        const SLfloat* b,
+                        SLfloat        t,
+                        SLfloat*       out,
+                        SLuint         n)
+{
+    for (SLuint i = 0; i < n; ++i)
+        out[i] = a[i] + (b[i] - a[i]) * t;
+}
+//-----------------------------------------------------------------------------
+/*! Normalized linear interpolation (nlerp) of the rotations of all tracks.
+The component type T is either SLfloat or the quantized SLshort that is
+scaled back with the factor dequant. The shorter arc is taken by flipping the
+second quaternion if the dot product is negative.
+*/
+template<class T>
+static void nlerpRotations(const T*    ax,
+                           const T*    ay,
+                           const T*    az,
+                           const T*    aw,
+                           const T*    bx,
+                           const T*    by,
+                           const T*    bz,
+                           const T*    bw,
+                           SLfloat     t,
+                           SLfloat     dequant,
+                           SLAnimPose& pose,
+                           SLuint      n)
+{
+    SLfloat* ox = pose.qx.data();
+    SLfloat* oy = pose.qy.data();
+    SLfloat* oz = pose.qz.data();
+    SLfloat* ow = pose.qw.data();
+
+    for (SLuint i = 0; i < n; ++i)
+    {
+        SLfloat x0 = (SLfloat)ax[i] * dequant;
+        SLfloat y0 = (SLfloat)ay[i] * dequant;
+        SLfloat z0 = (SLfloat)az[i] * dequant;
+        SLfloat w0 = (SLfloat)aw[i] * dequant;
+        SLfloat x1 = (SLfloat)bx[i] * dequant;
+        SLfloat y1 = (SLfloat)by[i] * dequant;
+        SLfloat z1 = (SLfloat)bz[i] * dequant;
+        SLfloat w1 = (SLfloat)bw[i] * dequant;
+
+        SLfloat dot  = x0 * x1 + y0 * y1 + z0 * z1 + w0 * w1;
+        SLfloat sign = dot < 0.0f ? -1.0f : 1.0f;
+
+        SLfloat x = x0 + (x1 * sign - x0) * t;
+        SLfloat y = y0 + (y1 * sign - y0) * t;
+        SLfloat z = z0 + (z1 * sign - z0) * t;
+        SLfloat w = w0 + (w1 * sign - w0) * t;
+
+        SLfloat invLen = 1.0f / sqrt(x * x + y * y + z * z + w * w);
+        ox[i]          = x * invLen;
+        oy[i]          = y * invLen;
+        oz[i]          = z * invLen;
+        ow[i]          = w * invLen;
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Compiles the animation by sampling all its node tracks at a fixed rate.
+The tracks are sampled with SLNodeAnimTrack::calcInterpolatedKeyframe so that
+the result matches the uncompiled evaluation at the sample times.
+@param animation Animation to compile. All its keyframes must be created.
+@param sampleRate Samples per second
+@param quantizeRotations Flag if the rotations are stored as 16 bit integers
+*/
+SLAnimClip::SLAnimClip(SLAnimation* animation,
+                       SLfloat      sampleRate,
+                       SLbool       quantizeRotations)
+  : _lengthSec(animation->lengthSec()),
+    _sampleRate(sampleRate),
+    _quantizeRotations(quantizeRotations)
+{
+    assert(sampleRate > 0.0f && "Invalid sample rate.");
+
+    const SLMNodeAnimTrack& tracks = animation->nodeAnimTracks();
+
+    _numTracks  = (SLuint)tracks.size();
+    _numSamples = (SLuint)ceil(_lengthSec * _sampleRate) + 1;
+
+    size_t numValues = (size_t)_numTracks * _numSamples;
+    _tx.resize(numValues);
+    _ty.resize(numValues);
+    _tz.resize(numValues);
+    _sx.resize(numValues);
+    _sy.resize(numValues);
+    _sz.resize(numValues);
+    if (_quantizeRotations)
+    {
+        _qxQ.resize(numValues);
+        _qyQ.resize(numValues);
+        _qzQ.resize(numValues);
+        _qwQ.resize(numValues);
+    }
+    else
+    {
+        _qx.resize(numValues);
+        _qy.resize(numValues);
+        _qz.resize(numValues);
+        _qw.resize(numValues);
+    }
+
+    SLuint track = 0;
+    for (auto it : tracks)
+    {
+        _trackIDs.push_back(it.first);
+        _animatedNodes.push_back(it.second->animatedNode());
+
+        SLuint cursor = 0;
+        for (SLuint s = 0; s < _numSamples; ++s)
+        {
+            SLfloat             time = std::min((SLfloat)s / _sampleRate, _lengthSec);
+            SLTransformKeyframe kf(nullptr, time);
+            it.second->calcInterpolatedKeyframe(time, &kf, &cursor);
+
+            size_t   i = (size_t)s * _numTracks + track;
+            SLQuat4f q = kf.rotation().normalized();
+
+            _tx[i] = kf.translation().x;
+            _ty[i] = kf.translation().y;
+            _tz[i] = kf.translation().z;
+            _sx[i] = kf.scale().x;
+            _sy[i] = kf.scale().y;
+            _sz[i] = kf.scale().z;
+
+            if (_quantizeRotations)
+            {
+                _qxQ[i] = (SLshort)lround(q.x() * quatQuantScale);
+                _qyQ[i] = (SLshort)lround(q.y() * quatQuantScale);
+                _qzQ[i] = (SLshort)lround(q.z() * quatQuantScale);
+                _qwQ[i] = (SLshort)lround(q.w() * quatQuantScale);
+            }
+            else
+            {
+                _qx[i] = q.x();
+                _qy[i] = q.y();
+                _qz[i] = q.z();
+                _qw[i] = q.w();
+            }
+        }
+        track++;
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Calculates the local transforms of all tracks at the passed time into the
+pose. The time wraps around the animation length like in
+SLAnimTrack::getKeyframesAtTime.
+*/
+void SLAnimClip::evaluate(SLfloat time, SLAnimPose& pose) const
+{
+    pose.resize(_numTracks);
+    if (_numTracks == 0) return;
+
+    if (_lengthSec > 0.0f)
+    {
+        if (time > _lengthSec)
+            time = fmod(time, _lengthSec);
+        while (time < 0.0f)
+            time += _lengthSec;
+    }
+
+    SLfloat sample = time * _sampleRate;
+    SLuint  s0     = std::min((SLuint)sample, _numSamples - 1);
+    SLuint  s1     = std::min(s0 + 1, _numSamples - 1);
+    SLfloat t      = std::min(std::max(sample - (SLfloat)s0, 0.0f), 1.0f);
+    size_t  i0     = (size_t)s0 * _numTracks;
+    size_t  i1     = (size_t)s1 * _numTracks;
+    SLuint  n      = _numTracks;
+
+    lerpChannel(&_tx[i0], &_tx[i1], t, pose.tx.data(), n);
+    lerpChannel(&_ty[i0], &_ty[i1], t, pose.ty.data(), n);
+    lerpChannel(&_tz[i0], &_tz[i1], t, pose.tz.data(), n);
+    lerpChannel(&_sx[i0], &_sx[i1], t, pose.sx.data(), n);
+    lerpChannel(&_sy[i0], &_sy[i1], t, pose.sy.data(), n);
+    lerpChannel(&_sz[i0], &_sz[i1], t, pose.sz.data(), n);
+
+    if (_quantizeRotations)
+        nlerpRotations(&_qxQ[i0], &_qyQ[i0], &_qzQ[i0], &_qwQ[i0], &_qxQ[i1], &_qyQ[i1], &_qzQ[i1], &_qwQ[i1], t, 1.0f / quatQuantScale, pose, n);
+    else
+        nlerpRotations(&_qx[i0], &_qy[i0], &_qz[i0], &_qw[i0], &_qx[i1], &_qy[i1], &_qz[i1], &_qw[i1], t, 1.0f, pose, n);
+}
+//-----------------------------------------------------------------------------
+/*! Composes the transform of the track i of the pose into the object matrix.
+The object matrix gets the same translation, rotation and scale transform as
+in SLNodeAnimTrack::applyToNode but composed in one matrix.
+*/
+static void composePose(const SLAnimPose& pose,
+                        SLuint            i,
+                        SLfloat           weight,
+                        SLfloat           scale,
+                        SLMat4f&          om)
+{
+    SLQuat4f rotation(pose.qx[i], pose.qy[i], pose.qz[i], pose.qw[i]);
+    if (weight != 1.0f)
+        rotation = SLQuat4f().slerp(rotation, weight);
+
+    // translate in parent space, rotate around the local origin & scale
+    SLVec3f pos = om.translation() +
+                  SLVec3f(pose.tx[i], pose.ty[i], pose.tz[i]) * weight * scale;
+    om.translation(0.0f, 0.0f, 0.0f);
+
+    SLMat4f m = rotation.toMat4() * om;
+    m.scale(pose.sx[i], pose.sy[i], pose.sz[i]);
+    m.translation(pos);
+    om = m;
+}
+//-----------------------------------------------------------------------------
+/*! Writes the pose to the target nodes in one pass. The targets vector holds
+one node or joint per track index (or nullptr to skip a track).
+*/
+void SLAnimClip::applyPose(const SLAnimPose& pose,
+                           const SLVNode&    targets,
+                           SLfloat           weight,
+                           SLfloat           scale) const
+{
+    SLuint n = std::min(_numTracks, (SLuint)targets.size());
+
+    for (SLuint i = 0; i < n; ++i)
+    {
+        SLNode* node = targets[i];
+        if (node == nullptr)
+            continue;
+
+        SLMat4f om = node->om();
+        composePose(pose, i, weight, scale, om);
+        node->om(om);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Writes the pose of a skeleton animation to local joint matrices instead of
+SLJoint nodes. The matrix of a track is found by its track ID that is the
+joint ID. This is used by SLSkeletonInstance that doesn't own any nodes.
+*/
+void SLAnimClip::applyPose(const SLAnimPose& pose,
+                           SLVMat4f&         localMats,
+                           SLfloat           weight,
+                           SLfloat           scale) const
+{
+    for (SLuint i = 0; i < _numTracks; ++i)
+    {
+        SLuint id = _trackIDs[i];
+        if (id < localMats.size())
+            composePose(pose, i, weight, scale, localMats[id]);
+    }
+}
+//-----------------------------------------------------------------------------
+//! Returns the memory of all samples in bytes
+size_t SLAnimClip::memoryBytes() const
+{
+    size_t numValues = (size_t)_numTracks * _numSamples;
+    size_t rotBytes  = _quantizeRotations ? sizeof(SLshort) : sizeof(SLfloat);
+    return numValues * (6 * sizeof(SLfloat) + 4 * rotBytes);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+//#############################################################################
+//  File:      SLAnimLOD.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+#include <SLAnimLOD.h>
+
+//-----------------------------------------------------------------------------
+SLAnimLOD::SLAnimLOD()
+  : _isOn(true),
+    _fullSizePX(150.0f),
+    _reducedRate(4),
+    _isVisible(true),
+    _screenSizePX(FLT_MAX),
+    _update(AU_full),
+    _needsEvaluation(true),
+    _framesSinceKey(0),
+    _hasKeys(false)
+{
+}
+//-----------------------------------------------------------------------------
+/*! Reports that a node drawing the skeleton survived the culling with the
+passed projected size in pixels. With multiple scene views the largest size
+is kept.
+*/
+void SLAnimLOD::visible(SLfloat screenSizePX)
+{
+    if (!_isVisible || screenSizePX > _screenSizePX)
+        _screenSizePX = screenSizePX;
+    _isVisible = true;
+}
+//-----------------------------------------------------------------------------
+/*! Decides the kind of update of the current frame based on the visibility
+and the screen size that were reported by the last culling. The visibility is
+reset for the culling of this frame. Must be called once per frame.
+*/
+SLAnimLODUpdate SLAnimLOD::nextUpdate()
+{
+    if (!_isOn)
+        _update = AU_full;
+    else if (!_isVisible)
+        _update = AU_skipped;
+    else if (_screenSizePX < _fullSizePX && _reducedRate > 1)
+        _update = AU_reduced;
+    else
+        _update = AU_full;
+
+    switch (_update)
+    {
+        case AU_full:
+            _needsEvaluation = true;
+            _hasKeys         = false;
+            break;
+        case AU_skipped:
+            _needsEvaluation = false;
+            _hasKeys         = false; // the time jumps while invisible
+            break;
+        case AU_reduced:
+            _framesSinceKey++;
+            _needsEvaluation = !_hasKeys || _framesSinceKey >= _reducedRate;
+            break;
+        default: break;
+    }
+
+    _isVisible    = false;
+    _screenSizePX = 0.0f;
+    return _update;
+}
+//-----------------------------------------------------------------------------
+/*! Finishes the update of the current frame. If the pose was evaluated the
+passed joint matrices are the new key pose. For reduced updates they are
+replaced by the interpolation between the last two key poses.
+*/
+void SLAnimLOD::finishUpdate(SLVMat4f& jointMatrices)
+{
+    if (_update == AU_reduced)
+    {
+        if (_needsEvaluation)
+        {
+            _keyFrom        = _hasKeys ? _keyTo : jointMatrices;
+            _keyTo          = jointMatrices;
+            _hasKeys        = true;
+            _framesSinceKey = 0;
+        }
+
+        SLfloat t = (SLfloat)_framesSinceKey / (SLfloat)_reducedRate;
+        for (SLuint i = 0; i < jointMatrices.size(); ++i)
+            jointMatrices[i] = _keyFrom[i] * (1.0f - t) + _keyTo[i] * t;
+    }
+
+    // Without a call of nextUpdate (e.g. a joint was moved by hand) the
+    // next update is a full one.
+    _update          = AU_full;
+    _needsEvaluation = true;
+}
+//-----------------------------------------------------------------------------
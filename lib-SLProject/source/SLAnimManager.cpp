@@ -16,6 +16,13 @@
 
 #include <SLScene.h>
 
+//-----------------------------------------------------------------------------
+SLAnimManager::SLAnimManager()
+  : _numFullUpdates(0),
+    _numReducedUpdates(0),
+    _numSkippedUpdates(0)
+{
+}
 //-----------------------------------------------------------------------------
 //! destructor
 SLAnimManager::~SLAnimManager()
@@ -35,12 +42,59 @@ void SLAnimManager::clear()
         delete it.second;
     _nodeAnimPlaybacks.clear();
 
+    for (auto instance : _skeletonInstances)
+        delete instance;
+    _skeletonInstances.clear();
+
     for (auto skeleton : _skeletons)
         delete skeleton;
     _skeletons.clear();
 
     _allAnimNames.clear();
     _allAnimPlaybacks.clear();
+
+    _numFullUpdates    = 0;
+    _numReducedUpdates = 0;
+    _numSkippedUpdates = 0;
+}
+//-----------------------------------------------------------------------------
+/*! Moves all skeletons, node animations and playbacks of the passed manager
+into this one. Used to add the animations of an asset that was loaded on a
+loader thread (see SLScene::addStaging). Node animations with a name that
+already exists get renamed.
+*/
+void SLAnimManager::merge(SLAnimManager& other)
+{
+    _skeletons.insert(_skeletons.end(), other._skeletons.begin(), other._skeletons.end());
+    _skeletonInstances.insert(_skeletonInstances.end(),
+                              other._skeletonInstances.begin(),
+                              other._skeletonInstances.end());
+
+    for (auto it : other._nodeAnimations)
+    {
+        SLstring name  = it.first;
+        SLuint   index = 1;
+        while (_nodeAnimations.find(name) != _nodeAnimations.end())
+            name = it.first + "_" + to_string(index++);
+
+        it.second->name(name);
+        _nodeAnimations[name]    = it.second;
+        _nodeAnimPlaybacks[name] = other._nodeAnimPlaybacks[it.first];
+    }
+
+    // The skeleton animations are only listed in the combined vectors
+    for (SLuint i = 0; i < other._allAnimPlaybacks.size(); ++i)
+    {
+        _allAnimNames.push_back(other._allAnimPlaybacks[i]->parentAnimation()->name());
+        _allAnimPlaybacks.push_back(other._allAnimPlaybacks[i]);
+    }
+
+    other._skeletons.clear();
+    other._skeletonInstances.clear();
+    other._nodeAnimations.clear();
+    other._nodeAnimPlaybacks.clear();
+    other._allAnimNames.clear();
+    other._allAnimPlaybacks.clear();
 }
 //-----------------------------------------------------------------------------
 //! Add a skeleton to the skeleton vector
@@ -49,6 +103,64 @@ void SLAnimManager::addSkeleton(SLSkeleton* skel)
     _skeletons.push_back(skel);
 }
 //-----------------------------------------------------------------------------
+/*! Creates a new independently animated instance of the passed skeleton. The
+instance is owned and updated by the animation manager. Assign it to the nodes
+that draw the skinned meshes with SLNode::skeletonInstance.
+*/
+SLSkeletonInstance* SLAnimManager::createSkeletonInstance(SLSkeleton* skel)
+{
+    SLSkeletonInstance* instance = new SLSkeletonInstance(skel);
+    _skeletonInstances.push_back(instance);
+    return instance;
+}
+//-----------------------------------------------------------------------------
+/*! Removes the skeleton with its animation playbacks from the manager and
+deletes it. Used by loaders that have to discard a partially loaded skeleton.
+*/
+void SLAnimManager::deleteSkeleton(SLSkeleton* skel)
+{
+    _skeletons.erase(std::remove(_skeletons.begin(), _skeletons.end(), skel),
+                     _skeletons.end());
+
+    for (SLint i = (SLint)_allAnimPlaybacks.size() - 1; i >= 0; --i)
+        if (skel->animPlayback(_allAnimNames[(SLuint)i]) == _allAnimPlaybacks[(SLuint)i])
+            removeAnimPlayback(_allAnimPlaybacks[(SLuint)i]);
+
+    delete skel;
+}
+//-----------------------------------------------------------------------------
+/*! Removes the node animation with its playback from the manager and deletes
+it. Used by loaders that have to discard a partially loaded animation.
+*/
+void SLAnimManager::deleteNodeAnimation(SLAnimation* anim)
+{
+    const SLstring& name = anim->name();
+    if (_nodeAnimations.find(name) == _nodeAnimations.end() ||
+        _nodeAnimations[name] != anim)
+        return;
+
+    SLAnimPlayback* playback = _nodeAnimPlaybacks[name];
+    removeAnimPlayback(playback);
+    _nodeAnimPlaybacks.erase(name);
+    _nodeAnimations.erase(name);
+    delete playback;
+    delete anim;
+}
+//-----------------------------------------------------------------------------
+//! Removes a playback and its name from the combined vectors
+void SLAnimManager::removeAnimPlayback(SLAnimPlayback* playback)
+{
+    for (SLuint i = 0; i < _allAnimPlaybacks.size(); ++i)
+    {
+        if (_allAnimPlaybacks[i] == playback)
+        {
+            _allAnimPlaybacks.erase(_allAnimPlaybacks.begin() + i);
+            _allAnimNames.erase(_allAnimNames.begin() + i);
+            return;
+        }
+    }
+}
+//-----------------------------------------------------------------------------
 /*! Creates a new node animation
     @param  duration    length of the animation
 */
@@ -119,16 +231,82 @@ SLbool SLAnimManager::update(SLfloat elapsedTimeSec)
             playback->parentAnimation()->resetNodes();
             playback->advanceTime(elapsedTimeSec);
             playback->parentAnimation()->apply(playback->localTime(),
-                                               playback->weight());
+                                               playback->weight(),
+                                               1.0f,
+                                               &playback->keyframeCursors());
             updated = true;
         }
     }
 
-    // update the skeletons separately
+    // update the skeletons and skeleton instances in one parallel loop. They
+    // only change their own joints, playbacks and joint matrices, so the result
+    // doesn't depend on the order.
+    atomic<bool> skeletonUpdated(false);
+    SLuint       numSkeletons = (SLuint)_skeletons.size();
+
+    SL::parallelFor(numSkeletons + (SLuint)_skeletonInstances.size(), [&](SLuint i) {
+        SLbool changed = i < numSkeletons
+                           ? _skeletons[i]->updateAnimations(elapsedTimeSec)
+                           : _skeletonInstances[i - numSkeletons]->updateAnimations(elapsedTimeSec);
+        if (changed) skeletonUpdated = true;
+    });
+
+    // count the animation LOD updates for the statistics
+    _numFullUpdates    = 0;
+    _numReducedUpdates = 0;
+    _numSkippedUpdates = 0;
     for (auto skeleton : _skeletons)
-        updated |= skeleton->updateAnimations(elapsedTimeSec);
+        countUpdate(skeleton->lastUpdate());
+    for (auto instance : _skeletonInstances)
+        countUpdate(instance->lastUpdate());
+
+    return updated || skeletonUpdated;
+}
+//-----------------------------------------------------------------------------
+//! Increments the statistics counter of the passed animation LOD update kind
+void SLAnimManager::countUpdate(SLAnimLODUpdate update)
+{
+    switch (update)
+    {
+        case AU_full: _numFullUpdates++; break;
+        case AU_reduced: _numReducedUpdates++; break;
+        case AU_skipped: _numSkippedUpdates++; break;
+        default: break;
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Does the software skinning of all passed meshes that are bound to a changed
+skeleton. The work is done in three dependent steps:
+1) The joint matrices of all changed skeletons are calculated in parallel once
+per skeleton and not once per mesh that is bound to it.
+2) The vertices of all meshes with a changed skeleton are transformed in
+parallel. Each mesh is skinned once even if it is referenced by many nodes.
+3) The parent nodes AABBs are flagged and the VBOs are updated on the main
+thread because they touch the scene graph and the OpenGL context.
+Returns true if any mesh was skinned.
+*/
+SLbool SLAnimManager::skinMeshes(const SLVMesh& meshes)
+{
+    SLVMesh skinnedMeshes;
+    for (auto mesh : meshes)
+        if (mesh->skeleton() && mesh->skeleton()->changed())
+            skinnedMeshes.push_back(mesh);
+
+    // 1) and 2) run as dependent stages on the thread pool
+    SL::parallelStages(
+      {{(SLuint)_skeletons.size(), [&](SLuint i) {
+            if (_skeletons[i]->changed())
+                _skeletons[i]->updateJointMatrices();
+        }},
+       {(SLuint)skinnedMeshes.size(), [&](SLuint i) {
+            skinnedMeshes[i]->skinVertices();
+        }}});
+
+    // 3) Update AABBs and VBOs on the main thread
+    for (auto mesh : skinnedMeshes)
+        mesh->updateSkin();
 
-    return updated;
+    return !skinnedMeshes.empty();
 }
 //-----------------------------------------------------------------------------
 //! Draws the animation visualizations.
@@ -39,12 +39,14 @@ SLAnimTrack::~SLAnimTrack()
 /*! Creates a new keyframed with the passed in timestamp.
     @note   It is required that the keyframes are created in chronological order.
             since we currently don't sort the keyframe list they have to be sorted
-            before being created.
+            before being created. The time of a keyframe must not be changed
+            after its creation because it is copied into _keyTimes.
 */
 SLKeyframe* SLAnimTrack::createKeyframe(SLfloat time)
 {
     SLKeyframe* kf = createKeyframeImpl(time);
     _keyframes.push_back(kf);
+    _keyTimes.push_back(time);
     return kf;
 }
 
@@ -59,15 +61,54 @@ SLKeyframe* SLAnimTrack::keyframe(SLint index)
     return _keyframes[(SLuint)index];
 }
 
+//-----------------------------------------------------------------------------
+/*! Returns the index of the last keyframe with a time less or equal to the
+    passed in time. If the time is before the first keyframe the index of the
+    last keyframe is returned for the wrap around.
+    If a cursor is passed the search starts at the cursor index and steps
+    forward over at most a few keyframes. This is the common case of a playback
+    that advances by one frame. Otherwise a binary search is done on the
+    contiguous key times. The cursor is updated with the found index.
+*/
+SLuint SLAnimTrack::findKeyframeIndex(SLfloat time, SLuint* cursor) const
+{
+    const SLuint maxCursorSteps = 4;
+    SLuint       numKf          = (SLuint)_keyTimes.size();
+
+    if (cursor && *cursor < numKf && _keyTimes[*cursor] <= time)
+    {
+        SLuint i = *cursor;
+        for (SLuint step = 0; step < maxCursorSteps; ++step)
+        {
+            if (i + 1 == numKf || _keyTimes[i + 1] > time)
+            {
+                *cursor = i;
+                return i;
+            }
+            ++i;
+        }
+    }
+
+    auto   upper = std::upper_bound(_keyTimes.begin(), _keyTimes.end(), time);
+    SLuint index = upper == _keyTimes.begin()
+                     ? numKf - 1
+                     : (SLuint)(upper - _keyTimes.begin()) - 1;
+    if (cursor)
+        *cursor = index;
+    return index;
+}
+
 //-----------------------------------------------------------------------------
 /*! Get the two keyframes to the left or the right of the passed in timestamp.
     If keyframes will wrap around, if there is no keyframe after the passed in time
     then the k2 result will be the first keyframe in the list.
     If only one keyframe exists the two values will be equivalent.
+    The optional cursor speeds up the keyframe search (see findKeyframeIndex).
 */
 SLfloat SLAnimTrack::getKeyframesAtTime(SLfloat      time,
                                         SLKeyframe** k1,
-                                        SLKeyframe** k2) const
+                                        SLKeyframe** k2,
+                                        SLuint*      cursor) const
 {
     SLfloat t1, t2;
     SLuint  numKf           = (SLuint)_keyframes.size();
@@ -97,38 +138,13 @@ SLfloat SLAnimTrack::getKeyframesAtTime(SLfloat      time,
 
     // search lower bound kf for given time
     // kf list must be sorted by time at this point
-    // @todo we could use std::lower_bounds here
-    // @todo this could be implemented much nicer
-    //      use the following algorithm:
-    //      1. find the keyframe that comes after the 'time' parameter
-    //      2. if there is no keyframe after 'time' then set keframe 2 to the first keyframe in the list
-    //          set t2 to animationLength + the time of the keyframe
-    //      3. if there is a keyframe after 'time' then set keyframe 2 to that keyframe
-    //          set t2 to the time of the keyframe
-    //      4. now find the keyframe before keyframe 2 (if we use iterators here this is trivial!)
-    //         set keyframe 1 to the keyframe found before keyframe 2
-    SLuint kfIndex = 0;
-    for (SLuint i = 0; i < numKf; ++i)
-    {
-        SLKeyframe* cur = _keyframes[i];
-
-        if (cur->time() <= time)
-        {
-            *k1     = cur;
-            kfIndex = i;
-        }
-    }
-
-    // time is than first kf
-    if (*k1 == nullptr)
-    {
-        *k1 = _keyframes.back();
-        // as long as k1 is in the back
-    }
+    // if time is before the first kf, k1 is the last kf (wrap around)
+    SLuint kfIndex = findKeyframeIndex(time, cursor);
+    *k1            = _keyframes[kfIndex];
 
     t1 = (*k1)->time();
 
-    if (*k1 == _keyframes.back())
+    if (kfIndex == numKf - 1)
     {
         *k2 = _keyframes.front();
         t2  = animationLength + (*k2)->time();
@@ -202,12 +218,13 @@ SLTransformKeyframe* SLNodeAnimTrack::createNodeKeyframe(SLfloat time)
 /*! Calculates a new keyframe based on the input time and interpolation functions.
 */
 void SLNodeAnimTrack::calcInterpolatedKeyframe(SLfloat     time,
-                                               SLKeyframe* keyframe) const
+                                               SLKeyframe* keyframe,
+                                               SLuint*     cursor) const
 {
     SLKeyframe* k1;
     SLKeyframe* k2;
 
-    SLfloat t = getKeyframesAtTime(time, &k1, &k2);
+    SLfloat t = getKeyframesAtTime(time, &k1, &k2, cursor);
 
     if (k1 == nullptr)
         return;
@@ -242,10 +259,13 @@ void SLNodeAnimTrack::calcInterpolatedKeyframe(SLfloat     time,
 //-----------------------------------------------------------------------------
 /*! Applies the animation with the input timestamp to the set animation target if it exists.
 */
-void SLNodeAnimTrack::apply(SLfloat time, SLfloat weight, SLfloat scale)
+void SLNodeAnimTrack::apply(SLfloat time,
+                            SLfloat weight,
+                            SLfloat scale,
+                            SLuint* cursor)
 {
     if (_animatedNode)
-        applyToNode(_animatedNode, time, weight, scale);
+        applyToNode(_animatedNode, time, weight, scale, cursor);
 }
 
 //-----------------------------------------------------------------------------
@@ -254,13 +274,14 @@ void SLNodeAnimTrack::apply(SLfloat time, SLfloat weight, SLfloat scale)
 void SLNodeAnimTrack::applyToNode(SLNode* node,
                                   SLfloat time,
                                   SLfloat weight,
-                                  SLfloat scale)
+                                  SLfloat scale,
+                                  SLuint* cursor)
 {
     if (node == nullptr)
         return;
 
     SLTransformKeyframe kf(nullptr, time);
-    calcInterpolatedKeyframe(time, &kf);
+    calcInterpolatedKeyframe(time, &kf, cursor);
 
     SLVec3f translation = kf.translation() * weight * scale;
     node->translate(translation, TS_parent);
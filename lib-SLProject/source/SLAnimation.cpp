@@ -21,7 +21,7 @@
 /*! Constructor
 */
 SLAnimation::SLAnimation(const SLstring& name, SLfloat duration)
-  : _name(name), _lengthSec(duration)
+  : _name(name), _lengthSec(duration), _clip(nullptr)
 {
 }
 //-----------------------------------------------------------------------------
@@ -31,6 +31,8 @@ SLAnimation::~SLAnimation()
 {
     for (auto it : _nodeAnimTracks)
         delete it.second;
+
+    delete _clip;
 }
 //-----------------------------------------------------------------------------
 /*! Setter for the animation length
@@ -38,6 +40,10 @@ SLAnimation::~SLAnimation()
 void SLAnimation::lengthSec(SLfloat lengthSec)
 {
     _lengthSec = lengthSec;
+
+    // The compiled clip is sampled over the old length
+    delete _clip;
+    _clip = nullptr;
 }
 //-----------------------------------------------------------------------------
 /*! Returns the timestamp for the next keyframe in all of the tracks.
@@ -119,15 +125,36 @@ SLNodeAnimTrack* SLAnimation::createNodeAnimationTrack(SLuint id)
 
     _nodeAnimTracks[id] = new SLNodeAnimTrack(this);
 
+    // A compiled clip doesn't contain the new track
+    delete _clip;
+    _clip = nullptr;
+
     return _nodeAnimTracks[id];
 }
 //-----------------------------------------------------------------------------
 /*! Applies all animation tracks for the passed in timestamp, weight and scale.
+The optional cursors vector holds one keyframe cursor per track and is owned
+by the playback (see SLAnimTrack::getKeyframesAtTime).
 */
-void SLAnimation::apply(SLfloat time, SLfloat weight, SLfloat scale)
+void SLAnimation::apply(SLfloat  time,
+                        SLfloat  weight,
+                        SLfloat  scale,
+                        SLVuint* cursors)
 {
+    if (_clip)
+    {
+        thread_local SLAnimPose pose;
+        _clip->evaluate(time, pose);
+        _clip->applyPose(pose, _clip->animatedNodes(), weight, scale);
+        return;
+    }
+
+    if (cursors && cursors->size() != _nodeAnimTracks.size())
+        cursors->assign(_nodeAnimTracks.size(), 0);
+
+    SLuint i = 0;
     for (auto it : _nodeAnimTracks)
-        it.second->apply(time, weight, scale);
+        it.second->apply(time, weight, scale, cursors ? &(*cursors)[i++] : nullptr);
 }
 //-----------------------------------------------------------------------------
 /*! Applies all node tracks of this animation on a single node
@@ -142,16 +169,43 @@ void SLAnimation::applyToNode(SLNode* node,
 }
 //-----------------------------------------------------------------------------
 /*! Applies all the tracks to their respective joints in the passed in skeleton.
+The optional cursors vector holds one keyframe cursor per track and is owned
+by the playback (see SLAnimTrack::getKeyframesAtTime).
 */
 void SLAnimation::apply(SLSkeleton* skel,
                         SLfloat     time,
                         SLfloat     weight,
-                        SLfloat     scale)
+                        SLfloat     scale,
+                        SLVuint*    cursors)
 {
+    if (_clip)
+    {
+        // Skeletons are updated in parallel (see SLAnimManager::update),
+        // so the scratch buffers must not be shared between threads.
+        thread_local SLAnimPose pose;
+        thread_local SLVNode    jointTargets;
+
+        jointTargets.clear();
+        for (auto id : _clip->trackIDs())
+            jointTargets.push_back(skel->getJoint(id));
+
+        _clip->evaluate(time, pose);
+        _clip->applyPose(pose, jointTargets, weight, scale);
+        return;
+    }
+
+    if (cursors && cursors->size() != _nodeAnimTracks.size())
+        cursors->assign(_nodeAnimTracks.size(), 0);
+
+    SLuint i = 0;
     for (auto it : _nodeAnimTracks)
     {
         SLJoint* joint = skel->getJoint(it.first);
-        it.second->applyToNode(joint, time, weight, scale);
+        it.second->applyToNode(joint,
+                               time,
+                               weight,
+                               scale,
+                               cursors ? &(*cursors)[i++] : nullptr);
     }
 }
 //-----------------------------------------------------------------------------
@@ -320,3 +374,15 @@ SLNodeAnimTrack* SLAnimation::createEllipticNodeTrack(SLNode* target,
     return track;
 }
 //-----------------------------------------------------------------------------
+/*! Compiles the animation into an SLAnimClip that is used by the apply
+functions from now on. It must be called after all keyframes are created.
+Adding a track or changing the length discards the compiled clip.
+@param sampleRate Samples per second of the resampled tracks
+@param quantizeRotations Flag if the rotations are stored as 16 bit integers
+*/
+void SLAnimation::compile(SLfloat sampleRate, SLbool quantizeRotations)
+{
+    delete _clip;
+    _clip = new SLAnimClip(this, sampleRate, quantizeRotations);
+}
+//-----------------------------------------------------------------------------
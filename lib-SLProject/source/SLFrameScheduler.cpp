@@ -0,0 +1,94 @@
+//#############################################################################
+//  File:      SLFrameScheduler.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#include <debug_new.h> // memory leak detector
+#endif
+
+#include <SLFrameScheduler.h>
+
+//-----------------------------------------------------------------------------
+//! The wait ends 1 ms early, so that the next buffer swap doesn't miss a vsync
+SLfloat SLFrameScheduler::waitSlackMS = 1.0f;
+//-----------------------------------------------------------------------------
+SLFrameScheduler::SLFrameScheduler()
+{
+    _dirty         = 0;
+    _lastDirty     = 0;
+    _targetFPS     = 0.0f;
+    _refreshRateHz = 0.0f;
+    _frameStartMS  = 0.0f;
+    _wasIdle       = true;
+    _timer.start();
+}
+//-----------------------------------------------------------------------------
+/*! Starts a new frame and returns the elapsed time in ms since the start of
+the last frame. After an idle period it returns at most one frame period.
+*/
+SLfloat SLFrameScheduler::beginFrame()
+{
+    SLfloat nowMS     = (SLfloat)_timer.elapsedTimeInMilliSec();
+    SLfloat elapsedMS = nowMS - _frameStartMS;
+
+    if (_wasIdle)
+        elapsedMS = std::min(elapsedMS, frameTimeMS());
+
+    _frameStartMS = nowMS;
+    _wasIdle      = false;
+    return elapsedMS;
+}
+//-----------------------------------------------------------------------------
+/*! Ends the frame and returns true if any dirty source requests the next
+frame. If it returns false the main loop waits for the next event and the
+next frame counts as the first after an idle period.
+*/
+SLbool SLFrameScheduler::endFrame()
+{
+    _lastDirty = _dirty.exchange(0);
+    _wasIdle   = _lastDirty == 0;
+    return !_wasIdle;
+}
+//-----------------------------------------------------------------------------
+/*! Sleeps until the next frame of the target frame rate is due. Without a
+target frame rate the buffer swap with vsync does the pacing alone.
+*/
+void SLFrameScheduler::waitForNextFrame()
+{
+    if (_targetFPS <= 0.0f) return;
+
+    SLfloat usedMS = (SLfloat)_timer.elapsedTimeInMilliSec() - _frameStartMS;
+    SLfloat waitMS = frameTimeMS() - usedMS - waitSlackMS;
+
+    if (waitMS > 0.0f)
+        this_thread::sleep_for(chrono::microseconds((SLint)(waitMS * 1000.0f)));
+}
+//-----------------------------------------------------------------------------
+/*! Returns the frame period in ms. With a known refresh rate the period of
+the target frame rate is rounded to a multiple of the refresh period.
+*/
+SLfloat SLFrameScheduler::frameTimeMS() const
+{
+    if (_refreshRateHz > 0.0f)
+        return 1000.0f / _refreshRateHz * (SLfloat)swapInterval();
+
+    return 1000.0f / (_targetFPS > 0.0f ? _targetFPS : 60.0f);
+}
+//-----------------------------------------------------------------------------
+//! Returns the NO. of vertical syncs per frame for the target frame rate
+SLint SLFrameScheduler::swapInterval() const
+{
+    if (_targetFPS <= 0.0f || _refreshRateHz <= 0.0f)
+        return 1;
+
+    return std::max((SLint)(_refreshRateHz / _targetFPS + 0.5f), 1);
+}
+//-----------------------------------------------------------------------------
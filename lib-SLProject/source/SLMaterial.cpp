@@ -138,14 +138,27 @@ SLMaterial::~SLMaterial()
 {
 }
 //-----------------------------------------------------------------------------
+//! Attaches the default shader program if no shader program is attached
+void SLMaterial::assignDefaultProgram()
+{
+    if (_program) return;
+
+    SLScene* s = SLApplication::scene;
+    if (_textures.size() > 0)
+        program(s->programs(SP_perVrtBlinnTex));
+    else
+        program(s->programs(SP_perVrtBlinn));
+}
+//-----------------------------------------------------------------------------
 /*!
 SLMaterial::activate applies the material parameter to the global render state
-and activates the attached shader
+and activates the attached shader. An optional override program is activated
+instead of the attached one (e.g. the skinning shader in SLMesh::draw).
 */
-void SLMaterial::activate(SLGLState* state, SLDrawBits drawBits)
+void SLMaterial::activate(SLGLState*   state,
+                          SLDrawBits   drawBits,
+                          SLGLProgram* overrideProgram)
 {
-    SLScene* s = SLApplication::scene;
-
     // Deactivate shader program of the current active material
     if (current && current->program())
         current->program()->endShader();
@@ -154,13 +167,7 @@ void SLMaterial::activate(SLGLState* state, SLDrawBits drawBits)
     current = this;
 
     // If no shader program is attached add the default shader program
-    if (!_program)
-    {
-        if (_textures.size() > 0)
-            program(s->programs(SP_perVrtBlinnTex));
-        else
-            program(s->programs(SP_perVrtBlinn));
-    }
+    assignDefaultProgram();
 
     // Check if shader had compile error and the error texture should be shown
     if (_program && _program->name().find("ErrorTex") != string::npos)
@@ -189,7 +196,10 @@ void SLMaterial::activate(SLGLState* state, SLDrawBits drawBits)
     }
 
     // Activate the shader program now
-    program()->beginUse(this);
+    if (overrideProgram)
+        overrideProgram->beginUse(this);
+    else
+        program()->beginUse(this);
 }
 //-----------------------------------------------------------------------------
 /*! 
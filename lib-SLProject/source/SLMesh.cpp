@@ -22,6 +22,7 @@
 #include <SLRay.h>
 #include <SLRaytracer.h>
 #include <SLSceneView.h>
+#include <SLSkeletonInstance.h>
 #include <SLSkybox.h>
 
 //-----------------------------------------------------------------------------
@@ -46,9 +47,13 @@ SLMesh::SLMesh(SLstring name) : SLObject(name)
     _isVolume             = true;    // is used for RT to decide inside/outside
     _accelStruct          = nullptr; // no initial acceleration structure
     _accelStructOutOfDate = true;
+    _vaoPackFlag          = false;
+    _vaoIsPacked          = false;
 
     // Add this mesh to the global resource vector for deallocation
-    SLApplication::scene->meshes().push_back(this);
+    // Headless tools without a scene delete their meshes themselves.
+    if (SLApplication::scene)
+        SLApplication::scene->meshes().push_back(this);
 }
 //-----------------------------------------------------------------------------
 //! The destructor deletes everything by calling deleteData.
@@ -78,7 +83,6 @@ void SLMesh::deleteData()
     I32.clear();
     IS32.clear();
 
-    _jointMatrices.clear();
     skinnedP.clear();
     skinnedN.clear();
 
@@ -91,6 +95,7 @@ void SLMesh::deleteData()
     _vao.deleteGL();
     _vaoN.deleteGL();
     _vaoT.deleteGL();
+    _vaoSkin.deleteGL();
 }
 //-----------------------------------------------------------------------------
 //! Deletes the rectangle selected vertices and the dependend triangles.
@@ -182,6 +187,7 @@ void SLMesh::deleteSelected(SLNode* node)
 
     // delete vertex array object so it gets regenerated
     _vao.deleteGL();
+    _vaoSkin.deleteGL();
 
     // delete the selection indexes
     IS32.clear();
@@ -352,11 +358,25 @@ void SLMesh::draw(SLSceneView* sv, SLNode* node)
     /////////////////////////////
 
     // 2.a) Apply mesh material if exists & differs from current
-    if (mat() != SLMaterial::current || SLMaterial::current->program() == nullptr)
+    // The meshes of a node with a skeleton instance are skinned on the GPU
+    // with the joint matrices of the instance and a skinning shader.
+    SLSkeletonInstance* skelInst  = node->skeletonInstance();
+    SLbool              skinOnGPU = skelInst && Ji.size() &&
+                                    skelInst->jointMatrices().size() <= SLSkeletonInstance::maxJointsGPU();
+    SLGLProgram*        skinProg  = nullptr;
+
+    if (skinOnGPU)
+    {
+        SLScene* s = SLApplication::scene;
+        skinProg   = s->programs(_mat->textures().size() ? SP_perVrtBlinnTexSkinned
+                                                         : SP_perVrtBlinnSkinned);
+        mat()->activate(_stateGL, *node->drawBits(), skinProg);
+    }
+    else if (mat() != SLMaterial::current || SLMaterial::current->program() == nullptr)
         mat()->activate(_stateGL, *node->drawBits());
 
     // 2.b) Pass the matrices to the shader program
-    SLGLProgram* sp = SLMaterial::current->program();
+    SLGLProgram* sp = skinOnGPU ? skinProg : SLMaterial::current->program();
     sp->uniformMatrix4fv("u_mvMatrix", 1, (SLfloat*)&_stateGL->modelViewMatrix);
     sp->uniformMatrix4fv("u_mvpMatrix", 1, (const SLfloat*)_stateGL->mvpMatrix());
 
@@ -390,31 +410,51 @@ void SLMesh::draw(SLSceneView* sv, SLNode* node)
         sp->uniformMatrix4fv(locTM, 1, (SLfloat*)&_stateGL->textureMatrix);
     }
 
+    // 2.d) Pass the joint matrices of the skeleton instance
+    if (skinOnGPU)
+    {
+        const SLVMat4f& jm = skelInst->jointMatrices();
+        sp->uniformMatrix4fv("u_jointMatrices", (SLsizei)jm.size(), (const SLfloat*)&jm[0]);
+    }
+
     ///////////////////////////////////////
     // 3) Generate Vertex Array Object once
     ///////////////////////////////////////
 
-    if (!_vao.id())
-    {
-        _vao.setAttrib(AT_position, sp->getAttribLocation("a_position"), _finalP);
-        if (N.size()) _vao.setAttrib(AT_normal, sp->getAttribLocation("a_normal"), _finalN);
-        if (Tc.size()) _vao.setAttrib(AT_texCoord, sp->getAttribLocation("a_texCoord"), &Tc);
-        if (C.size()) _vao.setAttrib(AT_color, sp->getAttribLocation("a_color"), &C);
-        if (T.size()) _vao.setAttrib(AT_tangent, sp->getAttribLocation("a_tangent"), &T);
-        if (I16.size()) _vao.setIndices(&I16);
-        if (I32.size()) _vao.setIndices(&I32);
-
-        _vao.generate((SLuint)P.size(), Ji.size() ? BU_stream : BU_static, !Ji.size());
-    }
+    generateVAO(sp);
+
+    if (skinOnGPU && !_vaoSkin.id())
+        generateSkinVAO(sp);
 
     ///////////////////////////////
     // 4): Finally do the draw call
     ///////////////////////////////
 
+    SLGLVertexArray& vao    = skinOnGPU ? _vaoSkin : _vao;
+    SLbool           packed = !skinOnGPU && _vaoIsPacked;
+
+    if (packed)
+    {
+        sp->uniform1i("u_vertexPacked", 1);
+        sp->uniform3f("u_posScale", _packScale.x, _packScale.y, _packScale.z);
+        sp->uniform3f("u_posOffset", _packOffset.x, _packOffset.y, _packOffset.z);
+    }
+
     if (_primitive == PT_points)
-        _vao.drawArrayAs(PT_points);
+        vao.drawArrayAs(PT_points);
     else
-        _vao.drawElementsAs(primitiveType);
+        vao.drawElementsAs(primitiveType);
+
+    if (packed)
+        sp->uniform1i("u_vertexPacked", 0);
+
+    // The skinning shader is not the material program, so the material must
+    // be activated again by the next mesh.
+    if (skinOnGPU)
+    {
+        skinProg->endShader();
+        SLMaterial::current = nullptr;
+    }
 
     //////////////////////////////////////
     // 5) Draw optional normals & tangents
@@ -612,24 +652,82 @@ void SLMesh::addStats(SLNodeStats& stats)
         _accelStruct->updateStats(stats);
 }
 //-----------------------------------------------------------------------------
+//! Min. NO. of vertices for which the calc functions run in parallel
+SLuint SLMesh::minParallelVertices = 100000;
+//-----------------------------------------------------------------------------
+/*! Returns the NO. of vertex ranges for the parallel calc functions: One range
+for small meshes and rangesPerThread ranges per thread for large meshes.
+*/
+static SLuint numVertexRanges(SLuint numVertices, SLuint rangesPerThread)
+{
+    if (numVertices < SLMesh::minParallelVertices)
+        return 1;
+    return SL::maxThreads() * rangesPerThread;
+}
+//-----------------------------------------------------------------------------
+/*! Splits numItems items into numRanges consecutive ranges and calls the
+function with the range index and the first and last (excluded) item of each
+range in parallel. A single range is processed on the calling thread.
+*/
+template<typename Function>
+static void forRanges(SLuint numItems, SLuint numRanges, Function function)
+{
+    SLuint rangeSize = (numItems + numRanges - 1) / numRanges;
+
+    SL::parallelFor(numRanges, [&](SLuint r) {
+        SLuint first = r * rangeSize;
+        SLuint last  = SL_min(first + rangeSize, numItems);
+        if (first < last)
+            function(r, first, last);
+    });
+}
+//-----------------------------------------------------------------------------
 /*! 
-SLMesh::calcMinMax calculates the axis alligned minimum and maximum point
+SLMesh::calcMinMax calculates the axis alligned minimum and maximum point.
+Large meshes are reduced in parallel ranges. The loop is branch-free so that
+the compiler can vectorize it. The ranges are combined in their order, so the
+result is exactly the same as with a single range.
 */
 void SLMesh::calcMinMax()
 {
-    // init min & max points
+    const SLVVec3f& pos       = *_finalP;
+    SLuint          numV      = (SLuint)P.size();
+    SLuint          numRanges = numVertexRanges(numV, 4);
+    SLVVec3f        rangeMin(numRanges, SLVec3f(FLT_MAX, FLT_MAX, FLT_MAX));
+    SLVVec3f        rangeMax(numRanges, SLVec3f(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+
+    // calc min and max point of all vertices per range
+    forRanges(numV, numRanges, [&](SLuint r, SLuint first, SLuint last) {
+        SLfloat minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+        SLfloat maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+
+        for (SLuint i = first; i < last; ++i)
+        {
+            const SLVec3f& p = pos[i];
+            minX             = p.x < minX ? p.x : minX;
+            maxX             = p.x > maxX ? p.x : maxX;
+            minY             = p.y < minY ? p.y : minY;
+            maxY             = p.y > maxY ? p.y : maxY;
+            minZ             = p.z < minZ ? p.z : minZ;
+            maxZ             = p.z > maxZ ? p.z : maxZ;
+        }
+
+        rangeMin[r].set(minX, minY, minZ);
+        rangeMax[r].set(maxX, maxY, maxZ);
+    });
+
+    // init min & max points and combine the ranges
     minP.set(FLT_MAX, FLT_MAX, FLT_MAX);
     maxP.set(-FLT_MAX, -FLT_MAX, -FLT_MAX);
 
-    // calc min and max point of all vertices
-    for (SLuint i = 0; i < P.size(); ++i)
+    for (SLuint r = 0; r < numRanges; ++r)
     {
-        if (finalP(i).x < minP.x) minP.x = finalP(i).x;
-        if (finalP(i).x > maxP.x) maxP.x = finalP(i).x;
-        if (finalP(i).y < minP.y) minP.y = finalP(i).y;
-        if (finalP(i).y > maxP.y) maxP.y = finalP(i).y;
-        if (finalP(i).z < minP.z) minP.z = finalP(i).z;
-        if (finalP(i).z > maxP.z) maxP.z = finalP(i).z;
+        if (rangeMin[r].x < minP.x) minP.x = rangeMin[r].x;
+        if (rangeMax[r].x > maxP.x) maxP.x = rangeMax[r].x;
+        if (rangeMin[r].y < minP.y) minP.y = rangeMin[r].y;
+        if (rangeMax[r].y > maxP.y) maxP.y = rangeMax[r].y;
+        if (rangeMin[r].z < minP.z) minP.z = rangeMin[r].z;
+        if (rangeMax[r].z > maxP.z) maxP.z = rangeMax[r].z;
     }
 }
 //-----------------------------------------------------------------------------
@@ -649,20 +747,81 @@ void SLMesh::calcCenterRad(SLVec3f& center, SLfloat& radius)
     xmin.x = ymin.y = zmin.z = FLT_MAX;
     xmax.x = ymax.y = zmax.z = -FLT_MAX;
 
-    for (i = 0; i < P.size(); ++i)
+    // A point that is a new minimum is not tested for a new maximum (else if).
+    // To find exactly the same points in parallel ranges, every range first
+    // gets its minimal coordinates. Every range then searches its points
+    // starting with the minima of all ranges before it.
+    SLuint   numV      = (SLuint)P.size();
+    SLuint   numRanges = numVertexRanges(numV, 4);
+    SLVVec3f rangeMin(numRanges, SLVec3f(FLT_MAX, FLT_MAX, FLT_MAX));
+    SLVVec3f prevMin(numRanges, SLVec3f(FLT_MAX, FLT_MAX, FLT_MAX));
+
+    if (numRanges > 1)
+    {
+        forRanges(numV, numRanges, [&](SLuint r, SLuint first, SLuint last) {
+            SLVec3f& m = rangeMin[r];
+            for (SLuint i = first; i < last; ++i)
+            {
+                m.x = P[i].x < m.x ? P[i].x : m.x;
+                m.y = P[i].y < m.y ? P[i].y : m.y;
+                m.z = P[i].z < m.z ? P[i].z : m.z;
+            }
+        });
+
+        for (SLuint r = 1; r < numRanges; ++r)
+            for (SLint a = 0; a < 3; ++a)
+                prevMin[r].comp[a] = SL_min(prevMin[r - 1].comp[a],
+                                            rangeMin[r - 1].comp[a]);
+    }
+
+    // min. & max. point per axis (0=x, 1=y, 2=z) and range
+    struct ExtremePoints
+    {
+        SLVec3f minPt[3];
+        SLVec3f maxPt[3];
+        SLbool  hasMin[3] = {false, false, false};
+        SLbool  hasMax[3] = {false, false, false};
+    };
+    vector<ExtremePoints> extremes(numRanges);
+
+    forRanges(numV, numRanges, [&](SLuint r, SLuint first, SLuint last) {
+        ExtremePoints& e = extremes[r];
+        SLVec3f        curMin(prevMin[r]);
+        SLVec3f        curMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+        for (SLuint i = first; i < last; ++i)
+        {
+            for (SLint a = 0; a < 3; ++a)
+            {
+                if (P[i].comp[a] < curMin.comp[a])
+                {
+                    curMin.comp[a] = P[i].comp[a];
+                    e.minPt[a]     = P[i];
+                    e.hasMin[a]    = true;
+                }
+                else if (P[i].comp[a] > curMax.comp[a])
+                {
+                    curMax.comp[a] = P[i].comp[a];
+                    e.maxPt[a]     = P[i];
+                    e.hasMax[a]    = true;
+                }
+            }
+        }
+    });
+
+    // combine the ranges in their order
+    SLVec3f* minPts[3] = {&xmin, &ymin, &zmin};
+    SLVec3f* maxPts[3] = {&xmax, &ymax, &zmax};
+    for (SLuint r = 0; r < numRanges; ++r)
     {
-        if (P[i].x < xmin.x)
-            xmin = P[i];
-        else if (P[i].x > xmax.x)
-            xmax = P[i];
-        if (P[i].y < ymin.y)
-            ymin = P[i];
-        else if (P[i].y > ymax.y)
-            ymax = P[i];
-        if (P[i].z < zmin.z)
-            zmin = P[i];
-        else if (P[i].z > zmax.z)
-            zmax = P[i];
+        for (SLint a = 0; a < 3; ++a)
+        {
+            if (extremes[r].hasMin[a])
+                *minPts[a] = extremes[r].minPt[a];
+            if (extremes[r].hasMax[a] &&
+                extremes[r].maxPt[a].comp[a] > maxPts[a]->comp[a])
+                *maxPts[a] = extremes[r].maxPt[a];
+        }
     }
 
     // Set xspan = distance between the 2 points xmin & xmax (squared)
@@ -712,6 +871,7 @@ void SLMesh::calcCenterRad(SLVec3f& center, SLfloat& radius)
     radius  = sqrt(radius2);
 
     // SECOND PASS: increment current sphere
+    // This pass depends on the order of the points and stays serial.
     for (i = 0; i < P.size(); ++i)
     {
         dx          = P[i].x - center.x;
@@ -794,6 +954,104 @@ void SLMesh::updateAccelStruct()
     }
 }
 //-----------------------------------------------------------------------------
+/*! Sorts the triangles into the vertex ranges of their vertices for the
+parallel calcNormals and calcTangents. The triangles are split into numRanges
+ranges as well that are sorted in parallel. buckets[t * numRanges + v] lists
+the triangles of the triangle range t with a vertex in the vertex range v in
+ascending order. A triangle is listed only once per vertex range, so the
+buckets hold at most 3 entries per triangle.
+*/
+template<typename INDEX>
+static void bucketTriangles(const vector<INDEX>& I,
+                            SLuint               numV,
+                            SLuint               numRanges,
+                            vector<SLVuint>&     buckets)
+{
+    SLuint numT            = (SLuint)I.size() / 3;
+    SLuint vertexRangeSize = (numV + numRanges - 1) / numRanges;
+
+    buckets.assign(numRanges * numRanges, SLVuint());
+
+    forRanges(numT, numRanges, [&](SLuint tr, SLuint first, SLuint last) {
+        SLVuint* rangeBuckets = &buckets[tr * numRanges];
+        for (SLuint t = first; t < last; ++t)
+        {
+            SLuint rA = I[t * 3] / vertexRangeSize;
+            SLuint rB = I[t * 3 + 1] / vertexRangeSize;
+            SLuint rC = I[t * 3 + 2] / vertexRangeSize;
+            rangeBuckets[rA].push_back(t);
+            if (rB != rA) rangeBuckets[rB].push_back(t);
+            if (rC != rA && rC != rB) rangeBuckets[rC].push_back(t);
+        }
+    });
+}
+//-----------------------------------------------------------------------------
+/*! Calls the function with the first index of every triangle that has a
+vertex in the vertex range vr. The triangles come in ascending order, so every
+vertex sums up its triangles in the same order as the serial loop. Without
+buckets (single range) all triangles are passed.
+*/
+template<typename INDEX, typename Function>
+static void forRangeTriangles(const vector<INDEX>&   I,
+                              const vector<SLVuint>& buckets,
+                              SLuint                 numRanges,
+                              SLuint                 vr,
+                              Function               function)
+{
+    if (buckets.empty())
+    {
+        for (SLuint i = 0; i + 2 < I.size(); i += 3)
+            function(i);
+        return;
+    }
+
+    for (SLuint tr = 0; tr < numRanges; ++tr)
+        for (auto t : buckets[tr * numRanges + vr])
+            function(t * 3);
+}
+//-----------------------------------------------------------------------------
+/*! Adds the not normalized face normals of the triangles of the vertex range
+vr to the normals of its vertices in [first, last). Every vertex normal is
+summed up in the same order for any NO. of ranges, so the result is
+bit-identical to a single range over all vertices.
+*/
+template<typename INDEX>
+static void accumulateNormals(const SLVVec3f&        P,
+                              const vector<INDEX>&   I,
+                              const vector<SLVuint>& buckets,
+                              SLuint                 numRanges,
+                              SLVVec3f&              N,
+                              SLuint                 vr,
+                              SLuint                 first,
+                              SLuint                 last)
+{
+    SLuint numV = last - first;
+
+    forRangeTriangles(I, buckets, numRanges, vr, [&](SLuint i) {
+        SLuint iA = I[i], iB = I[i + 1], iC = I[i + 2];
+
+        // Only add to the vertices in the range (unsigned wrap around)
+        SLbool inA = iA - first < numV;
+        SLbool inB = iB - first < numV;
+        SLbool inC = iC - first < numV;
+
+        // Calculate the face's normal
+        SLVec3f e1, e2, n;
+
+        // Calculate edges of triangle
+        e1.sub(P[iB], P[iC]); // e1 = B - C
+        e2.sub(P[iB], P[iA]); // e2 = B - A
+
+        // Build normal with cross product but do NOT normalize it.
+        n.cross(e1, e2); // n = e1 x e2
+
+        // Add this normal to its vertices normals
+        if (inA) N[iA] += n;
+        if (inB) N[iB] += n;
+        if (inC) N[iC] += n;
+    });
+}
+//-----------------------------------------------------------------------------
 //! SLMesh::calcNormals recalculates vertex normals for triangle meshes.
 /*! SLMesh::calcNormals recalculates the normals only from the vertices.
 This algorithms doesn't know anything about smoothgroups. It just loops over
@@ -802,6 +1060,11 @@ vertices. Note that the face normals are not normalized. The cross product of
 2 vectors is proportional to the area of the triangle. Like this the normal of
 big triangles are more weighted than small triangles and we get a better normal
 quality. At the end all vertex normals are normalized.
+Meshes with at least minParallelVertices vertices are split into one vertex
+range per thread. The triangles are first sorted in parallel into the vertex
+ranges they touch (see bucketTriangles). Every thread then only adds the
+triangles of its own vertices. No locks are needed, the work stays linear in
+the NO. of triangles and the normals are exactly the same as serially.
 */
 void SLMesh::calcNormals()
 {
@@ -811,61 +1074,101 @@ void SLMesh::calcNormals()
     if (_primitive != PT_triangles)
         return;
 
-    // Create vector and fill with zero vectors
-    N.resize(P.size());
-    std::fill(N.begin(), N.end(), SLVec3f::ZERO);
+    SLuint          numV      = (SLuint)P.size();
+    SLuint          numRanges = numVertexRanges(numV, 1);
+    vector<SLVuint> buckets;
+    N.resize(numV);
 
-    if (I16.size())
+    if (numRanges > 1)
     {
-        // Loop over all triangles
-        for (SLuint i = 0; i < I16.size(); i += 3)
-        {
-            // Calculate the face's normal
-            SLVec3f e1, e2, n;
-
-            // Calculate edges of triangle
-            e1.sub(P[I16[i + 1]], P[I16[i + 2]]); // e1 = B - C
-            e2.sub(P[I16[i + 1]], P[I16[i]]);     // e2 = B - A
-
-            // Build normal with cross product but do NOT normalize it.
-            n.cross(e1, e2); // n = e1 x e2
-
-            // Add this normal to its vertices normals
-            N[I16[i]] += n;
-            N[I16[i + 1]] += n;
-            N[I16[i + 2]] += n;
-        }
-    }
-    else
-    {
-        for (SLuint i = 0; i < I32.size(); i += 3)
-        {
-            // Calculate the face's normal
-            SLVec3f e1, e2, n;
-
-            // Calculate edges of triangle
-            e1.sub(P[I32[i + 1]], P[I32[i + 2]]); // e1 = B - C
-            e2.sub(P[I32[i + 1]], P[I32[i]]);     // e2 = B - A
-
-            // Build normal with cross product but do NOT normalize it.
-            n.cross(e1, e2); // n = e1 x e2
-
-            // Add this normal to its vertices normals
-            N[I32[i]] += n;
-            N[I32[i + 1]] += n;
-            N[I32[i + 2]] += n;
-        }
+        if (I16.size())
+            bucketTriangles(I16, numV, numRanges, buckets);
+        else
+            bucketTriangles(I32, numV, numRanges, buckets);
     }
 
-    // normalize vertex normals
-    for (SLuint i = 0; i < P.size(); ++i)
-        N[i].normalize();
+    forRanges(numV,
+              numRanges,
+              [&](SLuint r, SLuint first, SLuint last) {
+                  // Fill with zero vectors
+                  std::fill(N.begin() + first, N.begin() + last, SLVec3f::ZERO);
+
+                  if (I16.size())
+                      accumulateNormals(P, I16, buckets, numRanges, N, r, first, last);
+                  else
+                      accumulateNormals(P, I32, buckets, numRanges, N, r, first, last);
+
+                  // normalize vertex normals
+                  for (SLuint i = first; i < last; ++i)
+                      N[i].normalize();
+              });
+}
+//-----------------------------------------------------------------------------
+/*! Adds the tangent and bi-tangent directions of the triangles of the vertex
+range vr to the temporary tangent arrays T1 and T2 of its vertices in
+[first, last). Like in accumulateNormals the result doesn't depend on the
+NO. of ranges.
+*/
+template<typename INDEX>
+static void accumulateTangents(const SLVVec3f&        P,
+                               const SLVVec2f&        Tc,
+                               const vector<INDEX>&   I,
+                               const vector<SLVuint>& buckets,
+                               SLuint                 numRanges,
+                               SLVVec3f&              T1,
+                               SLVVec3f&              T2,
+                               SLuint                 vr,
+                               SLuint                 first,
+                               SLuint                 last)
+{
+    SLuint numV = last - first;
+
+    forRangeTriangles(I, buckets, numRanges, vr, [&](SLuint i) {
+        // Get the 3 vertex indices
+        SLuint iVA = I[i];
+        SLuint iVB = I[i + 1];
+        SLuint iVC = I[i + 2];
+
+        // Only add to the vertices in the range (unsigned wrap around)
+        SLbool inA = iVA - first < numV;
+        SLbool inB = iVB - first < numV;
+        SLbool inC = iVC - first < numV;
+
+        float x1 = P[iVB].x - P[iVA].x;
+        float x2 = P[iVC].x - P[iVA].x;
+        float y1 = P[iVB].y - P[iVA].y;
+        float y2 = P[iVC].y - P[iVA].y;
+        float z1 = P[iVB].z - P[iVA].z;
+        float z2 = P[iVC].z - P[iVA].z;
+
+        float s1 = Tc[iVB].x - Tc[iVA].x;
+        float s2 = Tc[iVC].x - Tc[iVA].x;
+        float t1 = Tc[iVB].y - Tc[iVA].y;
+        float t2 = Tc[iVC].y - Tc[iVA].y;
+
+        float   r = 1.0F / (s1 * t2 - s2 * t1);
+        SLVec3f sdir((t2 * x1 - t1 * x2) * r,
+                     (t2 * y1 - t1 * y2) * r,
+                     (t2 * z1 - t1 * z2) * r);
+        SLVec3f tdir((s1 * x2 - s2 * x1) * r,
+                     (s1 * y2 - s2 * y1) * r,
+                     (s1 * z2 - s2 * z1) * r);
+
+        if (inA) T1[iVA] += sdir;
+        if (inB) T1[iVB] += sdir;
+        if (inC) T1[iVC] += sdir;
+
+        if (inA) T2[iVA] += tdir;
+        if (inB) T2[iVB] += tdir;
+        if (inC) T2[iVC] += tdir;
+    });
 }
 //-----------------------------------------------------------------------------
 //! SLMesh::calcTangents computes the tangents per vertex for triangle meshes.
 /*! SLMesh::calcTangents computes the tangent and bi-tangent per vertex used 
 for GLSL normal map bump mapping. The code and mathematical derivation is in 
 detail explained in: http://www.terathon.com/code/tangent.html
+Large meshes are processed in parallel vertex ranges like in calcNormals.
 */
 void SLMesh::calcTangents()
 {
@@ -878,77 +1181,46 @@ void SLMesh::calcTangents()
             return;
 
         // allocate tangents
-        T.resize(P.size());
+        SLuint numV = (SLuint)P.size();
+        T.resize(numV);
 
         // allocate temp arrays for tangents
-        SLVVec3f T1;
-        T1.resize(P.size());
-        fill(T1.begin(), T1.end(), SLVec3f::ZERO);
-        SLVVec3f T2;
-        T2.resize(P.size());
-        fill(T2.begin(), T2.end(), SLVec3f::ZERO);
-
-        SLuint iVA, iVB, iVC;
-        SLuint numT = numI() / 3; //NO. of triangles
+        SLVVec3f T1(numV);
+        SLVVec3f T2(numV);
 
-        for (SLuint t = 0; t < numT; ++t)
+        SLuint          numRanges = numVertexRanges(numV, 1);
+        vector<SLVuint> buckets;
+        if (numRanges > 1)
         {
-            SLuint i = t * 3; // vertex index
-
-            // Get the 3 vertex indices
             if (I16.size())
-            {
-                iVA = I16[i];
-                iVB = I16[i + 1];
-                iVC = I16[i + 2];
-            }
+                bucketTriangles(I16, numV, numRanges, buckets);
             else
-            {
-                iVA = I32[i];
-                iVB = I32[i + 1];
-                iVC = I32[i + 2];
-            }
-
-            float x1 = P[iVB].x - P[iVA].x;
-            float x2 = P[iVC].x - P[iVA].x;
-            float y1 = P[iVB].y - P[iVA].y;
-            float y2 = P[iVC].y - P[iVA].y;
-            float z1 = P[iVB].z - P[iVA].z;
-            float z2 = P[iVC].z - P[iVA].z;
-
-            float s1 = Tc[iVB].x - Tc[iVA].x;
-            float s2 = Tc[iVC].x - Tc[iVA].x;
-            float t1 = Tc[iVB].y - Tc[iVA].y;
-            float t2 = Tc[iVC].y - Tc[iVA].y;
-
-            float   r = 1.0F / (s1 * t2 - s2 * t1);
-            SLVec3f sdir((t2 * x1 - t1 * x2) * r,
-                         (t2 * y1 - t1 * y2) * r,
-                         (t2 * z1 - t1 * z2) * r);
-            SLVec3f tdir((s1 * x2 - s2 * x1) * r,
-                         (s1 * y2 - s2 * y1) * r,
-                         (s1 * z2 - s2 * z1) * r);
-
-            T1[iVA] += sdir;
-            T1[iVB] += sdir;
-            T1[iVC] += sdir;
-
-            T2[iVA] += tdir;
-            T2[iVB] += tdir;
-            T2[iVC] += tdir;
+                bucketTriangles(I32, numV, numRanges, buckets);
         }
 
-        for (SLuint i = 0; i < P.size(); ++i)
-        {
-            // Gram-Schmidt orthogonalization
-            T[i] = T1[i] - N[i] * N[i].dot(T1[i]);
-            T[i].normalize();
-
-            // Calculate temp. bitangent and store its handedness in T.w
-            SLVec3f bitangent;
-            bitangent.cross(N[i], T1[i]);
-            T[i].w = (bitangent.dot(T2[i]) < 0.0f) ? -1.0f : 1.0f;
-        }
+        forRanges(numV,
+                  numRanges,
+                  [&](SLuint r, SLuint first, SLuint last) {
+                      fill(T1.begin() + first, T1.begin() + last, SLVec3f::ZERO);
+                      fill(T2.begin() + first, T2.begin() + last, SLVec3f::ZERO);
+
+                      if (I16.size())
+                          accumulateTangents(P, Tc, I16, buckets, numRanges, T1, T2, r, first, last);
+                      else
+                          accumulateTangents(P, Tc, I32, buckets, numRanges, T1, T2, r, first, last);
+
+                      for (SLuint i = first; i < last; ++i)
+                      {
+                          // Gram-Schmidt orthogonalization
+                          T[i] = T1[i] - N[i] * N[i].dot(T1[i]);
+                          T[i].normalize();
+
+                          // Calculate temp. bitangent and store its handedness in T.w
+                          SLVec3f bitangent;
+                          bitangent.cross(N[i], T1[i]);
+                          T[i].w = (bitangent.dot(T2[i]) < 0.0f) ? -1.0f : 1.0f;
+                      }
+                  });
     }
 }
 //-----------------------------------------------------------------------------
@@ -1185,14 +1457,239 @@ void SLMesh::preShade(SLRay* ray)
     }
 }
 //-----------------------------------------------------------------------------
+/*! Generates the vertex array object once with the attribute locations of the
+passed shader program. It is called at the first draw or in advance by
+SLAssimpImporter::finishAsync to spread the upload over several frames.
+The VAO gets regenerated if SLMesh::packVertices has changed. Static triangle
+meshes get packed vertices if the program decodes them (see
+SLMesh::generatePackedVAO).
+*/
+void SLMesh::generateVAO(SLGLProgram* sp)
+{
+    if (_vao.id() && _vaoPackFlag == packVertices) return;
+
+    _vao.clearAttribs();
+    _vaoPackFlag = packVertices;
+    _vaoIsPacked = packVertices &&
+                   _primitive == PT_triangles &&
+                   !Ji.size() &&
+                   _stateGL->glVersionNOf() >= 3.0f &&
+                   sp->getUniformLocation("u_vertexPacked") >= 0;
+
+    if (_vaoIsPacked)
+    {
+        generatePackedVAO(sp);
+        return;
+    }
+
+    _vao.setAttrib(AT_position, sp->getAttribLocation("a_position"), _finalP);
+    if (N.size()) _vao.setAttrib(AT_normal, sp->getAttribLocation("a_normal"), _finalN);
+    if (Tc.size()) _vao.setAttrib(AT_texCoord, sp->getAttribLocation("a_texCoord"), &Tc);
+    if (C.size()) _vao.setAttrib(AT_color, sp->getAttribLocation("a_color"), &C);
+    if (T.size()) _vao.setAttrib(AT_tangent, sp->getAttribLocation("a_tangent"), &T);
+    if (I16.size()) _vao.setIndices(&I16);
+    if (I32.size()) _vao.setIndices(&I32);
+
+    _vao.generate((SLuint)P.size(), Ji.size() ? BU_stream : BU_static, !Ji.size());
+}
+//-----------------------------------------------------------------------------
+SLbool SLMesh::packVertices = false;
+//-----------------------------------------------------------------------------
+//! Converts a float into an IEEE 754 half float without denormals
+static SLushort floatToHalf(SLfloat f)
+{
+    SLuint bits;
+    memcpy(&bits, &f, sizeof(bits));
+
+    SLuint sign     = (bits >> 16) & 0x8000;
+    SLint  exponent = (SLint)((bits >> 23) & 0xFF) - 127 + 15;
+    SLuint mantissa = bits & 0x007FFFFF;
+
+    if (exponent <= 0) return (SLushort)sign;           // underflow to zero
+    if (exponent >= 31) return (SLushort)(sign | 0x7C00); // overflow to infinity
+
+    // Round to nearest. A carry into the exponent is still correct.
+    SLuint half = sign | ((SLuint)exponent << 10) | (mantissa >> 13);
+    half += (mantissa >> 12) & 1;
+    return (SLushort)half;
+}
+//-----------------------------------------------------------------------------
+//! Encodes a unit vector into two snorm16 with the octahedron mapping
+static void octEncode(const SLVec3f& v, SLshort* e)
+{
+    SLfloat l = fabs(v.x) + fabs(v.y) + fabs(v.z);
+    SLfloat x = l > 0.0f ? v.x / l : 0.0f;
+    SLfloat y = l > 0.0f ? v.y / l : 0.0f;
+
+    // Fold the lower hemisphere over the diagonals
+    if (v.z < 0.0f)
+    {
+        SLfloat ox = x;
+        x          = (1.0f - fabs(y)) * (ox >= 0.0f ? 1.0f : -1.0f);
+        y          = (1.0f - fabs(ox)) * (y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    e[0] = (SLshort)lround(SL_clamp(x, -1.0f, 1.0f) * 32767.0f);
+    e[1] = (SLshort)lround(SL_clamp(y, -1.0f, 1.0f) * 32767.0f);
+}
+//-----------------------------------------------------------------------------
+/*! Generates the vertex array object with all attributes packed into one
+interleaved buffer:
+\n - Positions: 4 snorm16 relative to the AABB. The scale and offset are
+passed as the uniforms u_posScale and u_posOffset at the draw call.
+\n - Normals: 2 snorm16 octahedron encoded
+\n - Texture coordinates: 2 half floats
+\n - Colors: 4 unorm8
+\n - Tangents: 2 snorm16 octahedron encoded with the sign of the bitangent
+in the sign of the second component.
+\n A vertex with all attributes takes 24 instead of 64 bytes. The buffer is
+only needed until it is uploaded. The vertex shaders decode the attributes
+(see SLGLShader::addPackedVertexDecoding).
+*/
+void SLMesh::generatePackedVAO(SLGLProgram* sp)
+{
+    SLuint numV = (SLuint)P.size();
+
+    // Offsets of the attributes in the interleaved vertex
+    SLuint offsetN  = 4 * sizeof(SLshort);
+    SLuint offsetTc = offsetN + (N.size() ? 2 * sizeof(SLshort) : 0);
+    SLuint offsetC  = offsetTc + (Tc.size() ? 2 * sizeof(SLushort) : 0);
+    SLuint offsetT  = offsetC + (C.size() ? 4 * sizeof(SLuchar) : 0);
+    SLuint stride   = offsetT + (T.size() ? 2 * sizeof(SLshort) : 0);
+
+    // Positions get quantized relative to the AABB of the mesh
+    SLVec3f minV(FLT_MAX, FLT_MAX, FLT_MAX);
+    SLVec3f maxV(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (auto& p : P)
+    {
+        minV.setMin(p);
+        maxV.setMax(p);
+    }
+    SLVec3f halfExt = (maxV - minV) * 0.5f;
+    _packOffset     = (minV + maxV) * 0.5f;
+    _packScale      = halfExt / 32767.0f;
+
+    // A flat axis (e.g. a plane) has no extent: all its positions map to 0
+    SLVec3f toShort(halfExt.x > 0.0f ? 32767.0f / halfExt.x : 0.0f,
+                    halfExt.y > 0.0f ? 32767.0f / halfExt.y : 0.0f,
+                    halfExt.z > 0.0f ? 32767.0f / halfExt.z : 0.0f);
+
+    SLVuchar packed(numV * stride);
+
+    for (SLuint i = 0; i < numV; ++i)
+    {
+        SLuchar* v = &packed[i * stride];
+
+        SLVec3f d      = P[i] - _packOffset;
+        SLVec3f q(d.x * toShort.x, d.y * toShort.y, d.z * toShort.z);
+        SLshort pos[4] = {(SLshort)lround(SL_clamp(q.x, -32767.0f, 32767.0f)),
+                          (SLshort)lround(SL_clamp(q.y, -32767.0f, 32767.0f)),
+                          (SLshort)lround(SL_clamp(q.z, -32767.0f, 32767.0f)),
+                          32767};
+        memcpy(v, pos, sizeof(pos));
+
+        if (N.size())
+        {
+            SLshort n[2];
+            octEncode(N[i], n);
+            memcpy(v + offsetN, n, sizeof(n));
+        }
+        if (Tc.size())
+        {
+            SLushort tc[2] = {floatToHalf(Tc[i].x), floatToHalf(Tc[i].y)};
+            memcpy(v + offsetTc, tc, sizeof(tc));
+        }
+        if (C.size())
+        {
+            v[offsetC + 0] = (SLuchar)lround(SL_clamp(C[i].r, 0.0f, 1.0f) * 255.0f);
+            v[offsetC + 1] = (SLuchar)lround(SL_clamp(C[i].g, 0.0f, 1.0f) * 255.0f);
+            v[offsetC + 2] = (SLuchar)lround(SL_clamp(C[i].b, 0.0f, 1.0f) * 255.0f);
+            v[offsetC + 3] = (SLuchar)lround(SL_clamp(C[i].a, 0.0f, 1.0f) * 255.0f);
+        }
+        if (T.size())
+        {
+            // The second component is stored in [0,1] with the bitangent sign
+            SLshort t[2];
+            octEncode(SLVec3f(T[i].x, T[i].y, T[i].z), t);
+            SLint y = std::max(1, (SLint)lround((t[1] / 32767.0f * 0.5f + 0.5f) * 32767.0f));
+            t[1]    = (SLshort)(T[i].w < 0.0f ? -y : y);
+            memcpy(v + offsetT, t, sizeof(t));
+        }
+    }
+
+    // All attributes point to the same data, so the input is interleaved
+    void* data = &packed[0];
+    _vao.setAttrib(AT_position, 4, sp->getAttribLocation("a_position"), data, BT_short);
+    if (N.size()) _vao.setAttrib(AT_normal, 2, sp->getAttribLocation("a_normal"), data, BT_short);
+    if (Tc.size()) _vao.setAttrib(AT_texCoord, 2, sp->getAttribLocation("a_texCoord"), data, BT_half);
+    if (C.size()) _vao.setAttrib(AT_color, 4, sp->getAttribLocation("a_color"), data, BT_ubyte, true);
+    if (T.size()) _vao.setAttrib(AT_tangent, 2, sp->getAttribLocation("a_tangent"), data, BT_short);
+    if (I16.size()) _vao.setIndices(&I16);
+    if (I32.size()) _vao.setIndices(&I32);
+
+    _vao.generate(numV, BU_static);
+}
+//-----------------------------------------------------------------------------
+/*! Generates the vertex array object for the GPU skinning of nodes with an
+SLSkeletonInstance. It holds the unskinned positions and normals and up to
+four joint indices and weights per vertex. The VAO is static because the
+skinning is done in the vertex shader with the joint matrices of each
+instance, so all instances share the same vertex data.
+*/
+void SLMesh::generateSkinVAO(SLGLProgram* sp)
+{
+    _jointIdsGPU.resize(P.size());
+    _jointWeightsGPU.resize(P.size());
+
+    for (SLuint i = 0; i < P.size(); ++i)
+    {
+        SLfloat ids[4]     = {0.0f, 0.0f, 0.0f, 0.0f};
+        SLfloat weights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+        for (SLuint j = 0; j < Ji[i].size() && j < 4; ++j)
+        {
+            ids[j]     = (SLfloat)Ji[i][j];
+            weights[j] = Jw[i][j];
+        }
+
+        _jointIdsGPU[i].set(ids);
+        _jointWeightsGPU[i].set(weights);
+    }
+
+    _vaoSkin.setAttrib(AT_position, sp->getAttribLocation("a_position"), &P);
+    if (N.size()) _vaoSkin.setAttrib(AT_normal, sp->getAttribLocation("a_normal"), &N);
+    if (Tc.size()) _vaoSkin.setAttrib(AT_texCoord, sp->getAttribLocation("a_texCoord"), &Tc);
+    _vaoSkin.setAttrib(AT_jointIndex, sp->getAttribLocation("a_jointIds"), &_jointIdsGPU);
+    _vaoSkin.setAttrib(AT_jointWeight, sp->getAttribLocation("a_jointWeights"), &_jointWeightsGPU);
+    if (I16.size()) _vaoSkin.setIndices(&I16);
+    if (I32.size()) _vaoSkin.setIndices(&I32);
+
+    _vaoSkin.generate((SLuint)P.size());
+}
+//-----------------------------------------------------------------------------
 //! Transforms the vertex positions and normals with by joint weights
 /*! If the mesh is used for skinned skeleton animation this method transforms
 each vertex and normal by max. four joints of the skeleton. Each joint has
 a weight and an index. After the transform the VBO have to be updated.
 This skinning process can also be done (a lot faster) on the GPU.
-This software skinning is also needed for ray or path tracing.  
+This software skinning is also needed for ray or path tracing.
+This method does all steps of the skinning on the calling thread. The
+SLAnimManager::skinMeshes does the same for many meshes in parallel.
 */
 void SLMesh::transformSkin()
+{
+    _skeleton->updateJointMatrices();
+    skinVertices();
+    updateSkin();
+}
+//-----------------------------------------------------------------------------
+/*! Transforms all vertices and normals by the joint matrices of the skeleton
+into the skinnedP and skinnedN vectors. The joint matrices must be up to date
+(see SLSkeleton::updateJointMatrices). This method only writes into the
+buffers of this mesh and can therefore be called for different meshes on
+multiple threads.
+*/
+void SLMesh::skinVertices()
 {
     // create the secondary buffers for P and N once
     if (!skinnedP.size())
@@ -1208,17 +1705,7 @@ void SLMesh::transformSkin()
             skinnedN[i] = N[i];
     }
 
-    // Create array for joint matrices once
-    if (!_jointMatrices.size())
-    {
-        _jointMatrices.clear();
-        _jointMatrices.resize((SLuint)_skeleton->numJoints());
-    }
-
-    // update the joint matrix array
-    _skeleton->getJointMatrices(_jointMatrices);
-
-    notifyParentNodesAABBUpdate();
+    const SLVMat4f& jointMatrices = _skeleton->jointMatrices();
 
     // temporarily set finalP and finalN
     _finalP = &skinnedP;
@@ -1236,7 +1723,7 @@ void SLMesh::transformSkin()
         // accumulate final normal and positions
         for (SLuint j = 0; j < Ji[i].size(); ++j)
         {
-            const SLMat4f& jm      = _jointMatrices[Ji[i][j]];
+            const SLMat4f& jm      = jointMatrices[Ji[i][j]];
             SLVec4f        tempPos = jm * P[i];
             skinnedP[i].x += tempPos.x * Jw[i][j];
             skinnedP[i].y += tempPos.y * Jw[i][j];
@@ -1253,6 +1740,15 @@ void SLMesh::transformSkin()
             }
         }
     }
+}
+//-----------------------------------------------------------------------------
+/*! Finishes the skinning after skinVertices on the main thread: The AABBs of
+the parent nodes are flagged for an update and the skinned positions and
+normals are uploaded to the VBOs.
+*/
+void SLMesh::updateSkin()
+{
+    notifyParentNodesAABBUpdate();
 
     // update or create buffers
     if (_vao.id())
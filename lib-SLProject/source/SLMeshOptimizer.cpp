@@ -0,0 +1,444 @@
+//#############################################################################
+//  File:      SLMeshOptimizer.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+#include <SLMesh.h>
+#include <SLMeshOptimizer.h>
+
+//-----------------------------------------------------------------------------
+SLbool  SLMeshOptimizer::isOn              = false;
+SLuint  SLMeshOptimizer::cacheSizeFIFO     = 16;
+SLfloat SLMeshOptimizer::overdrawThreshold = 1.05f;
+//-----------------------------------------------------------------------------
+//! Size of the LRU cache that the vertex scores of Forsyth's algorithm model
+static const SLuint forsythCacheSize = 32;
+//-----------------------------------------------------------------------------
+//! Simulation of a FIFO post-transform vertex cache
+/*! A vertex is in the cache if less than cacheSize other vertices were added
+after it. Every vertex stores the time stamp of its addition, so no queue is
+needed. The cache is flushed by jumping over cacheSize time stamps.
+*/
+class SLVertexCacheFIFO
+{
+    public:
+    SLVertexCacheFIFO(SLuint numVertices, SLuint cacheSize)
+      : _stamps(numVertices, 0),
+        _cacheSize(cacheSize),
+        _time(cacheSize + 1)
+    {
+    }
+
+    //! Adds the vertex if it is not in the cache and returns 1 for a miss
+    SLuint miss(SLuint vertex)
+    {
+        if (_time - _stamps[vertex] > _cacheSize)
+        {
+            _stamps[vertex] = _time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    void flush() { _time += _cacheSize + 1; }
+
+    private:
+    SLVuint _stamps;    //!< time stamp of the last addition per vertex
+    SLuint  _cacheSize; //!< NO. of vertices in the cache
+    SLuint  _time;      //!< time stamp for the next addition
+};
+//-----------------------------------------------------------------------------
+//! Moves the per vertex attributes to their new index and drops unused ones
+template<typename T>
+static void remapVertices(vector<T>& attrib, const SLVuint& remap, SLuint numNew)
+{
+    if (attrib.size() != remap.size())
+        return;
+
+    vector<T> remapped(numNew);
+    for (SLuint v = 0; v < attrib.size(); ++v)
+        if (remap[v] != UINT_MAX)
+            remapped[remap[v]] = std::move(attrib[v]);
+
+    attrib.swap(remapped);
+}
+//-----------------------------------------------------------------------------
+/*! Optimizes the triangle and vertex order of a triangle mesh for the vertex
+cache, overdraw and vertex fetch and stores the indices in I16 if the NO. of
+vertices allows it. The ACMR before and after the optimization can be
+returned. Meshes with other primitives or without indices are not changed.
+The mesh must not be initialized yet.
+*/
+void SLMeshOptimizer::optimize(SLMesh*  mesh,
+                               SLfloat* acmrBefore,
+                               SLfloat* acmrAfter)
+{
+    if (!mesh || mesh->primitive() != PT_triangles)
+        return;
+    if (mesh->I16.empty() && mesh->I32.empty())
+        return;
+
+    SLuint  numV = (SLuint)mesh->P.size();
+    SLVuint I    = mesh->I16.size()
+                  ? SLVuint(mesh->I16.begin(), mesh->I16.end())
+                  : mesh->I32;
+
+    if (acmrBefore)
+        *acmrBefore = calcACMR(I, numV, cacheSizeFIFO);
+
+    optimizeVertexCache(I, numV);
+    optimizeOverdraw(I, mesh->P, overdrawThreshold);
+
+    if (acmrAfter)
+        *acmrAfter = calcACMR(I, numV, cacheSizeFIFO);
+
+    // renumber the vertices in the order of their first use
+    SLVuint remap;
+    SLuint  numNewV = optimizeVertexFetch(I, numV, remap);
+
+    remapVertices(mesh->P, remap, numNewV);
+    remapVertices(mesh->N, remap, numNewV);
+    remapVertices(mesh->Tc, remap, numNewV);
+    remapVertices(mesh->C, remap, numNewV);
+    remapVertices(mesh->T, remap, numNewV);
+    remapVertices(mesh->Ji, remap, numNewV);
+    remapVertices(mesh->Jw, remap, numNewV);
+
+    // the skinning buffers and the selection get recreated
+    mesh->skinnedP.clear();
+    mesh->skinnedN.clear();
+    mesh->IS32.clear();
+
+    // use 16 bit indices whenever possible
+    if (numNewV < 65536)
+    {
+        mesh->I16.assign(I.begin(), I.end());
+        mesh->I32.clear();
+    }
+    else
+    {
+        mesh->I16.clear();
+        mesh->I32.swap(I);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Sorts the triangles for the post-transform vertex cache with the algorithm
+of Tom Forsyth: Linear-Speed Vertex Cache Optimisation (2006). Every vertex
+gets a score from its position in a modelled LRU cache and from the NO. of its
+remaining triangles. The next triangle is always the one with the highest sum
+of its vertex scores. Only the triangles of the cached vertices need to be
+scored again after each step.
+*/
+void SLMeshOptimizer::optimizeVertexCache(SLVuint& indices, SLuint numVertices)
+{
+    SLuint numT = (SLuint)indices.size() / 3;
+    if (numT < 2)
+        return;
+
+    // remaining triangles per vertex and the triangle lists in one array
+    SLVuint numTris(numVertices, 0);
+    for (SLuint i = 0; i < numT * 3; ++i)
+        numTris[indices[i]]++;
+
+    SLVuint offsets(numVertices + 1, 0);
+    for (SLuint v = 0; v < numVertices; ++v)
+        offsets[v + 1] = offsets[v] + numTris[v];
+
+    SLVuint adjTris(offsets[numVertices]);
+    SLVuint fillPos(offsets.begin(), offsets.end() - 1);
+    for (SLuint i = 0; i < numT * 3; ++i)
+        adjTris[fillPos[indices[i]]++] = i / 3;
+
+    // score tables for the cache position and the NO. of remaining triangles
+    const SLuint maxValence = 32;
+    SLfloat      cacheScores[forsythCacheSize];
+    SLfloat      valenceScores[maxValence + 1];
+
+    for (SLuint p = 0; p < forsythCacheSize; ++p)
+    {
+        if (p < 3) // the vertices of the last triangle get a fixed score
+            cacheScores[p] = 0.75f;
+        else
+            cacheScores[p] = pow(1.0f - (SLfloat)(p - 3) / (SLfloat)(forsythCacheSize - 3), 1.5f);
+    }
+
+    valenceScores[0] = 0.0f;
+    for (SLuint n = 1; n <= maxValence; ++n)
+        valenceScores[n] = 2.0f * pow((SLfloat)n, -0.5f);
+
+    auto vertexScore = [&](SLint cachePos, SLuint remaining) {
+        if (remaining == 0)
+            return -1.0f;
+        SLfloat score = cachePos >= 0 ? cacheScores[cachePos] : 0.0f;
+        if (remaining <= maxValence)
+            score += valenceScores[remaining];
+        else
+            score += 2.0f * pow((SLfloat)remaining, -0.5f);
+        return score;
+    };
+
+    vector<SLint>   cachePos(numVertices, -1);
+    vector<SLfloat> vertScores(numVertices);
+    for (SLuint v = 0; v < numVertices; ++v)
+        vertScores[v] = vertexScore(-1, numTris[v]);
+
+    // start with the best triangle of all
+    SLuint  bestTri   = 0;
+    SLfloat bestScore = -FLT_MAX;
+    for (SLuint t = 0; t < numT; ++t)
+    {
+        const SLuint* tv    = &indices[t * 3];
+        SLfloat       score = vertScores[tv[0]] + vertScores[tv[1]] + vertScores[tv[2]];
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestTri   = t;
+        }
+    }
+
+    SLVbool triAdded(numT, false);
+    SLVuint sorted(indices);
+    SLVuint cache, newCache;
+    cache.reserve(forsythCacheSize + 3);
+    newCache.reserve(forsythCacheSize + 3);
+    SLuint nextTri = 0; // next triangle in input order for dead ends
+
+    for (SLuint o = 0; o < numT; ++o)
+    {
+        // Without a scored triangle in the cache take the next unused one
+        if (bestTri == UINT_MAX)
+        {
+            while (triAdded[nextTri])
+                nextTri++;
+            bestTri = nextTri;
+        }
+
+        triAdded[bestTri]  = true;
+        const SLuint* tri  = &indices[bestTri * 3];
+        sorted[o * 3]     = tri[0];
+        sorted[o * 3 + 1] = tri[1];
+        sorted[o * 3 + 2] = tri[2];
+
+        // remove the triangle from its vertices and put them in front
+        newCache.clear();
+        for (SLuint c = 0; c < 3; ++c)
+        {
+            SLuint  v     = tri[c];
+            SLuint* first = &adjTris[offsets[v]];
+            SLuint* last  = first + numTris[v];
+            SLuint* found = std::find(first, last, bestTri);
+            if (found != last)
+            {
+                *found = *(last - 1);
+                numTris[v]--;
+            }
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+                newCache.push_back(v);
+        }
+
+        for (auto v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache.push_back(v);
+
+        // vertices behind the cache size drop out of the cache
+        for (SLuint p = 0; p < newCache.size(); ++p)
+        {
+            SLuint v      = newCache[p];
+            cachePos[v]   = p < forsythCacheSize ? (SLint)p : -1;
+            vertScores[v] = vertexScore(cachePos[v], numTris[v]);
+        }
+
+        // score the remaining triangles of all touched vertices
+        bestTri   = UINT_MAX;
+        bestScore = -FLT_MAX;
+        for (auto v : newCache)
+        {
+            for (SLuint a = offsets[v]; a < offsets[v] + numTris[v]; ++a)
+            {
+                SLuint        t     = adjTris[a];
+                const SLuint* tv    = &indices[t * 3];
+                SLfloat       score = vertScores[tv[0]] + vertScores[tv[1]] + vertScores[tv[2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTri   = t;
+                }
+            }
+        }
+
+        if (newCache.size() > forsythCacheSize)
+            newCache.resize(forsythCacheSize);
+        cache.swap(newCache);
+    }
+
+    indices.swap(sorted);
+}
+//-----------------------------------------------------------------------------
+/*! Reorders clusters of the vertex cache optimized triangles to reduce the
+overdraw (Sander, Nehab & Barczak: Fast Triangle Reordering for Vertex
+Locality and Reduced Overdraw, 2007). The triangle order is split into
+clusters where all vertices of a triangle miss the cache. These clusters get
+split further as soon as the ACMR of their first part is within threshold
+times the ACMR of the whole cluster. The clusters are then sorted by the dot
+product of their average normal with the vector from the mesh center to the
+cluster center. Clusters on the outside that face away from the center are
+drawn first and likely occlude the others.
+*/
+void SLMeshOptimizer::optimizeOverdraw(SLVuint&        indices,
+                                       const SLVVec3f& positions,
+                                       SLfloat         threshold)
+{
+    SLuint numT = (SLuint)indices.size() / 3;
+    SLuint numV = (SLuint)positions.size();
+    if (numT < 2)
+        return;
+
+    SLVertexCacheFIFO cache(numV, cacheSizeFIFO);
+
+    // hard boundaries where a triangle misses all its vertices
+    SLVuint hardClusters;
+    for (SLuint t = 0; t < numT; ++t)
+    {
+        SLuint misses = cache.miss(indices[t * 3]) +
+                        cache.miss(indices[t * 3 + 1]) +
+                        cache.miss(indices[t * 3 + 2]);
+        if (t == 0 || misses == 3)
+            hardClusters.push_back(t);
+    }
+    hardClusters.push_back(numT);
+
+    // soft boundaries where the cluster start is good enough
+    SLVuint clusters;
+    for (SLuint c = 0; c + 1 < hardClusters.size(); ++c)
+    {
+        SLuint first = hardClusters[c];
+        SLuint last  = hardClusters[c + 1];
+
+        cache.flush();
+        SLuint clusterMisses = 0;
+        for (SLuint i = first * 3; i < last * 3; ++i)
+            clusterMisses += cache.miss(indices[i]);
+        SLfloat maxACMR = threshold * (SLfloat)clusterMisses / (SLfloat)(last - first);
+
+        cache.flush();
+        clusters.push_back(first);
+        SLuint misses = 0, tris = 0;
+        for (SLuint t = first; t < last; ++t)
+        {
+            misses += cache.miss(indices[t * 3]) +
+                      cache.miss(indices[t * 3 + 1]) +
+                      cache.miss(indices[t * 3 + 2]);
+            tris++;
+
+            if (t + 1 < last && (SLfloat)misses <= maxACMR * (SLfloat)tris)
+            {
+                clusters.push_back(t + 1);
+                cache.flush();
+                misses = tris = 0;
+            }
+        }
+    }
+    clusters.push_back(numT);
+
+    SLuint numClusters = (SLuint)clusters.size() - 1;
+    if (numClusters < 2)
+        return;
+
+    // mesh center as the average of all vertices
+    SLVec3f meshCenter(0, 0, 0);
+    for (auto& p : positions)
+        meshCenter += p;
+    meshCenter /= (SLfloat)numV;
+
+    // sort key per cluster from the area weighted center and normal
+    SLVfloat sortKeys(numClusters);
+    for (SLuint c = 0; c < numClusters; ++c)
+    {
+        SLVec3f center(0, 0, 0), normal(0, 0, 0);
+        SLfloat area = 0.0f;
+
+        for (SLuint t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const SLVec3f& p0 = positions[indices[t * 3]];
+            const SLVec3f& p1 = positions[indices[t * 3 + 1]];
+            const SLVec3f& p2 = positions[indices[t * 3 + 2]];
+            SLVec3f        n  = (p1 - p0) ^ (p2 - p0);
+            SLfloat        a  = n.length();
+
+            center += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+
+        if (area > 0.0f)
+            center /= area;
+        normal.normalize();
+        sortKeys[c] = (center - meshCenter).dot(normal);
+    }
+
+    SLVuint order(numClusters);
+    for (SLuint c = 0; c < numClusters; ++c)
+        order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&](SLuint a, SLuint b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    SLVuint sorted;
+    sorted.reserve(indices.size());
+    for (auto c : order)
+        sorted.insert(sorted.end(),
+                      indices.begin() + clusters[c] * 3,
+                      indices.begin() + clusters[c + 1] * 3);
+    indices.swap(sorted);
+}
+//-----------------------------------------------------------------------------
+/*! Renumbers the vertices in the order of their first use in the indices and
+returns the new NO. of vertices. The remap vector holds the new index per old
+vertex or UINT_MAX for unused vertices.
+*/
+SLuint SLMeshOptimizer::optimizeVertexFetch(SLVuint& indices,
+                                            SLuint   numVertices,
+                                            SLVuint& remap)
+{
+    remap.assign(numVertices, UINT_MAX);
+    SLuint numNew = 0;
+
+    for (auto& i : indices)
+    {
+        if (remap[i] == UINT_MAX)
+            remap[i] = numNew++;
+        i = remap[i];
+    }
+    return numNew;
+}
+//-----------------------------------------------------------------------------
+/*! Returns the average cache miss ratio: The NO. of vertex cache misses per
+triangle with a FIFO cache of cacheSize vertices. The value is between 0.5
+(regular grids) and 3 (no vertex reuse).
+*/
+SLfloat SLMeshOptimizer::calcACMR(const SLVuint& indices,
+                                  SLuint         numVertices,
+                                  SLuint         cacheSize)
+{
+    SLuint numT = (SLuint)indices.size() / 3;
+    if (numT == 0)
+        return 0.0f;
+
+    SLVertexCacheFIFO cache(numVertices, cacheSize);
+    SLuint            misses = 0;
+    for (SLuint i = 0; i < numT * 3; ++i)
+        misses += cache.miss(indices[i]);
+
+    return (SLfloat)misses / (SLfloat)numT;
+}
+//-----------------------------------------------------------------------------
@@ -21,10 +21,12 @@
 #include <SLLightSpot.h>
 #include <SLNode.h>
 #include <SLSceneView.h>
+#include <SLSkeleton.h>
+#include <SLSkeletonInstance.h>
 
 //-----------------------------------------------------------------------------
 // Static update counter
-SLuint SLNode::numWMUpdates = 0;
+atomic<SLuint> SLNode::numWMUpdates(0);
 //-----------------------------------------------------------------------------
 /*! 
 Default constructor just setting the name. 
@@ -39,10 +41,11 @@ SLNode::SLNode(SLstring name) : SLObject(name)
     _wmI.identity();
     _wmN.identity();
     _drawBits.allOff();
-    _animation      = nullptr;
-    _isWMUpToDate   = false;
-    _isAABBUpToDate = false;
-    _tracker        = nullptr;
+    _animation        = nullptr;
+    _isWMUpToDate     = false;
+    _isAABBUpToDate   = false;
+    _tracker          = nullptr;
+    _skeletonInstance = nullptr;
 }
 //-----------------------------------------------------------------------------
 /*! 
@@ -58,10 +61,11 @@ SLNode::SLNode(SLMesh* mesh, SLstring name) : SLObject(name)
     _wmI.identity();
     _wmN.identity();
     _drawBits.allOff();
-    _animation      = nullptr;
-    _isWMUpToDate   = false;
-    _isAABBUpToDate = false;
-    _tracker        = nullptr;
+    _animation        = nullptr;
+    _isWMUpToDate     = false;
+    _isAABBUpToDate   = false;
+    _tracker          = nullptr;
+    _skeletonInstance = nullptr;
 
     addMesh(mesh);
 }
@@ -451,8 +455,38 @@ void SLNode::cull3DRec(SLSceneView* sv)
         // Add all nodes to the opaque list
         // A node that has alpha meshes still can have opaque meshes
         sv->visibleNodes()->push_back(this);
+
+        // Report the visibility of animated skeletons for the animation LOD
+        if (_skeletonInstance || skeleton())
+            reportAnimLOD(sv);
     }
-} //-----------------------------------------------------------------------------
+}
+//-----------------------------------------------------------------------------
+/*! Reports the projected size in pixels of the nodes AABB to the animation
+LOD (SLAnimLOD) of the skeleton instance or of the skeletons of the meshes.
+Skeletons of culled nodes get no report and skip their pose evaluation.
+*/
+void SLNode::reportAnimLOD(SLSceneView* sv)
+{
+    SLCamera* cam    = sv->camera();
+    SLfloat   dist   = (_aabb.centerWS() - cam->translationWS()).length();
+    SLfloat   sizePX = (SLfloat)sv->scrH();
+
+    if (dist > _aabb.radiusWS())
+        sizePX = _aabb.radiusWS() / (dist * tan(cam->fov() * 0.5f * SL_DEG2RAD)) *
+                 (SLfloat)sv->scrH();
+
+    if (_skeletonInstance)
+        _skeletonInstance->lod().visible(sizePX);
+
+    // Instances with too many joints for the GPU draw the skinned mesh data
+    for (auto mesh : _meshes)
+        if (mesh->skeleton() &&
+            (!_skeletonInstance ||
+             mesh->skeleton()->joints().size() > SLSkeletonInstance::maxJointsGPU()))
+            mesh->skeleton()->lod().visible(sizePX);
+}
+//-----------------------------------------------------------------------------
 /*!
 Adds all 2D Nodes to the visible nodes vector
 */
@@ -623,6 +657,8 @@ SLNode* SLNode::copyRec()
     else
         copy->_animation = nullptr;
 
+    copy->_skeletonInstance = _skeletonInstance;
+
     for (auto mesh : _meshes)
         copy->addMesh(mesh);
     for (auto child : _children)
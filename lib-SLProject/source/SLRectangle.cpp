@@ -14,6 +14,7 @@
 #    include <debug_new.h> // memory leak detector
 #endif
 
+#include <SLMeshOptimizer.h>
 #include <SLRectangle.h>
 
 //-----------------------------------------------------------------------------
@@ -168,5 +169,9 @@ void SLRectangle::buildMesh(SLMaterial* material)
             v++;
         }
     }
+
+    // reorder triangles & vertices for the GPU caches
+    if (SLMeshOptimizer::isOn)
+        SLMeshOptimizer::optimize(this);
 }
 //-----------------------------------------------------------------------------
@@ -14,6 +14,7 @@
 #    include <debug_new.h> // memory leak detector
 #endif
 
+#include <SLMeshOptimizer.h>
 #include <SLRevolver.h>
 
 //-----------------------------------------------------------------------------
@@ -216,5 +217,9 @@ void SLRevolver::buildMesh(SLMaterial* material)
         N[iV1].normalize();
         N[iV2] = N[iV1];
     }
+
+    // reorder triangles & vertices for the GPU caches
+    if (SLMeshOptimizer::isOn)
+        SLMeshOptimizer::optimize(this);
 }
 //-----------------------------------------------------------------------------
@@ -22,10 +22,14 @@
 #include <SLDeviceLocation.h>
 #include <SLInputManager.h>
 #include <SLLightDirect.h>
+#include <SLProfiler.h>
 #include <SLScene.h>
 #include <SLSceneView.h>
 #include <SLText.h>
 
+//-----------------------------------------------------------------------------
+//! Resource staging of the current thread (nullptr on the render thread)
+thread_local SLSceneStaging* SLScene::_staging = nullptr;
 //-----------------------------------------------------------------------------
 /*! The constructor of the scene does all one time initialization such as 
 loading the standard shader programs from which the pointers are stored in
@@ -62,6 +66,7 @@ SLScene::SLScene(SLstring      name,
                  cbOnSceneLoad onSceneLoadCallback)
   : SLObject(name),
     _updateTimesMS(60, 0.0f),
+    _skinTimesMS(60, 0.0f),
     _trackingTimesMS(60, 0.0f),
     _detectTimesMS(60, 0.0f),
     _detect1TimesMS(60, 0.0f),
@@ -109,6 +114,8 @@ SLScene::SLScene(SLstring      name,
     p = new SLGLGenericProgram("FontTex.vert", "FontTex.frag");
     p = new SLGLGenericProgram("StereoOculus.vert", "StereoOculus.frag");
     p = new SLGLGenericProgram("StereoOculusDistortionMesh.vert", "StereoOculusDistortionMesh.frag");
+    p = new SLGLGenericProgram("PerVrtBlinnSkinned.vert", "PerVrtBlinn.frag");
+    p = new SLGLGenericProgram("PerVrtBlinnTexSkinned.vert", "PerVrtBlinnTex.frag");
 
     _numProgsPreload = (SLint)_programs.size();
 
@@ -167,6 +174,9 @@ SLScene::~SLScene()
     // delete fonts
     SLTexFont::deleteFonts();
 
+    // delete the timer queries of the profiler
+    SLProfiler::deleteGPUQueries();
+
     // release the capture device
     SLCVCapture::release();
 
@@ -190,6 +200,7 @@ void SLScene::init()
     _timer.start();
     _frameTimesMS.init(60, 0.0f);
     _updateTimesMS.init(60, 0.0f);
+    _skinTimesMS.init(60, 0.0f);
     _cullTimesMS.init(60, 0.0f);
     _draw3DTimesMS.init(60, 0.0f);
     _draw2DTimesMS.init(60, 0.0f);
@@ -224,6 +235,11 @@ destructed at process end.
 */
 void SLScene::unInit()
 {
+    // abort running asynchronous imports before their resources get deleted
+    for (auto importer : _asyncImporters)
+        delete importer;
+    _asyncImporters.clear();
+
     _selectedMesh = nullptr;
     _selectedNode = nullptr;
 
@@ -291,6 +307,9 @@ void SLScene::unInit()
     _eventHandlers.clear();
 
     _animManager.clear();
+
+    // the textures removed their streaming jobs when they got deleted
+    _textureStreamer.clear();
 }
 //-----------------------------------------------------------------------------
 //! Processes all queued events and updates animations, AR trackers and AABBs
@@ -298,6 +317,7 @@ void SLScene::unInit()
 \n
 \n 1) Calculate frame time
 \n 2) Process queued events
+\n 2b) Finish asynchronous imports & upload streamed textures
 \n 3) Update all animations
 \n 4) Augmented Reality (AR) Tracking with the live camera
 \n 5) Update AABBs
@@ -324,11 +344,15 @@ bool SLScene::onUpdate()
     // 1) Calculate frame time //
     /////////////////////////////
 
-    // Calculate the elapsed time for the animation
-    // todo: If slowdown on idle is enabled the delta time will be wrong!
-    _elapsedTimeMS    = timeMilliSec() - _lastUpdateTimeMS;
+    // Calculate the elapsed time for the animation. After waiting on idle
+    // the frame scheduler limits it to one frame period.
+    _elapsedTimeMS    = _frameScheduler.beginFrame();
     _lastUpdateTimeMS = timeMilliSec();
 
+    // Close the profiled frame and read back the finished GPU timers
+    SLProfiler::beginFrame();
+    SL_PROFILE_SCOPE("Update");
+
     // Sum up all timings of all sceneviews
     SLfloat sumCullTimeMS   = 0.0f;
     SLfloat sumDraw3DTimeMS = 0.0f;
@@ -365,6 +389,31 @@ bool SLScene::onUpdate()
 
     // Process queued up system events and poll custom input devices
     SLbool sceneHasChanged = SLApplication::inputManager.pollAndProcessEvents();
+    if (sceneHasChanged) _frameScheduler.markDirty(DS_input);
+
+    // Move the resources of finished imports into the scene and create their
+    // OpenGL objects within a time budget per frame. The index loop allows
+    // the load callbacks to start new asynchronous imports.
+    for (SLuint i = 0; i < _asyncImporters.size();)
+    {
+        SLAssimpImporter* importer = _asyncImporters[i];
+        sceneHasChanged            = true;
+        if (importer->finishAsync(SLAssimpImporter::uploadBudgetMS))
+        {
+            delete importer;
+            _asyncImporters.erase(_asyncImporters.begin() + i);
+        }
+        else
+            i++;
+    }
+
+    // Upload the mip levels of the streamed textures within the frame budget
+    SLbool uploaded = _textureStreamer.update();
+    sceneHasChanged |= uploaded;
+
+    // Keep on rendering while imports or texture decodings are pending
+    if (uploaded || !_asyncImporters.empty() || _textureStreamer.numJobs() > 0)
+        _frameScheduler.markDirty(DS_loading);
 
     //////////////////////////////
     // 3) Update all animations //
@@ -374,21 +423,20 @@ bool SLScene::onUpdate()
     for (auto skeleton : _animManager.skeletons())
         skeleton->changed(false);
 
-    sceneHasChanged |= !_stopAnimations && _animManager.update(elapsedTimeSec());
+    SLbool animated = !_stopAnimations && _animManager.update(elapsedTimeSec());
 
-    // Do software skinning on all changed skeletons
-    for (auto mesh : _meshes)
-    {
-        if (mesh->skeleton() && mesh->skeleton()->changed())
-        {
-            mesh->transformSkin();
-            sceneHasChanged = true;
-        }
+    // Do software skinning on all changed skeletons in parallel
+    SLfloat startSkinMS = timeMilliSec();
+    animated |= _animManager.skinMeshes(_meshes);
+    _skinTimesMS.set(timeMilliSec() - startSkinMS);
+
+    if (animated) _frameScheduler.markDirty(DS_animation);
+    sceneHasChanged |= animated;
 
-        // update any out of date acceleration structure for RT or if they're being rendered.
-        if (renderTypeIsRT || voxelsAreShown)
+    // update any out of date acceleration structure for RT or if they're being rendered.
+    if (renderTypeIsRT || voxelsAreShown)
+        for (auto mesh : _meshes)
             mesh->updateAccelStruct();
-    }
 
     ////////////////////
     // 4) AR Tracking //
@@ -396,6 +444,8 @@ bool SLScene::onUpdate()
 
     if (_videoType != VT_NONE && !SLCVCapture::lastFrame.empty())
     {
+        SL_PROFILE_SCOPE("Tracking");
+
         SLfloat          trackingTimeStartMS = timeMilliSec();
         SLCVCalibration* ac                  = SLApplication::activeCalib;
 
@@ -460,11 +510,12 @@ bool SLScene::onUpdate()
 
             // track all trackers in the first sceneview
             for (auto tracker : _trackers)
-                tracker->track(SLCVCapture::lastFrameGray,
-                               SLCVCapture::lastFrame,
-                               ac,
-                               _showDetection,
-                               _sceneViews[0]);
+                if (tracker->track(SLCVCapture::lastFrameGray,
+                                   SLCVCapture::lastFrame,
+                                   ac,
+                                   _showDetection,
+                                   _sceneViews[0]))
+                    _frameScheduler.markDirty(DS_tracking);
 
             // Update info text only for chessboard scene
             if (SLApplication::sceneID == SID_VideoCalibrateMain ||
@@ -486,7 +537,7 @@ bool SLScene::onUpdate()
         //copy image to video texture
         if (ac->state() == CS_calibrated && ac->showUndistorted())
         {
-            SLCVMat undistorted;
+            SLCVMat& undistorted = SLCVCapture::lastFrameUndistorted;
             ac->remap(SLCVCapture::lastFrame, undistorted);
 
             _videoTexture.copyVideoImage(undistorted.cols,
@@ -506,6 +557,7 @@ bool SLScene::onUpdate()
                                          true);
         }
 
+        _frameScheduler.markDirty(DS_video);
         _trackingTimesMS.set(timeMilliSec() - trackingTimeStartMS);
     }
 
@@ -698,6 +750,21 @@ void SLScene::onLoadAsset(SLstring assetFile,
     }
 }
 //-----------------------------------------------------------------------------
+/*! Moves all resources of a staging that were created on a loader thread into
+the global resource vectors of the scene. Must be called on the render thread.
+*/
+void SLScene::addStaging(SLSceneStaging& staging)
+{
+    _meshes.insert(_meshes.end(), staging.meshes.begin(), staging.meshes.end());
+    _materials.insert(_materials.end(), staging.materials.begin(), staging.materials.end());
+    _textures.insert(_textures.end(), staging.textures.begin(), staging.textures.end());
+    staging.meshes.clear();
+    staging.materials.clear();
+    staging.textures.clear();
+
+    _animManager.merge(staging.animManager);
+}
+//-----------------------------------------------------------------------------
 //! Setter for video type also sets the active calibration
 /*! The SLScene instance has two video camera calibrations, one for a main camera
 (SLScene::_calibMainCam) and one for the selfie camera on mobile devices
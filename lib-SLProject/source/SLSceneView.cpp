@@ -25,6 +25,7 @@
 #include <SLLight.h>
 #include <SLLightRect.h>
 #include <SLLightSpot.h>
+#include <SLProfiler.h>
 #include <SLSceneView.h>
 #include <SLTexFont.h>
 
@@ -394,6 +395,8 @@ the 2D or 3D graph was updated or waitEvents is false.
 */
 SLbool SLSceneView::onPaint()
 {
+    SL_PROFILE_SCOPE("Paint");
+
     SLScene* s          = SLApplication::scene;
     SLbool   camUpdated = false;
 
@@ -429,6 +432,12 @@ SLbool SLSceneView::onPaint()
     // Set gotPainted only to true if RT is not busy
     _gotPainted = _renderType == RT_gl || raytracer()->state() != rtBusy;
 
+    // Tell the frame scheduler what requests the next frame
+    if (_isFirstFrame || !_doWaitOnIdle)
+        s->frameScheduler().markDirty(DS_continuous);
+    if (camUpdated)
+        s->frameScheduler().markDirty(DS_animation);
+
     // Return true if it is the first frame or a repaint is needed
     if (_isFirstFrame)
     {
@@ -545,11 +554,14 @@ SLbool SLSceneView::draw3DGL(SLfloat elapsedTimeMS)
     // 4. Frustum Culling //
     ////////////////////////
 
-    _camera->setFrustumPlanes();
-    _blendNodes.clear();
-    _visibleNodes.clear();
-    if (s->root3D())
-        s->root3D()->cull3DRec(this);
+    {
+        SL_PROFILE_SCOPE("Cull");
+        _camera->setFrustumPlanes();
+        _blendNodes.clear();
+        _visibleNodes.clear();
+        if (s->root3D())
+            s->root3D()->cull3DRec(this);
+    }
 
     _cullTimeMS = s->timeMilliSec() - startMS;
 
@@ -598,13 +610,17 @@ pass only the alpha meshes and in the opaque pass only the opaque meshes.
 */
 void SLSceneView::draw3DGLAll()
 {
+    SL_PROFILE_SCOPE("Draw 3D");
+    SL_PROFILE_GPU("Draw 3D");
+
     // 1) Draw first the opaque shapes and all helper lines (normals and AABBs)
     draw3DGLNodes(_visibleNodes, false, false);
     draw3DGLLines(_visibleNodes);
     draw3DGLLines(_blendNodes);
 
-    // 2) Draw blended nodes sorted back to front
+    // 2) Draw blended nodes sorted back to front and all texts at once
     draw3DGLNodes(_blendNodes, true, true);
+    _textBatcher.flush();
 
     // 3) Draw helper
     draw3DGLLinesOverlay(_visibleNodes);
@@ -783,6 +799,9 @@ update is done to the 2D scenegraph.
 */
 void SLSceneView::draw2DGL()
 {
+    SL_PROFILE_SCOPE("Draw 2D");
+    SL_PROFILE_GPU("Draw 2D");
+
     SLScene* s       = SLApplication::scene;
     SLfloat  startMS = s->timeMilliSec();
 
@@ -870,6 +889,9 @@ void SLSceneView::draw2DGLNodes()
         node->drawMeshes(this);
     }
 
+    // Draw all texts of the 2D nodes in one draw call
+    _textBatcher.flush();
+
     // Draw rotation helpers during camera animations
     if ((_mouseDownL || _mouseDownM) && _touchDowns == 0)
     {
@@ -24,7 +24,8 @@
 SLSkeleton::SLSkeleton() : _rootJoint(nullptr),
                            _minOS(-1, -1, -1),
                            _maxOS(1, 1, 1),
-                           _minMaxOutOfDate(true)
+                           _minMaxOutOfDate(true),
+                           _lastUpdate(AU_none)
 {
     SLApplication::scene->animManager().addSkeleton(this);
 }
@@ -102,6 +103,22 @@ void SLSkeleton::getJointMatrices(SLVMat4f& jointWM)
     }
 }
 //-----------------------------------------------------------------------------
+/*! Updates the final joint matrices that are used by all meshes that are bound
+to this skeleton. They are calculated once per changed skeleton and not once
+per skinned mesh (see SLAnimManager::skinMeshes). In the frames between two
+reduced updates of the animation LOD they are interpolated instead.
+*/
+void SLSkeleton::updateJointMatrices()
+{
+    if (_jointMatrices.size() != _joints.size())
+        _jointMatrices.resize(_joints.size());
+
+    if (_lod.update() != AU_reduced || _lod.needsEvaluation())
+        getJointMatrices(_jointMatrices);
+
+    _lod.finishUpdate(_jointMatrices);
+}
+//-----------------------------------------------------------------------------
 /*! Create a nw animation owned by this skeleton.
 */
 SLAnimation* SLSkeleton::createAnimation(const SLstring& name, SLfloat duration)
@@ -132,11 +149,14 @@ void SLSkeleton::reset()
         j->resetToInitialState();
 }
 //-----------------------------------------------------------------------------
-/*! Updates the skeleton based on its active animation states
+/*! Updates the skeleton based on its active animation states. The time of the
+playbacks always advances but the pose is only evaluated as often as the
+animation LOD policy (SLAnimLOD) decides.
 */
 SLbool SLSkeleton::updateAnimations(SLfloat elapsedTimeSec)
 {
     SLbool animated = false;
+    _lastUpdate     = AU_none;
 
     for (auto it : _animPlaybacks)
     {
@@ -152,6 +172,21 @@ SLbool SLSkeleton::updateAnimations(SLfloat elapsedTimeSec)
     if (!animated)
         return false;
 
+    _lastUpdate = _lod.nextUpdate();
+
+    // Skip the pose evaluation if culled or interpolate between two poses
+    if (!_lod.needsEvaluation())
+    {
+        for (auto it : _animPlaybacks)
+            it.second->changed(false);
+
+        if (_lastUpdate == AU_skipped)
+            return false;
+
+        changed(true); // skin with the interpolated joint matrices
+        return true;
+    }
+
     // reset the skeleton and apply all enabled animations
     reset();
 
@@ -160,7 +195,11 @@ SLbool SLSkeleton::updateAnimations(SLfloat elapsedTimeSec)
         SLAnimPlayback* pb = it.second;
         if (pb->enabled())
         {
-            pb->parentAnimation()->apply(this, pb->localTime(), pb->weight());
+            pb->parentAnimation()->apply(this,
+                                         pb->localTime(),
+                                         pb->weight(),
+                                         1.0f,
+                                         &pb->keyframeCursors());
             pb->changed(false); // remove changed dirty flag from the pb again
         }
     }
@@ -0,0 +1,199 @@
+//#############################################################################
+//  File:      SLSkeletonInstance.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+#include <SLSkeleton.h>
+#include <SLSkeletonInstance.h>
+
+//-----------------------------------------------------------------------------
+/*! Creates an instance of the passed skeleton with one playback per skeleton
+animation. The joint hierarchy is flattened into a parent ID per joint and an
+evaluation order with parents before children. Animations that are not yet
+compiled get compiled because the instance evaluates only SLAnimClips.
+*/
+SLSkeletonInstance::SLSkeletonInstance(SLSkeleton* skeleton)
+  : _skeleton(skeleton),
+    _changed(false),
+    _lastUpdate(AU_none)
+{
+    assert(skeleton && "SLSkeletonInstance needs a valid skeleton.");
+
+    const SLVJoint& joints    = skeleton->joints();
+    SLuint          numJoints = (SLuint)joints.size();
+
+    _parentIDs.resize(numJoints, -1);
+    _initialMats.resize(numJoints);
+    _offsetMats.resize(numJoints);
+    _localMats.resize(numJoints);
+    _worldMats.resize(numJoints);
+    _jointMatrices.resize(numJoints);
+
+    // flatten the joint hierarchy in depth first order
+    if (skeleton->rootJoint())
+    {
+        vector<SLJoint*> stack;
+        stack.push_back(skeleton->rootJoint());
+        while (!stack.empty())
+        {
+            SLJoint* joint = stack.back();
+            stack.pop_back();
+
+            SLuint   id     = joint->id();
+            SLJoint* parent = dynamic_cast<SLJoint*>(joint->parent());
+
+            _parentIDs[id]   = parent ? (SLint)parent->id() : -1;
+            _initialMats[id] = joint->initialOM();
+            _offsetMats[id]  = joint->offsetMat();
+            _jointOrder.push_back(id);
+
+            for (auto child : joint->children())
+                if (SLJoint* childJoint = dynamic_cast<SLJoint*>(child))
+                    stack.push_back(childJoint);
+        }
+    }
+
+    for (auto it : skeleton->animations())
+    {
+        SLAnimation* anim = it.second;
+        if (!anim->clip())
+            anim->compile();
+        _animPlaybacks[it.first] = new SLAnimPlayback(anim);
+    }
+
+    // start in the initial pose
+    _localMats = _initialMats;
+    updateJointMatrices();
+}
+//-----------------------------------------------------------------------------
+SLSkeletonInstance::~SLSkeletonInstance()
+{
+    for (auto it : _animPlaybacks)
+        delete it.second;
+}
+//-----------------------------------------------------------------------------
+/*! Returns the playback of this instance for the skeleton animation with the
+passed name or nullptr.
+*/
+SLAnimPlayback* SLSkeletonInstance::animPlayback(const SLstring& name)
+{
+    if (_animPlaybacks.find(name) != _animPlaybacks.end())
+        return _animPlaybacks[name];
+    return nullptr;
+}
+//-----------------------------------------------------------------------------
+/*! Returns the max. NO. of joint matrices that fit into the vertex uniforms of
+the skinning shaders. It is queried once with the current OpenGL context and
+sets the size of u_jointMatrices (SL_MAX_JOINTS, see SLGLShader). OpenGL ES 3.0
+only guarantees 256 uniform vectors and a mat4 takes 4 of them. 128 vectors
+are kept for the matrices, lights and material of the skinning shaders.
+Instances with more joints are skinned on the CPU (see SLMesh::draw).
+*/
+SLuint SLSkeletonInstance::maxJointsGPU()
+{
+    static SLint maxJoints = -1;
+
+    if (maxJoints < 0)
+    {
+        GLint vectors = 0;
+#ifdef SL_GLES
+        glGetIntegerv(GL_MAX_VERTEX_UNIFORM_VECTORS, &vectors);
+#else
+        glGetIntegerv(GL_MAX_VERTEX_UNIFORM_COMPONENTS, &vectors);
+        vectors /= 4;
+#endif
+        maxJoints = std::max((vectors - 128) / 4, 1);
+    }
+    return (SLuint)maxJoints;
+}
+//-----------------------------------------------------------------------------
+/*! Advances the playbacks of this instance and updates the joint matrices if
+any playback changed. Only members of this instance are written, so many
+instances can be updated in parallel. The pose is only evaluated as often as
+the animation LOD policy (SLAnimLOD) decides.
+*/
+SLbool SLSkeletonInstance::updateAnimations(SLfloat elapsedTimeSec)
+{
+    _changed    = false;
+    _lastUpdate = AU_none;
+
+    for (auto it : _animPlaybacks)
+    {
+        SLAnimPlayback* pb = it.second;
+        if (pb->enabled())
+        {
+            pb->advanceTime(elapsedTimeSec);
+            _changed |= pb->changed();
+        }
+    }
+
+    if (!_changed)
+        return false;
+
+    for (auto it : _animPlaybacks)
+        it.second->changed(false);
+
+    _lastUpdate = _lod.nextUpdate();
+
+    if (_lastUpdate == AU_skipped)
+    {
+        _changed = false;
+        return false;
+    }
+
+    if (_lod.needsEvaluation())
+    {
+        // reset to the initial pose and apply all enabled animations
+        _localMats = _initialMats;
+
+        for (auto it : _animPlaybacks)
+        {
+            SLAnimPlayback* pb = it.second;
+            if (pb->enabled())
+            {
+                // Skip animations whose clip got discarded by a change. They
+                // can't be recompiled here because instances share animations.
+                SLAnimClip* clip = pb->parentAnimation()->clip();
+                if (!clip) continue;
+
+                clip->evaluate(pb->localTime(), _pose);
+                clip->applyPose(_pose, _localMats, pb->weight());
+            }
+        }
+
+        updateJointMatrices();
+    }
+
+    // interpolate the joint matrices for reduced updates
+    _lod.finishUpdate(_jointMatrices);
+    return true;
+}
+//-----------------------------------------------------------------------------
+/*! Concatenates the local joint matrices along the hierarchy and multiplies
+them with the joint offset matrices like SLSkeleton::getJointMatrices.
+*/
+void SLSkeletonInstance::updateJointMatrices()
+{
+    for (auto id : _jointOrder)
+    {
+        SLint parentID = _parentIDs[id];
+
+        if (parentID < 0)
+            _worldMats[id] = _localMats[id];
+        else
+            _worldMats[id] = _worldMats[(SLuint)parentID] * _localMats[id];
+
+        _jointMatrices[id] = _worldMats[id] * _offsetMats[id];
+    }
+}
+//-----------------------------------------------------------------------------
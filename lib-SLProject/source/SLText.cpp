@@ -16,6 +16,7 @@
 
 #include <SLApplication.h>
 #include <SLScene.h>
+#include <SLSceneView.h>
 #include <SLText.h>
 
 //-----------------------------------------------------------------------------
@@ -36,36 +37,37 @@ SLText::SLText(SLstring   text,
     _maxW  = maxWidth;
     _lineH = lineHeightFactor;
 
+    _isDirty = true;
     _aabb.hasAlpha(true);
 }
 //-----------------------------------------------------------------------------
+//! Sets a new text. The character quads are rebuilt at the next draw.
+void SLText::text(SLstring text)
+{
+    if (text == _text) return;
+    _text    = text;
+    _isDirty = true;
+    needAABBUpdate();
+}
+//-----------------------------------------------------------------------------
 /*! 
-SLText::shapeDraw draws the text buffer objects
+SLText::drawRec adds the character quads to the text batcher of the scene
+view that draws them with all other texts of the pass.
 */
 void SLText::drawRec(SLSceneView* sv)
 {
     if (_drawBits.get(SL_DB_HIDDEN) || !_stateGL->blend()) return;
 
-    // create buffer object for text once
-    if (!_vao.id())
+    // rebuild the character quads only if the text changed
+    if (_isDirty)
     {
-        _font->buildTextBuffers(_vao, _text, _maxW, _lineH);
-        _font->minFiler(SL_ANISOTROPY_MAX);
-        _font->magFiler(GL_LINEAR);
+        _font->buildTextQuads(_P, _T, _text, _maxW, _lineH);
+        _isDirty = false;
     }
-    // Enable & build font texture with active OpenGL context
-    _font->bindActive();
 
-    // Setup shader
-    SLGLProgram* sp    = SLApplication::scene->programs(SP_fontTex);
-    SLGLState*   state = SLGLState::getInstance();
-    sp->useProgram();
-    sp->uniformMatrix4fv("u_mvpMatrix", 1, (const SLfloat*)state->mvpMatrix());
-    sp->uniform4fv("u_textColor", 1, (float*)&_color);
-    sp->uniform1i("u_texture0", 0);
-
-    _vao.drawElementsAs(PT_triangles, (SLuint)_text.length() * 2 * 3);
+    sv->textBatcher().add(_P, _T, _color, _stateGL->modelViewMatrix);
 }
+//-----------------------------------------------------------------------------
 void SLText::drawMeshes(SLSceneView* sv)
 {
     drawRec(sv);
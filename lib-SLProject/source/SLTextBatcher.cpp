@@ -0,0 +1,132 @@
+//#############################################################################
+//  File:      SLTextBatcher.cpp
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Codestyle: https://github.com/cpvrlab/SLProject/wiki/Coding-Style-Guidelines
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#ifdef SL_MEMLEAKDETECT    // set in SL.h for debug config only
+#    include <debug_new.h> // memory leak detector
+#endif
+
+#include <SLApplication.h>
+#include <SLMaterial.h>
+#include <SLScene.h>
+#include <SLTexFont.h>
+#include <SLTextBatcher.h>
+
+//-----------------------------------------------------------------------------
+SLTextBatcher::SLTextBatcher()
+{
+    _numVertices = 0;
+    _capacity    = 0;
+}
+//-----------------------------------------------------------------------------
+/*! Adds the character quads of a text built by SLTexFont::buildTextQuads.
+The vertices get transformed by the modelview matrix of the text node. A full
+batch gets flushed before more quads are added.
+*/
+void SLTextBatcher::add(const SLVVec3f& P,
+                        const SLVVec2f& T,
+                        const SLCol4f&  color,
+                        const SLMat4f&  mv)
+{
+    assert(P.size() == T.size() && P.size() % 4 == 0);
+
+    SLuint numP = (SLuint)P.size();
+
+    for (SLuint first = 0; first < numP;)
+    {
+        if (_numVertices == maxVertices)
+            flush();
+
+        SLuint num = std::min(numP - first, maxVertices - _numVertices);
+        reserve(_numVertices + num);
+
+        for (SLuint i = 0; i < num; ++i)
+        {
+            _P[_numVertices + i] = mv * P[first + i];
+            _T[_numVertices + i] = T[first + i];
+            _C[_numVertices + i] = color;
+        }
+
+        _numVertices += num;
+        first += num;
+    }
+}
+//-----------------------------------------------------------------------------
+//! Grows the vertex arrays to the next power of 2 vertices up to maxVertices
+void SLTextBatcher::reserve(SLuint numVertices)
+{
+    if (numVertices <= _P.size()) return;
+
+    SLuint size = std::max(SLGLTexture::nextPowerOf2(numVertices), (SLuint)1024);
+    size        = std::min(size, (SLuint)maxVertices);
+    _P.resize(size);
+    _T.resize(size);
+    _C.resize(size);
+
+    // Two triangles per quad that never change
+    _I.resize(size / 4 * 6);
+    for (SLuint q = 0; q < size / 4; ++q)
+    {
+        SLushort iV   = (SLushort)(q * 4);
+        _I[q * 6]     = iV;
+        _I[q * 6 + 1] = iV + 1;
+        _I[q * 6 + 2] = iV + 3;
+        _I[q * 6 + 3] = iV + 1;
+        _I[q * 6 + 4] = iV + 2;
+        _I[q * 6 + 5] = iV + 3;
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Draws all quads added since the last flush in one draw call with the
+current projection matrix. The vertex buffer gets only regenerated if its
+capacity grew. Otherwise only the vertex attributes of the batched vertices
+are updated.
+*/
+void SLTextBatcher::flush()
+{
+    // Without a glyph atlas the batched texts can't be drawn
+    if (!SLTexFont::atlas) _numVertices = 0;
+    if (_numVertices == 0) return;
+
+    SLGLProgram* sp    = SLApplication::scene->programs(SP_fontTex);
+    SLGLState*   state = SLGLState::getInstance();
+    sp->useProgram();
+
+    if (_capacity != (SLuint)_P.size())
+    {
+        _capacity = (SLuint)_P.size();
+        _vao.clearAttribs();
+        _vao.setAttrib(AT_position, sp->getAttribLocation("a_position"), &_P);
+        _vao.setAttrib(AT_texCoord, sp->getAttribLocation("a_texCoord"), &_T);
+        _vao.setAttrib(AT_color, sp->getAttribLocation("a_color"), &_C);
+        _vao.setIndices(&_I);
+        _vao.generate(_capacity, BU_stream, false);
+    }
+    else
+    {
+        _vao.updateAttrib(AT_position, &_P, _numVertices);
+        _vao.updateAttrib(AT_texCoord, &_T, _numVertices);
+        _vao.updateAttrib(AT_color, &_C, _numVertices);
+    }
+
+    // Enable & build the glyph atlas with active OpenGL context
+    SLTexFont::atlas->bindActive(0);
+
+    sp->uniformMatrix4fv("u_mvpMatrix", 1, state->projectionMatrix.m());
+    sp->uniform1i("u_texture0", 0);
+
+    _vao.drawElementsAs(PT_triangles, _numVertices / 4 * 6);
+
+    // The next mesh has to activate its material again for its own program
+    SLMaterial::current = nullptr;
+    _numVertices        = 0;
+}
+//-----------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #include <SLApplication.h>
 #include <SLScene.h>
 #include <SLTransferFunction.h>
+#include <SLVolumeOccupancy.h>
 
 //-----------------------------------------------------------------------------
 //! ctor with vector of alpha values and a predefined color LUT scheme
@@ -27,6 +28,7 @@ SLTransferFunction::SLTransferFunction(SLVTransferAlpha alphaValues,
     _texType    = TT_color;
     _length     = length;
     _target     = GL_TEXTURE_2D; // OpenGL ES doesn't define 1D textures. We just make a 1 pixel high 2D texture
+    _occupancy  = nullptr;
 
     colors(lut);
 
@@ -50,6 +52,7 @@ SLTransferFunction::SLTransferFunction(SLVTransferAlpha alphaValues,
     _texType    = TT_color;
     _length     = length;
     _target     = GL_TEXTURE_2D; // OpenGL ES doesn't define 1D textures. We just make a 1 pixel high 2D texture
+    _occupancy  = nullptr;
 
     for (auto color : colorValues)
         _colors.push_back(color);
@@ -251,6 +254,9 @@ void SLTransferFunction::generateTexture()
 
     // Create 1 x lenght sized image from SLCol4f values
     load(tf);
+
+    // Update the empty bricks of the volume for the new alphas
+    if (_occupancy) _occupancy->update();
 }
 //-----------------------------------------------------------------------------
 //! Returns all alpha values of the transfer function as a float vector
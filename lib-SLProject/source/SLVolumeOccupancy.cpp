@@ -0,0 +1,212 @@
+//#############################################################################
+//  File:      SLVolumeOccupancy.cpp
+//  Purpose:   Implements the brick occupancy grid for volume ray casting
+//  Author:    Marcus Hudritsch
+//  Date:      Autumn 2018
+//  Copyright: Marcus Hudritsch
+//             This software is provide under the GNU General Public License
+//             Please visit: http://opensource.org/licenses/GPL-3.0
+//#############################################################################
+
+#include <stdafx.h> // Must be the 1st include followed by  an empty line
+
+#include <SLApplication.h>
+#include <SLScene.h>
+#include <SLTransferFunction.h>
+#include <SLVolumeOccupancy.h>
+
+//-----------------------------------------------------------------------------
+/*! ctor with the 3D volume texture and the transfer function that maps it.
+\param volume 3D texture with the loaded volume images
+\param tf Transfer function that maps the voxel values to alpha
+\param channel Channel of the voxel value in the volume images
+\param brickSize NO. of voxels per brick side
+*/
+SLVolumeOccupancy::SLVolumeOccupancy(SLGLTexture*        volume,
+                                     SLTransferFunction* tf,
+                                     SLint               channel,
+                                     SLint               brickSize)
+{
+    assert(volume && volume->target() == GL_TEXTURE_3D &&
+           "SLVolumeOccupancy: No 3D volume texture");
+    assert(tf && brickSize > 0);
+
+    name(volume->name() + "_occupancy");
+    _min_filter  = GL_NEAREST;
+    _mag_filter  = GL_NEAREST;
+    _wrap_s      = GL_CLAMP_TO_EDGE;
+    _wrap_t      = GL_CLAMP_TO_EDGE;
+    _texType     = TT_color;
+    _target      = GL_TEXTURE_3D;
+    _tf          = tf;
+    _brickSize   = brickSize;
+    _numOccupied = 0;
+
+    SLCVVImage& images = volume->images();
+    _bricksX           = ((SLint)images[0]->width() + brickSize - 1) / brickSize;
+    _bricksY           = ((SLint)images[0]->height() + brickSize - 1) / brickSize;
+    _bricksZ           = ((SLint)images.size() + brickSize - 1) / brickSize;
+
+    // One empty 8-bit image per brick slice
+    for (SLint z = 0; z < _bricksZ; ++z)
+    {
+        SLCVImage* img = new SLCVImage(_bricksX, _bricksY, PF_red, name());
+        memset(img->data(), 0, img->bytesPerImage());
+        _images.push_back(img);
+    }
+
+    calcMinMax(volume, channel);
+    update();
+
+    // The transfer function calls update whenever it gets regenerated
+    tf->occupancy(this);
+
+    // Add pointer to the global resource vectors for deallocation
+    SLApplication::scene->textures().push_back(this);
+}
+//-----------------------------------------------------------------------------
+/*! Calculates the min. and max. voxel value of each brick including the
+voxels next to the brick that the linear texture filter reads. The brick
+slices in z are processed in parallel.
+*/
+void SLVolumeOccupancy::calcMinMax(SLGLTexture* volume, SLint channel)
+{
+    SLCVVImage& images = volume->images();
+    SLint       volX   = (SLint)images[0]->width();
+    SLint       volY   = (SLint)images[0]->height();
+    SLint       volZ   = (SLint)images.size();
+    SLint       bpp    = (SLint)images[0]->bytesPerPixel();
+    SLint       B      = _brickSize;
+
+    if (channel < 0 || channel >= bpp)
+        SL_EXIT_MSG("SLVolumeOccupancy::calcMinMax: Invalid voxel channel");
+
+    _brickMin.assign((SLuint)(_bricksX * _bricksY * _bricksZ), 255);
+    _brickMax.assign((SLuint)(_bricksX * _bricksY * _bricksZ), 0);
+
+    SL::parallelFor((SLuint)_bricksZ, [&](SLuint i) {
+        SLint bz = (SLint)i;
+        SLint z0 = std::max(bz * B - 1, 0);
+        SLint z1 = std::min((bz + 1) * B + 1, volZ);
+
+        for (SLint by = 0; by < _bricksY; ++by)
+        {
+            SLint y0 = std::max(by * B - 1, 0);
+            SLint y1 = std::min((by + 1) * B + 1, volY);
+
+            for (SLint bx = 0; bx < _bricksX; ++bx)
+            {
+                SLint   x0   = std::max(bx * B - 1, 0);
+                SLint   x1   = std::min((bx + 1) * B + 1, volX);
+                SLuchar minV = 255;
+                SLuchar maxV = 0;
+
+                for (SLint z = z0; z < z1; ++z)
+                {
+                    SLCVImage* img = images[(SLuint)z];
+                    for (SLint y = y0; y < y1; ++y)
+                    {
+                        const SLuchar* row = img->data() + y * (SLint)img->bytesPerLine();
+                        for (SLint x = x0; x < x1; ++x)
+                        {
+                            SLuchar v = row[x * bpp + channel];
+                            minV      = std::min(minV, v);
+                            maxV      = std::max(maxV, v);
+                        }
+                    }
+                }
+
+                SLuint b     = (SLuint)((bz * _bricksY + by) * _bricksX + bx);
+                _brickMin[b] = minV;
+                _brickMax[b] = maxV;
+            }
+        }
+    });
+}
+//-----------------------------------------------------------------------------
+/*! Updates the occupancy of the bricks after a change of the transfer
+function. Only the bricks whose value range overlaps the changed part of the
+transfer function are tested. If a brick changed the grid gets uploaded again
+at the next bindActive.
+\return NO. of bricks whose occupancy changed
+*/
+SLuint SLVolumeOccupancy::update()
+{
+    SLVfloat alphas = _tf->allAlphas();
+    SLint    length = (SLint)alphas.size();
+
+    // Flags and prefix count of the nonzero alphas
+    SLVuchar      visible((SLuint)length);
+    vector<SLint> count((SLuint)length + 1, 0);
+    for (SLint i = 0; i < length; ++i)
+    {
+        visible[(SLuint)i]   = alphas[(SLuint)i] > 0.0f ? 1 : 0;
+        count[(SLuint)i + 1] = count[(SLuint)i] + visible[(SLuint)i];
+    }
+
+    // Range of the transfer function that changed since the last update
+    SLint changedLo = 0;
+    SLint changedHi = length - 1;
+    if (_lutVisible.size() == visible.size())
+    {
+        changedLo = length;
+        changedHi = -1;
+        for (SLint i = 0; i < length; ++i)
+        {
+            if (visible[(SLuint)i] != _lutVisible[(SLuint)i])
+            {
+                changedLo = std::min(changedLo, i);
+                changedHi = std::max(changedHi, i);
+            }
+        }
+    }
+    _lutVisible = visible;
+
+    if (changedHi < changedLo) return 0;
+
+    SLuint  numChanged = 0;
+    SLfloat scale      = (SLfloat)length / 255.0f;
+
+    for (SLint bz = 0; bz < _bricksZ; ++bz)
+    {
+        SLCVImage* img = _images[(SLuint)bz];
+        for (SLint by = 0; by < _bricksY; ++by)
+        {
+            SLuchar* row = img->data() + by * (SLint)img->bytesPerLine();
+            for (SLint bx = 0; bx < _bricksX; ++bx)
+            {
+                SLuint b = (SLuint)((bz * _bricksY + by) * _bricksX + bx);
+
+                // LUT entries that the linear filter reads for the value range
+                SLint lo = (SLint)floor((SLfloat)_brickMin[b] * scale - 0.5f);
+                SLint hi = (SLint)ceil((SLfloat)_brickMax[b] * scale - 0.5f);
+                lo       = SL_clamp(lo, 0, length - 1);
+                hi       = SL_clamp(hi, 0, length - 1);
+                if (hi < changedLo || lo > changedHi) continue;
+
+                SLuchar occupied = count[(SLuint)hi + 1] > count[(SLuint)lo] ? 255 : 0;
+                if (row[bx] != occupied)
+                {
+                    row[bx] = occupied;
+                    if (occupied)
+                        _numOccupied++;
+                    else
+                        _numOccupied--;
+                    numChanged++;
+                }
+            }
+        }
+    }
+
+    // Delete the texture so that bindActive builds it with the new grid
+    if (numChanged && _texName)
+    {
+        glDeleteTextures(1, &_texName);
+        numBytesInTextures -= _bytesOnGPU;
+        _texName    = 0;
+        _bytesOnGPU = 0;
+    }
+
+    return numChanged;
+}
+//-----------------------------------------------------------------------------